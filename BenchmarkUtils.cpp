@@ -0,0 +1,41 @@
+﻿#include "BenchmarkUtils.h"
+
+#include <iostream>
+#include <string>
+
+/**
+ * @brief Liczba znaków tekstu UTF-8.
+ */
+size_t Utf8Length(const char* text) {
+    size_t length = 0;
+    for (const unsigned char* c = reinterpret_cast<const unsigned char*>(text); *c; c++) {
+        if ((*c & 0xC0) != 0x80) length++;
+    }
+    return length;
+}
+
+/**
+ * @brief Wypisuje text dopełniony spacjami do width znaków.
+ */
+void PrintPadded(const char* text, size_t width) {
+    const size_t length = Utf8Length(text);
+    std::cout << text << std::string(length < width ? width - length : 1, ' ');
+}
+
+/**
+ * @brief Wypisuje wynik sprawdzenia i zwraca go.
+ */
+bool BenchmarkCheck(const char* name, bool ok) {
+    std::cout << "  ";
+    PrintPadded(name, BENCHMARK_CHECK_COLUMN);
+    std::cout << (ok ? "OK" : "BŁĄD") << "\n";
+    return ok;
+}
+
+/**
+ * @brief Wypisuje podsumowanie testu.
+ */
+int BenchmarkSummary(bool ok) {
+    std::cout << (ok ? "Wszystkie sprawdzenia zakończone powodzeniem." : "NIEKTÓRE SPRAWDZENIA NIE POWIODŁY SIĘ!") << std::endl;
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,50 @@
+﻿#pragma once
+#ifndef BENCHMARK_UTILS_H
+#define BENCHMARK_UTILS_H
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+
+/// Szerokość kolumny nazw sprawdzeń w znakach
+static const size_t BENCHMARK_CHECK_COLUMN = 54;
+
+/**
+ * @brief Liczba znaków tekstu UTF-8 (bajty kontynuacji nie są liczone).
+ */
+size_t Utf8Length(const char* text);
+
+/**
+ * @brief Wypisuje text dopełniony spacjami do width znaków.
+ *
+ * std::setw liczy bajty, a polskie litery zajmują w UTF-8 po dwa –
+ * etykiety z nimi rozjeżdżały kolumny.
+ */
+void PrintPadded(const char* text, size_t width);
+
+/**
+ * @brief Wypisuje wynik sprawdzenia testu wbudowanego i zwraca go.
+ */
+bool BenchmarkCheck(const char* name, bool ok);
+
+/**
+ * @brief Wypisuje podsumowanie testu.
+ * @return Kod zakończenia programu: 0 jeśli wszystkie sprawdzenia przeszły, 1 w przeciwnym razie.
+ */
+int BenchmarkSummary(bool ok);
+
+/**
+ * @brief Najkrótszy z repeats czasów wykonania function [ms].
+ */
+template <typename Function>
+double BestMs(int repeats, Function function) {
+    double best = 1e30;
+    for (int r = 0; r < repeats; r++) {
+        auto start = std::chrono::steady_clock::now();
+        function();
+        best = std::min(best, std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+    }
+    return best;
+}
+
+#endif
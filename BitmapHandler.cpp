@@ -1,8 +1,17 @@
 #include "BitmapHandler.h"
+#include "ImageMemory.h"
+
+#include <cstring>
+#include <fstream>
 
 /**
  * @brief Implementacja biblioteki stb_image.
+ *
+ * Przydziay stb_image trafiaj do areny dekodowania wtku (ImageMemory).
  */
+#define STBI_MALLOC(size) ImageScratchMalloc(size)
+#define STBI_REALLOC_SIZED(block, oldSize, newSize) ImageScratchRealloc(block, oldSize, newSize)
+#define STBI_FREE(block) ImageScratchFree(block)
 #define STB_IMAGE_IMPLEMENTATION
 #include "stb_image.h"
 
@@ -10,7 +19,7 @@
   * @brief Konstruktor klasy BitmapHandler.
   */
 BitmapHandler::BitmapHandler()
-    : data(nullptr), width(0), height(0), channels(0) {
+    : data(nullptr), width(0), height(0), channels(0), format(PIXEL_FORMAT_SOURCE), allocator(nullptr) {
 }
 
 /**
@@ -20,43 +29,158 @@ BitmapHandler::~BitmapHandler() {
     Free();
 }
 
+/**
+ * @brief Kopiuje piksele, opcjonalnie odwracajc wiersze i rozszerzajc do 4 kanaw.
+ */
+static void CopyPixels(const unsigned char* source, int sourceChannels, unsigned char* target, int targetChannels,
+    int width, int height, bool flipY) {
+    const size_t sourceRow = (size_t)width * sourceChannels;
+    const size_t targetRow = (size_t)width * targetChannels;
+    for (int y = 0; y < height; y++) {
+        const unsigned char* in = source + (flipY ? height - 1 - y : y) * sourceRow;
+        unsigned char* out = target + y * targetRow;
+        if (sourceChannels == targetChannels) {
+            memcpy(out, in, sourceRow);
+        }
+        else if (sourceChannels == 3) {
+            PixelConvert::ExpandRGBToRGBA(in, out, width);
+        }
+        else {
+            // Odcienie szaroci (z alf lub bez)  rzadkie, wersja skalarna
+            for (int x = 0; x < width; x++) {
+                unsigned char grey = in[x * sourceChannels];
+                out[x * 4 + 0] = grey;
+                out[x * 4 + 1] = grey;
+                out[x * 4 + 2] = grey;
+                out[x * 4 + 3] = sourceChannels == 2 ? in[x * 2 + 1] : 255;
+            }
+        }
+    }
+}
+
 /**
  * @brief Wczytuje plik graficzny do pamici.
  * @param filePath cieka do pliku obrazu.
  * @param flipY Czy odwrci obraz w osi Y.
+ * @param targetFormat Docelowy ukad pikseli.
  * @return True jeli wczytanie si powiodo.
  */
-bool BitmapHandler::Load(const std::string& filePath, bool flipY) {
+bool BitmapHandler::Load(const std::string& filePath, bool flipY, PixelFormat targetFormat) {
     // Upewniamy si, e poprzednie dane zostay wyczyszczone
     Free();
 
-    // Standard w 3D: OpenGL oczekuje tekstur odwrconych pionowo
-    stbi_set_flip_vertically_on_load(flipY);
-
-    // Wczytywanie pliku
-    data = stbi_load(filePath.c_str(), &width, &height, &channels, 0);
+    // Wczytywanie pliku  bufory tymczasowe i wynik stb_image yj w arenie do koca zakresu
+    ImageScratchScope scratch;
+    unsigned char* decoded = stbi_load(filePath.c_str(), &width, &height, &channels, 0);
 
-    if (!data) {
+    if (!decoded) {
         std::cerr << "[BitmapHandler Error] Failed to load: " << filePath
             << " | Reason: " << stbi_failure_reason() << std::endl;
         return false;
     }
 
+    // Kopia z areny do bufora wyniku (pula)  w tym samym przebiegu odwrcenie
+    // w osi Y (OpenGL oczekuje tekstur odwrconych pionowo) i rozszerzenie do 4 kanaw
+    const int outputChannels = targetFormat == PIXEL_FORMAT_SOURCE ? channels : 4;
+    allocator = &GetImageAllocator();
+    data = (unsigned char*)allocator->Allocate((size_t)width * height * outputChannels);
+    if (!data) {
+        std::cerr << "[BitmapHandler Error] Out of memory for: " << filePath << std::endl;
+        stbi_image_free(decoded);
+        width = height = channels = 0;
+        return false;
+    }
+    CopyPixels(decoded, channels, data, outputChannels, width, height, flipY);
+    stbi_image_free(decoded);
+    channels = outputChannels;
+
+    if (targetFormat != PIXEL_FORMAT_SOURCE) {
+        format = PIXEL_FORMAT_RGBA;
+        Convert(targetFormat);
+    }
+
     // Opcjonalnie: logowanie sukcesu (przydatne przy debugowaniu silnika)
     // std::cout << "[BitmapHandler] Loaded: " << filePath << " (" << width << "x" << height << ", " << channels << " channels)" << std::endl;
 
     return true;
 }
 
+/**
+ * @brief Zamienia wczytany obraz na 4 kanay RGBA lub BGRA.
+ * @param target Docelowy ukad pikseli.
+ * @return False jeli brak danych.
+ */
+bool BitmapHandler::Convert(PixelFormat target) {
+    if (!data) return false;
+    if (target == PIXEL_FORMAT_SOURCE || target == format) return true;
+
+    const size_t pixels = (size_t)width * height;
+    if (channels != 4) {
+        unsigned char* expanded = (unsigned char*)allocator->Allocate(pixels * 4);
+        if (!expanded) {
+            std::cerr << "[BitmapHandler Error] Out of memory converting to 4 channels" << std::endl;
+            return false;
+        }
+        CopyPixels(data, channels, expanded, 4, width, height, false);
+        allocator->Free(data, GetTotalSize());
+        data = expanded;
+        channels = 4;
+        format = PIXEL_FORMAT_RGBA;
+    }
+    else if (format == PIXEL_FORMAT_SOURCE) {
+        format = PIXEL_FORMAT_RGBA;
+    }
+
+    if (format != target) {
+        PixelConvert::SwapRedBlue(data, data, pixels);
+        format = target;
+    }
+    return true;
+}
+
+/**
+ * @brief Mnoy kolory przez alf.
+ */
+void BitmapHandler::PremultiplyAlpha() {
+    if (data && channels == 4) PixelConvert::PremultiplyAlpha(data, (size_t)width * height);
+}
+
 /**
  * @brief Zwalnia pami zajt przez obraz.
  */
 void BitmapHandler::Free() {
     if (data) {
-        stbi_image_free(data);
+        allocator->Free(data, GetTotalSize());
         data = nullptr;
         width = 0;
         height = 0;
         channels = 0;
+        format = PIXEL_FORMAT_SOURCE;
+    }
+}
+
+/**
+ * @brief Zapisuje obraz RGB do pliku PPM (P6).
+ * @param filePath cieka pliku wynikowego.
+ * @param width Szeroko w pikselach.
+ * @param height Wysoko w pikselach.
+ * @param rgb Dane RGB (3 bajty na piksel).
+ * @param flipY Czy zapisa wiersze w odwrotnej kolejnoci.
+ * @return True jeli zapis si powid.
+ */
+bool BitmapHandler::SavePPM(const std::string& filePath, int width, int height,
+    const unsigned char* rgb, bool flipY) {
+    std::ofstream file(filePath, std::ios::binary);
+    if (!file) {
+        std::cerr << "[BitmapHandler Error] Failed to open for writing: " << filePath << std::endl;
+        return false;
+    }
+
+    file << "P6\n" << width << " " << height << "\n255\n";
+    size_t rowSize = (size_t)width * 3;
+    for (int y = 0; y < height; y++) {
+        int row = flipY ? (height - 1 - y) : y;
+        file.write(reinterpret_cast<const char*>(rgb + row * rowSize), rowSize);
     }
+    return file.good();
 }
@@ -2,9 +2,13 @@
 #ifndef BITMAP_HANDLER_H
 #define BITMAP_HANDLER_H
 
+#include "PixelConvert.h"
+
 #include <string>
 #include <iostream>
 
+class ImageAllocator;
+
 /**
  * @brief Klasa obsugujca wczytywanie bitmap do pamici.
  */
@@ -28,11 +32,26 @@ public:
 
     /**
      * @brief Wczytuje dane tekstury z pliku.
+     *
+     * Dekodowanie korzysta z areny wtku, a piksele trafiaj do bufora
+     * z GetImageAllocator() (ImageMemory.h).
      * @param filePath cieka do pliku obrazu.
      * @param flipY Czy odwrci obraz w osi Y (domylnie true).
+     * @param targetFormat Docelowy ukad pikseli (domylnie jak w pliku).
      * @return True jeli wczytanie si powiodo.
      */
-    bool Load(const std::string& filePath, bool flipY = true);
+    bool Load(const std::string& filePath, bool flipY = true, PixelFormat targetFormat = PIXEL_FORMAT_SOURCE);
+
+    /**
+     * @brief Zamienia wczytany obraz na 4 kanay RGBA lub BGRA (PixelConvert).
+     * @return False jeli brak danych.
+     */
+    bool Convert(PixelFormat format);
+
+    /**
+     * @brief Mnoy kolory przez alf (tylko obrazy 4-kanaowe).
+     */
+    void PremultiplyAlpha();
 
     /**
      * @brief Zwalnia pami zajmowan przez dane obrazu.
@@ -63,17 +82,36 @@ public:
      */
     int GetChannels() const { return channels; }
 
+    /**
+     * @brief Zwraca ukad pikseli (PIXEL_FORMAT_SOURCE: 1-4 kanay jak w pliku).
+     */
+    PixelFormat GetFormat() const { return format; }
+
     /**
      * @brief Zwraca czny rozmiar danych obrazu w bajtach.
      * @return Rozmiar danych w bajtach.
      */
     size_t GetTotalSize() const { return (size_t)width * height * channels; }
 
+    /**
+     * @brief Zapisuje obraz RGB do pliku PPM (P6).
+     * @param filePath cieka pliku wynikowego.
+     * @param width Szeroko w pikselach.
+     * @param height Wysoko w pikselach.
+     * @param rgb Dane RGB (3 bajty na piksel, wiersze bez wyrwnania).
+     * @param flipY Czy zapisa wiersze w odwrotnej kolejnoci (dane z glReadPixels).
+     * @return True jeli zapis si powid.
+     */
+    static bool SavePPM(const std::string& filePath, int width, int height,
+        const unsigned char* rgb, bool flipY = false);
+
 private:
     unsigned char* data; /**< Wskanik na dane bitmapy */
     int width;           /**< Szeroko obrazu w pikselach */
     int height;          /**< Wysoko obrazu w pikselach */
     int channels;        /**< Liczba kanaw obrazu */
+    PixelFormat format;  /**< Ukad pikseli po konwersji */
+    ImageAllocator* allocator; /**< Przydzia, z ktrego pochodzi bufor danych */
 };
 
 #endif
@@ -0,0 +1,144 @@
+﻿#include "ClusterBenchmark.h"
+#include "BenchmarkUtils.h"
+#include "ClusteredLighting.h"
+#include "MathLib.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+/// Parametry kamery testu (jak w Engine::updateProjection)
+static const float BENCH_NEAR = 0.1f;
+static const float BENCH_FAR = 100.0f;
+
+/**
+ * @brief Losowe światła w prostopadłościanie przed kamerą (część poza bryłą widzenia).
+ */
+static std::vector<PointLight> RandomLights(int count) {
+    auto random = []() { return (float)rand() / RAND_MAX; };
+    std::vector<PointLight> lights(count);
+    for (PointLight& light : lights) {
+        light.position[0] = random() * 80.0f - 40.0f;
+        light.position[1] = random() * 40.0f - 20.0f;
+        light.position[2] = -random() * 100.0f;
+        light.radius = 1.0f + random() * 5.0f;
+        for (int k = 0; k < 3; k++) light.color[k] = random();
+        light.intensity = 1.0f;
+    }
+    return lights;
+}
+
+/**
+ * @brief Sprawdza, czy dwa przypisania mają identyczne listy klastrów.
+ */
+static bool SameClusters(const ClusteredLighting& a, const ClusteredLighting& b) {
+    for (int slice = 0; slice < ClusteredLighting::SLICES; slice++) {
+        for (int y = 0; y < ClusteredLighting::TILES_Y; y++) {
+            for (int x = 0; x < ClusteredLighting::TILES_X; x++) {
+                int count = a.GetClusterLightCount(x, y, slice);
+                if (count != b.GetClusterLightCount(x, y, slice)) return false;
+                if (std::memcmp(a.GetClusterLights(x, y, slice), b.GetClusterLights(x, y, slice),
+                    count * sizeof(unsigned short)) != 0) return false;
+            }
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Sprawdza, czy każde widoczne światło trafiło do klastra zawierającego jego środek.
+ * @return Liczba świateł brakujących w klastrze środka (poza przepełnionymi klastrami).
+ */
+static int MissingCenters(const ClusteredLighting& clusters, const std::vector<PointLight>& lights,
+    const Mat4& view, const Mat4& projection) {
+    const float sliceScale = ClusteredLighting::SLICES / std::log(BENCH_FAR / BENCH_NEAR);
+    int missing = 0;
+    for (size_t i = 0; i < lights.size(); i++) {
+        const PointLight& light = lights[i];
+        Vec3 center = view.TransformPoint(Vec3(light.position[0], light.position[1], light.position[2]));
+        float depth = -center.z;
+        if (depth <= BENCH_NEAR || depth >= BENCH_FAR) continue;
+
+        Vec4 clip = projection.Transform(Vec4(center.x, center.y, center.z, 1.0f));
+        float ndcX = clip.x / clip.w, ndcY = clip.y / clip.w;
+        if (ndcX <= -1.0f || ndcX >= 1.0f || ndcY <= -1.0f || ndcY >= 1.0f) continue;
+
+        int x = std::min(static_cast<int>((ndcX + 1.0f) * 0.5f * ClusteredLighting::TILES_X), ClusteredLighting::TILES_X - 1);
+        int y = std::min(static_cast<int>((ndcY + 1.0f) * 0.5f * ClusteredLighting::TILES_Y), ClusteredLighting::TILES_Y - 1);
+        int slice = static_cast<int>(std::floor(std::log(depth / BENCH_NEAR) * sliceScale));
+        slice = std::min(std::max(slice, 0), ClusteredLighting::SLICES - 1);
+
+        int count = clusters.GetClusterLightCount(x, y, slice);
+        if (count >= ClusteredLighting::MAX_LIGHTS_PER_CLUSTER) continue;
+        const unsigned short* list = clusters.GetClusterLights(x, y, slice);
+        if (std::find(list, list + count, static_cast<unsigned short>(i)) == list + count) missing++;
+    }
+    return missing;
+}
+
+/**
+ * @brief Średni czas przypisania (transformacja + listy) w repeats wywołaniach Build.
+ */
+static double MeasureBuild(ClusteredLighting& clusters, const std::vector<PointLight>& lights,
+    const Mat4& view, const Mat4& projection, int repeats) {
+    double total = 0.0;
+    for (int r = 0; r < repeats; r++) {
+        clusters.Build(lights.data(), lights.size(), view, projection, BENCH_NEAR, BENCH_FAR);
+        total += clusters.GetStats().binMs;
+    }
+    return total / repeats;
+}
+
+/**
+ * @brief Mierzy przypisanie świateł do klastrów dla rosnącej liczby świateł.
+ */
+int RunClusterBenchmark(int maxLights) {
+    if (maxLights <= 0) maxLights = 4096;
+    maxLights = std::min(maxLights, static_cast<int>(ClusteredLighting::MAX_LIGHTS));
+    srand(12345);
+
+    ClusteredLighting scalar(1), simd(1), threaded(0);
+    scalar.SetUseSimd(false);
+    const int threads = threaded.GetThreadCount();
+
+    const Mat4 view = Mat4::LookAt(Vec3(0.0f, 2.0f, 5.0f), Vec3(0.0f, 0.0f, -20.0f), Vec3(0.0f, 1.0f, 0.0f));
+    const Mat4 projection = Mat4::Perspective(Radians(60.0f), 16.0f / 9.0f, BENCH_NEAR, BENCH_FAR);
+
+    std::cout << "\n=== TEST KLASTRÓW ŚWIATEŁ (" << ClusteredLighting::TILES_X << "x" << ClusteredLighting::TILES_Y
+        << "x" << ClusteredLighting::SLICES << " klastrów, " << threads << " wątków) ===\n";
+    std::cout << "  Światła  widoczne  wpisy    skalarny [ms]  SSE [ms]  SSE x" << std::left << std::setw(3) << threads
+        << std::right << "[ms]  przyspieszenie  pakowanie [ms]\n";
+
+    bool ok = true;
+    // Kolejne potęgi dwójki, na końcu dokładnie maxLights
+    for (int step = 1;; step *= 2) {
+        const int count = std::min(step, maxLights);
+        std::vector<PointLight> lights = RandomLights(count);
+        const int repeats = std::max(20, 8192 / count);
+
+        double scalarMs = MeasureBuild(scalar, lights, view, projection, repeats);
+        double simdMs = MeasureBuild(simd, lights, view, projection, repeats);
+        double threadedMs = MeasureBuild(threaded, lights, view, projection, repeats);
+
+        bool same = SameClusters(scalar, simd) && SameClusters(scalar, threaded);
+        int missing = MissingCenters(threaded, lights, view, projection);
+        ok &= same && missing == 0;
+
+        const ClusterStats& stats = threaded.GetStats();
+        std::cout << std::fixed << std::setprecision(3)
+            << std::setw(9) << count << std::setw(10) << stats.visibleLights << std::setw(7) << stats.references
+            << std::setw(17) << scalarMs << std::setw(10) << simdMs << std::setw(13) << threadedMs
+            << std::setw(15) << std::setprecision(2) << scalarMs / threadedMs << "x"
+            << std::setw(16) << std::setprecision(3) << stats.packMs;
+        if (stats.overflow) std::cout << "  (przepełnienia: " << stats.overflow << ")";
+        if (!same) std::cout << "  BŁĄD: różne listy klastrów";
+        if (missing) std::cout << "  BŁĄD: " << missing << " świateł poza klastrem środka";
+        std::cout << "\n" << std::defaultfloat;
+        if (count == maxLights) break;
+    }
+    return BenchmarkSummary(ok);
+}
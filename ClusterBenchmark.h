@@ -0,0 +1,17 @@
+﻿#pragma once
+#ifndef CLUSTER_BENCHMARK_H
+#define CLUSTER_BENCHMARK_H
+
+/**
+ * @brief Test obciążenia przypisania świateł do klastrów (ClusteredLighting).
+ *
+ * Dla liczby świateł od 1 do maxLights (kolejne potęgi dwójki) mierzy czas
+ * Build w wersji skalarnej, SSE i SSE na wszystkich rdzeniach oraz sprawdza,
+ * czy wszystkie wersje dają identyczne listy klastrów. Nie wymaga kontekstu
+ * OpenGL.
+ * @param maxLights Największa liczba świateł (domyślnie 4096).
+ * @return 0 jeśli wszystkie sprawdzenia przeszły, 1 w przeciwnym razie.
+ */
+int RunClusterBenchmark(int maxLights);
+
+#endif
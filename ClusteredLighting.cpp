@@ -0,0 +1,478 @@
+﻿#include "ClusteredLighting.h"
+#include "JobSystem.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__SSE2__)
+#include <emmintrin.h>
+#define CLUSTER_SSE 1
+#endif
+
+/// Liczba świateł przetwarzanych przez jedno zadanie transformacji (wielokrotność 4)
+static const size_t LIGHTS_PER_TASK = 256;
+
+/**
+ * @brief Konstruktor klasy ClusteredLighting.
+ */
+ClusteredLighting::ClusteredLighting(int threadCount)
+    : jobs(nullptr), useSimd(true), input(nullptr), lightCount(0), nearPlane(0.1f), farPlane(100.0f),
+    sliceScale(1.0f), sliceBias(0.0f),
+    clusterCounts(CLUSTER_COUNT, 0), clusterLights(CLUSTER_COUNT * MAX_LIGHTS_PER_CLUSTER),
+    sliceOverflow(SLICES, 0), gridData(CLUSTER_COUNT * 4, 0.0f), block("clusterData", 4),
+    gridTexture(0), lightTexture(0), indexTexture(0),
+    gridWidth(0), gridHeight(0), lightWidth(0), lightHeight(0), indexWidth(0), indexHeight(0) {
+    for (int i = 0; i < 16; i++) viewMatrix[i] = (i % 5 == 0) ? 1.0f : 0.0f;
+    SetThreadCount(threadCount);
+}
+
+/**
+ * @brief Destruktor klasy ClusteredLighting.
+ */
+ClusteredLighting::~ClusteredLighting() {
+    ReleaseGPU();
+}
+
+/**
+ * @brief Zmienia liczbę wątków przypisania (0: wspólny system zadań silnika).
+ */
+void ClusteredLighting::SetThreadCount(int threadCount) {
+    if (threadCount <= 0) {
+        ownJobs.reset();
+        jobs = &GetJobSystem();
+        return;
+    }
+    if (ownJobs && ownJobs->GetThreadCount() == threadCount) return;
+    ownJobs.reset();
+    ownJobs.reset(new JobSystem(threadCount));
+    jobs = ownJobs.get();
+}
+
+/**
+ * @brief Zwraca liczbę wątków przypisania.
+ */
+int ClusteredLighting::GetThreadCount() const {
+    return jobs->GetThreadCount();
+}
+
+/**
+ * @brief Wyznacza płaszczyzny kafelków i parametry warstw dla klatki.
+ */
+void ClusteredLighting::PrepareFrame(const Mat4& view, const Mat4& projection, float nearPlane, float farPlane) {
+    for (int i = 0; i < 16; i++) viewMatrix[i] = view.m[i];
+    this->nearPlane = nearPlane;
+    this->farPlane = farPlane;
+    sliceScale = SLICES / std::log(farPlane / nearPlane);
+    sliceBias = -SLICES * std::log(nearPlane) / std::log(farPlane / nearPlane);
+
+    // Granica kafelka x_ndc = b: wiersz0 - b * wiersz3 (dodatnie na prawo od granicy)
+    const float* p = projection.m;
+    for (int axis = 0; axis < 2; axis++) {
+        const int tiles = axis == 0 ? TILES_X : TILES_Y;
+        float* planes = axis == 0 ? planesX : planesY;
+        for (int i = 0; i <= tiles; i++) {
+            float boundary = -1.0f + 2.0f * i / tiles;
+            float a = p[axis] - boundary * p[3];
+            float b = p[4 + axis] - boundary * p[7];
+            float c = p[8 + axis] - boundary * p[11];
+            float d = p[12 + axis] - boundary * p[15];
+            float length = std::sqrt(a * a + b * b + c * c);
+            float inv = length > 0.0f ? 1.0f / length : 0.0f;
+            planes[i * 4 + 0] = a * inv;
+            planes[i * 4 + 1] = b * inv;
+            planes[i * 4 + 2] = c * inv;
+            planes[i * 4 + 3] = d * inv;
+        }
+    }
+
+    viewX.resize(lightCount);
+    viewY.resize(lightCount);
+    viewZ.resize(lightCount);
+    radii.resize(lightCount);
+    rangeX0.resize(lightCount);
+    rangeX1.resize(lightCount);
+    rangeY0.resize(lightCount);
+    rangeY1.resize(lightCount);
+    rangeZ0.resize(lightCount);
+    rangeZ1.resize(lightCount);
+    lightData.resize(lightCount * 8);
+}
+
+/**
+ * @brief Przelicza zakres klastrów światła z jego środka w układzie kamery.
+ *
+ * Płaszczyzny kafelków są uporządkowane, więc zakres wyznacza liczba
+ * wewnętrznych granic leżących w całości po jednej stronie sfery.
+ */
+void ClusteredLighting::ComputeRanges(size_t light) {
+    const float x = viewX[light], y = viewY[light], z = viewZ[light], r = radii[light];
+    int counts[2][2];
+    bool outside = false;
+
+    for (int axis = 0; axis < 2; axis++) {
+        const int tiles = axis == 0 ? TILES_X : TILES_Y;
+        const float* planes = axis == 0 ? planesX : planesY;
+        int skipped = 0, cut = 0;
+        for (int i = 0; i <= tiles; i++) {
+            const float* plane = planes + i * 4;
+            float distance = plane[0] * x + plane[1] * y + plane[2] * z + plane[3];
+            if (i == 0) outside |= distance < -r;
+            else if (i == tiles) outside |= distance > r;
+            else {
+                skipped += distance > r;
+                cut += distance < -r;
+            }
+        }
+        counts[axis][0] = skipped;
+        counts[axis][1] = cut;
+    }
+    StoreRanges(light, counts, outside);
+}
+
+/**
+ * @brief Zapisuje zakres klastrów światła.
+ * @param counts Dla osi X i Y: liczba wewnętrznych granic w całości na lewo
+ *               od sfery (pominięte kafelki) i w całości na prawo.
+ * @param outside Czy sfera leży poza zewnętrzną granicą kafelków.
+ */
+void ClusteredLighting::StoreRanges(size_t light, const int counts[2][2], bool outside) {
+    const float z = viewZ[light], r = radii[light];
+    int range[2][2] = {
+        { counts[0][0], TILES_X - 1 - counts[0][1] },
+        { counts[1][0], TILES_Y - 1 - counts[1][1] }
+    };
+
+    float depthMin = -z - r, depthMax = -z + r;
+    if (depthMax < nearPlane || depthMin > farPlane) outside = true;
+
+    // Sfera obejmująca płaszczyznę oka: kolejność płaszczyzn perspektywy nie obowiązuje
+    if (depthMin <= 0.0f) {
+        range[0][0] = 0; range[0][1] = TILES_X - 1;
+        range[1][0] = 0; range[1][1] = TILES_Y - 1;
+    }
+    if (range[0][0] > range[0][1] || range[1][0] > range[1][1]) outside = true;
+
+    if (outside) {
+        rangeZ0[light] = 1;
+        rangeZ1[light] = 0;
+        return;
+    }
+
+    depthMin = std::max(depthMin, nearPlane);
+    depthMax = std::min(depthMax, farPlane);
+    int slice0 = static_cast<int>(std::floor(std::log(depthMin) * sliceScale + sliceBias));
+    int slice1 = static_cast<int>(std::floor(std::log(depthMax) * sliceScale + sliceBias));
+    rangeX0[light] = static_cast<unsigned char>(range[0][0]);
+    rangeX1[light] = static_cast<unsigned char>(range[0][1]);
+    rangeY0[light] = static_cast<unsigned char>(range[1][0]);
+    rangeY1[light] = static_cast<unsigned char>(range[1][1]);
+    rangeZ0[light] = static_cast<unsigned char>(std::min(std::max(slice0, 0), SLICES - 1));
+    rangeZ1[light] = static_cast<unsigned char>(std::min(std::max(slice1, 0), SLICES - 1));
+}
+
+/**
+ * @brief Przelicza światła [begin, end) do układu kamery (wersja skalarna).
+ */
+void ClusteredLighting::TransformLights(size_t begin, size_t end) {
+    const float* m = viewMatrix;
+    for (size_t i = begin; i < end; i++) {
+        const PointLight& light = input[i];
+        const float* p = light.position;
+        viewX[i] = m[0] * p[0] + m[4] * p[1] + m[8] * p[2] + m[12];
+        viewY[i] = m[1] * p[0] + m[5] * p[1] + m[9] * p[2] + m[13];
+        viewZ[i] = m[2] * p[0] + m[6] * p[1] + m[10] * p[2] + m[14];
+        radii[i] = light.radius;
+        ComputeRanges(i);
+        StoreTexels(i);
+    }
+}
+
+/**
+ * @brief Zapisuje teksele światła: (x, y, z, promień) w układzie kamery i kolor.
+ */
+void ClusteredLighting::StoreTexels(size_t light) {
+    const PointLight& source = input[light];
+    float* texels = &lightData[light * 8];
+    texels[0] = viewX[light];
+    texels[1] = viewY[light];
+    texels[2] = viewZ[light];
+    texels[3] = radii[light];
+    for (int k = 0; k < 3; k++) texels[4 + k] = source.color[k] * source.intensity;
+    texels[7] = 0.0f;
+}
+
+/**
+ * @brief Przelicza światła [begin, end) do układu kamery po 4 naraz (SSE).
+ *
+ * Transformacja i odległości od płaszczyzn kafelków liczone są dla czterech
+ * świateł jednocześnie; warstwy głębokości (logarytm) – skalarnie.
+ */
+void ClusteredLighting::TransformLightsSimd(size_t begin, size_t end) {
+#ifdef CLUSTER_SSE
+    const float* m = viewMatrix;
+    size_t i = begin;
+    for (; i + 4 <= end; i += 4) {
+        const PointLight* l = input + i;
+        __m128 px = _mm_setr_ps(l[0].position[0], l[1].position[0], l[2].position[0], l[3].position[0]);
+        __m128 py = _mm_setr_ps(l[0].position[1], l[1].position[1], l[2].position[1], l[3].position[1]);
+        __m128 pz = _mm_setr_ps(l[0].position[2], l[1].position[2], l[2].position[2], l[3].position[2]);
+        __m128 r = _mm_setr_ps(l[0].radius, l[1].radius, l[2].radius, l[3].radius);
+
+        // Kolejność dodawania jak w wersji skalarnej – wyniki identyczne bitowo
+        __m128 x = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(m[0]), px), _mm_mul_ps(_mm_set1_ps(m[4]), py)),
+            _mm_mul_ps(_mm_set1_ps(m[8]), pz)), _mm_set1_ps(m[12]));
+        __m128 y = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(m[1]), px), _mm_mul_ps(_mm_set1_ps(m[5]), py)),
+            _mm_mul_ps(_mm_set1_ps(m[9]), pz)), _mm_set1_ps(m[13]));
+        __m128 z = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(m[2]), px), _mm_mul_ps(_mm_set1_ps(m[6]), py)),
+            _mm_mul_ps(_mm_set1_ps(m[10]), pz)), _mm_set1_ps(m[14]));
+        _mm_storeu_ps(&viewX[i], x);
+        _mm_storeu_ps(&viewY[i], y);
+        _mm_storeu_ps(&viewZ[i], z);
+        _mm_storeu_ps(&radii[i], r);
+
+        // Maski porównań (-1 w prawdziwych liniach) odejmowane od liczników
+        __m128 negR = _mm_sub_ps(_mm_setzero_ps(), r);
+        __m128i outside = _mm_setzero_si128();
+        __m128i counts[2][2];
+        for (int axis = 0; axis < 2; axis++) {
+            const int tiles = axis == 0 ? TILES_X : TILES_Y;
+            const float* planes = axis == 0 ? planesX : planesY;
+            __m128i skipped = _mm_setzero_si128(), cut = _mm_setzero_si128();
+            for (int p = 0; p <= tiles; p++) {
+                const float* plane = planes + p * 4;
+                __m128 distance = _mm_add_ps(_mm_add_ps(
+                    _mm_add_ps(_mm_mul_ps(_mm_set1_ps(plane[0]), x), _mm_mul_ps(_mm_set1_ps(plane[1]), y)),
+                    _mm_mul_ps(_mm_set1_ps(plane[2]), z)), _mm_set1_ps(plane[3]));
+                __m128i above = _mm_castps_si128(_mm_cmpgt_ps(distance, r));
+                __m128i below = _mm_castps_si128(_mm_cmplt_ps(distance, negR));
+                if (p == 0) outside = _mm_or_si128(outside, below);
+                else if (p == tiles) outside = _mm_or_si128(outside, above);
+                else {
+                    skipped = _mm_sub_epi32(skipped, above);
+                    cut = _mm_sub_epi32(cut, below);
+                }
+            }
+            counts[axis][0] = skipped;
+            counts[axis][1] = cut;
+        }
+
+        alignas(16) int skippedX[4], cutX[4], skippedY[4], cutY[4], outsideMask[4];
+        _mm_store_si128(reinterpret_cast<__m128i*>(skippedX), counts[0][0]);
+        _mm_store_si128(reinterpret_cast<__m128i*>(cutX), counts[0][1]);
+        _mm_store_si128(reinterpret_cast<__m128i*>(skippedY), counts[1][0]);
+        _mm_store_si128(reinterpret_cast<__m128i*>(cutY), counts[1][1]);
+        _mm_store_si128(reinterpret_cast<__m128i*>(outsideMask), outside);
+
+        for (int k = 0; k < 4; k++) {
+            const int laneCounts[2][2] = { { skippedX[k], cutX[k] }, { skippedY[k], cutY[k] } };
+            StoreRanges(i + k, laneCounts, outsideMask[k] != 0);
+            StoreTexels(i + k);
+        }
+    }
+    TransformLights(i, end);
+#else
+    TransformLights(begin, end);
+#endif
+}
+
+/**
+ * @brief Wypełnia listy klastrów jednej warstwy (zadanie jednego wątku).
+ */
+void ClusteredLighting::BinSlice(int slice) {
+    const size_t first = static_cast<size_t>(slice) * TILES_X * TILES_Y;
+    std::fill(clusterCounts.begin() + first, clusterCounts.begin() + first + TILES_X * TILES_Y, static_cast<unsigned short>(0));
+    size_t overflow = 0;
+
+    for (size_t light = 0; light < lightCount; light++) {
+        if (slice < rangeZ0[light] || slice > rangeZ1[light]) continue;
+        for (int y = rangeY0[light]; y <= rangeY1[light]; y++) {
+            size_t cluster = first + static_cast<size_t>(y) * TILES_X + rangeX0[light];
+            for (int x = rangeX0[light]; x <= rangeX1[light]; x++, cluster++) {
+                unsigned short& count = clusterCounts[cluster];
+                if (count < MAX_LIGHTS_PER_CLUSTER) {
+                    clusterLights[cluster * MAX_LIGHTS_PER_CLUSTER + count] = static_cast<unsigned short>(light);
+                    count++;
+                }
+                else {
+                    overflow++;
+                }
+            }
+        }
+    }
+    sliceOverflow[slice] = overflow;
+}
+
+/**
+ * @brief Przypisuje światła do klastrów dla bieżącej kamery.
+ */
+void ClusteredLighting::Build(const PointLight* lights, size_t count, const Mat4& view, const Mat4& projection,
+    float nearPlane, float farPlane) {
+    auto start = std::chrono::high_resolution_clock::now();
+
+    input = lights;
+    lightCount = std::min(count, static_cast<size_t>(MAX_LIGHTS));
+    PrepareFrame(view, projection, nearPlane, farPlane);
+
+    jobs->ParallelFor(lightCount, LIGHTS_PER_TASK, [this](size_t begin, size_t end) {
+        if (useSimd) TransformLightsSimd(begin, end);
+        else TransformLights(begin, end);
+    });
+    jobs->ParallelFor(SLICES, 1, [this](size_t begin, size_t end) {
+        for (size_t slice = begin; slice < end; slice++) BinSlice(static_cast<int>(slice));
+    });
+
+    auto binned = std::chrono::high_resolution_clock::now();
+    Pack();
+    auto packed = std::chrono::high_resolution_clock::now();
+
+    stats.lights = lightCount;
+    stats.binMs = std::chrono::duration<double, std::milli>(binned - start).count();
+    stats.packMs = std::chrono::duration<double, std::milli>(packed - binned).count();
+    stats.uploadMs = 0.0;
+}
+
+/**
+ * @brief Skleja listy klastrów w jedną tablicę indeksów i liczy statystyki.
+ */
+void ClusteredLighting::Pack() {
+    stats.visibleLights = 0;
+    for (size_t light = 0; light < lightCount; light++) {
+        if (rangeZ0[light] <= rangeZ1[light]) stats.visibleLights++;
+    }
+
+    stats.references = 0;
+    stats.activeClusters = 0;
+    stats.maxPerCluster = 0;
+    stats.overflow = 0;
+    for (int slice = 0; slice < SLICES; slice++) stats.overflow += sliceOverflow[slice];
+
+    indexData.clear();
+    for (int cluster = 0; cluster < CLUSTER_COUNT; cluster++) {
+        const unsigned short count = clusterCounts[cluster];
+        gridData[cluster * 4 + 0] = static_cast<float>(indexData.size());
+        gridData[cluster * 4 + 1] = static_cast<float>(count);
+        const unsigned short* list = &clusterLights[static_cast<size_t>(cluster) * MAX_LIGHTS_PER_CLUSTER];
+        for (unsigned short k = 0; k < count; k++) indexData.push_back(static_cast<float>(list[k]));
+
+        stats.references += count;
+        if (count) stats.activeClusters++;
+        if (count > stats.maxPerCluster) stats.maxPerCluster = count;
+    }
+}
+
+/**
+ * @brief Sprawdza, czy kontekst obsługuje tekstury klastrów.
+ */
+bool ClusteredLighting::IsSupported() {
+    const GLCapabilities& caps = GetGLCapabilities();
+    return caps.shaders && caps.floatTextures && caps.multitexture;
+}
+
+/**
+ * @brief Tworzy teksturę (lub zmienia jej rozmiar) i wysyła dane.
+ */
+void ClusteredLighting::UploadTexture(GLuint& texture, int& allocatedWidth, int& allocatedHeight,
+    GLint internalFormat, GLenum format, int width, int height, const float* data) {
+    if (!texture) {
+        glGenTextures(1, &texture);
+        glBindTexture(GL_TEXTURE_2D, texture);
+        // Dane odczytywane dokładnie z tekseli – bez filtrowania
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP);
+    }
+    else {
+        glBindTexture(GL_TEXTURE_2D, texture);
+    }
+
+    if (width != allocatedWidth || height != allocatedHeight) {
+        glTexImage2D(GL_TEXTURE_2D, 0, internalFormat, width, height, 0, format, GL_FLOAT, data);
+        allocatedWidth = width;
+        allocatedHeight = height;
+    }
+    else {
+        glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, width, height, format, GL_FLOAT, data);
+    }
+}
+
+/**
+ * @brief Wysyła wynik ostatniego Build do tekstur.
+ */
+bool ClusteredLighting::Upload(int viewportWidth, int viewportHeight) {
+    if (!IsSupported()) return false;
+    auto start = std::chrono::high_resolution_clock::now();
+
+    // Wiersze tekstur świateł i indeksów dopełniane zerami do pełnej szerokości
+    const int lightRows = std::max(1, static_cast<int>((lightCount * 2 + TEXTURE_WIDTH - 1) / TEXTURE_WIDTH));
+    const int indexRows = std::max(1, static_cast<int>((indexData.size() + TEXTURE_WIDTH - 1) / TEXTURE_WIDTH));
+    lightData.resize(static_cast<size_t>(lightRows) * TEXTURE_WIDTH * 4, 0.0f);
+    indexData.resize(static_cast<size_t>(indexRows) * TEXTURE_WIDTH, 0.0f);
+
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    UploadTexture(gridTexture, gridWidth, gridHeight, GL_RGBA32F_ARB, GL_RGBA,
+        TILES_X * TILES_Y, SLICES, gridData.data());
+    UploadTexture(lightTexture, lightWidth, lightHeight, GL_RGBA32F_ARB, GL_RGBA,
+        TEXTURE_WIDTH, lightRows, lightData.data());
+    UploadTexture(indexTexture, indexWidth, indexHeight, GL_LUMINANCE32F_ARB, GL_LUMINANCE,
+        TEXTURE_WIDTH, indexRows, indexData.data());
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    block.Set(0, (float)TILES_X, (float)TILES_Y, (float)SLICES, (float)MAX_LIGHTS_PER_CLUSTER);
+    block.Set(1, (float)viewportWidth, (float)viewportHeight, sliceScale, sliceBias);
+    block.Set(2, (float)lightWidth, (float)lightHeight, (float)indexWidth, (float)indexHeight);
+    block.Set(3, (float)gridWidth, (float)gridHeight, 0.0f, 0.0f);
+
+    stats.uploadMs = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+    return true;
+}
+
+/**
+ * @brief Wiąże tekstury z jednostkami firstUnit..firstUnit+2.
+ */
+void ClusteredLighting::BindTextures(int firstUnit) const {
+    const GLuint textures[3] = { gridTexture, lightTexture, indexTexture };
+    for (int i = 0; i < 3; i++) {
+        glActiveTexture(GL_TEXTURE0 + firstUnit + i);
+        glBindTexture(GL_TEXTURE_2D, textures[i]);
+    }
+    glActiveTexture(GL_TEXTURE0);
+}
+
+/**
+ * @brief Odwiązuje tekstury z jednostek firstUnit..firstUnit+2.
+ */
+void ClusteredLighting::UnbindTextures(int firstUnit) const {
+    for (int i = 0; i < 3; i++) {
+        glActiveTexture(GL_TEXTURE0 + firstUnit + i);
+        glBindTexture(GL_TEXTURE_2D, 0);
+    }
+    glActiveTexture(GL_TEXTURE0);
+}
+
+/**
+ * @brief Zwalnia tekstury.
+ */
+void ClusteredLighting::ReleaseGPU() {
+    GLuint textures[3] = { gridTexture, lightTexture, indexTexture };
+    for (GLuint texture : textures) {
+        if (texture) glDeleteTextures(1, &texture);
+    }
+    gridTexture = lightTexture = indexTexture = 0;
+    gridWidth = gridHeight = lightWidth = lightHeight = indexWidth = indexHeight = 0;
+}
+
+/**
+ * @brief Zwraca liczbę świateł klastra (x, y, warstwa).
+ */
+int ClusteredLighting::GetClusterLightCount(int x, int y, int slice) const {
+    return clusterCounts[(static_cast<size_t>(slice) * TILES_Y + y) * TILES_X + x];
+}
+
+/**
+ * @brief Zwraca numery świateł klastra.
+ */
+const unsigned short* ClusteredLighting::GetClusterLights(int x, int y, int slice) const {
+    return &clusterLights[((static_cast<size_t>(slice) * TILES_Y + y) * TILES_X + x) * MAX_LIGHTS_PER_CLUSTER];
+}
@@ -0,0 +1,184 @@
+﻿#pragma once
+#ifndef CLUSTERED_LIGHTING_H
+#define CLUSTERED_LIGHTING_H
+
+#include "MathLib.h"
+#include "ShaderProgram.h"
+
+#include <memory>
+#include <vector>
+
+/**
+ * @brief Dynamiczne światło punktowe (w układzie świata).
+ */
+struct PointLight {
+    float position[3]; /**< Środek światła */
+    float radius;      /**< Zasięg (poza nim światło nie działa) */
+    float color[3];    /**< Kolor RGB */
+    float intensity;   /**< Mnożnik koloru */
+};
+
+/**
+ * @brief Liczniki ostatniego przypisania świateł do klastrów.
+ */
+struct ClusterStats {
+    size_t lights = 0;          /**< Liczba świateł na wejściu */
+    size_t visibleLights = 0;   /**< Światła przecinające bryłę widzenia */
+    size_t references = 0;      /**< Suma długości list świateł klastrów */
+    size_t activeClusters = 0;  /**< Klastry z co najmniej jednym światłem */
+    size_t maxPerCluster = 0;   /**< Najdłuższa lista klastra */
+    size_t overflow = 0;        /**< Odrzucone wpisy (lista klastra pełna) */
+    double binMs = 0.0;         /**< Czas transformacji i przypisania (wszystkie wątki) */
+    double packMs = 0.0;        /**< Czas budowy tablic dla GPU */
+    double uploadMs = 0.0;      /**< Czas wysyłki tekstur */
+};
+
+class JobSystem;
+
+/**
+ * @brief Przypisanie świateł punktowych do klastrów bryły widzenia (clustered shading).
+ *
+ * Bryła widzenia dzielona jest na TILES_X x TILES_Y kafelków ekranu i
+ * SLICES warstw głębokości rozłożonych logarytmicznie między near i far.
+ * Build przelicza światła do układu kamery (SSE, po 4 światła), wyznacza
+ * zakres kafelków z płaszczyzn granic kafelków wyliczonych z macierzy
+ * projekcji i zapisuje numer światła w listach klastrów. Warstwy są
+ * rozdzielane między zadania systemu zadań, więc każde zadanie pisze tylko
+ * do swoich klastrów.
+ *
+ * Upload wysyła wynik do trzech tekstur zmiennoprzecinkowych (GL 2.1 nie ma
+ * buforów tekstur ani SSBO): siatkę klastrów (początek i długość listy),
+ * dane świateł (pozycja w układzie kamery z promieniem, kolor) i tablicę
+ * indeksów. Parametry siatki trafiają do bloku uniform "clusterData".
+ */
+class ClusteredLighting {
+public:
+    static const int TILES_X = 16;                  /**< Kafelki w poziomie */
+    static const int TILES_Y = 9;                   /**< Kafelki w pionie */
+    static const int SLICES = 24;                   /**< Warstwy głębokości */
+    static const int CLUSTER_COUNT = TILES_X * TILES_Y * SLICES;
+    static const int MAX_LIGHTS_PER_CLUSTER = 128;  /**< Pojemność listy klastra (pętla w shaderze) */
+    static const int MAX_LIGHTS = 65535;            /**< Numery świateł mieszczą się w 16 bitach */
+    static const int TEXTURE_WIDTH = 1024;          /**< Szerokość tekstur świateł i indeksów */
+
+    /**
+     * @param threadCount Liczba wątków przypisania (0: wspólny system zadań silnika).
+     */
+    explicit ClusteredLighting(int threadCount = 0);
+    ~ClusteredLighting();
+
+    ClusteredLighting(const ClusteredLighting&) = delete;
+    ClusteredLighting& operator=(const ClusteredLighting&) = delete;
+
+    /**
+     * @brief Zmienia liczbę wątków przypisania (0: wspólny system zadań, inaczej własny system).
+     */
+    void SetThreadCount(int threadCount);
+    int GetThreadCount() const;
+
+    /**
+     * @brief Włącza/wyłącza ścieżkę SSE (wyłączona: wzorcowa wersja skalarna).
+     */
+    void SetUseSimd(bool enabled) { useSimd = enabled; }
+
+    /**
+     * @brief Przypisuje światła do klastrów dla bieżącej kamery (tylko CPU).
+     * @param lights Światła w układzie świata.
+     * @param count Liczba świateł (najwyżej MAX_LIGHTS).
+     * @param view Macierz widoku.
+     * @param projection Macierz projekcji (perspektywiczna lub ortogonalna).
+     * @param nearPlane Bliska płaszczyzna projekcji.
+     * @param farPlane Daleka płaszczyzna projekcji.
+     */
+    void Build(const PointLight* lights, size_t count, const Mat4& view, const Mat4& projection,
+        float nearPlane, float farPlane);
+
+    /**
+     * @brief Wysyła wynik ostatniego Build do tekstur.
+     * @param viewportWidth Szerokość obszaru rysowania w pikselach.
+     * @param viewportHeight Wysokość obszaru rysowania w pikselach.
+     * @return False jeśli kontekst nie obsługuje tekstur zmiennoprzecinkowych.
+     */
+    bool Upload(int viewportWidth, int viewportHeight);
+
+    /**
+     * @brief Wiąże tekstury z jednostkami firstUnit..firstUnit+2 (siatka, światła, indeksy).
+     */
+    void BindTextures(int firstUnit) const;
+
+    /**
+     * @brief Odwiązuje tekstury z jednostek firstUnit..firstUnit+2.
+     */
+    void UnbindTextures(int firstUnit) const;
+
+    /**
+     * @brief Zwalnia tekstury.
+     */
+    void ReleaseGPU();
+
+    /**
+     * @brief Sprawdza, czy kontekst obsługuje tekstury klastrów.
+     */
+    static bool IsSupported();
+
+    bool IsUploaded() const { return gridTexture != 0; }
+    const UniformBlock& GetBlock() const { return block; }
+    const ClusterStats& GetStats() const { return stats; }
+
+    /**
+     * @brief Zwraca liczbę świateł klastra (x, y, warstwa).
+     */
+    int GetClusterLightCount(int x, int y, int slice) const;
+
+    /**
+     * @brief Zwraca numery świateł klastra (GetClusterLightCount elementów).
+     */
+    const unsigned short* GetClusterLights(int x, int y, int slice) const;
+
+private:
+    void PrepareFrame(const Mat4& view, const Mat4& projection, float nearPlane, float farPlane);
+    void TransformLights(size_t begin, size_t end);
+    void TransformLightsSimd(size_t begin, size_t end);
+    void ComputeRanges(size_t light);
+    void StoreRanges(size_t light, const int counts[2][2], bool outside);
+    void StoreTexels(size_t light);
+    void BinSlice(int slice);
+    void Pack();
+    void UploadTexture(GLuint& texture, int& allocatedWidth, int& allocatedHeight,
+        GLint internalFormat, GLenum format, int width, int height, const float* data);
+
+    std::unique_ptr<JobSystem> ownJobs;      /**< Własny system zadań (jawna liczba wątków) */
+    JobSystem* jobs;                         /**< System wykonujący przypisanie */
+    bool useSimd;                            /**< Czy używać ścieżki SSE */
+
+    // Parametry klatki
+    const PointLight* input;       /**< Światła bieżącego Build */
+    size_t lightCount;             /**< Liczba świateł bieżącego Build */
+    float viewMatrix[16];          /**< Macierz widoku */
+    float planesX[(TILES_X + 1) * 4]; /**< Płaszczyzny granic kafelków w poziomie (znormalizowane) */
+    float planesY[(TILES_Y + 1) * 4]; /**< Płaszczyzny granic kafelków w pionie (znormalizowane) */
+    float nearPlane, farPlane;     /**< Zakres głębokości warstw */
+    float sliceScale, sliceBias;   /**< Warstwa = floor(log(głębokość) * sliceScale + sliceBias) */
+
+    // Wyniki na światło (SoA)
+    std::vector<float> viewX, viewY, viewZ, radii; /**< Środki w układzie kamery i promienie */
+    std::vector<unsigned char> rangeX0, rangeX1, rangeY0, rangeY1, rangeZ0, rangeZ1; /**< Zakresy klastrów */
+
+    // Listy klastrów
+    std::vector<unsigned short> clusterCounts; /**< Długości list */
+    std::vector<unsigned short> clusterLights; /**< Listy (MAX_LIGHTS_PER_CLUSTER na klaster) */
+    std::vector<size_t> sliceOverflow;         /**< Przepełnienia w każdej warstwie */
+
+    // Dane dla GPU
+    std::vector<float> gridData;   /**< (początek, długość, 0, 0) na klaster */
+    std::vector<float> lightData;  /**< 2 teksele na światło: (x, y, z, promień), (kolor * intensywność, 0) */
+    std::vector<float> indexData;  /**< Numery świateł list klastrów */
+    UniformBlock block;            /**< Parametry siatki dla shadera */
+
+    GLuint gridTexture, lightTexture, indexTexture; /**< Tekstury GL */
+    int gridWidth, gridHeight, lightWidth, lightHeight, indexWidth, indexHeight; /**< Rozmiary tekstur */
+
+    ClusterStats stats;            /**< Liczniki ostatniego Build/Upload */
+};
+
+#endif
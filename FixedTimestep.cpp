@@ -0,0 +1,75 @@
+﻿#include "FixedTimestep.h"
+
+#include <algorithm>
+#include <iostream>
+
+/// Tolerancja zaokrągleń akumulatora (ułamek kroku) – 1/60 s to dokładnie dwa kroki 1/120 s
+static const double STEP_EPSILON = 1e-6;
+
+/**
+ * @brief Konstruktor klasy FixedTimestep.
+ */
+FixedTimestep::FixedTimestep(int rate, int maxSteps) : rate(0), maxSteps(1), step(1.0), accumulator(0.0), tick(0) {
+    SetRate(rate);
+    SetMaxSteps(maxSteps);
+}
+
+/**
+ * @brief Zmienia częstotliwość kroków.
+ */
+void FixedTimestep::SetRate(int value) {
+    rate = std::max(value, 1);
+    step = 1.0 / rate;
+    accumulator = 0.0;
+}
+
+/**
+ * @brief Ustawia największą liczbę kroków na klatkę.
+ */
+void FixedTimestep::SetMaxSteps(int steps) {
+    maxSteps = std::max(steps, 1);
+}
+
+/**
+ * @brief Dodaje czas klatki i wybiera z akumulatora całe kroki.
+ */
+int FixedTimestep::Advance(double frameSeconds) {
+    stats.frames++;
+    accumulator += std::max(frameSeconds, 0.0);
+
+    int steps = static_cast<int>(accumulator / step + STEP_EPSILON);
+    if (steps > maxSteps) {
+        // Spirala śmierci: zamiast nadrabiać, odrzucamy nadmiar (zostaje ułamek kroku)
+        const double excess = (steps - maxSteps) * step;
+        accumulator -= excess;
+        stats.clampedFrames++;
+        stats.droppedSeconds += excess;
+        steps = maxSteps;
+    }
+    accumulator -= steps * step;
+    if (accumulator < 0.0) accumulator = 0.0;
+
+    tick += steps;
+    stats.steps += steps;
+    stats.maxStepsInFrame = std::max(stats.maxStepsInFrame, steps);
+    return steps;
+}
+
+/**
+ * @brief Zeruje akumulator i numer kroku.
+ */
+void FixedTimestep::Reset() {
+    accumulator = 0.0;
+    tick = 0;
+}
+
+/**
+ * @brief Wypisuje liczniki kroków.
+ */
+void FixedTimestep::PrintStats() const {
+    std::cout << "Symulacja: " << rate << " Hz, " << stats.steps << " kroków w " << stats.frames << " klatkach ("
+        << (stats.frames ? static_cast<double>(stats.steps) / stats.frames : 0.0) << " na klatkę, max "
+        << stats.maxStepsInFrame << ")\n";
+    std::cout << "  Przycięte klatki: " << stats.clampedFrames << " (limit " << maxSteps << " kroków), odrzucony czas "
+        << stats.droppedSeconds * 1000.0 << " ms" << std::endl;
+}
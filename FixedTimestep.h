@@ -0,0 +1,92 @@
+﻿#pragma once
+#ifndef FIXED_TIMESTEP_H
+#define FIXED_TIMESTEP_H
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief Liczniki kroków symulacji od utworzenia lub ResetStats.
+ */
+struct FixedTimestepStats {
+    size_t frames = 0;          /**< Wywołania Advance (klatki) */
+    uint64_t steps = 0;         /**< Wykonane kroki symulacji */
+    size_t clampedFrames = 0;   /**< Klatki przycięte do maxSteps kroków */
+    double droppedSeconds = 0.0; /**< Czas odrzucony przez przycięcie */
+    int maxStepsInFrame = 0;    /**< Najwięcej kroków w jednej klatce */
+};
+
+/**
+ * @brief Stały krok symulacji z akumulatorem czasu.
+ *
+ * Czas klatki trafia do akumulatora, z którego wybierane są całe kroki
+ * o długości 1 / rate. Reszta przechodzi na następną klatkę, a ułamek
+ * GetAlpha() służy do interpolacji stanu między dwoma ostatnimi krokami
+ * przy renderowaniu. Symulacja zależy więc tylko od liczby kroków,
+ * a nie od tempa klatek – te same wejścia dają ten sam stan.
+ *
+ * Gdy klatka trwała dłużej niż maxSteps kroków (przycięcie chroni przed
+ * spiralą śmierci: wolna klatka -> więcej kroków -> wolniejsza klatka),
+ * nadmiar czasu jest odrzucany i symulacja zwalnia zamiast się zapętlić.
+ */
+class FixedTimestep {
+public:
+    static const int DEFAULT_RATE = 120;
+    static const int DEFAULT_MAX_STEPS = 8;
+
+    /**
+     * @param rate Liczba kroków na sekundę.
+     * @param maxSteps Najwięcej kroków na klatkę.
+     */
+    explicit FixedTimestep(int rate = DEFAULT_RATE, int maxSteps = DEFAULT_MAX_STEPS);
+
+    /**
+     * @brief Zmienia częstotliwość kroków (akumulator zostaje wyzerowany).
+     */
+    void SetRate(int rate);
+    int GetRate() const { return rate; }
+
+    void SetMaxSteps(int steps);
+    int GetMaxSteps() const { return maxSteps; }
+
+    /// Długość kroku [s]
+    double GetStep() const { return step; }
+
+    /**
+     * @brief Dodaje czas klatki do akumulatora.
+     * @param frameSeconds Czas od poprzedniej klatki [s].
+     * @return Liczba kroków do wykonania w tej klatce (0..maxSteps).
+     */
+    int Advance(double frameSeconds);
+
+    /**
+     * @brief Położenie chwili renderowania między dwoma ostatnimi krokami (0..1).
+     */
+    float GetAlpha() const { return static_cast<float>(accumulator / step); }
+
+    /// Numer następnego kroku od Reset (czas symulacji = GetTick() * GetStep())
+    uint64_t GetTick() const { return tick; }
+
+    /**
+     * @brief Zeruje akumulator i numer kroku.
+     */
+    void Reset();
+
+    FixedTimestepStats GetStats() const { return stats; }
+    void ResetStats() { stats = FixedTimestepStats(); }
+
+    /**
+     * @brief Wypisuje częstotliwość, średnią liczbę kroków na klatkę i przycięcia.
+     */
+    void PrintStats() const;
+
+private:
+    int rate;
+    int maxSteps;
+    double step;            /**< 1 / rate [s] */
+    double accumulator;     /**< Czas jeszcze nie zasymulowany (< step po Advance) */
+    uint64_t tick;
+    FixedTimestepStats stats;
+};
+
+#endif
@@ -0,0 +1,179 @@
+﻿#include "FramePacer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <thread>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#include <timeapi.h>
+#pragma comment(lib, "winmm.lib")
+#endif
+
+/// Granica czasu, poniżej której nie próbujemy już spać [s]
+static const double MIN_SLEEP_ESTIMATE = 0.0005;
+/// Spóźnienie, od którego klatka liczona jest jako nietrafiona [s]
+static const double MISSED_TOLERANCE = 0.0005;
+
+/**
+ * @brief Konstruktor klasy FramePacer.
+ * @param targetFPS Docelowa liczba klatek na sekundę.
+ * @param historySize Liczba klatek przechowywanych do statystyk.
+ */
+FramePacer::FramePacer(int targetFPS, size_t historySize)
+    : targetFPS(0), period(0), started(false),
+    history(historySize > 0 ? historySize : 1, 0.0), historyNext(0), historyCount(0),
+    missedDeadlines(0), sleepEstimate(0.002), sleepMean(0.001), sleepM2(0.0), sleepSamples(1),
+    sleptSeconds(0.0), spunSeconds(0.0) {
+#ifdef _WIN32
+    // Domyślny kwant zegara Windows to ~15.6 ms – za dużo dla 1 ms snu
+    timeBeginPeriod(1);
+#endif
+    SetTargetFPS(targetFPS);
+}
+
+/**
+ * @brief Destruktor (przywraca rozdzielczość zegara systemowego).
+ */
+FramePacer::~FramePacer() {
+#ifdef _WIN32
+    timeEndPeriod(1);
+#endif
+}
+
+/**
+ * @brief Ustawia docelową liczbę FPS.
+ */
+void FramePacer::SetTargetFPS(int fps) {
+    if (fps <= 0) fps = 1;
+    if (fps == targetFPS) return;
+
+    targetFPS = fps;
+    period = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / fps));
+    started = false; // nowy rytm – terminy liczone od następnej klatki
+}
+
+/**
+ * @brief Zeruje historię i ustala nowy punkt startowy terminów.
+ */
+void FramePacer::Reset() {
+    started = false;
+    historyNext = 0;
+    historyCount = 0;
+    missedDeadlines = 0;
+    sleptSeconds = 0.0;
+    spunSeconds = 0.0;
+}
+
+/**
+ * @brief Śpi w krokach 1 ms, a końcówkę dobija aktywnym czekaniem.
+ */
+void FramePacer::SleepUntil(Clock::time_point deadline) {
+    Clock::time_point now = Clock::now();
+
+    while (std::chrono::duration<double>(deadline - now).count() > sleepEstimate) {
+        Clock::time_point before = now;
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        now = Clock::now();
+
+        // Aktualizacja szacunku czasu snu: średnia + odchylenie standardowe
+        double observed = std::chrono::duration<double>(now - before).count();
+        sleptSeconds += observed;
+        sleepSamples++;
+        double delta = observed - sleepMean;
+        sleepMean += delta / sleepSamples;
+        sleepM2 += delta * (observed - sleepMean);
+        double stddev = std::sqrt(sleepM2 / (sleepSamples - 1));
+        sleepEstimate = std::max(MIN_SLEEP_ESTIMATE, sleepMean + stddev);
+    }
+
+    Clock::time_point spinStart = now;
+    while (now < deadline) {
+        std::this_thread::yield();
+        now = Clock::now();
+    }
+    spunSeconds += std::chrono::duration<double>(now - spinStart).count();
+}
+
+/**
+ * @brief Czeka do terminu następnej klatki i zapisuje czas bieżącej.
+ */
+void FramePacer::WaitForNextFrame() {
+    Clock::time_point now = Clock::now();
+    if (!started) {
+        started = true;
+        nextDeadline = now + period;
+        lastFrameEnd = now;
+        return;
+    }
+
+    if (now > nextDeadline + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(MISSED_TOLERANCE))) {
+        missedDeadlines++;
+        // Przy dużym opóźnieniu nie próbujemy nadrabiać – nowy rytm od teraz
+        if (now > nextDeadline + period) nextDeadline = now;
+    }
+    else {
+        SleepUntil(nextDeadline);
+    }
+
+    now = Clock::now();
+    RecordFrame(std::chrono::duration<double>(now - lastFrameEnd).count());
+    lastFrameEnd = now;
+    nextDeadline += period;
+}
+
+/**
+ * @brief Zapisuje czas klatki w buforze cyklicznym.
+ */
+void FramePacer::RecordFrame(double frameSeconds) {
+    history[historyNext] = frameSeconds;
+    historyNext = (historyNext + 1) % history.size();
+    if (historyCount < history.size()) historyCount++;
+}
+
+/**
+ * @brief Zwraca statystyki z ostatnich klatek.
+ */
+FramePacingStats FramePacer::GetStats() const {
+    FramePacingStats stats;
+    stats.frames = historyCount;
+    stats.targetMs = 1000.0 / targetFPS;
+    stats.missedDeadlines = missedDeadlines;
+    double waited = sleptSeconds + spunSeconds;
+    stats.sleepShare = waited > 0.0 ? sleptSeconds / waited : 0.0;
+    if (historyCount == 0) return stats;
+
+    std::vector<double> samples(history.begin(), history.begin() + historyCount);
+    double sum = 0.0;
+    for (double s : samples) sum += s;
+    double mean = sum / samples.size();
+
+    double variance = 0.0;
+    for (double s : samples) variance += (s - mean) * (s - mean);
+    variance /= samples.size();
+
+    std::sort(samples.begin(), samples.end());
+    size_t p99Index = std::min(samples.size() - 1, (size_t)std::ceil(samples.size() * 0.99) - 1);
+
+    stats.meanMs = mean * 1000.0;
+    stats.p99Ms = samples[p99Index] * 1000.0;
+    stats.maxMs = samples.back() * 1000.0;
+    stats.jitterMs = std::sqrt(variance) * 1000.0;
+    return stats;
+}
+
+/**
+ * @brief Wypisuje statystyki na standardowe wyjście.
+ */
+void FramePacer::PrintStats() const {
+    FramePacingStats stats = GetStats();
+    std::cout << "Tempo klatek (ostatnie " << stats.frames << "): cel=" << stats.targetMs
+        << " ms, średnio=" << stats.meanMs << " ms, p99=" << stats.p99Ms
+        << " ms, max=" << stats.maxMs << " ms, jitter=" << stats.jitterMs << " ms\n";
+    std::cout << "  Spóźnione klatki: " << stats.missedDeadlines
+        << ", sen w czasie oczekiwania: " << (int)(stats.sleepShare * 100.0) << "%" << std::endl;
+}
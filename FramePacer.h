@@ -0,0 +1,98 @@
+﻿#pragma once
+#ifndef FRAME_PACER_H
+#define FRAME_PACER_H
+
+#include <chrono>
+#include <vector>
+
+/**
+ * @brief Statystyki tempa klatek zebrane przez FramePacer.
+ */
+struct FramePacingStats {
+    size_t frames = 0;              /**< Liczba klatek w historii */
+    double targetMs = 0.0;          /**< Docelowy czas klatki */
+    double meanMs = 0.0;            /**< Średni czas klatki */
+    double p99Ms = 0.0;             /**< 99. percentyl czasu klatki */
+    double maxMs = 0.0;             /**< Najdłuższa klatka */
+    double jitterMs = 0.0;          /**< Odchylenie standardowe czasu klatki */
+    unsigned int missedDeadlines = 0; /**< Klatki, które przekroczyły termin (łącznie) */
+    double sleepShare = 0.0;        /**< Udział snu w czasie oczekiwania (0..1) */
+};
+
+/**
+ * @brief Ogranicznik liczby klatek łączący sen systemowy z krótkim aktywnym czekaniem.
+ *
+ * Większość czasu oczekiwania wątek śpi (zwalnia rdzeń). Ostatni fragment,
+ * krótszy niż szacowany błąd budzenia systemu, jest dobijany aktywnym
+ * czekaniem, dzięki czemu precyzja zostaje na poziomie ułamka milisekundy.
+ */
+class FramePacer {
+public:
+    /**
+     * @brief Konstruktor klasy FramePacer.
+     * @param targetFPS Docelowa liczba klatek na sekundę.
+     * @param historySize Liczba klatek przechowywanych do statystyk.
+     */
+    explicit FramePacer(int targetFPS = 60, size_t historySize = 240);
+
+    /**
+     * @brief Destruktor (przywraca rozdzielczość zegara systemowego).
+     */
+    ~FramePacer();
+
+    FramePacer(const FramePacer&) = delete;
+    FramePacer& operator=(const FramePacer&) = delete;
+
+    /**
+     * @brief Ustawia docelową liczbę FPS (bez efektu, jeśli się nie zmienia).
+     */
+    void SetTargetFPS(int fps);
+
+    /**
+     * @brief Czeka do terminu następnej klatki i zapisuje czas bieżącej.
+     */
+    void WaitForNextFrame();
+
+    /**
+     * @brief Zeruje historię i ustala nowy punkt startowy terminów.
+     */
+    void Reset();
+
+    /**
+     * @brief Zwraca statystyki z ostatnich klatek.
+     */
+    FramePacingStats GetStats() const;
+
+    /**
+     * @brief Wypisuje statystyki na standardowe wyjście.
+     */
+    void PrintStats() const;
+
+private:
+    typedef std::chrono::steady_clock Clock;
+
+    void SleepUntil(Clock::time_point deadline);
+    void RecordFrame(double frameSeconds);
+
+    int targetFPS;                   /**< Docelowa liczba FPS */
+    Clock::duration period;          /**< Docelowy czas klatki */
+    Clock::time_point nextDeadline;  /**< Termin zakończenia bieżącej klatki */
+    Clock::time_point lastFrameEnd;  /**< Moment zakończenia poprzedniej klatki */
+    bool started;                    /**< Czy znany jest pierwszy termin */
+
+    std::vector<double> history;     /**< Bufor cykliczny czasów klatek [s] */
+    size_t historyNext;              /**< Następna pozycja do zapisu */
+    size_t historyCount;             /**< Liczba zapisanych wartości */
+    unsigned int missedDeadlines;    /**< Licznik spóźnionych klatek */
+
+    // Szacowanie błędu budzenia ze snu (średnia i wariancja metodą Welforda)
+    double sleepEstimate;            /**< Szacowany czas jednego snu 1 ms [s] */
+    double sleepMean;                /**< Średni zmierzony czas snu [s] */
+    double sleepM2;                  /**< Suma kwadratów odchyleń */
+    long long sleepSamples;          /**< Liczba próbek snu */
+
+    double sleptSeconds;             /**< Łączny czas snu */
+    double spunSeconds;              /**< Łączny czas aktywnego czekania */
+};
+
+#endif
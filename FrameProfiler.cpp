@@ -0,0 +1,255 @@
+﻿#include "FrameProfiler.h"
+
+#include <GLFW/glfw3.h>
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+
+/**
+ * @brief Konstruktor klasy FrameProfiler.
+ */
+FrameProfiler::FrameProfiler(size_t frameCapacity, size_t zonesPerFrame)
+    : frames(frameCapacity > 0 ? frameCapacity : 1), current(0), frameCount(0),
+    depth(0), inFrame(false), enabled(true), origin(Clock::now()) {
+    // Rezerwacja z góry – w trakcie klatki nie ma alokacji
+    for (FrameRecord& frame : frames) frame.zones.reserve(zonesPerFrame);
+}
+
+/**
+ * @brief Zwraca czas od startu profilera w milisekundach.
+ */
+double FrameProfiler::NowMs() const {
+    return std::chrono::duration<double, std::milli>(Clock::now() - origin).count();
+}
+
+/**
+ * @brief Zwraca klatkę sprzed age klatek (0 = ostatnia zakończona).
+ */
+const FrameProfiler::FrameRecord& FrameProfiler::GetFrame(size_t age) const {
+    size_t index = (current + frames.size() - 1 - age) % frames.size();
+    return frames[index];
+}
+
+/**
+ * @brief Rozpoczyna pomiar nowej klatki.
+ */
+void FrameProfiler::BeginFrame() {
+    if (!enabled) return;
+    FrameRecord& frame = frames[current];
+    frame.zones.clear();
+    frame.startMs = NowMs();
+    frame.durationMs = 0.0;
+    depth = 0;
+    inFrame = true;
+}
+
+/**
+ * @brief Kończy pomiar bieżącej klatki.
+ */
+void FrameProfiler::EndFrame() {
+    if (!enabled || !inFrame) return;
+    FrameRecord& frame = frames[current];
+    frame.durationMs = NowMs() - frame.startMs;
+    current = (current + 1) % frames.size();
+    if (frameCount < frames.size()) frameCount++;
+    inFrame = false;
+}
+
+/**
+ * @brief Otwiera strefę w bieżącej klatce.
+ */
+int FrameProfiler::BeginZone(const char* name) {
+    if (!enabled || !inFrame) return -1;
+    FrameRecord& frame = frames[current];
+    ProfileZoneRecord zone = { name, depth++, NowMs(), 0.0 };
+    frame.zones.push_back(zone);
+    return static_cast<int>(frame.zones.size() - 1);
+}
+
+/**
+ * @brief Zamyka strefę otwartą przez BeginZone.
+ */
+void FrameProfiler::EndZone(int zoneIndex) {
+    if (zoneIndex < 0 || !inFrame) return;
+    FrameRecord& frame = frames[current];
+    if ((size_t)zoneIndex >= frame.zones.size()) return;
+    ProfileZoneRecord& zone = frame.zones[zoneIndex];
+    zone.durationMs = NowMs() - zone.startMs;
+    depth--;
+}
+
+/**
+ * @brief Zapisuje strefy wszystkich klatek do pliku CSV.
+ */
+bool FrameProfiler::ExportCSV(const std::string& filePath) const {
+    std::ofstream file(filePath);
+    if (!file) {
+        std::cerr << "[FrameProfiler Error] Failed to open for writing: " << filePath << std::endl;
+        return false;
+    }
+
+    file << "frame,zone,depth,start_ms,duration_ms\n";
+    file << std::fixed << std::setprecision(4);
+    for (size_t age = frameCount; age-- > 0;) {
+        const FrameRecord& frame = GetFrame(age);
+        size_t number = frameCount - 1 - age;
+        file << number << ",Frame,-1," << frame.startMs << "," << frame.durationMs << "\n";
+        for (const ProfileZoneRecord& zone : frame.zones) {
+            file << number << "," << zone.name << "," << zone.depth << ","
+                << zone.startMs << "," << zone.durationMs << "\n";
+        }
+    }
+    return file.good();
+}
+
+/**
+ * @brief Zapisuje strefy w formacie JSON Chrome Trace Event.
+ */
+bool FrameProfiler::ExportChromeTrace(const std::string& filePath) const {
+    std::ofstream file(filePath);
+    if (!file) {
+        std::cerr << "[FrameProfiler Error] Failed to open for writing: " << filePath << std::endl;
+        return false;
+    }
+
+    // Zdarzenia "X" (complete) w mikrosekundach
+    file << "{\"traceEvents\":[\n";
+    file << std::fixed << std::setprecision(3);
+    bool first = true;
+    for (size_t age = frameCount; age-- > 0;) {
+        const FrameRecord& frame = GetFrame(age);
+        file << (first ? "" : ",\n") << "{\"name\":\"Frame\",\"ph\":\"X\",\"pid\":1,\"tid\":1,\"ts\":"
+            << frame.startMs * 1000.0 << ",\"dur\":" << frame.durationMs * 1000.0 << "}";
+        first = false;
+        for (const ProfileZoneRecord& zone : frame.zones) {
+            file << ",\n{\"name\":\"" << zone.name << "\",\"ph\":\"X\",\"pid\":1,\"tid\":1,\"ts\":"
+                << zone.startMs * 1000.0 << ",\"dur\":" << zone.durationMs * 1000.0 << "}";
+        }
+    }
+    file << "\n],\"displayTimeUnit\":\"ms\"}\n";
+    return file.good();
+}
+
+/**
+ * @brief Wypisuje średni i maksymalny czas każdej strefy.
+ */
+void FrameProfiler::PrintSummary() const {
+    struct Summary { double total = 0.0; double max = 0.0; int depth = 0; size_t order = 0; };
+    std::map<std::string, Summary> zones;
+    double frameTotal = 0.0, frameMax = 0.0;
+
+    for (size_t age = 0; age < frameCount; age++) {
+        const FrameRecord& frame = GetFrame(age);
+        frameTotal += frame.durationMs;
+        frameMax = std::max(frameMax, frame.durationMs);
+        for (size_t i = 0; i < frame.zones.size(); i++) {
+            const ProfileZoneRecord& zone = frame.zones[i];
+            Summary& summary = zones[zone.name];
+            summary.total += zone.durationMs;
+            summary.max = std::max(summary.max, zone.durationMs);
+            summary.depth = zone.depth;
+            summary.order = i;
+        }
+    }
+
+    std::cout << "=== PROFILER (ostatnie " << frameCount << " klatek) ===\n";
+    if (frameCount == 0) return;
+
+    // Kolejność jak w klatce, z wcięciem wg zagnieżdżenia
+    std::vector<std::pair<std::string, Summary>> ordered(zones.begin(), zones.end());
+    std::sort(ordered.begin(), ordered.end(),
+        [](const std::pair<std::string, Summary>& a, const std::pair<std::string, Summary>& b) {
+            return a.second.order < b.second.order;
+        });
+
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << "  Klatka: średnio " << frameTotal / frameCount << " ms, max " << frameMax << " ms\n";
+    for (const auto& entry : ordered) {
+        std::cout << "  " << std::string(entry.second.depth * 2, ' ') << std::left << std::setw(18) << entry.first
+            << std::right << " średnio " << entry.second.total / frameCount
+            << " ms, max " << entry.second.max << " ms\n";
+    }
+    std::cout << std::defaultfloat << std::flush;
+}
+
+/**
+ * @brief Wyznacza stały kolor strefy na podstawie nazwy.
+ */
+void FrameProfiler::ZoneColor(const char* name, float& r, float& g, float& b) {
+    static const float palette[8][3] = {
+        { 0.90f, 0.30f, 0.30f }, { 0.30f, 0.80f, 0.30f }, { 0.30f, 0.50f, 0.95f }, { 0.95f, 0.80f, 0.20f },
+        { 0.80f, 0.40f, 0.90f }, { 0.20f, 0.85f, 0.85f }, { 0.95f, 0.55f, 0.15f }, { 0.70f, 0.70f, 0.70f },
+    };
+    unsigned int hash = 2166136261u; // FNV-1a
+    for (const char* c = name; *c; c++) hash = (hash ^ (unsigned char)*c) * 16777619u;
+    const float* color = palette[hash % 8];
+    r = color[0]; g = color[1]; b = color[2];
+}
+
+/**
+ * @brief Rysuje wykres czasu klatek (słupki stref najwyższego poziomu).
+ */
+void FrameProfiler::DrawOverlay(int screenWidth, int screenHeight, double targetMs) const {
+    if (frameCount == 0 || screenWidth <= 0 || screenHeight <= 0) return;
+
+    const float graphHeight = screenHeight * 0.25f;
+    const float pixelsPerMs = graphHeight / 33.3f; // 30 FPS = pełna wysokość
+    const float barWidth = (float)screenWidth / frames.size();
+
+    glPushAttrib(GL_ENABLE_BIT | GL_CURRENT_BIT | GL_LINE_BIT);
+    glDisable(GL_LIGHTING);
+    glDisable(GL_TEXTURE_2D);
+    glDisable(GL_DEPTH_TEST);
+    glDisable(GL_CULL_FACE);
+
+    glMatrixMode(GL_PROJECTION);
+    glPushMatrix();
+    glLoadIdentity();
+    glOrtho(0.0, screenWidth, 0.0, screenHeight, -1.0, 1.0);
+    glMatrixMode(GL_MODELVIEW);
+    glPushMatrix();
+    glLoadIdentity();
+
+    glBegin(GL_QUADS);
+    for (size_t age = 0; age < frameCount; age++) {
+        const FrameRecord& frame = GetFrame(age);
+        float x0 = screenWidth - (age + 1) * barWidth;
+        float x1 = x0 + barWidth * 0.9f;
+
+        // Tło słupka: cała klatka (czas poza strefami)
+        glColor3f(0.25f, 0.25f, 0.25f);
+        float top = (float)frame.durationMs * pixelsPerMs;
+        glVertex2f(x0, 0.0f); glVertex2f(x1, 0.0f); glVertex2f(x1, top); glVertex2f(x0, top);
+
+        float y = 0.0f;
+        for (const ProfileZoneRecord& zone : frame.zones) {
+            if (zone.depth != 0) continue;
+            float r, g, b;
+            ZoneColor(zone.name, r, g, b);
+            glColor3f(r, g, b);
+            float h = (float)zone.durationMs * pixelsPerMs;
+            glVertex2f(x0, y); glVertex2f(x1, y); glVertex2f(x1, y + h); glVertex2f(x0, y + h);
+            y += h;
+        }
+    }
+    glEnd();
+
+    if (targetMs > 0.0) {
+        float y = (float)targetMs * pixelsPerMs;
+        glLineWidth(1.0f);
+        glColor3f(1.0f, 1.0f, 1.0f);
+        glBegin(GL_LINES);
+        glVertex2f(0.0f, y); glVertex2f((float)screenWidth, y);
+        glEnd();
+    }
+
+    glPopMatrix();
+    glMatrixMode(GL_PROJECTION);
+    glPopMatrix();
+    glMatrixMode(GL_MODELVIEW);
+    glPopAttrib();
+}
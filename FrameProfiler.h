@@ -0,0 +1,141 @@
+﻿#pragma once
+#ifndef FRAME_PROFILER_H
+#define FRAME_PROFILER_H
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Pomiar pojedynczej strefy w klatce.
+ */
+struct ProfileZoneRecord {
+    const char* name;   /**< Nazwa strefy (literał, nie jest kopiowany) */
+    int depth;          /**< Poziom zagnieżdżenia (0 = strefa najwyższego poziomu) */
+    double startMs;     /**< Początek względem startu profilera [ms] */
+    double durationMs;  /**< Czas trwania [ms] */
+};
+
+/**
+ * @brief Lekki profiler klatek ze strefami mierzonymi zegarem CPU.
+ *
+ * Przechowuje bufor cykliczny ostatnich N klatek. Strefy otwierane są
+ * obiektem ProfileZone (RAII) lub makrem PROFILE_ZONE. Wyniki można
+ * zapisać do CSV lub formatu Chrome Trace (chrome://tracing, Perfetto)
+ * albo narysować jako wykres słupkowy na ekranie.
+ */
+class FrameProfiler {
+public:
+    /**
+     * @brief Konstruktor klasy FrameProfiler.
+     * @param frameCapacity Liczba klatek przechowywanych w buforze.
+     * @param zonesPerFrame Liczba stref rezerwowanych na klatkę.
+     */
+    explicit FrameProfiler(size_t frameCapacity = 240, size_t zonesPerFrame = 64);
+
+    FrameProfiler(const FrameProfiler&) = delete;
+    FrameProfiler& operator=(const FrameProfiler&) = delete;
+
+    /**
+     * @brief Rozpoczyna pomiar nowej klatki.
+     */
+    void BeginFrame();
+
+    /**
+     * @brief Kończy pomiar bieżącej klatki.
+     */
+    void EndFrame();
+
+    /**
+     * @brief Otwiera strefę w bieżącej klatce.
+     * @return Indeks strefy (do EndZone) lub -1 gdy profiler jest wyłączony.
+     */
+    int BeginZone(const char* name);
+
+    /**
+     * @brief Zamyka strefę otwartą przez BeginZone.
+     */
+    void EndZone(int zoneIndex);
+
+    void SetEnabled(bool enabled) { this->enabled = enabled; }
+    bool IsEnabled() const { return enabled; }
+
+    /**
+     * @brief Zwraca liczbę klatek zapisanych w buforze.
+     */
+    size_t GetFrameCount() const { return frameCount; }
+
+    /**
+     * @brief Zapisuje strefy wszystkich klatek do pliku CSV.
+     * @return True jeśli zapis się powiódł.
+     */
+    bool ExportCSV(const std::string& filePath) const;
+
+    /**
+     * @brief Zapisuje strefy w formacie JSON Chrome Trace Event.
+     * @return True jeśli zapis się powiódł.
+     */
+    bool ExportChromeTrace(const std::string& filePath) const;
+
+    /**
+     * @brief Wypisuje średni i maksymalny czas każdej strefy.
+     */
+    void PrintSummary() const;
+
+    /**
+     * @brief Rysuje wykres czasu klatek (słupki stref najwyższego poziomu).
+     * @param screenWidth Szerokość okna w pikselach.
+     * @param screenHeight Wysokość okna w pikselach.
+     * @param targetMs Czas docelowy klatki (pozioma linia), 0 = brak.
+     */
+    void DrawOverlay(int screenWidth, int screenHeight, double targetMs) const;
+
+private:
+    typedef std::chrono::steady_clock Clock;
+
+    /**
+     * @brief Zapis jednej klatki.
+     */
+    struct FrameRecord {
+        double startMs = 0.0;                 /**< Początek klatki [ms] */
+        double durationMs = 0.0;              /**< Czas trwania klatki [ms] */
+        std::vector<ProfileZoneRecord> zones; /**< Strefy w kolejności otwarcia */
+    };
+
+    double NowMs() const;
+    const FrameRecord& GetFrame(size_t age) const;
+    static void ZoneColor(const char* name, float& r, float& g, float& b);
+
+    std::vector<FrameRecord> frames; /**< Bufor cykliczny klatek */
+    size_t current;                  /**< Indeks bieżącej klatki */
+    size_t frameCount;               /**< Liczba zakończonych klatek w buforze */
+    int depth;                       /**< Bieżący poziom zagnieżdżenia */
+    bool inFrame;                    /**< Czy klatka jest w trakcie pomiaru */
+    bool enabled;                    /**< Czy pomiary są zbierane */
+    Clock::time_point origin;        /**< Punkt odniesienia czasu */
+};
+
+/**
+ * @brief Strefa profilera mierzona od konstrukcji do zniszczenia obiektu.
+ */
+class ProfileZone {
+public:
+    ProfileZone(FrameProfiler& profiler, const char* name)
+        : profiler(profiler), index(profiler.BeginZone(name)) {
+    }
+    ~ProfileZone() { profiler.EndZone(index); }
+
+    ProfileZone(const ProfileZone&) = delete;
+    ProfileZone& operator=(const ProfileZone&) = delete;
+
+private:
+    FrameProfiler& profiler;
+    int index;
+};
+
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+/// Mierzy czas do końca bieżącego bloku jako strefę o podanej nazwie
+#define PROFILE_ZONE(profiler, name) ProfileZone PROFILE_CONCAT(profileZone_, __LINE__)(profiler, name)
+
+#endif
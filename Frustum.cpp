@@ -0,0 +1,113 @@
+﻿#include "Frustum.h"
+
+#include <cmath>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__SSE__)
+#include <xmmintrin.h>
+#define FRUSTUM_SSE 1
+#endif
+
+/**
+ * @brief Wyznacza płaszczyzny bryły widzenia z macierzy projekcja * widok.
+ */
+void ExtractFrustum(const float* m, Frustum& frustum) {
+    // Wiersz i macierzy kolumnowej: (m[i], m[4+i], m[8+i], m[12+i])
+    for (int plane = 0; plane < Frustum::PLANE_COUNT; plane++) {
+        int row = plane / 2;
+        float sign = (plane % 2 == 0) ? 1.0f : -1.0f;
+        float a = m[3] + sign * m[row];
+        float b = m[7] + sign * m[4 + row];
+        float c = m[11] + sign * m[8 + row];
+        float d = m[15] + sign * m[12 + row];
+
+        float length = std::sqrt(a * a + b * b + c * c);
+        float inverse = length > 0.0f ? 1.0f / length : 0.0f;
+        frustum.nx[plane] = a * inverse;
+        frustum.ny[plane] = b * inverse;
+        frustum.nz[plane] = c * inverse;
+        frustum.d[plane] = d * inverse;
+    }
+}
+
+/**
+ * @brief Sprawdza, czy sfera przecina bryłę widzenia.
+ */
+bool SphereInFrustum(const Frustum& frustum, float x, float y, float z, float radius) {
+    for (int plane = 0; plane < Frustum::PLANE_COUNT; plane++) {
+        float distance = frustum.nx[plane] * x + frustum.ny[plane] * y + frustum.nz[plane] * z + frustum.d[plane];
+        if (distance < -radius) return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Klasyfikuje prostopadłościan względem bryły widzenia.
+ *
+ * Dla każdej płaszczyzny sprawdzany jest wierzchołek najdalej wysunięty
+ * w stronę normalnej (p) i najdalej w stronę przeciwną (n).
+ */
+FrustumTest AabbInFrustum(const Frustum& frustum, const float min[3], const float max[3]) {
+    FrustumTest result = FRUSTUM_INSIDE;
+    for (int plane = 0; plane < Frustum::PLANE_COUNT; plane++) {
+        float nx = frustum.nx[plane], ny = frustum.ny[plane], nz = frustum.nz[plane];
+        float px = nx >= 0.0f ? max[0] : min[0];
+        float py = ny >= 0.0f ? max[1] : min[1];
+        float pz = nz >= 0.0f ? max[2] : min[2];
+        if (nx * px + ny * py + nz * pz + frustum.d[plane] < 0.0f) return FRUSTUM_OUTSIDE;
+
+        float qx = nx >= 0.0f ? min[0] : max[0];
+        float qy = ny >= 0.0f ? min[1] : max[1];
+        float qz = nz >= 0.0f ? min[2] : max[2];
+        if (nx * qx + ny * qy + nz * qz + frustum.d[plane] < 0.0f) result = FRUSTUM_INTERSECTS;
+    }
+    return result;
+}
+
+/**
+ * @brief Testuje tablicę sfer (SoA) z bryłą widzenia.
+ */
+size_t CullSpheres(const Frustum& frustum, const float* x, const float* y, const float* z,
+    const float* radius, size_t count, unsigned char* visible) {
+    size_t visibleCount = 0;
+    size_t i = 0;
+
+#ifdef FRUSTUM_SSE
+    __m128 nx[Frustum::PLANE_COUNT], ny[Frustum::PLANE_COUNT], nz[Frustum::PLANE_COUNT], d[Frustum::PLANE_COUNT];
+    for (int plane = 0; plane < Frustum::PLANE_COUNT; plane++) {
+        nx[plane] = _mm_set1_ps(frustum.nx[plane]);
+        ny[plane] = _mm_set1_ps(frustum.ny[plane]);
+        nz[plane] = _mm_set1_ps(frustum.nz[plane]);
+        d[plane] = _mm_set1_ps(frustum.d[plane]);
+    }
+
+    for (; i + 4 <= count; i += 4) {
+        __m128 px = _mm_loadu_ps(x + i);
+        __m128 py = _mm_loadu_ps(y + i);
+        __m128 pz = _mm_loadu_ps(z + i);
+        __m128 negRadius = _mm_sub_ps(_mm_setzero_ps(), _mm_loadu_ps(radius + i));
+
+        // Bit ustawiony = sfera poza co najmniej jedną płaszczyzną
+        __m128 outside = _mm_setzero_ps();
+        for (int plane = 0; plane < Frustum::PLANE_COUNT; plane++) {
+            __m128 distance = _mm_add_ps(
+                _mm_add_ps(_mm_mul_ps(nx[plane], px), _mm_mul_ps(ny[plane], py)),
+                _mm_add_ps(_mm_mul_ps(nz[plane], pz), d[plane]));
+            outside = _mm_or_ps(outside, _mm_cmplt_ps(distance, negRadius));
+        }
+
+        int mask = _mm_movemask_ps(outside);
+        for (int k = 0; k < 4; k++) {
+            unsigned char inside = (mask & (1 << k)) ? 0 : 1;
+            visible[i + k] = inside;
+            visibleCount += inside;
+        }
+    }
+#endif
+
+    for (; i < count; i++) {
+        unsigned char inside = SphereInFrustum(frustum, x[i], y[i], z[i], radius[i]) ? 1 : 0;
+        visible[i] = inside;
+        visibleCount += inside;
+    }
+    return visibleCount;
+}
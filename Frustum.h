@@ -0,0 +1,61 @@
+﻿#pragma once
+#ifndef FRUSTUM_H
+#define FRUSTUM_H
+
+#include <cstddef>
+
+/**
+ * @brief Sześć płaszczyzn bryły widzenia.
+ *
+ * Płaszczyzny są znormalizowane i skierowane do wnętrza: punkt p leży
+ * po wewnętrznej stronie, gdy nx*px + ny*py + nz*pz + d >= 0.
+ * Składowe przechowywane są osobno (SoA), żeby testy SIMD mogły
+ * rozgłaszać jedną płaszczyznę na cztery obiekty naraz.
+ */
+struct Frustum {
+    enum Plane { LEFT, RIGHT, BOTTOM, TOP, NEAR_PLANE, FAR_PLANE, PLANE_COUNT };
+
+    float nx[PLANE_COUNT]; /**< Składowe X normalnych */
+    float ny[PLANE_COUNT]; /**< Składowe Y normalnych */
+    float nz[PLANE_COUNT]; /**< Składowe Z normalnych */
+    float d[PLANE_COUNT];  /**< Odległości od początku układu */
+};
+
+/**
+ * @brief Wynik testu prostopadłościanu z bryłą widzenia.
+ */
+enum FrustumTest {
+    FRUSTUM_OUTSIDE = -1,   /**< Całkowicie poza bryłą */
+    FRUSTUM_INTERSECTS = 0, /**< Częściowo wewnątrz */
+    FRUSTUM_INSIDE = 1      /**< Całkowicie wewnątrz */
+};
+
+/**
+ * @brief Wyznacza płaszczyzny bryły widzenia z macierzy projekcja * widok.
+ *
+ * Metoda Gribba-Hartmanna; płaszczyzny są w przestrzeni świata.
+ * @param viewProjection Macierz 4x4 w układzie kolumnowym OpenGL.
+ */
+void ExtractFrustum(const float* viewProjection, Frustum& frustum);
+
+/**
+ * @brief Sprawdza, czy sfera przecina bryłę widzenia.
+ */
+bool SphereInFrustum(const Frustum& frustum, float x, float y, float z, float radius);
+
+/**
+ * @brief Klasyfikuje prostopadłościan względem bryły widzenia.
+ */
+FrustumTest AabbInFrustum(const Frustum& frustum, const float min[3], const float max[3]);
+
+/**
+ * @brief Testuje tablicę sfer (SoA) z bryłą widzenia.
+ *
+ * Używa SSE (cztery sfery na iterację), gdy kompilator je udostępnia.
+ * @param visible Wynik: 1 dla sfer widocznych, 0 dla odrzuconych.
+ * @return Liczba widocznych sfer.
+ */
+size_t CullSpheres(const Frustum& frustum, const float* x, const float* y, const float* z,
+    const float* radius, size_t count, unsigned char* visible);
+
+#endif
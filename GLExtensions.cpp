@@ -0,0 +1,205 @@
+﻿#include "GLExtensions.h"
+
+#include <iostream>
+#include <cstdlib>
+#include <cstring>
+
+GLEXT_ACTIVETEXTURE glextActiveTexture = nullptr;
+
+GLEXT_GENBUFFERS glextGenBuffers = nullptr;
+GLEXT_DELETEBUFFERS glextDeleteBuffers = nullptr;
+GLEXT_BINDBUFFER glextBindBuffer = nullptr;
+GLEXT_BUFFERDATA glextBufferData = nullptr;
+GLEXT_BUFFERSUBDATA glextBufferSubData = nullptr;
+GLEXT_MAPBUFFER glextMapBuffer = nullptr;
+GLEXT_UNMAPBUFFER glextUnmapBuffer = nullptr;
+
+GLEXT_MAPBUFFERRANGE glextMapBufferRange = nullptr;
+GLEXT_FENCESYNC glextFenceSync = nullptr;
+GLEXT_CLIENTWAITSYNC glextClientWaitSync = nullptr;
+GLEXT_DELETESYNC glextDeleteSync = nullptr;
+GLEXT_BUFFERSTORAGE glextBufferStorage = nullptr;
+
+GLEXT_GENFRAMEBUFFERS glextGenFramebuffers = nullptr;
+GLEXT_DELETEFRAMEBUFFERS glextDeleteFramebuffers = nullptr;
+GLEXT_BINDFRAMEBUFFER glextBindFramebuffer = nullptr;
+GLEXT_CHECKFRAMEBUFFERSTATUS glextCheckFramebufferStatus = nullptr;
+GLEXT_FRAMEBUFFERTEXTURE2D glextFramebufferTexture2D = nullptr;
+GLEXT_FRAMEBUFFERRENDERBUFFER glextFramebufferRenderbuffer = nullptr;
+GLEXT_GENRENDERBUFFERS glextGenRenderbuffers = nullptr;
+GLEXT_DELETERENDERBUFFERS glextDeleteRenderbuffers = nullptr;
+GLEXT_BINDRENDERBUFFER glextBindRenderbuffer = nullptr;
+GLEXT_RENDERBUFFERSTORAGE glextRenderbufferStorage = nullptr;
+
+GLEXT_CREATESHADER glextCreateShader = nullptr;
+GLEXT_DELETESHADER glextDeleteShader = nullptr;
+GLEXT_SHADERSOURCE glextShaderSource = nullptr;
+GLEXT_COMPILESHADER glextCompileShader = nullptr;
+GLEXT_GETSHADERIV glextGetShaderiv = nullptr;
+GLEXT_GETSHADERINFOLOG glextGetShaderInfoLog = nullptr;
+GLEXT_CREATEPROGRAM glextCreateProgram = nullptr;
+GLEXT_DELETEPROGRAM glextDeleteProgram = nullptr;
+GLEXT_ATTACHSHADER glextAttachShader = nullptr;
+GLEXT_BINDATTRIBLOCATION glextBindAttribLocation = nullptr;
+GLEXT_LINKPROGRAM glextLinkProgram = nullptr;
+GLEXT_GETPROGRAMIV glextGetProgramiv = nullptr;
+GLEXT_GETPROGRAMINFOLOG glextGetProgramInfoLog = nullptr;
+GLEXT_USEPROGRAM glextUseProgram = nullptr;
+GLEXT_GETUNIFORMLOCATION glextGetUniformLocation = nullptr;
+GLEXT_UNIFORM1I glextUniform1i = nullptr;
+GLEXT_UNIFORM1F glextUniform1f = nullptr;
+GLEXT_UNIFORM4FV glextUniform4fv = nullptr;
+GLEXT_UNIFORMMATRIX4FV glextUniformMatrix4fv = nullptr;
+GLEXT_VERTEXATTRIBPOINTER glextVertexAttribPointer = nullptr;
+GLEXT_ENABLEVERTEXATTRIBARRAY glextEnableVertexAttribArray = nullptr;
+GLEXT_DISABLEVERTEXATTRIBARRAY glextDisableVertexAttribArray = nullptr;
+
+GLEXT_DRAWELEMENTSINSTANCED glextDrawElementsInstanced = nullptr;
+GLEXT_VERTEXATTRIBDIVISOR glextVertexAttribDivisor = nullptr;
+
+static GLCapabilities capabilities;
+
+/**
+ * @brief Pobiera adres funkcji, próbując także wariantu z sufiksem ARB.
+ */
+template <typename T>
+static bool LoadProc(T& target, const char* name, const char* arbName = nullptr) {
+    target = reinterpret_cast<T>(glfwGetProcAddress(name));
+    if (!target && arbName) {
+        target = reinterpret_cast<T>(glfwGetProcAddress(arbName));
+    }
+    return target != nullptr;
+}
+
+/**
+ * @brief Sprawdza, czy wersja kontekstu jest co najmniej major.minor.
+ */
+static bool HasVersion(int major, int minor) {
+    return capabilities.versionMajor > major ||
+        (capabilities.versionMajor == major && capabilities.versionMinor >= minor);
+}
+
+/**
+ * @brief Wczytuje wskaźniki funkcji dla bieżącego kontekstu.
+ * @return True jeśli kontekst jest aktywny i wersja została odczytana.
+ */
+bool LoadGLExtensions() {
+    capabilities = GLCapabilities();
+
+    const char* version = reinterpret_cast<const char*>(glGetString(GL_VERSION));
+    if (!version) {
+        std::cerr << "[GLExtensions Error] No current OpenGL context" << std::endl;
+        return false;
+    }
+    // Format: "<major>.<minor>[.<release>] <informacje producenta>"
+    const char* dot = strchr(version, '.');
+    capabilities.versionMajor = atoi(version);
+    capabilities.versionMinor = dot ? atoi(dot + 1) : 0;
+
+    if (HasVersion(1, 3) || glfwExtensionSupported("GL_ARB_multitexture")) {
+        capabilities.multitexture = LoadProc(glextActiveTexture, "glActiveTexture", "glActiveTextureARB");
+    }
+    capabilities.floatTextures = HasVersion(3, 0) || glfwExtensionSupported("GL_ARB_texture_float");
+    capabilities.depthTextures = HasVersion(1, 4) ||
+        (glfwExtensionSupported("GL_ARB_depth_texture") && glfwExtensionSupported("GL_ARB_shadow"));
+    capabilities.generateMipmap = HasVersion(1, 4) || glfwExtensionSupported("GL_SGIS_generate_mipmap");
+    if (glfwExtensionSupported("GL_EXT_texture_filter_anisotropic")) {
+        glGetFloatv(GL_MAX_TEXTURE_MAX_ANISOTROPY_EXT, &capabilities.maxAnisotropy);
+        if (capabilities.maxAnisotropy < 1.0f) capabilities.maxAnisotropy = 1.0f;
+    }
+
+    if (HasVersion(1, 5) || glfwExtensionSupported("GL_ARB_vertex_buffer_object")) {
+        bool ok = LoadProc(glextGenBuffers, "glGenBuffers", "glGenBuffersARB");
+        ok &= LoadProc(glextDeleteBuffers, "glDeleteBuffers", "glDeleteBuffersARB");
+        ok &= LoadProc(glextBindBuffer, "glBindBuffer", "glBindBufferARB");
+        ok &= LoadProc(glextBufferData, "glBufferData", "glBufferDataARB");
+        ok &= LoadProc(glextBufferSubData, "glBufferSubData", "glBufferSubDataARB");
+        capabilities.vertexBufferObjects = ok;
+    }
+
+    // Bufory pikseli używają tych samych funkcji co VBO oraz mapowania
+    if (capabilities.vertexBufferObjects &&
+        (HasVersion(2, 1) || glfwExtensionSupported("GL_ARB_pixel_buffer_object"))) {
+        bool ok = LoadProc(glextMapBuffer, "glMapBuffer", "glMapBufferARB");
+        ok &= LoadProc(glextUnmapBuffer, "glUnmapBuffer", "glUnmapBufferARB");
+        capabilities.pixelBufferObjects = ok;
+    }
+    if (capabilities.pixelBufferObjects &&
+        (HasVersion(3, 0) || glfwExtensionSupported("GL_ARB_map_buffer_range"))) {
+        capabilities.mapBufferRange = LoadProc(glextMapBufferRange, "glMapBufferRange");
+    }
+    if (HasVersion(3, 2) || glfwExtensionSupported("GL_ARB_sync")) {
+        bool ok = LoadProc(glextFenceSync, "glFenceSync");
+        ok &= LoadProc(glextClientWaitSync, "glClientWaitSync");
+        ok &= LoadProc(glextDeleteSync, "glDeleteSync");
+        capabilities.syncObjects = ok;
+    }
+    if (capabilities.mapBufferRange &&
+        (HasVersion(4, 4) || glfwExtensionSupported("GL_ARB_buffer_storage"))) {
+        capabilities.bufferStorage = LoadProc(glextBufferStorage, "glBufferStorage");
+    }
+
+    if (HasVersion(3, 0) || glfwExtensionSupported("GL_ARB_framebuffer_object") ||
+        glfwExtensionSupported("GL_EXT_framebuffer_object")) {
+        bool ok = LoadProc(glextGenFramebuffers, "glGenFramebuffers", "glGenFramebuffersEXT");
+        ok &= LoadProc(glextDeleteFramebuffers, "glDeleteFramebuffers", "glDeleteFramebuffersEXT");
+        ok &= LoadProc(glextBindFramebuffer, "glBindFramebuffer", "glBindFramebufferEXT");
+        ok &= LoadProc(glextCheckFramebufferStatus, "glCheckFramebufferStatus", "glCheckFramebufferStatusEXT");
+        ok &= LoadProc(glextFramebufferTexture2D, "glFramebufferTexture2D", "glFramebufferTexture2DEXT");
+        ok &= LoadProc(glextFramebufferRenderbuffer, "glFramebufferRenderbuffer", "glFramebufferRenderbufferEXT");
+        ok &= LoadProc(glextGenRenderbuffers, "glGenRenderbuffers", "glGenRenderbuffersEXT");
+        ok &= LoadProc(glextDeleteRenderbuffers, "glDeleteRenderbuffers", "glDeleteRenderbuffersEXT");
+        ok &= LoadProc(glextBindRenderbuffer, "glBindRenderbuffer", "glBindRenderbufferEXT");
+        ok &= LoadProc(glextRenderbufferStorage, "glRenderbufferStorage", "glRenderbufferStorageEXT");
+        capabilities.framebufferObjects = ok;
+    }
+
+    if (HasVersion(2, 0)) {
+        bool ok = LoadProc(glextCreateShader, "glCreateShader");
+        ok &= LoadProc(glextDeleteShader, "glDeleteShader");
+        ok &= LoadProc(glextShaderSource, "glShaderSource");
+        ok &= LoadProc(glextCompileShader, "glCompileShader");
+        ok &= LoadProc(glextGetShaderiv, "glGetShaderiv");
+        ok &= LoadProc(glextGetShaderInfoLog, "glGetShaderInfoLog");
+        ok &= LoadProc(glextCreateProgram, "glCreateProgram");
+        ok &= LoadProc(glextDeleteProgram, "glDeleteProgram");
+        ok &= LoadProc(glextAttachShader, "glAttachShader");
+        ok &= LoadProc(glextBindAttribLocation, "glBindAttribLocation");
+        ok &= LoadProc(glextLinkProgram, "glLinkProgram");
+        ok &= LoadProc(glextGetProgramiv, "glGetProgramiv");
+        ok &= LoadProc(glextGetProgramInfoLog, "glGetProgramInfoLog");
+        ok &= LoadProc(glextUseProgram, "glUseProgram");
+        ok &= LoadProc(glextGetUniformLocation, "glGetUniformLocation");
+        ok &= LoadProc(glextUniform1i, "glUniform1i");
+        ok &= LoadProc(glextUniform1f, "glUniform1f");
+        ok &= LoadProc(glextUniform4fv, "glUniform4fv");
+        ok &= LoadProc(glextUniformMatrix4fv, "glUniformMatrix4fv");
+        ok &= LoadProc(glextVertexAttribPointer, "glVertexAttribPointer");
+        ok &= LoadProc(glextEnableVertexAttribArray, "glEnableVertexAttribArray");
+        ok &= LoadProc(glextDisableVertexAttribArray, "glDisableVertexAttribArray");
+        capabilities.shaders = ok;
+    }
+
+    // Atrybuty na instancję wymagają shaderów i VBO
+    if (capabilities.shaders && capabilities.vertexBufferObjects &&
+        (HasVersion(3, 3) || (glfwExtensionSupported("GL_ARB_instanced_arrays") &&
+            glfwExtensionSupported("GL_ARB_draw_instanced")))) {
+        bool ok = LoadProc(glextDrawElementsInstanced, "glDrawElementsInstanced", "glDrawElementsInstancedARB");
+        ok &= LoadProc(glextVertexAttribDivisor, "glVertexAttribDivisor", "glVertexAttribDivisorARB");
+        capabilities.instancing = ok;
+    }
+
+    std::cout << "OpenGL " << version << " (VBO: "
+        << (capabilities.vertexBufferObjects ? "tak" : "nie") << ", FBO: "
+        << (capabilities.framebufferObjects ? "tak" : "nie") << ", GLSL: "
+        << (capabilities.shaders ? "tak" : "nie") << ", instancing: "
+        << (capabilities.instancing ? "tak" : "nie") << ")" << std::endl;
+    return true;
+}
+
+/**
+ * @brief Zwraca możliwości wykryte przy ostatnim LoadGLExtensions.
+ */
+const GLCapabilities& GetGLCapabilities() {
+    return capabilities;
+}
@@ -0,0 +1,321 @@
+﻿#pragma once
+#ifndef GL_EXTENSIONS_H
+#define GL_EXTENSIONS_H
+
+#include <GLFW/glfw3.h>
+#include <cstddef>
+
+/**
+ * @file GLExtensions.h
+ * @brief Minimalny loader funkcji OpenGL spoza wersji 1.1.
+ *
+ * opengl32.lib w Windows eksportuje tylko OpenGL 1.1, dlatego funkcje
+ * nowszych wersji są pobierane przez glfwGetProcAddress po utworzeniu
+ * kontekstu. Nazwy funkcji są mapowane makrami na wskaźniki (jak w GLEW).
+ */
+
+#if defined(_WIN32)
+#define GLEXT_APIENTRY __stdcall
+#else
+#define GLEXT_APIENTRY
+#endif
+
+// === OpenGL 1.3: wiele jednostek tekstur ===
+#ifndef GL_VERSION_1_3
+#define GL_TEXTURE0                       0x84C0
+#endif
+
+typedef void (GLEXT_APIENTRY* GLEXT_ACTIVETEXTURE)(GLenum texture);
+
+extern GLEXT_ACTIVETEXTURE glextActiveTexture;
+
+#define glActiveTexture glextActiveTexture
+
+// === ARB_texture_float: tekstury zmiennoprzecinkowe ===
+#ifndef GL_RGBA32F_ARB
+#define GL_RGBA32F_ARB                    0x8814
+#define GL_LUMINANCE32F_ARB               0x8818
+#endif
+
+// === OpenGL 1.4 / ARB_depth_texture + ARB_shadow: tekstury głębokości z porównaniem ===
+#ifndef GL_VERSION_1_2
+#define GL_CLAMP_TO_EDGE                  0x812F
+#endif
+#ifndef GL_VERSION_1_4
+#define GL_DEPTH_TEXTURE_MODE             0x884B
+#define GL_TEXTURE_COMPARE_MODE           0x884C
+#define GL_TEXTURE_COMPARE_FUNC           0x884D
+#define GL_COMPARE_R_TO_TEXTURE           0x884E
+#endif
+
+// === OpenGL 1.4 / SGIS_generate_mipmap: mipmapy liczone przez sterownik ===
+#ifndef GL_VERSION_1_4
+#define GL_GENERATE_MIPMAP                0x8191
+#endif
+
+// === EXT_texture_filter_anisotropic: filtrowanie anizotropowe ===
+#ifndef GL_TEXTURE_MAX_ANISOTROPY_EXT
+#define GL_TEXTURE_MAX_ANISOTROPY_EXT     0x84FE
+#define GL_MAX_TEXTURE_MAX_ANISOTROPY_EXT 0x84FF
+#endif
+
+// === OpenGL 1.5: obiekty buforów ===
+#ifndef GL_VERSION_1_5
+typedef ptrdiff_t GLsizeiptr;
+typedef ptrdiff_t GLintptr;
+#define GL_ARRAY_BUFFER                   0x8892
+#define GL_ELEMENT_ARRAY_BUFFER           0x8893
+#define GL_STREAM_DRAW                    0x88E0
+#define GL_STATIC_DRAW                    0x88E4
+#define GL_DYNAMIC_DRAW                   0x88E8
+#define GL_WRITE_ONLY                     0x88B9
+#endif
+
+typedef void (GLEXT_APIENTRY* GLEXT_GENBUFFERS)(GLsizei n, GLuint* buffers);
+typedef void (GLEXT_APIENTRY* GLEXT_DELETEBUFFERS)(GLsizei n, const GLuint* buffers);
+typedef void (GLEXT_APIENTRY* GLEXT_BINDBUFFER)(GLenum target, GLuint buffer);
+typedef void (GLEXT_APIENTRY* GLEXT_BUFFERDATA)(GLenum target, GLsizeiptr size, const void* data, GLenum usage);
+typedef void (GLEXT_APIENTRY* GLEXT_BUFFERSUBDATA)(GLenum target, GLintptr offset, GLsizeiptr size, const void* data);
+typedef void* (GLEXT_APIENTRY* GLEXT_MAPBUFFER)(GLenum target, GLenum access);
+typedef GLboolean(GLEXT_APIENTRY* GLEXT_UNMAPBUFFER)(GLenum target);
+
+extern GLEXT_GENBUFFERS glextGenBuffers;
+extern GLEXT_DELETEBUFFERS glextDeleteBuffers;
+extern GLEXT_BINDBUFFER glextBindBuffer;
+extern GLEXT_BUFFERDATA glextBufferData;
+extern GLEXT_BUFFERSUBDATA glextBufferSubData;
+extern GLEXT_MAPBUFFER glextMapBuffer;
+extern GLEXT_UNMAPBUFFER glextUnmapBuffer;
+
+#define glGenBuffers glextGenBuffers
+#define glDeleteBuffers glextDeleteBuffers
+#define glBindBuffer glextBindBuffer
+#define glBufferData glextBufferData
+#define glBufferSubData glextBufferSubData
+#define glMapBuffer glextMapBuffer
+#define glUnmapBuffer glextUnmapBuffer
+
+// === OpenGL 2.1 / ARB_pixel_buffer_object: bufory pikseli ===
+#ifndef GL_VERSION_2_1
+#define GL_PIXEL_UNPACK_BUFFER            0x88EC
+#endif
+
+// === OpenGL 3.0 / ARB_map_buffer_range: mapowanie fragmentu bufora ===
+#ifndef GL_VERSION_3_0
+#define GL_MAP_WRITE_BIT                  0x0002
+#define GL_MAP_INVALIDATE_RANGE_BIT       0x0004
+#define GL_MAP_FLUSH_EXPLICIT_BIT         0x0010
+#define GL_MAP_UNSYNCHRONIZED_BIT         0x0020
+#endif
+
+typedef void* (GLEXT_APIENTRY* GLEXT_MAPBUFFERRANGE)(GLenum target, GLintptr offset, GLsizeiptr length, GLbitfield access);
+
+extern GLEXT_MAPBUFFERRANGE glextMapBufferRange;
+
+#define glMapBufferRange glextMapBufferRange
+
+// === OpenGL 3.2 / ARB_sync: płoty synchronizacji CPU-GPU ===
+#ifndef GL_VERSION_3_2
+typedef struct __GLsync* GLsync;
+typedef unsigned long long GLuint64;
+#define GL_SYNC_GPU_COMMANDS_COMPLETE     0x9117
+#define GL_ALREADY_SIGNALED               0x911A
+#define GL_TIMEOUT_EXPIRED                0x911B
+#define GL_CONDITION_SATISFIED            0x911C
+#define GL_WAIT_FAILED                    0x911D
+#define GL_SYNC_FLUSH_COMMANDS_BIT        0x00000001
+#endif
+
+typedef GLsync(GLEXT_APIENTRY* GLEXT_FENCESYNC)(GLenum condition, GLbitfield flags);
+typedef GLenum(GLEXT_APIENTRY* GLEXT_CLIENTWAITSYNC)(GLsync sync, GLbitfield flags, GLuint64 timeout);
+typedef void (GLEXT_APIENTRY* GLEXT_DELETESYNC)(GLsync sync);
+
+extern GLEXT_FENCESYNC glextFenceSync;
+extern GLEXT_CLIENTWAITSYNC glextClientWaitSync;
+extern GLEXT_DELETESYNC glextDeleteSync;
+
+#define glFenceSync glextFenceSync
+#define glClientWaitSync glextClientWaitSync
+#define glDeleteSync glextDeleteSync
+
+// === OpenGL 4.4 / ARB_buffer_storage: bufory mapowane na stałe ===
+#ifndef GL_VERSION_4_4
+#define GL_MAP_PERSISTENT_BIT             0x0040
+#define GL_MAP_COHERENT_BIT               0x0080
+#endif
+
+typedef void (GLEXT_APIENTRY* GLEXT_BUFFERSTORAGE)(GLenum target, GLsizeiptr size, const void* data, GLbitfield flags);
+
+extern GLEXT_BUFFERSTORAGE glextBufferStorage;
+
+#define glBufferStorage glextBufferStorage
+
+// === OpenGL 3.0 / EXT_framebuffer_object: bufory ramki ===
+#ifndef GL_VERSION_3_0
+#define GL_FRAMEBUFFER                    0x8D40
+#define GL_RENDERBUFFER                   0x8D41
+#define GL_COLOR_ATTACHMENT0              0x8CE0
+#define GL_DEPTH_ATTACHMENT               0x8D00
+#define GL_FRAMEBUFFER_COMPLETE           0x8CD5
+#endif
+#ifndef GL_VERSION_1_4
+#define GL_DEPTH_COMPONENT24              0x81A6
+#endif
+
+typedef void (GLEXT_APIENTRY* GLEXT_GENFRAMEBUFFERS)(GLsizei n, GLuint* framebuffers);
+typedef void (GLEXT_APIENTRY* GLEXT_DELETEFRAMEBUFFERS)(GLsizei n, const GLuint* framebuffers);
+typedef void (GLEXT_APIENTRY* GLEXT_BINDFRAMEBUFFER)(GLenum target, GLuint framebuffer);
+typedef GLenum(GLEXT_APIENTRY* GLEXT_CHECKFRAMEBUFFERSTATUS)(GLenum target);
+typedef void (GLEXT_APIENTRY* GLEXT_FRAMEBUFFERTEXTURE2D)(GLenum target, GLenum attachment, GLenum textarget, GLuint texture, GLint level);
+typedef void (GLEXT_APIENTRY* GLEXT_FRAMEBUFFERRENDERBUFFER)(GLenum target, GLenum attachment, GLenum renderbuffertarget, GLuint renderbuffer);
+typedef void (GLEXT_APIENTRY* GLEXT_GENRENDERBUFFERS)(GLsizei n, GLuint* renderbuffers);
+typedef void (GLEXT_APIENTRY* GLEXT_DELETERENDERBUFFERS)(GLsizei n, const GLuint* renderbuffers);
+typedef void (GLEXT_APIENTRY* GLEXT_BINDRENDERBUFFER)(GLenum target, GLuint renderbuffer);
+typedef void (GLEXT_APIENTRY* GLEXT_RENDERBUFFERSTORAGE)(GLenum target, GLenum internalformat, GLsizei width, GLsizei height);
+
+extern GLEXT_GENFRAMEBUFFERS glextGenFramebuffers;
+extern GLEXT_DELETEFRAMEBUFFERS glextDeleteFramebuffers;
+extern GLEXT_BINDFRAMEBUFFER glextBindFramebuffer;
+extern GLEXT_CHECKFRAMEBUFFERSTATUS glextCheckFramebufferStatus;
+extern GLEXT_FRAMEBUFFERTEXTURE2D glextFramebufferTexture2D;
+extern GLEXT_FRAMEBUFFERRENDERBUFFER glextFramebufferRenderbuffer;
+extern GLEXT_GENRENDERBUFFERS glextGenRenderbuffers;
+extern GLEXT_DELETERENDERBUFFERS glextDeleteRenderbuffers;
+extern GLEXT_BINDRENDERBUFFER glextBindRenderbuffer;
+extern GLEXT_RENDERBUFFERSTORAGE glextRenderbufferStorage;
+
+#define glGenFramebuffers glextGenFramebuffers
+#define glDeleteFramebuffers glextDeleteFramebuffers
+#define glBindFramebuffer glextBindFramebuffer
+#define glCheckFramebufferStatus glextCheckFramebufferStatus
+#define glFramebufferTexture2D glextFramebufferTexture2D
+#define glFramebufferRenderbuffer glextFramebufferRenderbuffer
+#define glGenRenderbuffers glextGenRenderbuffers
+#define glDeleteRenderbuffers glextDeleteRenderbuffers
+#define glBindRenderbuffer glextBindRenderbuffer
+#define glRenderbufferStorage glextRenderbufferStorage
+
+// === OpenGL 2.0: shadery GLSL i ogólne atrybuty wierzchołków ===
+#ifndef GL_VERSION_2_0
+typedef char GLchar;
+#define GL_FRAGMENT_SHADER                0x8B30
+#define GL_VERTEX_SHADER                  0x8B31
+#define GL_COMPILE_STATUS                 0x8B81
+#define GL_LINK_STATUS                    0x8B82
+#define GL_INFO_LOG_LENGTH                0x8B84
+#endif
+
+typedef GLuint(GLEXT_APIENTRY* GLEXT_CREATESHADER)(GLenum type);
+typedef void (GLEXT_APIENTRY* GLEXT_DELETESHADER)(GLuint shader);
+typedef void (GLEXT_APIENTRY* GLEXT_SHADERSOURCE)(GLuint shader, GLsizei count, const GLchar* const* string, const GLint* length);
+typedef void (GLEXT_APIENTRY* GLEXT_COMPILESHADER)(GLuint shader);
+typedef void (GLEXT_APIENTRY* GLEXT_GETSHADERIV)(GLuint shader, GLenum pname, GLint* params);
+typedef void (GLEXT_APIENTRY* GLEXT_GETSHADERINFOLOG)(GLuint shader, GLsizei bufSize, GLsizei* length, GLchar* infoLog);
+typedef GLuint(GLEXT_APIENTRY* GLEXT_CREATEPROGRAM)();
+typedef void (GLEXT_APIENTRY* GLEXT_DELETEPROGRAM)(GLuint program);
+typedef void (GLEXT_APIENTRY* GLEXT_ATTACHSHADER)(GLuint program, GLuint shader);
+typedef void (GLEXT_APIENTRY* GLEXT_BINDATTRIBLOCATION)(GLuint program, GLuint index, const GLchar* name);
+typedef void (GLEXT_APIENTRY* GLEXT_LINKPROGRAM)(GLuint program);
+typedef void (GLEXT_APIENTRY* GLEXT_GETPROGRAMIV)(GLuint program, GLenum pname, GLint* params);
+typedef void (GLEXT_APIENTRY* GLEXT_GETPROGRAMINFOLOG)(GLuint program, GLsizei bufSize, GLsizei* length, GLchar* infoLog);
+typedef void (GLEXT_APIENTRY* GLEXT_USEPROGRAM)(GLuint program);
+typedef GLint(GLEXT_APIENTRY* GLEXT_GETUNIFORMLOCATION)(GLuint program, const GLchar* name);
+typedef void (GLEXT_APIENTRY* GLEXT_UNIFORM1I)(GLint location, GLint v0);
+typedef void (GLEXT_APIENTRY* GLEXT_UNIFORM1F)(GLint location, GLfloat v0);
+typedef void (GLEXT_APIENTRY* GLEXT_UNIFORM4FV)(GLint location, GLsizei count, const GLfloat* value);
+typedef void (GLEXT_APIENTRY* GLEXT_UNIFORMMATRIX4FV)(GLint location, GLsizei count, GLboolean transpose, const GLfloat* value);
+typedef void (GLEXT_APIENTRY* GLEXT_VERTEXATTRIBPOINTER)(GLuint index, GLint size, GLenum type, GLboolean normalized, GLsizei stride, const void* pointer);
+typedef void (GLEXT_APIENTRY* GLEXT_ENABLEVERTEXATTRIBARRAY)(GLuint index);
+typedef void (GLEXT_APIENTRY* GLEXT_DISABLEVERTEXATTRIBARRAY)(GLuint index);
+
+extern GLEXT_CREATESHADER glextCreateShader;
+extern GLEXT_DELETESHADER glextDeleteShader;
+extern GLEXT_SHADERSOURCE glextShaderSource;
+extern GLEXT_COMPILESHADER glextCompileShader;
+extern GLEXT_GETSHADERIV glextGetShaderiv;
+extern GLEXT_GETSHADERINFOLOG glextGetShaderInfoLog;
+extern GLEXT_CREATEPROGRAM glextCreateProgram;
+extern GLEXT_DELETEPROGRAM glextDeleteProgram;
+extern GLEXT_ATTACHSHADER glextAttachShader;
+extern GLEXT_BINDATTRIBLOCATION glextBindAttribLocation;
+extern GLEXT_LINKPROGRAM glextLinkProgram;
+extern GLEXT_GETPROGRAMIV glextGetProgramiv;
+extern GLEXT_GETPROGRAMINFOLOG glextGetProgramInfoLog;
+extern GLEXT_USEPROGRAM glextUseProgram;
+extern GLEXT_GETUNIFORMLOCATION glextGetUniformLocation;
+extern GLEXT_UNIFORM1I glextUniform1i;
+extern GLEXT_UNIFORM1F glextUniform1f;
+extern GLEXT_UNIFORM4FV glextUniform4fv;
+extern GLEXT_UNIFORMMATRIX4FV glextUniformMatrix4fv;
+extern GLEXT_VERTEXATTRIBPOINTER glextVertexAttribPointer;
+extern GLEXT_ENABLEVERTEXATTRIBARRAY glextEnableVertexAttribArray;
+extern GLEXT_DISABLEVERTEXATTRIBARRAY glextDisableVertexAttribArray;
+
+#define glCreateShader glextCreateShader
+#define glDeleteShader glextDeleteShader
+#define glShaderSource glextShaderSource
+#define glCompileShader glextCompileShader
+#define glGetShaderiv glextGetShaderiv
+#define glGetShaderInfoLog glextGetShaderInfoLog
+#define glCreateProgram glextCreateProgram
+#define glDeleteProgram glextDeleteProgram
+#define glAttachShader glextAttachShader
+#define glBindAttribLocation glextBindAttribLocation
+#define glLinkProgram glextLinkProgram
+#define glGetProgramiv glextGetProgramiv
+#define glGetProgramInfoLog glextGetProgramInfoLog
+#define glUseProgram glextUseProgram
+#define glGetUniformLocation glextGetUniformLocation
+#define glUniform1i glextUniform1i
+#define glUniform1f glextUniform1f
+#define glUniform4fv glextUniform4fv
+#define glUniformMatrix4fv glextUniformMatrix4fv
+#define glVertexAttribPointer glextVertexAttribPointer
+#define glEnableVertexAttribArray glextEnableVertexAttribArray
+#define glDisableVertexAttribArray glextDisableVertexAttribArray
+
+// === OpenGL 3.1/3.3 / ARB_draw_instanced + ARB_instanced_arrays: instancing ===
+typedef void (GLEXT_APIENTRY* GLEXT_DRAWELEMENTSINSTANCED)(GLenum mode, GLsizei count, GLenum type, const void* indices, GLsizei instancecount);
+typedef void (GLEXT_APIENTRY* GLEXT_VERTEXATTRIBDIVISOR)(GLuint index, GLuint divisor);
+
+extern GLEXT_DRAWELEMENTSINSTANCED glextDrawElementsInstanced;
+extern GLEXT_VERTEXATTRIBDIVISOR glextVertexAttribDivisor;
+
+#define glDrawElementsInstanced glextDrawElementsInstanced
+#define glVertexAttribDivisor glextVertexAttribDivisor
+
+/**
+ * @brief Możliwości kontekstu OpenGL wykryte przez LoadGLExtensions.
+ */
+struct GLCapabilities {
+    int versionMajor = 1;            /**< Główny numer wersji OpenGL */
+    int versionMinor = 1;            /**< Poboczny numer wersji OpenGL */
+    bool vertexBufferObjects = false; /**< Dostępne VBO/IBO (GL 1.5 / ARB_vertex_buffer_object) */
+    bool framebufferObjects = false;  /**< Dostępne FBO (GL 3.0 / EXT_framebuffer_object) */
+    bool shaders = false;             /**< Dostępne shadery GLSL (GL 2.0) */
+    bool instancing = false;          /**< Dostępne rysowanie instancji z atrybutami na instancję */
+    bool multitexture = false;        /**< Dostępne glActiveTexture (GL 1.3) */
+    bool floatTextures = false;       /**< Dostępne tekstury GL_RGBA32F (GL 3.0 / ARB_texture_float) */
+    bool depthTextures = false;       /**< Dostępne tekstury głębokości z porównaniem (GL 1.4 / ARB_shadow) */
+    bool generateMipmap = false;      /**< Dostępne GL_GENERATE_MIPMAP (GL 1.4 / SGIS_generate_mipmap) */
+    float maxAnisotropy = 1.0f;       /**< Największa anizotropia (1 – brak EXT_texture_filter_anisotropic) */
+    bool pixelBufferObjects = false;  /**< Dostępne PBO z glMapBuffer (GL 2.1 / ARB_pixel_buffer_object) */
+    bool mapBufferRange = false;      /**< Dostępne glMapBufferRange (GL 3.0 / ARB_map_buffer_range) */
+    bool syncObjects = false;         /**< Dostępne płoty glFenceSync (GL 3.2 / ARB_sync) */
+    bool bufferStorage = false;       /**< Dostępne bufory mapowane na stałe (GL 4.4 / ARB_buffer_storage) */
+};
+
+/**
+ * @brief Wczytuje wskaźniki funkcji dla bieżącego kontekstu.
+ *
+ * Musi być wywołane po glfwMakeContextCurrent.
+ * @return True jeśli kontekst jest aktywny i wersja została odczytana.
+ */
+bool LoadGLExtensions();
+
+/**
+ * @brief Zwraca możliwości wykryte przy ostatnim LoadGLExtensions.
+ */
+const GLCapabilities& GetGLCapabilities();
+
+#endif
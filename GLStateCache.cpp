@@ -0,0 +1,168 @@
+﻿#include "GLStateCache.h"
+
+#include <iostream>
+
+/// Ile różnic zgłosić na strumieniu błędów (dalsze tylko liczone)
+static const size_t MAX_REPORTED_MISMATCHES = 16;
+
+const GLenum GLStateCache::trackedCapabilities[TRACKED_CAPABILITIES] = {
+    GL_LIGHTING, GL_TEXTURE_2D, GL_DEPTH_TEST, GL_CULL_FACE, GL_NORMALIZE
+};
+
+/**
+ * @brief Suma wykonanych wywołań wszystkich kategorii.
+ */
+size_t GLStateStats::TotalIssued() const {
+    size_t total = 0;
+    for (size_t count : issued) total += count;
+    return total;
+}
+
+/**
+ * @brief Suma pominiętych wywołań wszystkich kategorii.
+ */
+size_t GLStateStats::TotalSkipped() const {
+    size_t total = 0;
+    for (size_t count : skipped) total += count;
+    return total;
+}
+
+/**
+ * @brief Konstruktor klasy GLStateCache (stan nieznany).
+ */
+GLStateCache::GLStateCache() : validation(false) {
+    Invalidate();
+}
+
+/**
+ * @brief Zapomina zapamiętany stan.
+ */
+void GLStateCache::Invalidate() {
+    for (int& state : enabled) state = STATE_UNKNOWN;
+    boundTexture = 0;
+    textureKnown = false;
+    lineWidth = -1.0f;
+    shadeModel = 0;
+}
+
+/**
+ * @brief Zamyka liczniki klatki i zeruje bieżące.
+ */
+void GLStateCache::BeginFrame() {
+    frameStats = stats;
+    stats = GLStateStats();
+}
+
+/**
+ * @brief Zwraca indeks śledzonego przełącznika lub -1.
+ */
+int GLStateCache::FindCapability(GLenum capability) const {
+    for (int i = 0; i < TRACKED_CAPABILITIES; i++) {
+        if (trackedCapabilities[i] == capability) return i;
+    }
+    return -1;
+}
+
+/**
+ * @brief Decyduje o pominięciu wywołania, którego kopia stanu nie zmieni.
+ * @param driverMatches Wynik porównania z glGet* (tylko w trybie sprawdzania).
+ * @return True jeśli wywołanie można pominąć.
+ */
+bool GLStateCache::Skip(StateCategory category, bool driverMatches) {
+    if (validation) {
+        stats.queries++;
+        if (!driverMatches) {
+            if (stats.mismatches++ < MAX_REPORTED_MISMATCHES) {
+                std::cerr << "[GLStateCache Warning] Stale " << GetCategoryName(category)
+                    << " state (changed outside the cache)" << std::endl;
+            }
+            return false;
+        }
+    }
+    stats.skipped[category]++;
+    return true;
+}
+
+/**
+ * @brief Włącza lub wyłącza przełącznik stanu.
+ */
+void GLStateCache::SetEnabled(GLenum capability, bool enable) {
+    const int index = FindCapability(capability);
+    const int value = enable ? 1 : 0;
+    if (index >= 0 && enabled[index] == value) {
+        bool matches = !validation || (glIsEnabled(capability) == GL_TRUE) == enable;
+        if (Skip(STATE_CATEGORY_ENABLE, matches)) return;
+    }
+    if (enable) glEnable(capability);
+    else glDisable(capability);
+    if (index >= 0) enabled[index] = value;
+    stats.issued[STATE_CATEGORY_ENABLE]++;
+}
+
+/**
+ * @brief Wiąże teksturę 2D z jednostką 0.
+ */
+void GLStateCache::BindTexture(GLuint texture) {
+    if (textureKnown && boundTexture == texture) {
+        bool matches = true;
+        if (validation) {
+            GLint current = 0;
+            glGetIntegerv(GL_TEXTURE_BINDING_2D, &current);
+            matches = static_cast<GLuint>(current) == texture;
+        }
+        if (Skip(STATE_CATEGORY_TEXTURE, matches)) return;
+    }
+    glBindTexture(GL_TEXTURE_2D, texture);
+    boundTexture = texture;
+    textureKnown = true;
+    stats.issued[STATE_CATEGORY_TEXTURE]++;
+}
+
+/**
+ * @brief Ustawia szerokość linii.
+ */
+void GLStateCache::LineWidth(float width) {
+    if (lineWidth == width) {
+        bool matches = true;
+        if (validation) {
+            GLfloat current = 0.0f;
+            glGetFloatv(GL_LINE_WIDTH, &current);
+            matches = current == width;
+        }
+        if (Skip(STATE_CATEGORY_LINE_WIDTH, matches)) return;
+    }
+    glLineWidth(width);
+    lineWidth = width;
+    stats.issued[STATE_CATEGORY_LINE_WIDTH]++;
+}
+
+/**
+ * @brief Ustawia model cieniowania.
+ */
+void GLStateCache::ShadeModel(GLenum mode) {
+    if (shadeModel == mode) {
+        bool matches = true;
+        if (validation) {
+            GLint current = 0;
+            glGetIntegerv(GL_SHADE_MODEL, &current);
+            matches = static_cast<GLenum>(current) == mode;
+        }
+        if (Skip(STATE_CATEGORY_SHADE_MODEL, matches)) return;
+    }
+    glShadeModel(mode);
+    shadeModel = mode;
+    stats.issued[STATE_CATEGORY_SHADE_MODEL]++;
+}
+
+/**
+ * @brief Nazwa kategorii do wypisywania liczników.
+ */
+const char* GLStateCache::GetCategoryName(int category) {
+    switch (category) {
+    case STATE_CATEGORY_ENABLE: return "glEnable/glDisable";
+    case STATE_CATEGORY_TEXTURE: return "glBindTexture";
+    case STATE_CATEGORY_LINE_WIDTH: return "glLineWidth";
+    case STATE_CATEGORY_SHADE_MODEL: return "glShadeModel";
+    default: return "?";
+    }
+}
@@ -0,0 +1,117 @@
+﻿#pragma once
+#ifndef GL_STATE_CACHE_H
+#define GL_STATE_CACHE_H
+
+#include <GLFW/glfw3.h>
+
+#include <cstddef>
+
+/**
+ * @brief Rodzaje wywołań zmieniających stan (do liczników).
+ */
+enum StateCategory {
+    STATE_CATEGORY_ENABLE = 0,   /**< glEnable / glDisable */
+    STATE_CATEGORY_TEXTURE,      /**< glBindTexture (jednostka 0) */
+    STATE_CATEGORY_LINE_WIDTH,   /**< glLineWidth */
+    STATE_CATEGORY_SHADE_MODEL,  /**< glShadeModel */
+    STATE_CATEGORY_COUNT
+};
+
+/**
+ * @brief Liczniki wywołań stanu w jednej klatce.
+ */
+struct GLStateStats {
+    size_t issued[STATE_CATEGORY_COUNT] = {};   /**< Wywołania przekazane do sterownika */
+    size_t skipped[STATE_CATEGORY_COUNT] = {};  /**< Wywołania pominięte (stan już ustawiony) */
+    size_t queries = 0;     /**< Zapytania glGet* trybu sprawdzania */
+    size_t mismatches = 0;  /**< Różnice kopii stanu i sterownika wykryte przy sprawdzaniu */
+
+    size_t TotalIssued() const;
+    size_t TotalSkipped() const;
+};
+
+/**
+ * @brief Kopia stanu GL po stronie CPU pomijająca wywołania bez efektu.
+ *
+ * Śledzi glEnable/glDisable wybranych przełączników (GL_LIGHTING,
+ * GL_TEXTURE_2D, GL_DEPTH_TEST, GL_CULL_FACE, GL_NORMALIZE), teksturę
+ * związaną z jednostką 0, szerokość linii i model cieniowania. Pozostałe
+ * przełączniki przechodzą bez zmian do sterownika (liczone jako wykonane).
+ *
+ * Kod zmieniający ten stan bezpośrednio (np. ShadowMap, wysyłanie tekstur)
+ * musi być zakończony Invalidate – po nim stan jest nieznany i pierwsze
+ * wywołanie każdego rodzaju trafia do sterownika. W trybie sprawdzania
+ * każde pominięcie porównywane jest z glGet*; różnica jest zgłaszana,
+ * a wywołanie wykonywane.
+ */
+class GLStateCache {
+public:
+    GLStateCache();
+
+    GLStateCache(const GLStateCache&) = delete;
+    GLStateCache& operator=(const GLStateCache&) = delete;
+
+    /**
+     * @brief Zapomina zapamiętany stan (po kodzie zmieniającym go bezpośrednio).
+     */
+    void Invalidate();
+
+    /**
+     * @brief Zamyka liczniki klatki (dostępne przez GetFrameStats) i zeruje bieżące.
+     */
+    void BeginFrame();
+
+    /**
+     * @brief Włącza lub wyłącza przełącznik stanu.
+     */
+    void SetEnabled(GLenum capability, bool enabled);
+
+    /**
+     * @brief Wiąże teksturę 2D z jednostką 0.
+     */
+    void BindTexture(GLuint texture);
+
+    /**
+     * @brief Ustawia szerokość linii.
+     */
+    void LineWidth(float width);
+
+    /**
+     * @brief Ustawia model cieniowania (GL_SMOOTH / GL_FLAT).
+     */
+    void ShadeModel(GLenum mode);
+
+    /**
+     * @brief Włącza porównywanie pominięć ze stanem sterownika (glGet*).
+     */
+    void SetValidation(bool enabled) { validation = enabled; }
+    bool IsValidating() const { return validation; }
+
+    const GLStateStats& GetStats() const { return stats; }
+    const GLStateStats& GetFrameStats() const { return frameStats; }
+
+    /**
+     * @brief Nazwa kategorii do wypisywania liczników.
+     */
+    static const char* GetCategoryName(int category);
+
+private:
+    enum { STATE_UNKNOWN = -1 };
+    enum { TRACKED_CAPABILITIES = 5 };
+
+    int FindCapability(GLenum capability) const;
+    bool Skip(StateCategory category, bool driverMatches);
+
+    static const GLenum trackedCapabilities[TRACKED_CAPABILITIES]; /**< Śledzone przełączniki */
+    int enabled[TRACKED_CAPABILITIES]; /**< Stan przełączników (0/1, STATE_UNKNOWN) */
+    GLuint boundTexture;    /**< Tekstura związana z jednostką 0 */
+    bool textureKnown;      /**< Czy boundTexture jest aktualne */
+    float lineWidth;        /**< Szerokość linii (< 0 – nieznana) */
+    GLenum shadeModel;      /**< Model cieniowania (0 – nieznany) */
+
+    bool validation;          /**< Tryb sprawdzania glGet* */
+    GLStateStats stats;       /**< Liczniki od ostatniego BeginFrame */
+    GLStateStats frameStats;  /**< Liczniki poprzedniej klatki */
+};
+
+#endif
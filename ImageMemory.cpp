@@ -0,0 +1,380 @@
+﻿#include "ImageMemory.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+
+static const size_t SCRATCH_ALIGNMENT = 16;
+static const size_t SCRATCH_FIRST_CHUNK = 1024 * 1024;
+static const size_t SCRATCH_RETAIN_LIMIT = 64u * 1024 * 1024; /**< Największa arena trzymana między wczytaniami */
+
+static std::mutex statsMutex;
+static ImageMemoryStats scratchStats;  /**< Liczniki aren (pole output uzupełnia GetImageMemoryStats) */
+static std::atomic<bool> scratchEnabled(true);
+static std::atomic<ImageAllocator*> currentAllocator(nullptr);
+
+/**
+ * @brief Liczy przydział ze sterty wykonany na potrzeby dekodowania.
+ */
+static void CountScratchHeapAllocation() {
+    std::lock_guard<std::mutex> lock(statsMutex);
+    scratchStats.scratchHeapAllocations++;
+}
+
+// === HeapImageAllocator ===
+
+void* HeapImageAllocator::Allocate(size_t size) {
+    void* block = malloc(size);
+    if (!block) return nullptr;
+    std::lock_guard<std::mutex> lock(mutex);
+    stats.allocations++;
+    stats.heapAllocations++;
+    stats.bytesInUse += size;
+    stats.peakBytesInUse = std::max(stats.peakBytesInUse, stats.bytesInUse);
+    return block;
+}
+
+void HeapImageAllocator::Free(void* block, size_t size) {
+    if (!block) return;
+    free(block);
+    std::lock_guard<std::mutex> lock(mutex);
+    stats.bytesInUse -= size;
+}
+
+ImageAllocatorStats HeapImageAllocator::GetStats() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return stats;
+}
+
+// === PooledImageAllocator ===
+
+/**
+ * @brief Konstruktor klasy PooledImageAllocator.
+ */
+PooledImageAllocator::PooledImageAllocator(size_t cacheLimit)
+    : freeLists(ClassFor(MAX_CLASS_SIZE) + 1), cacheLimit(cacheLimit) {
+}
+
+/**
+ * @brief Destruktor – zwalnia bufory trzymane w puli.
+ */
+PooledImageAllocator::~PooledImageAllocator() {
+    Trim();
+}
+
+/**
+ * @brief Klasa rozmiaru: 0 dla MIN_CLASS_SIZE, dalej 4 klasy na potęgę dwójki (-1: poza pulą).
+ */
+int PooledImageAllocator::ClassFor(size_t size) {
+    if (size <= MIN_CLASS_SIZE) return 0;
+    if (size > MAX_CLASS_SIZE) return -1;
+    int power = 0;
+    while ((size - 1) >> (power + 1)) power++;
+    const size_t step = size_t(1) << (power - 2);
+    const size_t quarter = (size - (size_t(1) << power) + step - 1) / step;
+    return (power - 12) * 4 + static_cast<int>(quarter);
+}
+
+/**
+ * @brief Rozmiar bufora klasy.
+ */
+size_t PooledImageAllocator::ClassSize(int sizeClass) {
+    if (sizeClass == 0) return MIN_CLASS_SIZE;
+    const int power = 12 + (sizeClass - 1) / 4;
+    const size_t quarter = (sizeClass - 1) % 4 + 1;
+    return (size_t(1) << power) + quarter * (size_t(1) << (power - 2));
+}
+
+void* PooledImageAllocator::Allocate(size_t size) {
+    const int sizeClass = ClassFor(size);
+    const size_t blockSize = sizeClass < 0 ? size : ClassSize(sizeClass);
+    void* block = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (sizeClass >= 0 && !freeLists[sizeClass].empty()) {
+            block = freeLists[sizeClass].back();
+            freeLists[sizeClass].pop_back();
+            stats.cachedBytes -= blockSize;
+        }
+    }
+    const bool fromHeap = block == nullptr;
+    if (fromHeap) {
+        block = malloc(blockSize);
+        if (!block) return nullptr;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    stats.allocations++;
+    if (fromHeap) stats.heapAllocations++;
+    stats.bytesInUse += blockSize;
+    stats.peakBytesInUse = std::max(stats.peakBytesInUse, stats.bytesInUse);
+    return block;
+}
+
+void PooledImageAllocator::Free(void* block, size_t size) {
+    if (!block) return;
+    const int sizeClass = ClassFor(size);
+    const size_t blockSize = sizeClass < 0 ? size : ClassSize(sizeClass);
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stats.bytesInUse -= blockSize;
+        if (sizeClass >= 0 && stats.cachedBytes + blockSize <= cacheLimit) {
+            freeLists[sizeClass].push_back(block);
+            stats.cachedBytes += blockSize;
+            return;
+        }
+    }
+    free(block);
+}
+
+ImageAllocatorStats PooledImageAllocator::GetStats() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return stats;
+}
+
+/**
+ * @brief Oddaje do sterty wszystkie bufory trzymane w puli.
+ */
+void PooledImageAllocator::Trim() {
+    std::lock_guard<std::mutex> lock(mutex);
+    for (std::vector<void*>& list : freeLists) {
+        for (void* block : list) free(block);
+        list.clear();
+    }
+    stats.cachedBytes = 0;
+}
+
+/**
+ * @brief Ustawia przydział buforów wyniku (nullptr: domyślna pula).
+ */
+void SetImageAllocator(ImageAllocator* allocator) {
+    currentAllocator = allocator;
+}
+
+ImageAllocator& GetImageAllocator() {
+    static PooledImageAllocator defaultAllocator;
+    ImageAllocator* allocator = currentAllocator;
+    return allocator ? *allocator : defaultAllocator;
+}
+
+// === Arena wątku ===
+
+/**
+ * @brief Arena z przesuwanym wskaźnikiem dla buforów tymczasowych jednego wątku.
+ *
+ * Zwolnienie cofa wskaźnik tylko dla ostatniego bloku (typowe dla stb_image),
+ * pozostałe bloki znikają przy Reset.
+ */
+class ScratchArena {
+public:
+    ScratchArena() : used(0), peak(0), capacity(0), last(nullptr), lastSize(0) {}
+    ~ScratchArena() { Release(); }
+
+    void* Allocate(size_t size) {
+        const size_t aligned = Align(size);
+        if (chunks.empty() || chunks.back().used + aligned > chunks.back().size) {
+            if (!AddChunk(aligned)) return nullptr;
+        }
+        Chunk& chunk = chunks.back();
+        void* block = chunk.memory + chunk.used;
+        chunk.used += aligned;
+        Grow(aligned);
+        last = block;
+        lastSize = aligned;
+        return block;
+    }
+
+    void* Reallocate(void* block, size_t oldSize, size_t newSize) {
+        if (block == last) {
+            // Ostatni blok rośnie w miejscu, jeśli mieści się w bloku areny
+            Chunk& chunk = chunks.back();
+            const size_t offset = static_cast<unsigned char*>(block) - chunk.memory;
+            const size_t aligned = Align(newSize);
+            if (offset + aligned <= chunk.size) {
+                chunk.used = offset + aligned;
+                used -= lastSize;
+                Grow(aligned);
+                lastSize = aligned;
+                return block;
+            }
+        }
+        void* grown = Allocate(newSize);
+        if (grown) memcpy(grown, block, std::min(oldSize, newSize));
+        return grown;
+    }
+
+    void Free(void* block) {
+        if (!block || block != last) return;
+        chunks.back().used -= lastSize;
+        used -= lastSize;
+        last = nullptr;
+    }
+
+    bool Owns(const void* block) const {
+        const unsigned char* pointer = static_cast<const unsigned char*>(block);
+        for (const Chunk& chunk : chunks) {
+            if (pointer >= chunk.memory && pointer < chunk.memory + chunk.size) return true;
+        }
+        return false;
+    }
+
+    /**
+     * @brief Zwalnia wszystkie bloki; kilka bloków areny łączy w jeden (do limitu).
+     */
+    void Reset() {
+        const size_t retained = std::min(capacity, SCRATCH_RETAIN_LIMIT);
+        if (chunks.size() > 1 || capacity > retained) {
+            Release();
+            AddChunk(retained);
+        }
+        for (Chunk& chunk : chunks) chunk.used = 0;
+        used = 0;
+        last = nullptr;
+    }
+
+    void ResetPeak() { peak = used; }
+    size_t GetPeak() const { return peak; }
+
+private:
+    struct Chunk {
+        unsigned char* memory;
+        size_t size;
+        size_t used;
+    };
+
+    static size_t Align(size_t size) { return (size + SCRATCH_ALIGNMENT - 1) / SCRATCH_ALIGNMENT * SCRATCH_ALIGNMENT; }
+
+    void Grow(size_t bytes) {
+        used += bytes;
+        peak = std::max(peak, used);
+    }
+
+    bool AddChunk(size_t minimum) {
+        // Podwajanie: kolejny blok co najmniej tak duży jak wszystkie dotychczasowe
+        const size_t size = std::max(minimum, std::max(SCRATCH_FIRST_CHUNK, capacity));
+        unsigned char* memory = static_cast<unsigned char*>(malloc(size));
+        if (!memory) return false;
+        chunks.push_back({ memory, size, 0 });
+        capacity += size;
+        std::lock_guard<std::mutex> lock(statsMutex);
+        scratchStats.scratchHeapAllocations++;
+        scratchStats.scratchRetained += size;
+        return true;
+    }
+
+    void Release() {
+        for (Chunk& chunk : chunks) free(chunk.memory);
+        chunks.clear();
+        {
+            std::lock_guard<std::mutex> lock(statsMutex);
+            scratchStats.scratchRetained -= capacity;
+        }
+        capacity = 0;
+        used = 0;
+        last = nullptr;
+    }
+
+    std::vector<Chunk> chunks;
+    size_t used;       /**< Zajęte bajty wszystkich bloków */
+    size_t peak;       /**< Największe zajęcie od ResetPeak */
+    size_t capacity;   /**< Rozmiar wszystkich bloków */
+    void* last;        /**< Ostatni przydzielony blok (może rosnąć / zostać cofnięty) */
+    size_t lastSize;
+};
+
+static thread_local ScratchArena threadArena;
+static thread_local int scopeDepth = 0;
+
+/**
+ * @brief Konstruktor klasy ImageScratchScope.
+ */
+ImageScratchScope::ImageScratchScope() : active(scratchEnabled) {
+    if (active && scopeDepth++ == 0) threadArena.ResetPeak();
+}
+
+/**
+ * @brief Destruktor – zapisuje szczyt zakresu i zeruje arenę.
+ */
+ImageScratchScope::~ImageScratchScope() {
+    if (!active || --scopeDepth > 0) return;
+    const size_t peak = threadArena.GetPeak();
+    {
+        std::lock_guard<std::mutex> lock(statsMutex);
+        scratchStats.loads++;
+        scratchStats.scratchPeakTotal += peak;
+        scratchStats.scratchPeakMax = std::max(scratchStats.scratchPeakMax, peak);
+    }
+    threadArena.Reset();
+}
+
+size_t ImageScratchScope::GetPeak() const {
+    return active ? threadArena.GetPeak() : 0;
+}
+
+void SetImageScratchEnabled(bool enabled) {
+    scratchEnabled = enabled;
+}
+
+// === Przydziały stb_image ===
+
+void* ImageScratchMalloc(size_t size) {
+    if (scopeDepth > 0) return threadArena.Allocate(size);
+    CountScratchHeapAllocation();
+    return malloc(size);
+}
+
+void* ImageScratchRealloc(void* block, size_t oldSize, size_t newSize) {
+    if (!block) return ImageScratchMalloc(newSize);
+    if (threadArena.Owns(block)) return threadArena.Reallocate(block, oldSize, newSize);
+    CountScratchHeapAllocation();
+    return realloc(block, newSize);
+}
+
+void ImageScratchFree(void* block) {
+    if (!block) return;
+    if (threadArena.Owns(block)) threadArena.Free(block);
+    else free(block);
+}
+
+// === Statystyki ===
+
+ImageMemoryStats GetImageMemoryStats() {
+    ImageMemoryStats stats;
+    {
+        std::lock_guard<std::mutex> lock(statsMutex);
+        stats = scratchStats;
+    }
+    stats.output = GetImageAllocator().GetStats();
+    return stats;
+}
+
+void ResetImageMemoryStats() {
+    std::lock_guard<std::mutex> lock(statsMutex);
+    const size_t retained = scratchStats.scratchRetained;
+    scratchStats = ImageMemoryStats();
+    scratchStats.scratchRetained = retained;
+}
+
+/**
+ * @brief Wypisuje szczyt i stan ustalony pamięci na wczytanie.
+ */
+void PrintImageMemoryReport() {
+    const ImageMemoryStats stats = GetImageMemoryStats();
+    const ImageAllocatorStats& output = stats.output;
+    std::cout << "Pamięć dekodowania obrazów (" << GetImageAllocator().GetName() << "): " << stats.loads
+        << " wczytań\n";
+    std::cout << std::fixed << std::setprecision(1);
+    if (stats.loads) {
+        std::cout << "  Arena stb_image: szczyt na wczytanie średnio "
+            << stats.scratchPeakTotal / 1024.0 / stats.loads << " KB, maks. " << stats.scratchPeakMax / 1024.0 << " KB\n";
+    }
+    std::cout << "  Stan ustalony: areny " << stats.scratchRetained / 1024.0 << " KB, bufory w puli "
+        << output.cachedBytes / 1024.0 << " KB | przydziały ze sterty: dekodowanie "
+        << stats.scratchHeapAllocations << ", bufory wyniku " << output.heapAllocations << " z "
+        << output.allocations << "\n";
+    std::cout << "  Bufory wyniku: w użyciu " << output.bytesInUse / 1024.0 << " KB (szczyt "
+        << output.peakBytesInUse / 1024.0 << " KB)" << std::defaultfloat << std::endl;
+}
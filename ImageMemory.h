@@ -0,0 +1,172 @@
+﻿#pragma once
+#ifndef IMAGE_MEMORY_H
+#define IMAGE_MEMORY_H
+
+#include <cstddef>
+#include <mutex>
+#include <vector>
+
+/**
+ * @file ImageMemory.h
+ * @brief Pamięć dekodowania obrazów: wymienny przydział buforów wyniku
+ *        i arena na bufory tymczasowe stb_image.
+ *
+ * stb_image przydziela przez STBI_MALLOC/STBI_REALLOC/STBI_FREE, które
+ * w BitmapHandler.cpp wskazują na ImageScratchMalloc/Realloc/Free. W obrębie
+ * ImageScratchScope bloki pochodzą z areny wątku (przesuwany wskaźnik,
+ * zwalniana w całości na końcu zakresu), a poza nim – ze sterty. Piksele
+ * wyniku są kopiowane z areny do bufora z ImageAllocator (domyślnie pula
+ * klas rozmiarów), który wraca do puli po zwolnieniu obrazu.
+ */
+
+/**
+ * @brief Liczniki przydziałów buforów wyniku.
+ */
+struct ImageAllocatorStats {
+    unsigned int allocations = 0;     /**< Wywołania Allocate */
+    unsigned int heapAllocations = 0; /**< Przydziały, które trafiły do sterty */
+    size_t bytesInUse = 0;            /**< Bajty w buforach wydanych użytkownikom */
+    size_t peakBytesInUse = 0;        /**< Największa wartość bytesInUse */
+    size_t cachedBytes = 0;           /**< Bajty zwolnionych buforów trzymanych do ponownego użycia */
+};
+
+/**
+ * @brief Interfejs przydziału buforów pikseli (wynik BitmapHandler::Load).
+ *
+ * Implementacje muszą być bezpieczne wątkowo (dekodowanie w TextureStreamer).
+ */
+class ImageAllocator {
+public:
+    virtual ~ImageAllocator() {}
+
+    /**
+     * @return Blok co najmniej size bajtów wyrównany do 16 lub nullptr.
+     */
+    virtual void* Allocate(size_t size) = 0;
+
+    /**
+     * @param size Rozmiar przekazany do Allocate.
+     */
+    virtual void Free(void* block, size_t size) = 0;
+
+    virtual ImageAllocatorStats GetStats() const = 0;
+    virtual const char* GetName() const = 0;
+};
+
+/**
+ * @brief Przydział bezpośrednio ze sterty (malloc/free) – zachowanie sprzed puli.
+ */
+class HeapImageAllocator : public ImageAllocator {
+public:
+    void* Allocate(size_t size) override;
+    void Free(void* block, size_t size) override;
+    ImageAllocatorStats GetStats() const override;
+    const char* GetName() const override { return "sterta"; }
+
+private:
+    mutable std::mutex mutex;
+    ImageAllocatorStats stats;
+};
+
+/**
+ * @brief Pula buforów w klasach rozmiarów (4 klasy na potęgę dwójki, strata do 25%).
+ *
+ * Zwolnione bufory trafiają na listę swojej klasy, dopóki pamięć trzymana
+ * w puli nie przekroczy cacheLimit; większe niż MAX_CLASS_SIZE idą do sterty.
+ */
+class PooledImageAllocator : public ImageAllocator {
+public:
+    static const size_t MIN_CLASS_SIZE = 4096;
+    static const size_t MAX_CLASS_SIZE = 256u * 1024 * 1024;
+
+    explicit PooledImageAllocator(size_t cacheLimit = 64u * 1024 * 1024);
+    ~PooledImageAllocator() override;
+
+    void* Allocate(size_t size) override;
+    void Free(void* block, size_t size) override;
+    ImageAllocatorStats GetStats() const override;
+    const char* GetName() const override { return "pula klas rozmiarów"; }
+
+    /**
+     * @brief Oddaje do sterty wszystkie bufory trzymane w puli.
+     */
+    void Trim();
+
+private:
+    static int ClassFor(size_t size);
+    static size_t ClassSize(int sizeClass);
+
+    mutable std::mutex mutex;
+    std::vector<std::vector<void*>> freeLists; /**< Wolne bufory każdej klasy */
+    size_t cacheLimit;
+    ImageAllocatorStats stats;
+};
+
+/**
+ * @brief Ustawia przydział buforów wyniku (nullptr: domyślna pula).
+ *
+ * Obrazy pamiętają przydział, z którego pochodzą, ale musi on istnieć
+ * do ich zwolnienia.
+ */
+void SetImageAllocator(ImageAllocator* allocator);
+ImageAllocator& GetImageAllocator();
+
+/**
+ * @brief Zakres dekodowania: przydziały stb_image tego wątku idą do areny.
+ *
+ * Na końcu zakresu arena jest zerowana (jeden blok o rozmiarze największego
+ * dotychczasowego dekodowania, do limitu), więc kolejne wczytania nie
+ * przydzielają pamięci.
+ */
+class ImageScratchScope {
+public:
+    ImageScratchScope();
+    ~ImageScratchScope();
+
+    ImageScratchScope(const ImageScratchScope&) = delete;
+    ImageScratchScope& operator=(const ImageScratchScope&) = delete;
+
+    /**
+     * @brief Największe zajęcie areny w tym zakresie w bajtach.
+     */
+    size_t GetPeak() const;
+
+private:
+    bool active;
+};
+
+/**
+ * @brief Włącza arenę (false: stb_image używa sterty jak wcześniej – do porównań).
+ */
+void SetImageScratchEnabled(bool enabled);
+
+// Przydziały stb_image (STBI_MALLOC, STBI_REALLOC_SIZED, STBI_FREE)
+void* ImageScratchMalloc(size_t size);
+void* ImageScratchRealloc(void* block, size_t oldSize, size_t newSize);
+void ImageScratchFree(void* block);
+
+/**
+ * @brief Pamięć dekodowania zbiorczo dla wszystkich wątków.
+ */
+struct ImageMemoryStats {
+    unsigned int loads = 0;            /**< Zakończone zakresy dekodowania */
+    size_t scratchPeakMax = 0;         /**< Największe zajęcie areny w jednym dekodowaniu */
+    size_t scratchPeakTotal = 0;       /**< Suma zajęć (średnia = / loads) */
+    size_t scratchRetained = 0;        /**< Pamięć aren trzymana między wczytaniami (wszystkie wątki) */
+    unsigned int scratchHeapAllocations = 0; /**< Bloki aren i przydziały stb poza areną */
+    ImageAllocatorStats output;        /**< Bufory wyniku (bieżący ImageAllocator) */
+};
+
+ImageMemoryStats GetImageMemoryStats();
+
+/**
+ * @brief Zeruje liczniki wczytań (pamięć trzymana zostaje).
+ */
+void ResetImageMemoryStats();
+
+/**
+ * @brief Wypisuje szczyt i stan ustalony pamięci na wczytanie.
+ */
+void PrintImageMemoryReport();
+
+#endif
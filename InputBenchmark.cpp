@@ -0,0 +1,150 @@
+﻿#include "InputBenchmark.h"
+#include "BenchmarkUtils.h"
+#include "InputSystem.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Zdarzenie klawisza o podanym czasie.
+ */
+static InputEvent KeyEvent(int key, int action, double time) {
+    InputEvent event;
+    event.type = INPUT_KEY;
+    event.code = key;
+    event.action = action;
+    event.time = time;
+    return event;
+}
+
+/**
+ * @brief Sprawdza wejście buforowane i mierzy koszt kolejki.
+ */
+int RunInputBenchmark(int events) {
+    events = std::max(events, 1);
+    std::cout << "\n=== TEST WEJŚCIA BUFOROWANEGO (" << events << " zdarzeń) ===\n";
+    bool ok = true;
+
+    // --- Kolejka: jeden producent, jeden odbiorca ---
+    {
+        InputEventQueue queue(1024);
+        const auto start = std::chrono::steady_clock::now();
+        std::thread producer([&] {
+            InputEvent event;
+            event.type = INPUT_CURSOR;
+            for (int i = 0; i < events; i++) {
+                event.code = i;
+                while (!queue.Push(event)) std::this_thread::yield();
+            }
+        });
+        int expected = 0;
+        bool ordered = true;
+        InputEvent event;
+        while (expected < events) {
+            if (!queue.Pop(event)) {
+                std::this_thread::yield();
+                continue;
+            }
+            ordered &= event.code == expected;
+            expected++;
+        }
+        producer.join();
+        const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        ok &= BenchmarkCheck("Kolejka: wszystkie zdarzenia w kolejności", ordered && !queue.Pop(event));
+        std::cout << "  Przepustowość między wątkami: " << events / seconds / 1e6 << " mln zdarzeń/s\n";
+    }
+    {
+        InputEventQueue queue(8);
+        int accepted = 0;
+        for (int i = 0; i < 20; i++) accepted += queue.Push(KeyEvent(i, InputSystem::PRESS, 1.0)) ? 1 : 0;
+        ok &= BenchmarkCheck("Pełna kolejka odrzuca zdarzenia bez czekania", accepted == 8 && queue.GetDropped() == 12);
+    }
+
+    // --- Akcje ---
+    {
+        InputSystem input;
+        input.Bind(0, 10);
+        input.Bind(0, 11);
+        input.Bind(1, 12);
+        std::vector<InputEvent> batch;
+
+        // Stuknięcie krótsze niż klatka
+        input.Push(KeyEvent(10, InputSystem::PRESS, 1.0));
+        input.Push(KeyEvent(10, InputSystem::RELEASE, 1.001));
+        const size_t received = input.Update(batch);
+        bool tap = received == 2 && batch.size() == 2 && input.IsDown(0) && input.WasPressed(0) && !input.IsDown(1);
+        batch.clear();
+        input.Update(batch);
+        tap &= !input.IsDown(0) && !input.WasPressed(0);
+        ok &= BenchmarkCheck("Stuknięcie w jednej klatce aktywuje akcję raz", tap);
+
+        // Trzymanie drugiego klawisza akcji i powtórzenia
+        input.Push(KeyEvent(11, InputSystem::PRESS, 2.0));
+        input.Update(batch);
+        bool held = input.IsDown(0) && input.WasPressed(0);
+        input.Push(KeyEvent(11, InputSystem::REPEAT, 2.5));
+        input.Update(batch);
+        held &= input.IsDown(0) && !input.WasPressed(0);
+        input.Update(batch);
+        held &= input.IsDown(0);
+        input.Push(KeyEvent(11, InputSystem::RELEASE, 3.0));
+        input.Update(batch);
+        held &= !input.IsDown(0) && !input.IsKeyDown(11);
+        ok &= BenchmarkCheck("Trzymanie klawisza i powtórzenia", held);
+
+        // Zmiana przypisań nie gubi stanu klawiszy
+        input.Push(KeyEvent(12, InputSystem::PRESS, 4.0));
+        input.Update(batch);
+        input.ClearBindings();
+        input.Bind(2, 12);
+        input.Update(batch);
+        ok &= BenchmarkCheck("Nowe przypisanie widzi trzymany klawisz", input.IsDown(2) && !input.IsDown(1));
+    }
+
+    // --- Znaczniki opóźnienia ---
+    {
+        InputSystem input;
+        std::vector<InputEvent> batch;
+        input.Push(KeyEvent(5, InputSystem::PRESS, 10.020));
+        input.Push(KeyEvent(6, InputSystem::PRESS, 10.000));
+        input.Push(KeyEvent(6, InputSystem::REPEAT, 9.0));
+        input.Update(batch);
+        const InputStamp stamp = input.TakeFrameStamp();
+        bool stamps = stamp.IsValid() && stamp.eventTime == 10.000 && !input.TakeFrameStamp().IsValid();
+        input.RecordPresent(stamp, 10.016);
+        input.RecordPresent(InputStamp(), 99.0);
+        const InputLatencyStats stats = input.GetLatencyStats();
+        stamps &= stats.samples == 1 && std::fabs(stats.meanMs - 16.0) < 1e-6 && stats.events == 3;
+        ok &= BenchmarkCheck("Opóźnienie liczone od najstarszego zdarzenia klatki", stamps);
+    }
+
+    // --- Koszt Update na klatkę ---
+    {
+        InputSystem input(4096);
+        for (int action = 0; action < 16; action++) {
+            input.Bind(action, 32 + action);
+            input.Bind(action, 64 + action);
+        }
+        std::vector<InputEvent> batch;
+        const int frames = std::max(events / 64, 1);
+        const auto start = std::chrono::steady_clock::now();
+        size_t active = 0;
+        for (int frame = 0; frame < frames; frame++) {
+            for (int i = 0; i < 64; i++) {
+                const int key = 32 + (frame * 7 + i) % 48;
+                input.Push(KeyEvent(key, (i & 1) ? InputSystem::RELEASE : InputSystem::PRESS, frame));
+            }
+            batch.clear();
+            input.Update(batch);
+            for (int action = 0; action < 16; action++) active += input.IsDown(action) ? 1 : 0;
+        }
+        const double us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / frames;
+        std::cout << "  Update (64 zdarzenia, 16 akcji): " << us << " us na klatkę (aktywne akcje: " << active << ")\n";
+    }
+
+    return BenchmarkSummary(ok);
+}
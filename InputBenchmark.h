@@ -0,0 +1,18 @@
+﻿#pragma once
+#ifndef INPUT_BENCHMARK_H
+#define INPUT_BENCHMARK_H
+
+/**
+ * @brief Test wejścia buforowanego (InputSystem).
+ *
+ * Przesyła events zdarzeń z wątku producenta przez kolejkę bez blokad
+ * i sprawdza kolejność i kompletność, odrzucanie przy pełnej kolejce,
+ * stan akcji (krótkie stuknięcie w jednej klatce, trzymanie, powtórzenia)
+ * i znaczniki opóźnienia wejście -> obraz, a następnie mierzy przepustowość
+ * kolejki i koszt Update na klatkę. Nie wymaga okna ani OpenGL.
+ * @param events Liczba zdarzeń testu przepustowości.
+ * @return 0 jeśli wszystkie sprawdzenia przeszły, 1 w przeciwnym razie.
+ */
+int RunInputBenchmark(int events);
+
+#endif
@@ -0,0 +1,205 @@
+﻿#include "InputSystem.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+
+/**
+ * @brief Konstruktor klasy InputEventQueue.
+ */
+InputEventQueue::InputEventQueue(size_t capacity) : head(0), tail(0), dropped(0) {
+    size_t size = 2;
+    while (size < capacity) size <<= 1;
+    buffer.resize(size);
+    mask = size - 1;
+}
+
+/**
+ * @brief Dodaje zdarzenie (wątek producenta).
+ */
+bool InputEventQueue::Push(const InputEvent& event) {
+    const size_t write = head.load(std::memory_order_relaxed);
+    if (write - tail.load(std::memory_order_acquire) >= buffer.size()) {
+        dropped.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    buffer[write & mask] = event;
+    head.store(write + 1, std::memory_order_release);
+    return true;
+}
+
+/**
+ * @brief Zdejmuje najstarsze zdarzenie (wątek odbiorcy).
+ */
+bool InputEventQueue::Pop(InputEvent& event) {
+    const size_t read = tail.load(std::memory_order_relaxed);
+    if (read == head.load(std::memory_order_acquire)) return false;
+    event = buffer[read & mask];
+    tail.store(read + 1, std::memory_order_release);
+    return true;
+}
+
+/**
+ * @brief Konstruktor klasy InputSystem.
+ */
+InputSystem::InputSystem(size_t capacity, size_t historySize)
+    : queue(capacity), keyDown(KEY_COUNT, 0), keyPressed(KEY_COUNT, 0), consumed(0),
+    latencyHistory(historySize > 0 ? historySize : 1, 0.0), queuedHistory(latencyHistory.size(), 0.0),
+    historyNext(0), historyCount(0) {
+}
+
+/**
+ * @brief Bieżący czas zegara steady w sekundach.
+ */
+double InputSystem::Now() {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/**
+ * @brief Dodaje zdarzenie do kolejki.
+ */
+bool InputSystem::Push(const InputEvent& event) {
+    return queue.Push(event);
+}
+
+/**
+ * @brief Przypisuje klawisz do akcji.
+ */
+void InputSystem::Bind(int action, int key) {
+    if (action < 0 || key < 0 || key >= KEY_COUNT) return;
+    if (static_cast<size_t>(action) >= actions.size()) actions.resize(action + 1);
+    actions[action].keys.push_back(key);
+}
+
+/**
+ * @brief Usuwa przypisania klawiszy (stan klawiszy zostaje).
+ */
+void InputSystem::ClearBindings() {
+    for (ActionState& state : actions) {
+        state.keys.clear();
+        state.down = false;
+        state.pressed = false;
+    }
+}
+
+/**
+ * @brief Odbiera zdarzenia jednym przebiegiem i wylicza stan akcji.
+ */
+size_t InputSystem::Update(std::vector<InputEvent>& events) {
+    std::fill(keyPressed.begin(), keyPressed.end(), 0);
+
+    const double now = Now();
+    size_t count = 0;
+    InputEvent event;
+    while (queue.Pop(event)) {
+        count++;
+        if (event.type == INPUT_KEY && event.code >= 0 && event.code < KEY_COUNT) {
+            if (event.action == PRESS) {
+                keyDown[event.code] = 1;
+                keyPressed[event.code] = 1;
+            }
+            else if (event.action == RELEASE) {
+                keyDown[event.code] = 0;
+            }
+        }
+        // Powtórzenia klawisza nie zmieniają stanu – nie liczą się do opóźnienia
+        if (event.action != REPEAT && (!pendingStamp.IsValid() || event.time < pendingStamp.eventTime)) {
+            pendingStamp.eventTime = event.time;
+            pendingStamp.consumeTime = now;
+        }
+        events.push_back(event);
+    }
+    consumed += count;
+
+    for (ActionState& state : actions) {
+        state.down = false;
+        state.pressed = false;
+        for (int key : state.keys) {
+            state.down |= keyDown[key] != 0 || keyPressed[key] != 0;
+            state.pressed |= keyPressed[key] != 0;
+        }
+    }
+    return count;
+}
+
+bool InputSystem::IsDown(int action) const {
+    return action >= 0 && static_cast<size_t>(action) < actions.size() && actions[action].down;
+}
+
+bool InputSystem::WasPressed(int action) const {
+    return action >= 0 && static_cast<size_t>(action) < actions.size() && actions[action].pressed;
+}
+
+bool InputSystem::IsKeyDown(int key) const {
+    return key >= 0 && key < KEY_COUNT && keyDown[key] != 0;
+}
+
+/**
+ * @brief Zwraca znaczniki najstarszego zdarzenia od poprzedniego wywołania.
+ */
+InputStamp InputSystem::TakeFrameStamp() {
+    InputStamp stamp = pendingStamp;
+    pendingStamp = InputStamp();
+    return stamp;
+}
+
+/**
+ * @brief Zapisuje opóźnienie wejście -> obraz.
+ */
+void InputSystem::RecordPresent(const InputStamp& stamp, double presentTime) {
+    if (!stamp.IsValid()) return;
+    std::lock_guard<std::mutex> lock(latencyMutex);
+    latencyHistory[historyNext] = presentTime - stamp.eventTime;
+    queuedHistory[historyNext] = stamp.consumeTime - stamp.eventTime;
+    historyNext = (historyNext + 1) % latencyHistory.size();
+    if (historyCount < latencyHistory.size()) historyCount++;
+}
+
+/**
+ * @brief Zwraca statystyki opóźnienia z ostatnich klatek z wejściem.
+ */
+InputLatencyStats InputSystem::GetLatencyStats() const {
+    InputLatencyStats stats;
+    stats.events = consumed;
+    stats.dropped = queue.GetDropped();
+
+    std::lock_guard<std::mutex> lock(latencyMutex);
+    stats.samples = historyCount;
+    if (historyCount == 0) return stats;
+
+    std::vector<double> samples(latencyHistory.begin(), latencyHistory.begin() + historyCount);
+    double sum = 0.0, queued = 0.0;
+    for (size_t i = 0; i < historyCount; i++) {
+        sum += samples[i];
+        queued += queuedHistory[i];
+    }
+    std::sort(samples.begin(), samples.end());
+    const size_t p99Index = std::min(samples.size() - 1, (size_t)std::ceil(samples.size() * 0.99) - 1);
+
+    stats.meanMs = sum / historyCount * 1000.0;
+    stats.p99Ms = samples[p99Index] * 1000.0;
+    stats.maxMs = samples.back() * 1000.0;
+    stats.queuedMs = queued / historyCount * 1000.0;
+    return stats;
+}
+
+/**
+ * @brief Zeruje historię opóźnień.
+ */
+void InputSystem::ResetLatencyStats() {
+    std::lock_guard<std::mutex> lock(latencyMutex);
+    historyNext = 0;
+    historyCount = 0;
+}
+
+/**
+ * @brief Wypisuje opóźnienie wejście -> obraz i liczniki kolejki.
+ */
+void InputSystem::PrintStats() const {
+    const InputLatencyStats stats = GetLatencyStats();
+    std::cout << "Wejście -> obraz (ostatnie " << stats.samples << " klatek z wejściem): średnio " << stats.meanMs
+        << " ms, p99 " << stats.p99Ms << " ms, max " << stats.maxMs << " ms (w kolejce zdarzeń: " << stats.queuedMs << " ms)\n";
+    std::cout << "  Zdarzenia wejścia: " << stats.events << ", odrzucone (pełna kolejka " << queue.GetCapacity()
+        << "): " << stats.dropped << std::endl;
+}
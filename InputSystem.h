@@ -0,0 +1,194 @@
+﻿#pragma once
+#ifndef INPUT_SYSTEM_H
+#define INPUT_SYSTEM_H
+
+#include <atomic>
+#include <cstddef>
+#include <mutex>
+#include <vector>
+
+/**
+ * @brief Rodzaj zdarzenia wejścia.
+ */
+enum InputEventType {
+    INPUT_KEY,            /**< Klawisz (code: klawisz GLFW) */
+    INPUT_MOUSE_BUTTON,   /**< Przycisk myszy (code: przycisk GLFW) */
+    INPUT_CURSOR,         /**< Ruch kursora (x, y: położenie) */
+    INPUT_SCROLL          /**< Kółko myszy (x, y: przesunięcie) */
+};
+
+/**
+ * @brief Zdarzenie wejścia ze znacznikiem czasu.
+ */
+struct InputEvent {
+    InputEventType type = INPUT_KEY;
+    int code = 0;         /**< Klawisz lub przycisk */
+    int action = 0;       /**< InputSystem::PRESS / RELEASE / REPEAT (wartości GLFW) */
+    double x = 0.0, y = 0.0;
+    double time = 0.0;    /**< Chwila zdarzenia [s, InputSystem::Now] */
+};
+
+/**
+ * @brief Kolejka zdarzeń bez blokad dla jednego producenta i jednego odbiorcy.
+ *
+ * Pierścień o pojemności będącej potęgą dwójki; producent przesuwa tylko
+ * head, odbiorca tylko tail. Przy pełnej kolejce zdarzenie jest odrzucane
+ * (licznik GetDropped) – callback okna nigdy nie czeka.
+ */
+class InputEventQueue {
+public:
+    explicit InputEventQueue(size_t capacity = 1024);
+
+    InputEventQueue(const InputEventQueue&) = delete;
+    InputEventQueue& operator=(const InputEventQueue&) = delete;
+
+    /**
+     * @brief Dodaje zdarzenie (wątek producenta).
+     * @return False, gdy kolejka jest pełna.
+     */
+    bool Push(const InputEvent& event);
+
+    /**
+     * @brief Zdejmuje najstarsze zdarzenie (wątek odbiorcy).
+     */
+    bool Pop(InputEvent& event);
+
+    size_t GetCapacity() const { return buffer.size(); }
+    size_t GetDropped() const { return dropped.load(std::memory_order_relaxed); }
+
+private:
+    std::vector<InputEvent> buffer;
+    size_t mask;
+    std::atomic<size_t> head;     /**< Następny zapis (producent) */
+    std::atomic<size_t> tail;     /**< Następny odczyt (odbiorca) */
+    std::atomic<size_t> dropped;
+};
+
+/**
+ * @brief Znaczniki najstarszego wejścia widocznego w klatce.
+ */
+struct InputStamp {
+    double eventTime = 0.0;    /**< Chwila najstarszego zdarzenia klatki (0: brak wejścia) */
+    double consumeTime = 0.0;  /**< Chwila odebrania zdarzeń z kolejki */
+
+    bool IsValid() const { return eventTime > 0.0; }
+};
+
+/**
+ * @brief Opóźnienie wejście -> obraz z ostatnich klatek z wejściem.
+ */
+struct InputLatencyStats {
+    size_t samples = 0;        /**< Klatki z wejściem w historii */
+    double meanMs = 0.0;       /**< Od zdarzenia do zamiany buforów */
+    double p99Ms = 0.0;
+    double maxMs = 0.0;
+    double queuedMs = 0.0;     /**< Średnio od zdarzenia do odebrania z kolejki */
+    size_t events = 0;         /**< Odebrane zdarzenia (łącznie) */
+    size_t dropped = 0;        /**< Zdarzenia odrzucone przy pełnej kolejce */
+};
+
+/**
+ * @brief Wejście buforowane: kolejka zdarzeń, mapowanie akcji i pomiar opóźnienia.
+ *
+ * Callbacki okna tylko dopisują zdarzenia ze znacznikiem czasu do kolejki.
+ * Update odbiera całą kolejkę jednym przebiegiem na klatkę symulacji:
+ * aktualizuje stan klawiszy, wylicza stan akcji z przypisanych klawiszy
+ * i przekazuje zdarzenia do obsługi (np. klawisze poleceń). Akcja jest
+ * aktywna także wtedy, gdy klawisz wciśnięto i puszczono w jednej
+ * klatce – krótkie stuknięcie nie ginie między odczytami.
+ *
+ * TakeFrameStamp zwraca chwilę najstarszego zdarzenia odebranego od
+ * poprzedniego wywołania; RecordPresent (wołane po zamianie buforów,
+ * także z wątku renderowania) zapisuje opóźnienie wejście -> obraz.
+ * Czas wyświetlania przez monitor (do jednego odświeżenia) nie jest
+ * w pomiarze ujęty.
+ */
+class InputSystem {
+public:
+    static const int KEY_COUNT = 512;
+    static const int RELEASE = 0;
+    static const int PRESS = 1;
+    static const int REPEAT = 2;
+
+    /**
+     * @param capacity Pojemność kolejki zdarzeń (zaokrąglana do potęgi dwójki).
+     * @param historySize Liczba klatek przechowywanych do statystyk opóźnienia.
+     */
+    explicit InputSystem(size_t capacity = 1024, size_t historySize = 240);
+
+    InputSystem(const InputSystem&) = delete;
+    InputSystem& operator=(const InputSystem&) = delete;
+
+    /**
+     * @brief Bieżący czas zegara steady w sekundach (znaczniki zdarzeń i pomiary).
+     */
+    static double Now();
+
+    /**
+     * @brief Dodaje zdarzenie do kolejki (callback okna, bez blokad).
+     */
+    bool Push(const InputEvent& event);
+
+    /**
+     * @brief Przypisuje klawisz do akcji (jedna akcja może mieć wiele klawiszy).
+     */
+    void Bind(int action, int key);
+    void ClearBindings();
+
+    /**
+     * @brief Odbiera zdarzenia, aktualizuje stan klawiszy i akcji.
+     * @param events Odebrane zdarzenia (dopisywane w kolejności nadejścia).
+     * @return Liczba odebranych zdarzeń.
+     */
+    size_t Update(std::vector<InputEvent>& events);
+
+    /// Akcja aktywna w tej klatce (klawisz trzymany lub wciśnięty od poprzedniego Update)
+    bool IsDown(int action) const;
+    /// Akcja wciśnięta od poprzedniego Update
+    bool WasPressed(int action) const;
+    bool IsKeyDown(int key) const;
+
+    /**
+     * @brief Zwraca znaczniki najstarszego zdarzenia od poprzedniego wywołania i je zeruje.
+     */
+    InputStamp TakeFrameStamp();
+
+    /**
+     * @brief Zapisuje opóźnienie klatki, która pokazała wejście stamp (dowolny wątek).
+     */
+    void RecordPresent(const InputStamp& stamp, double presentTime);
+
+    InputLatencyStats GetLatencyStats() const;
+    void ResetLatencyStats();
+
+    /**
+     * @brief Wypisuje opóźnienie wejście -> obraz i liczniki kolejki.
+     */
+    void PrintStats() const;
+
+private:
+    /**
+     * @brief Stan akcji po ostatnim Update.
+     */
+    struct ActionState {
+        std::vector<int> keys;    /**< Przypisane klawisze */
+        bool down = false;
+        bool pressed = false;
+    };
+
+    InputEventQueue queue;
+    std::vector<unsigned char> keyDown;     /**< Klawisze trzymane */
+    std::vector<unsigned char> keyPressed;  /**< Klawisze wciśnięte od poprzedniego Update */
+    std::vector<ActionState> actions;
+    InputStamp pendingStamp;                /**< Najstarsze zdarzenie jeszcze niepokazane */
+    size_t consumed;
+
+    // Historia opóźnień (zapisywana także z wątku renderowania)
+    mutable std::mutex latencyMutex;
+    std::vector<double> latencyHistory;     /**< Bufor cykliczny [s] */
+    std::vector<double> queuedHistory;      /**< Czas w kolejce [s] */
+    size_t historyNext;
+    size_t historyCount;
+};
+
+#endif
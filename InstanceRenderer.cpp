@@ -0,0 +1,253 @@
+﻿#include "InstanceRenderer.h"
+
+#include <cstddef>
+#include <iostream>
+
+/**
+ * @brief Zwraca nazwę ścieżki rysowania.
+ */
+const char* GetInstancePathName(InstancePath path) {
+    switch (path) {
+    case INSTANCE_PATH_HARDWARE: return "instancing sprzętowy";
+    case INSTANCE_PATH_MERGED: return "siatka scalona (CPU)";
+    case INSTANCE_PATH_PER_OBJECT: return "osobno dla każdego obiektu";
+    default: return "?";
+    }
+}
+
+// === InstanceBatch ===
+
+/**
+ * @brief Konstruktor klasy InstanceBatch.
+ */
+InstanceBatch::InstanceBatch(const Mesh* mesh, GLenum usage)
+    : mesh(mesh), instanceVbo(0), usage(usage), instancesDirty(true), mergedDirty(true) {
+}
+
+/**
+ * @brief Destruktor klasy InstanceBatch.
+ */
+InstanceBatch::~InstanceBatch() {
+    ReleaseGPU();
+}
+
+/**
+ * @brief Zmienia siatkę partii.
+ */
+void InstanceBatch::SetMesh(const Mesh* mesh) {
+    if (this->mesh == mesh) return;
+    this->mesh = mesh;
+    mergedDirty = true;
+}
+
+/**
+ * @brief Usuwa wszystkie instancje.
+ */
+void InstanceBatch::Clear() {
+    instances.clear();
+    instancesDirty = true;
+    mergedDirty = true;
+}
+
+/**
+ * @brief Rezerwuje miejsce na podaną liczbę instancji.
+ */
+void InstanceBatch::Reserve(size_t count) {
+    instances.reserve(count);
+}
+
+/**
+ * @brief Dodaje instancję.
+ */
+void InstanceBatch::Add(float x, float y, float z, float scale, const float color[4]) {
+    InstanceData instance = { { x, y, z, scale }, { color[0], color[1], color[2], color[3] } };
+    instances.push_back(instance);
+    instancesDirty = true;
+    mergedDirty = true;
+}
+
+/**
+ * @brief Zwalnia bufory GPU partii.
+ */
+void InstanceBatch::ReleaseGPU() {
+    if (instanceVbo) glDeleteBuffers(1, &instanceVbo);
+    instanceVbo = 0;
+    instancesDirty = true;
+    merged.reset();
+    mergedDirty = true;
+}
+
+/**
+ * @brief Wysyła dane instancji do bufora GPU, jeśli się zmieniły.
+ */
+bool InstanceBatch::UploadInstances() {
+    if (!instancesDirty && instanceVbo) return true;
+    if (!GetGLCapabilities().vertexBufferObjects) return false;
+
+    if (!instanceVbo) glGenBuffers(1, &instanceVbo);
+    glBindBuffer(GL_ARRAY_BUFFER, instanceVbo);
+    glBufferData(GL_ARRAY_BUFFER, instances.size() * sizeof(InstanceData), instances.data(), usage);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    instancesDirty = false;
+    return true;
+}
+
+/**
+ * @brief Buduje siatkę zawierającą wszystkie instancje (przekształcone na CPU).
+ */
+const Mesh* InstanceBatch::BuildMerged() {
+    if (!mergedDirty && merged) return merged.get();
+    mergedDirty = false;
+    merged.reset();
+    if (!mesh || instances.empty()) return nullptr;
+
+    const std::vector<MeshVertex>& sourceVertices = mesh->GetVertices();
+    const std::vector<unsigned int>& sourceIndices = mesh->GetIndices();
+    const size_t vertexCount = sourceVertices.size();
+
+    merged.reset(new Mesh(mesh->GetPrimitive()));
+    for (const InstanceData& instance : instances) {
+        const float* t = instance.offsetScale;
+        const float* c = instance.color;
+        unsigned int base = static_cast<unsigned int>(merged->GetVertexCount());
+        for (const MeshVertex& source : sourceVertices) {
+            MeshVertex vertex = source;
+            for (int k = 0; k < 3; k++) vertex.position[k] = source.position[k] * t[3] + t[k];
+            for (int k = 0; k < 4; k++) vertex.color[k] = source.color[k] * c[k];
+            merged->AddVertex(vertex);
+        }
+        for (size_t i = 0; i + 1 < sourceIndices.size(); ) {
+            if (mesh->GetPrimitive() == GL_LINES) {
+                merged->AddLine(base + sourceIndices[i], base + sourceIndices[i + 1]);
+                i += 2;
+            }
+            else {
+                if (i + 2 >= sourceIndices.size()) break;
+                merged->AddTriangle(base + sourceIndices[i], base + sourceIndices[i + 1], base + sourceIndices[i + 2]);
+                i += 3;
+            }
+        }
+    }
+
+    // Warianty kolorów źródła, przemnożone przez kolor instancji
+    for (int variant = 1; variant < mesh->GetColorVariantCount(); variant++) {
+        const MeshColor* sourceColors = mesh->GetColorVariant(variant);
+        std::vector<MeshColor> colors;
+        colors.reserve(vertexCount * instances.size());
+        for (const InstanceData& instance : instances) {
+            for (size_t v = 0; v < vertexCount; v++) {
+                MeshColor color;
+                for (int k = 0; k < 4; k++) color.rgba[k] = sourceColors[v].rgba[k] * instance.color[k];
+                colors.push_back(color);
+            }
+        }
+        merged->AddColorVariant(colors);
+    }
+
+    merged->Upload();
+    return merged.get();
+}
+
+// === InstanceRenderer ===
+
+/**
+ * @brief Konstruktor klasy InstanceRenderer.
+ */
+InstanceRenderer::InstanceRenderer()
+    : shader(nullptr), drawCalls(0) {
+}
+
+/**
+ * @brief Podłącza shader oświetlenia używany przez ścieżkę sprzętową.
+ */
+bool InstanceRenderer::Init(LitShader* shader) {
+    this->shader = shader;
+    return IsHardwareSupported();
+}
+
+/**
+ * @brief Odłącza shader.
+ */
+void InstanceRenderer::Release() {
+    shader = nullptr;
+}
+
+/**
+ * @brief Rysuje partię.
+ */
+InstancePath InstanceRenderer::Draw(InstanceBatch& batch, InstancePath path, int colorVariant) {
+    if (!batch.GetMesh() || batch.GetCount() == 0) return path;
+
+    if (path == INSTANCE_PATH_HARDWARE && (!IsHardwareSupported() || !shader->IsActive())) {
+        path = INSTANCE_PATH_MERGED;
+    }
+
+    switch (path) {
+    case INSTANCE_PATH_HARDWARE: DrawHardware(batch, colorVariant); break;
+    case INSTANCE_PATH_MERGED: DrawMerged(batch, colorVariant); break;
+    default: DrawPerObject(batch, colorVariant); break;
+    }
+    return path;
+}
+
+/**
+ * @brief Jedno wywołanie glDrawElementsInstanced dla całej partii.
+ */
+void InstanceRenderer::DrawHardware(InstanceBatch& batch, int colorVariant) {
+    if (!batch.UploadInstances()) {
+        DrawMerged(batch, colorVariant);
+        return;
+    }
+
+    shader->SetInstanced(true);
+
+    const GLsizei stride = sizeof(InstanceData);
+    const char* base = nullptr;
+    glBindBuffer(GL_ARRAY_BUFFER, batch.instanceVbo);
+    glVertexAttribPointer(LIT_ATTRIB_INSTANCE_OFFSET_SCALE, 4, GL_FLOAT, GL_FALSE, stride, base + offsetof(InstanceData, offsetScale));
+    glVertexAttribPointer(LIT_ATTRIB_INSTANCE_COLOR, 4, GL_FLOAT, GL_FALSE, stride, base + offsetof(InstanceData, color));
+    glEnableVertexAttribArray(LIT_ATTRIB_INSTANCE_OFFSET_SCALE);
+    glEnableVertexAttribArray(LIT_ATTRIB_INSTANCE_COLOR);
+    glVertexAttribDivisor(LIT_ATTRIB_INSTANCE_OFFSET_SCALE, 1);
+    glVertexAttribDivisor(LIT_ATTRIB_INSTANCE_COLOR, 1);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    batch.GetMesh()->DrawInstanced(static_cast<int>(batch.GetCount()), colorVariant);
+    drawCalls++;
+
+    glVertexAttribDivisor(LIT_ATTRIB_INSTANCE_OFFSET_SCALE, 0);
+    glVertexAttribDivisor(LIT_ATTRIB_INSTANCE_COLOR, 0);
+    glDisableVertexAttribArray(LIT_ATTRIB_INSTANCE_OFFSET_SCALE);
+    glDisableVertexAttribArray(LIT_ATTRIB_INSTANCE_COLOR);
+    shader->SetInstanced(false);
+}
+
+/**
+ * @brief Jedno wywołanie glDrawElements dla scalonej siatki.
+ */
+void InstanceRenderer::DrawMerged(InstanceBatch& batch, int colorVariant) {
+    const Mesh* merged = batch.BuildMerged();
+    if (!merged) return;
+    merged->Draw(colorVariant);
+    drawCalls++;
+}
+
+/**
+ * @brief Osobna transformacja i wywołanie dla każdej instancji (punkt odniesienia).
+ *
+ * Kolor instancji trafia do glColor, który przy włączonej tablicy kolorów
+ * siatki nie ma wpływu na wynik – ścieżka służy do porównań wydajności.
+ */
+void InstanceRenderer::DrawPerObject(InstanceBatch& batch, int colorVariant) {
+    const Mesh* mesh = batch.GetMesh();
+    for (const InstanceData& instance : batch.GetInstances()) {
+        const float* t = instance.offsetScale;
+        glPushMatrix();
+        glTranslatef(t[0], t[1], t[2]);
+        glScalef(t[3], t[3], t[3]);
+        glColor4fv(instance.color);
+        mesh->Draw(colorVariant);
+        glPopMatrix();
+        drawCalls++;
+    }
+}
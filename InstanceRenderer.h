@@ -0,0 +1,154 @@
+﻿#pragma once
+#ifndef INSTANCE_RENDERER_H
+#define INSTANCE_RENDERER_H
+
+#include "Mesh.h"
+#include "LitShader.h"
+
+#include <memory>
+#include <vector>
+
+/**
+ * @brief Dane jednej instancji (32 bajty, układ bufora GPU).
+ */
+struct InstanceData {
+    float offsetScale[4]; /**< Przesunięcie XYZ i skala jednorodna (W) */
+    float color[4];       /**< Kolor RGBA mnożony przez kolor wierzchołka */
+};
+
+/**
+ * @brief Sposób rysowania partii instancji.
+ */
+enum InstancePath {
+    INSTANCE_PATH_HARDWARE,    /**< glDrawElementsInstanced + atrybuty na instancję */
+    INSTANCE_PATH_MERGED,      /**< Jedna scalona siatka zbudowana na CPU */
+    INSTANCE_PATH_PER_OBJECT,  /**< glPushMatrix/glTranslatef/glScalef dla każdej instancji */
+    INSTANCE_PATH_COUNT
+};
+
+/**
+ * @brief Zwraca nazwę ścieżki rysowania.
+ */
+const char* GetInstancePathName(InstancePath path);
+
+/**
+ * @brief Partia instancji jednej siatki.
+ *
+ * Przechowuje tablicę InstanceData oraz bufory GPU obu ścieżek: bufor
+ * instancji (sprzętowy instancing) i scaloną siatkę (zastępcza ścieżka CPU).
+ * Bufory są odświeżane leniwie, tylko gdy dane instancji się zmieniły.
+ */
+class InstanceBatch {
+public:
+    /**
+     * @brief Konstruktor klasy InstanceBatch.
+     * @param mesh Siatka rysowana dla każdej instancji.
+     * @param usage Sposób użycia bufora instancji (GL_STREAM_DRAW dla danych zmienianych co klatkę).
+     */
+    explicit InstanceBatch(const Mesh* mesh = nullptr, GLenum usage = GL_STATIC_DRAW);
+    ~InstanceBatch();
+
+    InstanceBatch(const InstanceBatch&) = delete;
+    InstanceBatch& operator=(const InstanceBatch&) = delete;
+
+    /**
+     * @brief Zmienia siatkę partii (unieważnia scaloną siatkę).
+     */
+    void SetMesh(const Mesh* mesh);
+
+    /**
+     * @brief Usuwa wszystkie instancje.
+     */
+    void Clear();
+
+    /**
+     * @brief Rezerwuje miejsce na podaną liczbę instancji.
+     */
+    void Reserve(size_t count);
+
+    /**
+     * @brief Dodaje instancję.
+     */
+    void Add(float x, float y, float z, float scale, const float color[4]);
+
+    /**
+     * @brief Zwalnia bufory GPU partii.
+     */
+    void ReleaseGPU();
+
+    const Mesh* GetMesh() const { return mesh; }
+    size_t GetCount() const { return instances.size(); }
+    const std::vector<InstanceData>& GetInstances() const { return instances; }
+
+private:
+    friend class InstanceRenderer;
+
+    bool UploadInstances();
+    const Mesh* BuildMerged();
+
+    const Mesh* mesh;                    /**< Rysowana siatka */
+    std::vector<InstanceData> instances; /**< Dane instancji */
+    GLuint instanceVbo;                  /**< Bufor instancji na GPU */
+    GLenum usage;                        /**< Sposób użycia bufora instancji */
+    bool instancesDirty;                 /**< Czy bufor instancji wymaga wysłania */
+    std::unique_ptr<Mesh> merged;        /**< Scalona siatka dla ścieżki CPU */
+    bool mergedDirty;                    /**< Czy scalona siatka wymaga przebudowy */
+};
+
+/**
+ * @brief Rysuje partie instancji wybraną ścieżką.
+ *
+ * Ścieżka sprzętowa używa instancjonowanego wariantu LitShader, więc
+ * oświetlenie i materiał są takie same jak dla pozostałych obiektów sceny.
+ * Gdy rozszerzenia instancingu są niedostępne (albo LitShader nie jest
+ * aktywny), żądanie ścieżki sprzętowej jest realizowane przez siatkę scaloną.
+ */
+class InstanceRenderer {
+public:
+    InstanceRenderer();
+
+    InstanceRenderer(const InstanceRenderer&) = delete;
+    InstanceRenderer& operator=(const InstanceRenderer&) = delete;
+
+    /**
+     * @brief Podłącza shader oświetlenia używany przez ścieżkę sprzętową.
+     * @param shader Shader z wariantem LIT_INSTANCED (musi istnieć do Release).
+     * @return True jeśli ścieżka sprzętowa jest dostępna.
+     */
+    bool Init(LitShader* shader);
+
+    /**
+     * @brief Odłącza shader.
+     */
+    void Release();
+
+    /**
+     * @brief Rysuje partię.
+     *
+     * Tekstura, model widoku oraz materiał (LitShader::Begin/SetMaterial)
+     * są ustawiane przez wywołującego.
+     * @param batch Partia instancji.
+     * @param path Żądana ścieżka rysowania.
+     * @param colorVariant Wariant kolorów siatki.
+     * @return Ścieżka faktycznie użyta.
+     */
+    InstancePath Draw(InstanceBatch& batch, InstancePath path, int colorVariant);
+
+    bool IsHardwareSupported() const { return shader && shader->IsValid(LIT_INSTANCED); }
+
+    /**
+     * @brief Zwraca liczbę wywołań rysowania od ostatniego ResetDrawCalls.
+     */
+    unsigned int GetDrawCalls() const { return drawCalls; }
+    void ResetDrawCalls() { drawCalls = 0; }
+
+private:
+    void DrawHardware(InstanceBatch& batch, int colorVariant);
+    void DrawMerged(InstanceBatch& batch, int colorVariant);
+    void DrawPerObject(InstanceBatch& batch, int colorVariant);
+
+    LitShader* shader;        /**< Shader ścieżki sprzętowej */
+    unsigned int drawCalls;   /**< Licznik wywołań rysowania */
+};
+
+#endif
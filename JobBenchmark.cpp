@@ -0,0 +1,229 @@
+﻿#include "JobBenchmark.h"
+#include "BenchmarkUtils.h"
+#include "JobSystem.h"
+#include "BitmapHandler.h"
+#include "ClusteredLighting.h"
+#include "MathLib.h"
+#include "Mesh.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+/// Elementy obliczeń ParallelFor i ich fragment
+static const size_t COMPUTE_COUNT = 1 << 22;
+static const size_t COMPUTE_GRAIN = 16384;
+/// Głębokość drzewa drobnych zadań (2^depth liści)
+static const int TREE_DEPTH = 16;
+
+/**
+ * @brief Kilka rund xorshift – praca obliczeniowa bez dostępu do pamięci.
+ */
+static uint32_t Hash(uint32_t value) {
+    value += 0x9E3779B9u;
+    for (int round = 0; round < 24; round++) {
+        value ^= value << 13;
+        value ^= value >> 17;
+        value ^= value << 5;
+    }
+    return value;
+}
+
+/**
+ * @brief Suma skrótów [0, COMPUTE_COUNT) w fragmentach ParallelFor.
+ */
+static uint64_t ComputeSum(JobSystem& jobs) {
+    std::atomic<uint64_t> sum(0);
+    jobs.ParallelFor(COMPUTE_COUNT, COMPUTE_GRAIN, [&](size_t begin, size_t end) {
+        uint64_t local = 0;
+        for (size_t i = begin; i < end; i++) local += Hash(static_cast<uint32_t>(i));
+        sum += local;
+    });
+    return sum;
+}
+
+/**
+ * @brief Zadanie drzewa: do głębokości depth zleca dwa zadania potomne, liście liczą się w leaves.
+ */
+static void SpawnTree(JobSystem& jobs, JobCounter& counter, std::atomic<size_t>& leaves, int depth) {
+    if (depth == 0) {
+        leaves++;
+        return;
+    }
+    for (int child = 0; child < 2; child++) {
+        jobs.Schedule([&jobs, &counter, &leaves, depth] { SpawnTree(jobs, counter, leaves, depth - 1); }, &counter);
+    }
+}
+
+/**
+ * @brief Liczba liści drzewa zadań (2^TREE_DEPTH zadań-liści, zlecanych z wątków roboczych).
+ */
+static size_t RunTree(JobSystem& jobs) {
+    JobCounter counter;
+    std::atomic<size_t> leaves(0);
+    jobs.Schedule([&] { SpawnTree(jobs, counter, leaves, TREE_DEPTH); }, &counter);
+    jobs.Wait(counter);
+    return leaves;
+}
+
+/**
+ * @brief Losowe światła przed kamerą (jak w teście klastrów).
+ */
+static std::vector<PointLight> RandomLights(int count) {
+    auto random = []() { return (float)rand() / RAND_MAX; };
+    std::vector<PointLight> lights(count);
+    for (PointLight& light : lights) {
+        light.position[0] = random() * 80.0f - 40.0f;
+        light.position[1] = random() * 40.0f - 20.0f;
+        light.position[2] = -random() * 100.0f;
+        light.radius = 1.0f + random() * 5.0f;
+        for (int k = 0; k < 3; k++) light.color[k] = random();
+        light.intensity = 1.0f;
+    }
+    return lights;
+}
+
+/**
+ * @brief Sprawdza system zadań i mierzy skalowanie etapów silnika.
+ */
+int RunJobBenchmark(int maxThreads) {
+    if (maxThreads <= 0) maxThreads = static_cast<int>(std::thread::hardware_concurrency());
+    maxThreads = std::max(maxThreads, 1);
+    srand(12345);
+
+    std::cout << "\n=== TEST SYSTEMU ZADAŃ (1.." << maxThreads << " wątków, rdzenie: "
+        << std::thread::hardware_concurrency() << ") ===\n";
+
+    bool ok = true;
+    {
+        JobSystem jobs(maxThreads);
+
+        // --- Pokrycie zakresu ---
+        std::vector<std::atomic<int>> hits(1000003);
+        for (std::atomic<int>& hit : hits) hit = 0;
+        jobs.ParallelFor(hits.size(), 1007, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; i++) hits[i]++;
+        });
+        bool once = true;
+        for (const std::atomic<int>& hit : hits) once &= (hit == 1);
+        ok &= BenchmarkCheck("ParallelFor: każdy indeks dokładnie raz", once);
+
+        // --- Drzewo drobnych zadań ---
+        ok &= BenchmarkCheck("Drzewo zadań: wszystkie liście wykonane", RunTree(jobs) == (static_cast<size_t>(1) << TREE_DEPTH));
+
+        // --- Zależności: A -> B -> C ---
+        const int STAGE_JOBS = 64;
+        std::vector<int> a(STAGE_JOBS, 0), b(STAGE_JOBS, 0), c(STAGE_JOBS, 0);
+        JobCounter stageA, stageB, stageC;
+        // A jest wolne (uśpienie), więc B i C trafiają do list zadań odłożonych
+        for (int i = 0; i < STAGE_JOBS; i++) {
+            jobs.Schedule([&, i] { std::this_thread::sleep_for(std::chrono::microseconds(50)); a[i] = i; }, &stageA);
+        }
+        for (int i = 0; i < STAGE_JOBS; i++) {
+            jobs.Schedule([&, i] {
+                int sum = 0;
+                for (int k = 0; k < STAGE_JOBS; k++) sum += a[k];
+                b[i] = sum + i;
+            }, &stageB, &stageA);
+        }
+        for (int i = 0; i < STAGE_JOBS; i++) {
+            jobs.Schedule([&, i] { c[i] = b[i] + b[(i + 1) % STAGE_JOBS]; }, &stageC, &stageB);
+        }
+        jobs.Wait(stageC);
+        const int sumA = STAGE_JOBS * (STAGE_JOBS - 1) / 2;
+        bool ordered = stageA.IsDone() && stageB.IsDone();
+        for (int i = 0; i < STAGE_JOBS; i++) ordered &= (c[i] == 2 * sumA + i + (i + 1) % STAGE_JOBS);
+        ok &= BenchmarkCheck("Zależności: etapy A -> B -> C w kolejności", ordered);
+
+        // --- Zagnieżdżone ParallelFor ---
+        std::atomic<size_t> nested(0);
+        jobs.ParallelFor(16, 1, [&](size_t outerBegin, size_t outerEnd) {
+            for (size_t outer = outerBegin; outer < outerEnd; outer++) {
+                jobs.ParallelFor(1000, 10, [&](size_t begin, size_t end) { nested += end - begin; });
+            }
+        });
+        ok &= BenchmarkCheck("Zagnieżdżone ParallelFor bez zakleszczenia", nested == 16000);
+
+        // --- Niski priorytet ---
+        JobCounter background;
+        std::atomic<int> backgroundDone(0);
+        for (int i = 0; i < 32; i++) {
+            jobs.Schedule([&] { backgroundDone++; }, &background, nullptr, JOB_PRIORITY_LOW);
+        }
+        jobs.Wait(background);
+        ok &= BenchmarkCheck("Zadania o niskim priorytecie wykonane", backgroundDone == 32);
+        jobs.PrintStats();
+    }
+
+    // --- Skalowanie ---
+    BitmapHandler probe;
+    const bool haveImage = probe.Load("textura.jpg", true, PIXEL_FORMAT_RGBA);
+    if (!haveImage) std::cout << "  (brak textura.jpg – bez pomiaru dekodowania)\n";
+    probe.Free();
+    const std::vector<PointLight> lights = RandomLights(4096);
+    const Mat4 view = Mat4::LookAt(Vec3(0.0f, 2.0f, 5.0f), Vec3(0.0f, 0.0f, -20.0f), Vec3(0.0f, 1.0f, 0.0f));
+    const Mat4 projection = Mat4::Perspective(Radians(60.0f), 16.0f / 9.0f, 0.1f, 100.0f);
+
+    std::cout << "\n  Wątki  ParallelFor [ms]  2^" << TREE_DEPTH
+        << " zadań [ms]  kule [ms]  dekodowanie [ms]  światła [ms]  podkradzione  przyspieszenie\n";
+    uint64_t referenceSum = 0;
+    size_t referenceVertices = 0;
+    bool same = true;
+    double singleMs = 0.0;
+    for (int threads = 1;; threads = std::min(threads * 2, maxThreads)) {
+        JobSystem jobs(threads);
+        ClusteredLighting clusters(threads);
+
+        uint64_t sum = 0;
+        const double computeMs = BestMs(3, [&] { sum = ComputeSum(jobs); });
+        size_t leaves = 0;
+        const double treeMs = BestMs(3, [&] { leaves = RunTree(jobs); });
+
+        // Siatki kul jak SphereMeshCache::Prewarm (bez wysyłki do GPU)
+        std::vector<Mesh> spheres(32);
+        const double sphereMs = BestMs(3, [&] {
+            jobs.ParallelFor(spheres.size(), 1, [&](size_t begin, size_t end) {
+                for (size_t i = begin; i < end; i++) spheres[i].BuildSphere(96 + static_cast<int>(i % 4) * 16);
+            });
+        });
+        size_t vertices = 0;
+        for (const Mesh& sphere : spheres) vertices += sphere.GetVertexCount();
+
+        double decodeMs = 0.0;
+        if (haveImage) {
+            std::vector<BitmapHandler> images(16);
+            decodeMs = BestMs(2, [&] {
+                jobs.ParallelFor(images.size(), 1, [&](size_t begin, size_t end) {
+                    for (size_t i = begin; i < end; i++) images[i].Load("textura.jpg", true, PIXEL_FORMAT_RGBA);
+                });
+            });
+        }
+
+        const double lightMs = BestMs(5, [&] {
+            clusters.Build(lights.data(), lights.size(), view, projection, 0.1f, 100.0f);
+        });
+
+        if (threads == 1) {
+            referenceSum = sum;
+            referenceVertices = vertices;
+        }
+        same &= (sum == referenceSum) && (vertices == referenceVertices) && (leaves == (static_cast<size_t>(1) << TREE_DEPTH));
+
+        const double totalMs = computeMs + treeMs + sphereMs + decodeMs + lightMs;
+        if (threads == 1) singleMs = totalMs;
+        std::cout << std::fixed << std::setprecision(2) << std::setw(7) << threads << std::setw(18) << computeMs
+            << std::setw(17) << treeMs << std::setw(11) << sphereMs << std::setw(18) << decodeMs
+            << std::setw(14) << lightMs << std::setw(14) << jobs.GetStats().stolen
+            << std::setw(15) << singleMs / totalMs << "x\n" << std::defaultfloat;
+        if (threads == maxThreads) break;
+    }
+    ok &= BenchmarkCheck("Wyniki etapów niezależne od liczby wątków", same);
+
+    return BenchmarkSummary(ok);
+}
@@ -0,0 +1,19 @@
+﻿#pragma once
+#ifndef JOB_BENCHMARK_H
+#define JOB_BENCHMARK_H
+
+/**
+ * @brief Test systemu zadań (JobSystem).
+ *
+ * Sprawdza pokrycie zakresu przez ParallelFor, rekurencyjne zlecanie
+ * drobnych zadań (podkradanie), kolejność zadań zależnych od liczników,
+ * zagnieżdżone ParallelFor i zadania o niskim priorytecie, a następnie
+ * mierzy czasy etapów silnika – obliczeń ParallelFor, drobnych zadań,
+ * generowania kul, dekodowania textura.jpg i przypisania świateł do
+ * klastrów – dla 1, 2, 4... wątków. Nie wymaga kontekstu OpenGL.
+ * @param maxThreads Największa liczba wątków (0: liczba rdzeni).
+ * @return 0 jeśli wszystkie sprawdzenia przeszły, 1 w przeciwnym razie.
+ */
+int RunJobBenchmark(int maxThreads);
+
+#endif
@@ -0,0 +1,288 @@
+﻿#include "JobSystem.h"
+
+#include <algorithm>
+#include <iostream>
+
+/// Liczba prób znalezienia pracy przed uśpieniem wątku
+static const int SPIN_COUNT = 64;
+
+/// System i numer kolejki bieżącego wątku roboczego (-1: wątek spoza systemu)
+static thread_local JobSystem* currentSystem = nullptr;
+static thread_local int currentWorker = -1;
+
+/**
+ * @brief Konstruktor klasy JobSystem.
+ */
+JobSystem::JobSystem(int threadCount)
+    : pending(0), sleeping(0), quit(false), executed(0), stolen(0), helped(0), deferred(0), sleeps(0) {
+    if (threadCount <= 0) threadCount = static_cast<int>(std::thread::hardware_concurrency());
+    if (threadCount <= 0) threadCount = 1;
+    for (int i = 1; i < threadCount; i++) queues.emplace_back(new WorkerQueue());
+    for (int i = 1; i < threadCount; i++) workers.emplace_back(&JobSystem::WorkerLoop, this, i - 1);
+}
+
+/**
+ * @brief Destruktor klasy JobSystem – wątki kończą pracę po opróżnieniu kolejek.
+ */
+JobSystem::~JobSystem() {
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        quit = true;
+    }
+    wake.notify_all();
+    for (std::thread& thread : workers) thread.join();
+}
+
+/**
+ * @brief Zleca zadanie lub odkłada je do wyzerowania licznika zależności.
+ */
+void JobSystem::Schedule(std::function<void()> function, JobCounter* counter, JobCounter* dependency, JobPriority priority) {
+    if (counter) {
+        counter->value.fetch_add(1, std::memory_order_relaxed);
+        if (priority == JOB_PRIORITY_LOW) counter->background.store(true, std::memory_order_relaxed);
+    }
+    if (dependency) {
+        std::lock_guard<std::mutex> lock(dependency->mutex);
+        if (dependency->value.load(std::memory_order_acquire) != 0) {
+            dependency->continuations.push_back({ std::move(function), counter, priority });
+            deferred.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+    }
+    Push({ std::move(function), counter }, priority);
+}
+
+/**
+ * @brief Wstawia zadanie do kolejki i budzi uśpiony wątek.
+ *
+ * Wątek roboczy tego systemu wstawia na koniec własnej kolejki,
+ * pozostałe wątki – do kolejki wspólnej.
+ */
+void JobSystem::Push(Job job, JobPriority priority) {
+    if (priority == JOB_PRIORITY_LOW) {
+        std::lock_guard<std::mutex> lock(backgroundMutex);
+        backgroundJobs.push_back(std::move(job));
+    }
+    else if (currentSystem == this && currentWorker >= 0) {
+        WorkerQueue& queue = *queues[currentWorker];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        queue.jobs.push_back(std::move(job));
+    }
+    else {
+        std::lock_guard<std::mutex> lock(sharedMutex);
+        sharedJobs.push_back(std::move(job));
+    }
+
+    // pending przed sleeping, a w wątku roboczym odwrotnie – jedna ze stron zawsze widzi drugą
+    pending.fetch_add(1);
+    if (sleeping.load() > 0) {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        wake.notify_one();
+    }
+}
+
+/**
+ * @brief Zdejmuje zadanie z początku kolejki.
+ */
+bool JobSystem::PopFront(std::mutex& mutex, std::deque<Job>& queue, Job& job) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (queue.empty()) return false;
+    job = std::move(queue.front());
+    queue.pop_front();
+    return true;
+}
+
+/**
+ * @brief Szuka zadania: własna kolejka (od końca), kolejka wspólna, cudze kolejki (od początku), kolejka tła.
+ * @param index Numer kolejki wątku (-1: wątek spoza systemu).
+ * @param allowLow Czy brać zadania o niskim priorytecie.
+ */
+bool JobSystem::FindJob(int index, bool allowLow, Job& job) {
+    if (pending.load(std::memory_order_relaxed) <= 0) return false;
+
+    if (index >= 0) {
+        WorkerQueue& queue = *queues[index];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (!queue.jobs.empty()) {
+            job = std::move(queue.jobs.back());
+            queue.jobs.pop_back();
+            pending.fetch_sub(1);
+            return true;
+        }
+    }
+    if (PopFront(sharedMutex, sharedJobs, job)) {
+        pending.fetch_sub(1);
+        return true;
+    }
+
+    const int count = static_cast<int>(queues.size());
+    for (int i = 1; i <= count; i++) {
+        const int victim = (std::max(index, 0) + i) % count;
+        if (victim == index) continue;
+        if (PopFront(queues[victim]->mutex, queues[victim]->jobs, job)) {
+            pending.fetch_sub(1);
+            stolen.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+
+    if (allowLow && PopFront(backgroundMutex, backgroundJobs, job)) {
+        pending.fetch_sub(1);
+        return true;
+    }
+    return false;
+}
+
+/**
+ * @brief Wykonuje zadanie i zmniejsza jego licznik.
+ */
+void JobSystem::Execute(Job& job) {
+    job.function();
+    job.function = nullptr;
+    executed.fetch_add(1, std::memory_order_relaxed);
+    if (job.counter) Finish(job.counter);
+}
+
+/**
+ * @brief Zmniejsza licznik; po wyzerowaniu zleca zadania od niego zależne.
+ *
+ * Zmiana wartości odbywa się pod blokadą licznika, a Wait przed powrotem
+ * przejmuje tę blokadę – licznik nie zostanie zniszczony w trakcie Finish.
+ */
+void JobSystem::Finish(JobCounter* counter) {
+    std::vector<JobCounter::Continuation> ready;
+    {
+        std::lock_guard<std::mutex> lock(counter->mutex);
+        if (counter->value.fetch_sub(1, std::memory_order_acq_rel) != 1) return;
+        ready.swap(counter->continuations);
+    }
+    for (JobCounter::Continuation& continuation : ready) {
+        Push({ std::move(continuation.function), continuation.counter }, continuation.priority);
+    }
+}
+
+/**
+ * @brief Czeka na licznik, wykonując zadania zamiast blokować wątek.
+ */
+void JobSystem::Wait(JobCounter& counter) {
+    const int index = (currentSystem == this) ? currentWorker : -1;
+    while (!counter.IsDone()) {
+        const bool allowLow = workers.empty() || counter.background.load(std::memory_order_relaxed);
+        Job job;
+        if (FindJob(index, allowLow, job)) {
+            helped.fetch_add(1, std::memory_order_relaxed);
+            Execute(job);
+        }
+        else {
+            std::this_thread::yield();
+        }
+    }
+    // Ostatni Finish mógł jeszcze trzymać blokadę licznika
+    std::lock_guard<std::mutex> lock(counter.mutex);
+}
+
+/**
+ * @brief Dzieli [0, count) na zadania po grain elementów; pierwszy przedział wykonuje wywołujący.
+ */
+void JobSystem::ParallelFor(size_t count, size_t grain, const std::function<void(size_t begin, size_t end)>& function) {
+    if (count == 0) return;
+    grain = std::max<size_t>(grain, 1);
+    if (workers.empty() || count <= grain) {
+        function(0, count);
+        return;
+    }
+
+    JobCounter counter;
+    for (size_t begin = grain; begin < count; begin += grain) {
+        const size_t end = std::min(begin + grain, count);
+        Schedule([&function, begin, end] { function(begin, end); }, &counter);
+    }
+    function(0, grain);
+    Wait(counter);
+}
+
+/**
+ * @brief Pętla wątku roboczego.
+ */
+void JobSystem::WorkerLoop(int index) {
+    currentSystem = this;
+    currentWorker = index;
+
+    int idle = 0;
+    for (;;) {
+        Job job;
+        if (FindJob(index, true, job)) {
+            Execute(job);
+            idle = 0;
+            continue;
+        }
+        if (++idle < SPIN_COUNT) {
+            std::this_thread::yield();
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(sleepMutex);
+        if (quit) return;
+        sleeping.fetch_add(1);
+        sleeps.fetch_add(1, std::memory_order_relaxed);
+        wake.wait(lock, [this] { return quit || pending.load() > 0; });
+        sleeping.fetch_sub(1);
+        idle = 0;
+    }
+}
+
+/**
+ * @brief Zwraca liczniki zadań.
+ */
+JobSystemStats JobSystem::GetStats() const {
+    JobSystemStats result;
+    result.executed = executed.load();
+    result.stolen = stolen.load();
+    result.helped = helped.load();
+    result.deferred = deferred.load();
+    result.sleeps = sleeps.load();
+    return result;
+}
+
+/**
+ * @brief Zeruje liczniki zadań.
+ */
+void JobSystem::ResetStats() {
+    executed = 0;
+    stolen = 0;
+    helped = 0;
+    deferred = 0;
+    sleeps = 0;
+}
+
+/**
+ * @brief Wypisuje liczniki zadań.
+ */
+void JobSystem::PrintStats() const {
+    const JobSystemStats stats = GetStats();
+    std::cout << "System zadań (" << GetThreadCount() << " wątków): wykonane " << stats.executed
+        << ", podkradzione " << stats.stolen << ", wykonane w Wait " << stats.helped
+        << ", odłożone " << stats.deferred << ", uśpienia " << stats.sleeps << std::endl;
+}
+
+/// Wspólny system zadań silnika
+static std::unique_ptr<JobSystem> sharedSystem;
+static std::mutex sharedSystemMutex;
+
+/**
+ * @brief Zwraca wspólny system zadań, tworząc go przy pierwszym użyciu.
+ */
+JobSystem& GetJobSystem() {
+    std::lock_guard<std::mutex> lock(sharedSystemMutex);
+    if (!sharedSystem) sharedSystem.reset(new JobSystem(0));
+    return *sharedSystem;
+}
+
+/**
+ * @brief Tworzy wspólny system zadań od nowa z podaną liczbą wątków.
+ */
+void SetJobSystemThreadCount(int threadCount) {
+    std::lock_guard<std::mutex> lock(sharedSystemMutex);
+    sharedSystem.reset();
+    sharedSystem.reset(new JobSystem(threadCount));
+}
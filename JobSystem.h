@@ -0,0 +1,177 @@
+﻿#pragma once
+#ifndef JOB_SYSTEM_H
+#define JOB_SYSTEM_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class JobSystem;
+
+/**
+ * @brief Priorytet zadania.
+ */
+enum JobPriority {
+    JOB_PRIORITY_HIGH = 0,   /**< Praca klatki (ParallelFor, etapy silnika) */
+    JOB_PRIORITY_LOW = 1     /**< Praca w tle (dekodowanie tekstur) – nie wykonywana przez czekających */
+};
+
+/**
+ * @brief Licznik niezakończonych zadań.
+ *
+ * Schedule zwiększa licznik, zakończenie zadania go zmniejsza. Na licznik
+ * można czekać (JobSystem::Wait) albo uzależnić od niego kolejne zadania –
+ * zostaną zlecone, gdy licznik spadnie do zera. Licznik można zniszczyć
+ * dopiero po powrocie z Wait.
+ */
+class JobCounter {
+public:
+    JobCounter() : value(0), background(false) {}
+
+    JobCounter(const JobCounter&) = delete;
+    JobCounter& operator=(const JobCounter&) = delete;
+
+    bool IsDone() const { return value.load(std::memory_order_acquire) == 0; }
+    int Get() const { return value.load(std::memory_order_acquire); }
+
+private:
+    friend class JobSystem;
+
+    /**
+     * @brief Zadanie czekające na licznik.
+     */
+    struct Continuation {
+        std::function<void()> function;
+        JobCounter* counter;
+        JobPriority priority;
+    };
+
+    std::atomic<int> value;
+    std::atomic<bool> background; /**< Czy liczy zadania o niskim priorytecie (Wait może je wykonywać) */
+    std::mutex mutex;
+    std::vector<Continuation> continuations; /**< Zadania zlecane po spadku do zera */
+};
+
+/**
+ * @brief Liczniki systemu zadań od utworzenia lub ResetStats.
+ */
+struct JobSystemStats {
+    size_t executed = 0;    /**< Wykonane zadania */
+    size_t stolen = 0;      /**< Zadania zabrane z kolejki innego wątku */
+    size_t helped = 0;      /**< Zadania wykonane przez wątki czekające w Wait */
+    size_t deferred = 0;    /**< Zadania odłożone do spełnienia zależności */
+    size_t sleeps = 0;      /**< Uśpienia wątków roboczych bez pracy */
+};
+
+/**
+ * @brief System zadań z kolejkami na wątek i podkradaniem pracy.
+ *
+ * Każdy wątek roboczy ma własną dwustronną kolejkę: zadania zlecone przez
+ * niego trafiają na jej koniec i są zdejmowane z końca (najświeższe dane
+ * w pamięci podręcznej), a bezczynne wątki podkradają z początku kolejek
+ * innych. Zadania zlecone spoza wątków roboczych trafiają do kolejki
+ * wspólnej, zadania o niskim priorytecie – do osobnej kolejki tła.
+ *
+ * Wait nie usypia wątku: czekający wykonuje zadania o wysokim priorytecie
+ * (niskim tylko, gdy sam czeka na takie zadania lub system nie ma wątków
+ * w tle – inaczej długie dekodowanie opóźniłoby klatkę), więc zagnieżdżone
+ * ParallelFor nie blokują puli. Przy N wątkach tworzonych jest N - 1 wątków
+ * w tle; N-tym jest wątek, który czeka.
+ */
+class JobSystem {
+public:
+    /**
+     * @param threadCount Liczba wątków wraz z czekającym (0: liczba rdzeni).
+     */
+    explicit JobSystem(int threadCount = 0);
+    ~JobSystem();
+
+    JobSystem(const JobSystem&) = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+
+    int GetThreadCount() const { return static_cast<int>(workers.size()) + 1; }
+
+    /**
+     * @brief Zleca zadanie.
+     * @param function Praca do wykonania.
+     * @param counter Licznik zwiększany teraz i zmniejszany po wykonaniu (opcjonalny).
+     * @param dependency Licznik, na którego wyzerowanie zadanie czeka przed zleceniem (opcjonalny).
+     * @param priority Priorytet zadania.
+     */
+    void Schedule(std::function<void()> function, JobCounter* counter = nullptr,
+        JobCounter* dependency = nullptr, JobPriority priority = JOB_PRIORITY_HIGH);
+
+    /**
+     * @brief Czeka na wyzerowanie licznika, wykonując w tym czasie inne zadania.
+     */
+    void Wait(JobCounter& counter);
+
+    /**
+     * @brief Wykonuje function(begin, end) dla przedziałów [0, count) po grain elementów i czeka na koniec.
+     */
+    void ParallelFor(size_t count, size_t grain, const std::function<void(size_t begin, size_t end)>& function);
+
+    JobSystemStats GetStats() const;
+    void ResetStats();
+
+    /**
+     * @brief Wypisuje liczniki zadań.
+     */
+    void PrintStats() const;
+
+private:
+    struct Job {
+        std::function<void()> function;
+        JobCounter* counter;
+    };
+
+    /**
+     * @brief Kolejka wątku roboczego (właściciel: koniec, złodzieje: początek).
+     */
+    struct WorkerQueue {
+        std::mutex mutex;
+        std::deque<Job> jobs;
+    };
+
+    void WorkerLoop(int index);
+    void Push(Job job, JobPriority priority);
+    bool FindJob(int index, bool allowLow, Job& job);
+    bool PopFront(std::mutex& mutex, std::deque<Job>& queue, Job& job);
+    void Execute(Job& job);
+    void Finish(JobCounter* counter);
+
+    std::vector<std::thread> workers;
+    std::vector<std::unique_ptr<WorkerQueue>> queues; /**< Kolejki wątków w tle (po jednej na wątek) */
+    std::mutex sharedMutex;
+    std::deque<Job> sharedJobs;   /**< Zadania zlecone spoza wątków roboczych */
+    std::mutex backgroundMutex;
+    std::deque<Job> backgroundJobs; /**< Zadania o niskim priorytecie */
+
+    std::atomic<int> pending;     /**< Zadania we wszystkich kolejkach */
+    std::atomic<int> sleeping;    /**< Uśpione wątki robocze */
+    std::mutex sleepMutex;
+    std::condition_variable wake;
+    bool quit;
+
+    std::atomic<size_t> executed, stolen, helped, deferred, sleeps;
+};
+
+/**
+ * @brief Wspólny system zadań silnika (tworzony przy pierwszym użyciu, liczba rdzeni).
+ */
+JobSystem& GetJobSystem();
+
+/**
+ * @brief Tworzy wspólny system zadań od nowa z podaną liczbą wątków (0: liczba rdzeni).
+ *
+ * Wywoływać, gdy żadne zadanie nie jest w toku (np. przed utworzeniem silnika).
+ */
+void SetJobSystemThreadCount(int threadCount);
+
+#endif
@@ -0,0 +1,424 @@
+﻿#include "LitShader.h"
+#include "ClusteredLighting.h"
+#include "ShadowMap.h"
+
+#include <string>
+
+static const char* LIT_VERTEX_SHADER =
+"varying vec3 eyePosition;\n"
+"varying vec3 eyeNormal;\n"
+"#ifdef INSTANCED\n"
+"attribute vec4 instanceOffsetScale;\n"
+"attribute vec4 instanceColor;\n"
+"#endif\n"
+"void main() {\n"
+"    vec4 position = gl_Vertex;\n"
+"    vec4 color = gl_Color;\n"
+"#ifdef INSTANCED\n"
+"    position = vec4(gl_Vertex.xyz * instanceOffsetScale.w + instanceOffsetScale.xyz, 1.0);\n"
+"    color *= instanceColor;\n"
+"#endif\n"
+"    vec4 eye = gl_ModelViewMatrix * position;\n"
+"    eyePosition = eye.xyz;\n"
+"    eyeNormal = gl_NormalMatrix * gl_Normal;\n"
+"    gl_FrontColor = color;\n"
+"    gl_BackColor = color;\n"
+"    gl_TexCoord[0] = gl_MultiTexCoord0;\n"
+"    gl_Position = gl_ProjectionMatrix * eye;\n"
+"}\n";
+
+static const char* LIT_FRAGMENT_SHADER =
+"uniform vec4 lightData[MAX_LIGHTS * 4];\n"
+"uniform vec4 materialData[2];\n"
+"uniform bool useTexture;\n"
+"uniform bool lit;\n"
+"uniform sampler2D diffuseMap;\n"
+"varying vec3 eyePosition;\n"
+"varying vec3 eyeNormal;\n"
+"#ifdef CLUSTERED\n"
+"uniform sampler2D clusterGrid;\n"
+"uniform sampler2D clusterLights;\n"
+"uniform sampler2D clusterIndices;\n"
+"uniform vec4 clusterData[4];\n"
+"// Odczyt teksela o numerze index z tekstury o rozmiarze size (wiersz po wierszu)\n"
+"vec4 FetchTexel(sampler2D map, float index, vec2 size) {\n"
+"    vec2 texel = vec2(mod(index, size.x), floor(index / size.x));\n"
+"    return texture2D(map, (texel + 0.5) / size);\n"
+"}\n"
+"// Światła punktowe z listy klastra zawierającego fragment\n"
+"vec3 ClusterLighting(vec3 color, vec3 normal) {\n"
+"    vec2 tile = floor(gl_FragCoord.xy / clusterData[1].xy * clusterData[0].xy);\n"
+"    tile = clamp(tile, vec2(0.0), clusterData[0].xy - 1.0);\n"
+"    float slice = floor(log(max(-eyePosition.z, 1e-4)) * clusterData[1].z + clusterData[1].w);\n"
+"    if (slice < 0.0 || slice >= clusterData[0].z) return vec3(0.0);\n"
+"    float cluster = (slice * clusterData[0].y + tile.y) * clusterData[0].x + tile.x;\n"
+"    vec4 range = FetchTexel(clusterGrid, cluster, clusterData[3].xy);\n"
+"    vec3 result = vec3(0.0);\n"
+"    for (int i = 0; i < MAX_CLUSTER_LIGHTS; i++) {\n"
+"        if (float(i) >= range.y) break;\n"
+"        float light = FetchTexel(clusterIndices, range.x + float(i), clusterData[2].zw).r;\n"
+"        vec4 positionRadius = FetchTexel(clusterLights, light * 2.0, clusterData[2].xy);\n"
+"        vec3 toLight = positionRadius.xyz - eyePosition;\n"
+"        float distanceSq = dot(toLight, toLight);\n"
+"        float radiusSq = positionRadius.w * positionRadius.w;\n"
+"        if (distanceSq >= radiusSq) continue;\n"
+"        float falloff = 1.0 - distanceSq / radiusSq;\n"
+"        float diffuse = max(dot(normal, toLight * inversesqrt(distanceSq)), 0.0);\n"
+"        vec3 lightColor = FetchTexel(clusterLights, light * 2.0 + 1.0, clusterData[2].xy).rgb;\n"
+"        result += color * lightColor * diffuse * falloff * falloff;\n"
+"    }\n"
+"    return result;\n"
+"}\n"
+"#endif\n"
+"#ifdef SHADOWED\n"
+"uniform sampler2DShadow shadowMap;\n"
+"uniform vec4 shadowData[MAX_SHADOW_CASCADES * 4 + 2];\n"
+"// Widoczność światła 0 z kaskady zawierającej fragment (4 próbki PCF)\n"
+"float ShadowFactor() {\n"
+"    vec4 splits = shadowData[MAX_SHADOW_CASCADES * 4];\n"
+"    vec4 params = shadowData[MAX_SHADOW_CASCADES * 4 + 1];\n"
+"    float cascade = dot(step(splits, vec4(-eyePosition.z)), vec4(1.0));\n"
+"    if (cascade >= params.x) return 1.0;\n"
+"    int base = int(cascade) * 4;\n"
+"    mat4 eyeToShadow = mat4(shadowData[base], shadowData[base + 1], shadowData[base + 2], shadowData[base + 3]);\n"
+"    vec3 coord = (eyeToShadow * vec4(eyePosition, 1.0)).xyz;\n"
+"    vec2 offset = 0.5 * params.yz;\n"
+"    float visibility = shadow2D(shadowMap, coord + vec3(-offset.x, -offset.y, 0.0)).r;\n"
+"    visibility += shadow2D(shadowMap, coord + vec3(offset.x, -offset.y, 0.0)).r;\n"
+"    visibility += shadow2D(shadowMap, coord + vec3(-offset.x, offset.y, 0.0)).r;\n"
+"    visibility += shadow2D(shadowMap, coord + vec3(offset.x, offset.y, 0.0)).r;\n"
+"    return visibility * 0.25;\n"
+"}\n"
+"#endif\n"
+"void main() {\n"
+"    vec4 color = gl_Color;\n"
+"    if (lit) {\n"
+"#ifdef FLAT_SHADING\n"
+"        // Normalna ściany: pochodne pozycji są stałe w obrębie trójkąta\n"
+"        vec3 normal = normalize(cross(dFdx(eyePosition), dFdy(eyePosition)));\n"
+"#else\n"
+"        vec3 normal = normalize(eyeNormal);\n"
+"#endif\n"
+"        vec3 viewDir = normalize(-eyePosition);\n"
+"        // Kolor wierzchołka jest składnikiem ambient i diffuse (jak GL_COLOR_MATERIAL)\n"
+"        vec3 result = color.rgb * materialData[1].rgb;\n"
+"        int lightCount = int(materialData[1].w);\n"
+"#ifdef SHADOWED\n"
+"        float shadow = ShadowFactor();\n"
+"#endif\n"
+"        for (int i = 0; i < MAX_LIGHTS; i++) {\n"
+"            if (i >= lightCount) break;\n"
+"            vec4 lightPosition = lightData[i * 4];\n"
+"            vec3 lightDir = normalize(lightPosition.w == 0.0 ? lightPosition.xyz : lightPosition.xyz - eyePosition);\n"
+"            float visibility = 1.0;\n"
+"#ifdef SHADOWED\n"
+"            if (i == 0) visibility = shadow;\n"
+"#endif\n"
+"            float diffuse = max(dot(normal, lightDir), 0.0);\n"
+"            result += color.rgb * (lightData[i * 4 + 1].rgb + lightData[i * 4 + 2].rgb * diffuse * visibility);\n"
+"            if (diffuse > 0.0) {\n"
+"                vec3 halfVector = normalize(lightDir + viewDir);\n"
+"                result += materialData[0].rgb * lightData[i * 4 + 3].rgb * visibility\n"
+"                    * pow(max(dot(normal, halfVector), 0.0), materialData[0].w);\n"
+"            }\n"
+"        }\n"
+"#ifdef CLUSTERED\n"
+"        result += ClusterLighting(color.rgb, normal);\n"
+"#endif\n"
+"        color.rgb = result;\n"
+"    }\n"
+"    if (useTexture) color *= texture2D(diffuseMap, gl_TexCoord[0].st);\n"
+"    gl_FragColor = color;\n"
+"}\n";
+
+// === LightingState ===
+
+/**
+ * @brief Konstruktor klasy LightingState (jedno białe światło, wartości jak w OpenGL).
+ */
+LightingState::LightingState()
+    : lightCount(0), lightBlock("lightData", MAX_LIGHTS * 4), materialBlock("materialData", 2) {
+    LightSource light = {
+        { 0.0f, 0.0f, 1.0f, 0.0f },
+        { 0.0f, 0.0f, 0.0f, 1.0f },
+        { 1.0f, 1.0f, 1.0f, 1.0f },
+        { 1.0f, 1.0f, 1.0f, 1.0f }
+    };
+    for (int i = 0; i < MAX_LIGHTS; i++) lights[i] = light;
+
+    const float specular[4] = { 0.0f, 0.0f, 0.0f, 1.0f };
+    SetMaterial(specular, 0.0f);
+    SetGlobalAmbient(0.2f, 0.2f, 0.2f);
+    SetLightCount(1);
+}
+
+/**
+ * @brief Ustawia światło o numerze index (pozycja w układzie świata).
+ */
+void LightingState::SetLight(int index, const LightSource& light) {
+    if (index < 0 || index >= MAX_LIGHTS) return;
+    lights[index] = light;
+    lightBlock.Set(index * 4 + 1, light.ambient);
+    lightBlock.Set(index * 4 + 2, light.diffuse);
+    lightBlock.Set(index * 4 + 3, light.specular);
+}
+
+/**
+ * @brief Ustawia liczbę aktywnych świateł (0..MAX_LIGHTS).
+ */
+void LightingState::SetLightCount(int count) {
+    if (count < 0) count = 0;
+    if (count > MAX_LIGHTS) count = MAX_LIGHTS;
+    lightCount = count;
+    const float* ambient = materialBlock.Get(1);
+    materialBlock.Set(1, ambient[0], ambient[1], ambient[2], static_cast<float>(count));
+}
+
+/**
+ * @brief Ustawia odbicie zwierciadlane i połysk materiału.
+ */
+void LightingState::SetMaterial(const float specular[4], float shininess) {
+    materialBlock.Set(0, specular[0], specular[1], specular[2], shininess);
+}
+
+/**
+ * @brief Ustawia globalne światło otoczenia.
+ */
+void LightingState::SetGlobalAmbient(float r, float g, float b) {
+    materialBlock.Set(1, r, g, b, static_cast<float>(lightCount));
+}
+
+/**
+ * @brief Przelicza pozycje świateł do układu kamery.
+ *
+ * Blok zmienia wersję tylko, gdy pozycja faktycznie się zmieniła, więc przy
+ * nieruchomej kamerze nic nie jest ponownie wysyłane.
+ */
+void LightingState::Update(const Mat4& view) {
+    for (int i = 0; i < lightCount; i++) {
+        const float* p = lights[i].position;
+        Vec4 eye = view.Transform(Vec4(p[0], p[1], p[2], p[3]));
+        lightBlock.Set(i * 4, eye.x, eye.y, eye.z, eye.w);
+    }
+}
+
+/**
+ * @brief Ładuje stan do potoku stałych funkcji (pierwsze 8 świateł).
+ */
+void LightingState::ApplyFixedFunction() const {
+    glMatrixMode(GL_MODELVIEW);
+    glPushMatrix();
+    glLoadIdentity();
+    for (int i = 0; i < 8; i++) {
+        GLenum light = GL_LIGHT0 + i;
+        if (i >= lightCount) {
+            glDisable(light);
+            continue;
+        }
+        glEnable(light);
+        glLightfv(light, GL_POSITION, lightBlock.Get(i * 4));
+        glLightfv(light, GL_AMBIENT, lights[i].ambient);
+        glLightfv(light, GL_DIFFUSE, lights[i].diffuse);
+        glLightfv(light, GL_SPECULAR, lights[i].specular);
+    }
+    glPopMatrix();
+
+    const float* material = materialBlock.Get(0);
+    const float* ambient = materialBlock.Get(1);
+    const float globalAmbient[4] = { ambient[0], ambient[1], ambient[2], 1.0f };
+    const float specular[4] = { material[0], material[1], material[2], 1.0f };
+    glLightModelfv(GL_LIGHT_MODEL_AMBIENT, globalAmbient);
+    glEnable(GL_COLOR_MATERIAL);
+    glColorMaterial(GL_FRONT_AND_BACK, GL_AMBIENT_AND_DIFFUSE);
+    glMaterialfv(GL_FRONT_AND_BACK, GL_SPECULAR, specular);
+    glMaterialf(GL_FRONT_AND_BACK, GL_SHININESS, material[3]);
+}
+
+// === LitShader ===
+
+/**
+ * @brief Konstruktor klasy LitShader.
+ */
+LitShader::LitShader()
+    : lighting(nullptr), clusterBlock(nullptr), shadowBlock(nullptr), baseVariant(LIT_SMOOTH), current(-1), textured(false), lit(true) {
+    for (Variant& variant : variants) {
+        variant.useTextureLocation = -1;
+        variant.litLocation = -1;
+        variant.sentTextured = -1;
+        variant.sentLit = -1;
+    }
+}
+
+/**
+ * @brief Kompiluje wszystkie warianty.
+ */
+bool LitShader::Init() {
+    Release();
+    if (!GetGLCapabilities().shaders) return false;
+
+    const ShaderAttribute attributes[] = {
+        { LIT_ATTRIB_INSTANCE_OFFSET_SCALE, "instanceOffsetScale" },
+        { LIT_ATTRIB_INSTANCE_COLOR, "instanceColor" },
+    };
+
+    for (unsigned int v = 0; v < LIT_VARIANT_COUNT; v++) {
+        // Wariant instancjonowany wymaga glVertexAttribDivisor, klastrowy – tekstur float,
+        // z cieniami – tekstur głębokości
+        if ((v & LIT_INSTANCED) && !GetGLCapabilities().instancing) continue;
+        if ((v & LIT_CLUSTERED) && !ClusteredLighting::IsSupported()) continue;
+        if ((v & LIT_SHADOWED) && !ShadowMap::IsSupported()) continue;
+
+        std::string name = "lit";
+        std::string header = "#version 120\n#define MAX_LIGHTS " + std::to_string(LightingState::MAX_LIGHTS) + "\n";
+        if (v & LIT_FLAT) {
+            header += "#define FLAT_SHADING\n";
+            name += "-flat";
+        }
+        if (v & LIT_INSTANCED) {
+            header += "#define INSTANCED\n";
+            name += "-instanced";
+        }
+        if (v & LIT_CLUSTERED) {
+            header += "#define CLUSTERED\n#define MAX_CLUSTER_LIGHTS "
+                + std::to_string(ClusteredLighting::MAX_LIGHTS_PER_CLUSTER) + "\n";
+            name += "-clustered";
+        }
+        if (v & LIT_SHADOWED) {
+            header += "#define SHADOWED\n#define MAX_SHADOW_CASCADES " + std::to_string(ShadowMap::MAX_CASCADES) + "\n";
+            name += "-shadowed";
+        }
+        std::string vertexSource = header + LIT_VERTEX_SHADER;
+        std::string fragmentSource = header + LIT_FRAGMENT_SHADER;
+
+        Variant& variant = variants[v];
+        if (!variant.program.Build(name, vertexSource.c_str(), fragmentSource.c_str(),
+            attributes, (v & LIT_INSTANCED) ? 2 : 0)) {
+            continue;
+        }
+        variant.useTextureLocation = variant.program.GetUniformLocation("useTexture");
+        variant.litLocation = variant.program.GetUniformLocation("lit");
+        // Tekstura materiału zawsze w jednostce 0, tekstury klastrów i cieni w kolejnych
+        variant.program.Use();
+        glUniform1i(variant.program.GetUniformLocation("diffuseMap"), 0);
+        if (v & LIT_CLUSTERED) {
+            glUniform1i(variant.program.GetUniformLocation("clusterGrid"), LIT_CLUSTER_TEXTURE_UNIT);
+            glUniform1i(variant.program.GetUniformLocation("clusterLights"), LIT_CLUSTER_TEXTURE_UNIT + 1);
+            glUniform1i(variant.program.GetUniformLocation("clusterIndices"), LIT_CLUSTER_TEXTURE_UNIT + 2);
+        }
+        if (v & LIT_SHADOWED) glUniform1i(variant.program.GetUniformLocation("shadowMap"), LIT_SHADOW_TEXTURE_UNIT);
+    }
+    ShaderProgram::UseFixedFunction();
+    return IsValid(LIT_SMOOTH);
+}
+
+/**
+ * @brief Zwalnia programy.
+ */
+void LitShader::Release() {
+    for (Variant& variant : variants) {
+        variant.program.Release();
+        variant.sentTextured = -1;
+        variant.sentLit = -1;
+    }
+    current = -1;
+    lighting = nullptr;
+    clusterBlock = nullptr;
+    shadowBlock = nullptr;
+}
+
+/**
+ * @brief Sprawdza, czy wariant został skompilowany.
+ */
+bool LitShader::IsValid(unsigned int variant) const {
+    return variant < LIT_VARIANT_COUNT && variants[variant].program.IsValid();
+}
+
+/**
+ * @brief Rozpoczyna rysowanie wariantem variant z podanym oświetleniem.
+ */
+void LitShader::Begin(const LightingState& lighting, unsigned int variant, const UniformBlock* clusterBlock,
+    const UniformBlock* shadowBlock) {
+    this->lighting = &lighting;
+    this->clusterBlock = clusterBlock;
+    this->shadowBlock = shadowBlock;
+    if (!clusterBlock) variant &= ~LIT_CLUSTERED;
+    if (!shadowBlock) variant &= ~LIT_SHADOWED;
+    baseVariant = variant & (LIT_FLAT | LIT_CLUSTERED | LIT_SHADOWED);
+    current = -1;
+    Bind(baseVariant);
+}
+
+/**
+ * @brief Wiąże program wariantu i wysyła nieaktualne bloki.
+ */
+void LitShader::Bind(unsigned int variant) {
+    if (!IsValid(variant) || static_cast<int>(variant) == current) return;
+
+    Variant& target = variants[variant];
+    target.program.Use();
+    target.program.UploadBlock(lighting->GetLightBlock());
+    target.program.UploadBlock(lighting->GetMaterialBlock());
+    if (variant & LIT_CLUSTERED) target.program.UploadBlock(*clusterBlock);
+    if (variant & LIT_SHADOWED) target.program.UploadBlock(*shadowBlock);
+    current = static_cast<int>(variant);
+    ApplyMaterial(target);
+}
+
+/**
+ * @brief Wysyła zmienne materiału, które różnią się od ostatnio wysłanych.
+ */
+void LitShader::ApplyMaterial(Variant& variant) {
+    if (variant.sentTextured != (textured ? 1 : 0)) {
+        glUniform1i(variant.useTextureLocation, textured ? 1 : 0);
+        variant.sentTextured = textured ? 1 : 0;
+    }
+    if (variant.sentLit != (lit ? 1 : 0)) {
+        glUniform1i(variant.litLocation, lit ? 1 : 0);
+        variant.sentLit = lit ? 1 : 0;
+    }
+}
+
+/**
+ * @brief Ustawia parametry materiału rysowanego obiektu.
+ */
+void LitShader::SetMaterial(bool textured, bool lit) {
+    this->textured = textured;
+    this->lit = lit;
+    if (current >= 0) ApplyMaterial(variants[current]);
+}
+
+/**
+ * @brief Przełącza między wariantem zwykłym a instancjonowanym.
+ */
+void LitShader::SetInstanced(bool instanced) {
+    if (current < 0) return;
+    Bind(instanced ? (baseVariant | LIT_INSTANCED) : baseVariant);
+}
+
+/**
+ * @brief Kończy rysowanie i przywraca potok stałych funkcji.
+ */
+void LitShader::End() {
+    if (current < 0) return;
+    ShaderProgram::UseFixedFunction();
+    current = -1;
+    lighting = nullptr;
+    clusterBlock = nullptr;
+    shadowBlock = nullptr;
+}
+
+/**
+ * @brief Zwraca liczbę wysyłek bloków od ostatniego ResetBlockUploads.
+ */
+unsigned int LitShader::GetBlockUploads() const {
+    unsigned int uploads = 0;
+    for (const Variant& variant : variants) uploads += variant.program.GetBlockUploads();
+    return uploads;
+}
+
+/**
+ * @brief Zeruje liczniki wysyłek bloków.
+ */
+void LitShader::ResetBlockUploads() {
+    for (Variant& variant : variants) variant.program.ResetBlockUploads();
+}
@@ -0,0 +1,195 @@
+﻿#pragma once
+#ifndef LIT_SHADER_H
+#define LIT_SHADER_H
+
+#include "MathLib.h"
+#include "ShaderProgram.h"
+
+/// Numery ogólnych atrybutów instancji (6 i 7 nie kolidują z atrybutami stałych funkcji)
+const GLuint LIT_ATTRIB_INSTANCE_OFFSET_SCALE = 6;
+const GLuint LIT_ATTRIB_INSTANCE_COLOR = 7;
+/// Pierwsza jednostka tekstur klastrów świateł (siatka, światła, indeksy – zob. ClusteredLighting)
+const int LIT_CLUSTER_TEXTURE_UNIT = 1;
+/// Jednostka atlasu map cieni (zob. ShadowMap)
+const int LIT_SHADOW_TEXTURE_UNIT = 4;
+
+/**
+ * @brief Parametry jednego źródła światła (jak w glLightfv).
+ */
+struct LightSource {
+    float position[4]; /**< Pozycja w świecie (w = 0: światło kierunkowe) */
+    float ambient[4];  /**< Składnik ambient */
+    float diffuse[4];  /**< Składnik diffuse */
+    float specular[4]; /**< Składnik specular */
+};
+
+/**
+ * @brief Stan oświetlenia sceny przechowywany w blokach uniform.
+ *
+ * Blok "lightData" zawiera po cztery vec4 na światło (pozycja w układzie
+ * kamery, ambient, diffuse, specular), blok "materialData" – odbicie
+ * zwierciadlane materiału z połyskiem w W oraz globalny ambient z liczbą
+ * świateł w W. Pozycje przeliczane są raz na klatkę w Update.
+ */
+class LightingState {
+public:
+    /// Maksymalna liczba świateł w shaderze (potok stałych funkcji ma tylko 8)
+    static const int MAX_LIGHTS = 16;
+
+    LightingState();
+
+    /**
+     * @brief Ustawia światło o numerze index (pozycja w układzie świata).
+     */
+    void SetLight(int index, const LightSource& light);
+    const LightSource& GetLight(int index) const { return lights[index]; }
+
+    /**
+     * @brief Ustawia liczbę aktywnych świateł (0..MAX_LIGHTS).
+     */
+    void SetLightCount(int count);
+    int GetLightCount() const { return lightCount; }
+
+    /**
+     * @brief Ustawia odbicie zwierciadlane i połysk materiału.
+     */
+    void SetMaterial(const float specular[4], float shininess);
+
+    /**
+     * @brief Ustawia globalne światło otoczenia (GL_LIGHT_MODEL_AMBIENT).
+     */
+    void SetGlobalAmbient(float r, float g, float b);
+
+    /**
+     * @brief Przelicza pozycje świateł do układu kamery i aktualizuje bloki.
+     * @param view Macierz widoku bieżącej klatki.
+     */
+    void Update(const Mat4& view);
+
+    /**
+     * @brief Ładuje stan do potoku stałych funkcji (pierwsze 8 świateł).
+     *
+     * Używane, gdy kontekst nie obsługuje GLSL. Pozycje pochodzą z ostatniego
+     * Update (układ kamery), więc są ładowane przy jednostkowej macierzy widoku.
+     */
+    void ApplyFixedFunction() const;
+
+    const UniformBlock& GetLightBlock() const { return lightBlock; }
+    const UniformBlock& GetMaterialBlock() const { return materialBlock; }
+
+private:
+    LightSource lights[MAX_LIGHTS]; /**< Światła w układzie świata */
+    int lightCount;                 /**< Liczba aktywnych świateł */
+    UniformBlock lightBlock;        /**< Blok lightData */
+    UniformBlock materialBlock;     /**< Blok materialData */
+};
+
+/**
+ * @brief Flagi wariantów shadera oświetlenia.
+ */
+enum LitShaderVariant {
+    LIT_SMOOTH = 0,          /**< Normalne interpolowane, oświetlenie na piksel */
+    LIT_FLAT = 1,            /**< Normalna ściany z pochodnych pozycji (cieniowanie płaskie) */
+    LIT_INSTANCED = 2,       /**< Przesunięcie, skala i kolor z atrybutów instancji */
+    LIT_CLUSTERED = 4,       /**< Dodatkowo światła punktowe z list klastrów (ClusteredLighting) */
+    LIT_SHADOWED = 8,        /**< Cień światła 0 z kaskadowych map cieni (ShadowMap) */
+    LIT_VARIANT_COUNT = 16
+};
+
+/**
+ * @brief Shader oświetlenia Blinna-Phonga na piksel zastępujący GL_LIGHTING.
+ *
+ * Warianty (LitShaderVariant) powstają z jednego źródła przez #define.
+ * Begin wiąże wariant na czas rysowania sceny i wysyła bloki LightingState –
+ * każdy program tylko wtedy, gdy ich wersja zmieniła się od poprzedniej
+ * wysyłki, czyli najwyżej raz na klatkę. Zmienne materiału obiektu
+ * (tekstura, oświetlenie) są wysyłane tylko przy zmianie wartości.
+ */
+class LitShader {
+public:
+    LitShader();
+
+    LitShader(const LitShader&) = delete;
+    LitShader& operator=(const LitShader&) = delete;
+
+    /**
+     * @brief Kompiluje wszystkie warianty.
+     * @return True jeśli wariant podstawowy (LIT_SMOOTH) jest dostępny.
+     */
+    bool Init();
+
+    /**
+     * @brief Zwalnia programy.
+     */
+    void Release();
+
+    /**
+     * @brief Sprawdza, czy wariant został skompilowany.
+     */
+    bool IsValid(unsigned int variant = LIT_SMOOTH) const;
+
+    /**
+     * @brief Rozpoczyna rysowanie wariantem variant z podanym oświetleniem.
+     *
+     * Dla LIT_CLUSTERED tekstury klastrów muszą być związane od jednostki
+     * LIT_CLUSTER_TEXTURE_UNIT, dla LIT_SHADOWED atlas cieni z jednostką
+     * LIT_SHADOW_TEXTURE_UNIT.
+     * @param lighting Stan oświetlenia (musi istnieć do End).
+     * @param variant Flagi LIT_SMOOTH/LIT_FLAT/LIT_CLUSTERED/LIT_SHADOWED.
+     * @param clusterBlock Blok "clusterData" (wymagany dla LIT_CLUSTERED).
+     * @param shadowBlock Blok "shadowData" (wymagany dla LIT_SHADOWED).
+     */
+    void Begin(const LightingState& lighting, unsigned int variant, const UniformBlock* clusterBlock = nullptr,
+        const UniformBlock* shadowBlock = nullptr);
+
+    /**
+     * @brief Ustawia parametry materiału rysowanego obiektu.
+     * @param textured Czy próbkować teksturę związaną z jednostką 0.
+     * @param lit Czy oświetlać obiekt.
+     */
+    void SetMaterial(bool textured, bool lit);
+
+    /**
+     * @brief Przełącza między wariantem zwykłym a instancjonowanym.
+     */
+    void SetInstanced(bool instanced);
+
+    /**
+     * @brief Kończy rysowanie i przywraca potok stałych funkcji.
+     */
+    void End();
+
+    bool IsActive() const { return current >= 0; }
+
+    /**
+     * @brief Zwraca liczbę wysyłek bloków od ostatniego ResetBlockUploads.
+     */
+    unsigned int GetBlockUploads() const;
+    void ResetBlockUploads();
+
+private:
+    /**
+     * @brief Program wariantu z położeniami zmiennych i ostatnio wysłanymi wartościami.
+     */
+    struct Variant {
+        ShaderProgram program;
+        GLint useTextureLocation;
+        GLint litLocation;
+        int sentTextured; /**< Ostatnio wysłane useTexture (-1: nieznane) */
+        int sentLit;      /**< Ostatnio wysłane lit (-1: nieznane) */
+    };
+
+    void Bind(unsigned int variant);
+    void ApplyMaterial(Variant& variant);
+
+    Variant variants[LIT_VARIANT_COUNT]; /**< Programy wszystkich wariantów */
+    const LightingState* lighting;       /**< Oświetlenie bieżącego Begin */
+    const UniformBlock* clusterBlock;    /**< Parametry klastrów bieżącego Begin */
+    const UniformBlock* shadowBlock;     /**< Kaskady cieni bieżącego Begin */
+    unsigned int baseVariant;            /**< Wariant z Begin (bez LIT_INSTANCED) */
+    int current;                         /**< Bieżący wariant (-1: poza Begin/End) */
+    bool textured;                       /**< Żądane useTexture */
+    bool lit;                            /**< Żądane lit */
+};
+
+#endif
@@ -23,6 +23,14 @@ i interakcję użytkownika.
 #include <cmath>
 #include <locale.h>
 #include <vector>
+#include <string>
+#include <sstream>
+#include <iomanip>
+#include <cctype>
+#include <cstring>
+#include <memory>
+#include <algorithm>
+#include <atomic>
 
 using namespace std;
 
@@ -31,8 +39,38 @@ using namespace std;
 #endif
 
 #include "stb_image.h"
-GLuint myTexture; // Globalny identyfikator tekstury
 #include "BitmapHandler.h" // Upewnij się, że masz ten include
+#include "MathLib.h"
+#include "MathBenchmark.h"
+#include "PixelBenchmark.h"
+#include "RasterBenchmark.h"
+#include "JobBenchmark.h"
+#include "ImageMemory.h"
+#include "ClusterBenchmark.h"
+#include "TextureCache.h"
+#include "GLExtensions.h"
+#include "Mesh.h"
+#include "SphereMeshCache.h"
+#include "FramePacer.h"
+#include "OffscreenTarget.h"
+#include "FrameProfiler.h"
+#include "Scene.h"
+#include "LitShader.h"
+#include "ClusteredLighting.h"
+#include "ShadowMap.h"
+#include "InstanceRenderer.h"
+#include "RenderQueue.h"
+#include "GLStateCache.h"
+#include "MipChain.h"
+#include "Frustum.h"
+#include "SceneBVH.h"
+#include "SoftwareRasterizer.h"
+#include "JobSystem.h"
+#include "RenderThread.h"
+#include "FixedTimestep.h"
+#include "TimestepBenchmark.h"
+#include "InputSystem.h"
+#include "InputBenchmark.h"
 
 
 
@@ -60,17 +98,35 @@ public:
         MANUAL_CAMERA     /**< Kamera sterowana klawiszami */
     };
 
+    /**
+     * @enum CameraAction
+     * @brief Akcje ruchu kamery (klawisze przypisuje bindCameraKeys według trybu).
+     */
+    enum CameraAction {
+        ACTION_UP,        /**< W (FPS) / I (ręczny) */
+        ACTION_DOWN,      /**< S / K */
+        ACTION_LEFT,      /**< A / J */
+        ACTION_RIGHT,     /**< D / L */
+        ACTION_FORWARD,   /**< U (ręczny) */
+        ACTION_BACK       /**< O (ręczny) */
+    };
+
 
 private:
     /// Aktualny tryb kamery
     CameraMode cameraMode;
     /// Wskaźnik do okna GLFW
     GLFWwindow* window;
+    /// Kopia stanu GL silnika (oświetlenie, cieniowanie, linie)
+    GLStateCache* glState;
+    /// Wejście buforowane silnika (stan akcji ruchu)
+    InputSystem* input;
 
     // Zmienne dla trybu FPS
     float camX = 0.0f, camY = 0.0f, camZ = 10.0f;
     float yaw = -90.0f;                         ///< Obrót w osi Y (lewo/prawo)
     float pitch = 0.0f;                         ///< Obrót w osi X (góra/dół)
+    Quat orientation;                           ///< Orientacja kamery FPS (z yaw i pitch)
     float moveSpeed = 10.0f;                    ///< Prędkość poruszania kamery
     float mouseSensitivity = 0.1f;              ///< Czułość myszy
     bool firstMouse = true;                     ///< Flaga pierwszego ruchu myszy
@@ -80,6 +136,15 @@ private:
     double staticRotation = 0.0;                ///< Kąt obrotu kamery
     bool rotateCamera = false;                  ///< Czy kamera się obraca
 
+    /**
+     * @brief Położenie kamery w chwili kroku symulacji (do interpolacji przy renderowaniu).
+     */
+    struct CameraPose {
+        float camX, camY, camZScroll, yaw, pitch;
+        double staticRotation;
+    };
+    CameraPose previousPose = {};               ///< Stan z początku ostatniego kroku symulacji
+
     // Zmienne dla scrolla myszy
     float camZScroll = 10.0f;                   ///< Pozycja kamery w osi Z                      
     const float scrollSpeed = 1.0f;             ///< Prędkość scrolla
@@ -88,28 +153,69 @@ private:
 
     // === OŚWIETLENIE ===
     bool lightingEnabled;     ///< Czy oświetlenie jest włączone
-    bool shadowsEnabled;      ///< Flaga cieni (na przyszłość)
+    bool shadowsEnabled;      ///< Czy rysowane są cienie światła 0 (kaskadowe mapy cieni)
     bool smoothShading;       ///< Tryb cieniowania
     float lightPosition[4];   ///< Pozycja światła
     float lightAmbient[4];    ///< Składnik ambient
     float lightDiffuse[4];    ///< Składnik diffuse
     float lightSpecular[4];   ///< Składnik specular
+    LightingState lighting;   ///< Światła i materiał w blokach uniform (LitShader)
 
     // === INNE ===
     bool showAxes;                ///< Czy osie świata są widoczne
 
+    static float Lerp(float a, float b, float t) { return a + (b - a) * t; }
+    /**
+     * @brief Orientacja kamery FPS z kątów yaw i pitch [stopnie].
+     */
+    static Quat OrientationFromAngles(float yaw, float pitch) {
+        return Quat::FromAxisAngle(Vec3(1.0f, 0.0f, 0.0f), Radians(-pitch))
+            * Quat::FromAxisAngle(Vec3(0.0f, 1.0f, 0.0f), Radians(-yaw));
+    }
+    CameraPose getPose() const {
+        return { camX, camY, camZScroll, yaw, pitch, staticRotation };
+    }
+    /**
+     * @brief Macierz widoku dla położenia pose i orientacji FPS rotation.
+     */
+    Mat4 buildViewMatrix(const CameraPose& pose, const Quat& rotation) const {
+        const Vec3 axisX(1.0f, 0.0f, 0.0f), axisY(0.0f, 1.0f, 0.0f);
+
+        if (cameraMode == STATIC_CAMERA) {
+            Mat4 view = Mat4::Translation(0.0f, 0.0f, -pose.camZScroll);
+            if (pose.camZScroll < 0) {
+                view = view * Mat4::Rotation(Radians(180.0f), axisY);
+            }
+            Quat orbit = Quat::FromAxisAngle(axisY, Radians(static_cast<float>(pose.staticRotation) * 0.5f))
+                * Quat::FromAxisAngle(axisX, Radians(20.0f));
+            return view * orbit.ToMat4();
+        }
+
+        Mat4 view = (cameraMode == FPS_CAMERA) ? rotation.ToMat4() : Mat4::Identity();
+        view = view * Mat4::Translation(-pose.camX, -pose.camY, -pose.camZScroll);
+        if (pose.camZScroll < 0 && cameraMode != FPS_CAMERA) {
+            view = view * Mat4::Rotation(Radians(180.0f), axisY);
+        }
+        return view;
+    }
+
 public:
     /**
      * @brief Konstruktor klasy Player.
      * @param win Wskaźnik do okna GLFW.
+     * @param state Kopia stanu GL, przez którą gracz zmienia stan.
+     * @param events Wejście, w którym gracz przypisuje klawisze ruchu.
      */
-    Player(GLFWwindow* win) : window(win) {
+    Player(GLFWwindow* win, GLStateCache& state, InputSystem& events) : window(win), glState(&state), input(&events) {
         cameraMode = STATIC_CAMERA;
         rotateCamera = false;
         lightingEnabled = true;
         shadowsEnabled = false;
         smoothShading = true;
         showAxes = false;
+        updateOrientation();
+        beginStep();
+        bindCameraKeys();
 
         // Domyślne parametry światła
         lightPosition[0] = -5.0f; lightPosition[1] = 10.0f;
@@ -123,6 +229,7 @@ public:
 
         lightSpecular[0] = 1.0f; lightSpecular[1] = 1.0f;
         lightSpecular[2] = 1.0f; lightSpecular[3] = 1.0f;
+        setupLighting();
 
         // Ustawienie kursoru
         glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_NORMAL);
@@ -135,6 +242,8 @@ public:
      */
     void setCameraMode(CameraMode mode) {
         cameraMode = mode;
+        beginStep();
+        bindCameraKeys();
 
         if (cameraMode == FPS_CAMERA) {
             glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
@@ -151,41 +260,59 @@ public:
             }
         }
     }
+    /**
+     * @brief Przypisuje klawisze akcji ruchu dla bieżącego trybu kamery.
+     *
+     * Klawisze I/J/K/L/U/O poruszają kamerą tylko w trybie ręcznym,
+     * więc L w trybie FPS przełącza wyłącznie oświetlenie.
+     */
+    void bindCameraKeys() {
+        input->ClearBindings();
+        if (cameraMode == FPS_CAMERA) {
+            input->Bind(ACTION_UP, GLFW_KEY_W);
+            input->Bind(ACTION_DOWN, GLFW_KEY_S);
+            input->Bind(ACTION_LEFT, GLFW_KEY_A);
+            input->Bind(ACTION_RIGHT, GLFW_KEY_D);
+        }
+        else if (cameraMode == MANUAL_CAMERA) {
+            input->Bind(ACTION_UP, GLFW_KEY_I);
+            input->Bind(ACTION_DOWN, GLFW_KEY_K);
+            input->Bind(ACTION_LEFT, GLFW_KEY_J);
+            input->Bind(ACTION_RIGHT, GLFW_KEY_L);
+            input->Bind(ACTION_FORWARD, GLFW_KEY_U);
+            input->Bind(ACTION_BACK, GLFW_KEY_O);
+        }
+    }
     /**
      * @brief Obsługuje ruch kamery w zależności od trybu.
-     * @param deltaTime Czas między klatkami.
+     *
+     * Stan akcji pochodzi z InputSystem::Update (raz na klatkę), a nie
+     * z odpytywania klawiszy w każdym kroku.
+     * @param deltaTime Długość kroku symulacji.
      */
     void handleCameraMovement(float deltaTime) {
         if (cameraMode == FPS_CAMERA) {
             float velocity = moveSpeed * deltaTime;
+            // Za obiektami (camZScroll < 0) sterowanie w osi X odwrócone
+            float side = camZScroll >= 0 ? velocity : -velocity;
 
-            if (camZScroll >= 0) {
-                // Normalne sterowanie - przed obiektami
-                if (glfwGetKey(window, GLFW_KEY_W) == GLFW_PRESS) camY += velocity;
-                if (glfwGetKey(window, GLFW_KEY_S) == GLFW_PRESS) camY -= velocity;
-                if (glfwGetKey(window, GLFW_KEY_A) == GLFW_PRESS) camX -= velocity;
-                if (glfwGetKey(window, GLFW_KEY_D) == GLFW_PRESS) camX += velocity;
-            }
-            else {
-                // Odwrócone sterowanie - za obiektami
-                if (glfwGetKey(window, GLFW_KEY_W) == GLFW_PRESS) camY += velocity;
-                if (glfwGetKey(window, GLFW_KEY_S) == GLFW_PRESS) camY -= velocity;
-                if (glfwGetKey(window, GLFW_KEY_A) == GLFW_PRESS) camX += velocity;
-                if (glfwGetKey(window, GLFW_KEY_D) == GLFW_PRESS) camX -= velocity;
-            }
+            if (input->IsDown(ACTION_UP)) camY += velocity;
+            if (input->IsDown(ACTION_DOWN)) camY -= velocity;
+            if (input->IsDown(ACTION_LEFT)) camX -= side;
+            if (input->IsDown(ACTION_RIGHT)) camX += side;
         }
         else if (cameraMode == MANUAL_CAMERA) {
             float velocity = moveSpeed * deltaTime;
 
-            if (glfwGetKey(window, GLFW_KEY_I) == GLFW_PRESS) camY += velocity;
-            if (glfwGetKey(window, GLFW_KEY_K) == GLFW_PRESS) camY -= velocity;
-            if (glfwGetKey(window, GLFW_KEY_J) == GLFW_PRESS) camX -= velocity;
-            if (glfwGetKey(window, GLFW_KEY_L) == GLFW_PRESS) camX += velocity;
-            if (glfwGetKey(window, GLFW_KEY_U) == GLFW_PRESS) {
+            if (input->IsDown(ACTION_UP)) camY += velocity;
+            if (input->IsDown(ACTION_DOWN)) camY -= velocity;
+            if (input->IsDown(ACTION_LEFT)) camX -= velocity;
+            if (input->IsDown(ACTION_RIGHT)) camX += velocity;
+            if (input->IsDown(ACTION_FORWARD)) {
                 camZScroll -= velocity;
                 if (camZScroll < minZ) camZScroll = minZ;
             }
-            if (glfwGetKey(window, GLFW_KEY_O) == GLFW_PRESS) {
+            if (input->IsDown(ACTION_BACK)) {
                 camZScroll += velocity;
                 if (camZScroll > maxZ) camZScroll = maxZ;
             }
@@ -193,7 +320,7 @@ public:
     }
     /**
      * @brief Aktualizuje obrót kamery statycznej.
-     * @param deltaTime Czas między klatkami.
+     * @param deltaTime Długość kroku symulacji.
      */
     void updateStaticRotation(float deltaTime) {
         if (cameraMode == STATIC_CAMERA && rotateCamera) {
@@ -202,39 +329,45 @@ public:
         }
     }
 
+    /**
+     * @brief Zapamiętuje stan kamery przed krokiem symulacji (poprzedni stan interpolacji).
+     */
+    void beginStep() {
+        previousPose = getPose();
+    }
+    /**
+     * @brief Przelicza orientację kamery FPS z kątów yaw i pitch.
+     */
+    void updateOrientation() {
+        orientation = OrientationFromAngles(yaw, pitch);
+    }
+    /**
+     * @brief Buduje macierz widoku dla bieżącego trybu kamery.
+     * @param alpha Chwila między poprzednim (0) a ostatnim (1) krokiem symulacji.
+     * @return Macierz widoku (świat -> kamera).
+     */
+    Mat4 getViewMatrix(float alpha = 1.0f) const {
+        if (alpha >= 1.0f) return buildViewMatrix(getPose(), orientation);
+
+        const CameraPose current = getPose();
+        CameraPose pose;
+        pose.camX = Lerp(previousPose.camX, current.camX, alpha);
+        pose.camY = Lerp(previousPose.camY, current.camY, alpha);
+        pose.camZScroll = Lerp(previousPose.camZScroll, current.camZScroll, alpha);
+        pose.yaw = Lerp(previousPose.yaw, current.yaw, alpha);
+        pose.pitch = Lerp(previousPose.pitch, current.pitch, alpha);
+        // Kąt obrotu zawija się przy 360 stopniach – interpolacja krótszą drogą
+        double rotation = current.staticRotation;
+        if (rotation < previousPose.staticRotation - 180.0) rotation += 360.0;
+        pose.staticRotation = previousPose.staticRotation + (rotation - previousPose.staticRotation) * alpha;
+        return buildViewMatrix(pose, OrientationFromAngles(pose.yaw, pose.pitch));
+    }
     /**
      * @brief Nakłada transformacje kamery na macierz widoku.
+     * @param view Macierz widoku klatki (getViewMatrix z chwili symulacji).
      */
-    void applyCameraTransform() {
-        glLoadIdentity();
-
-        if (cameraMode == STATIC_CAMERA) {
-            if (camZScroll >= 0) {
-                glTranslatef(0.0f, 0.0f, -camZScroll);
-            }
-            else {
-                glTranslatef(0.0f, 0.0f, -camZScroll);
-                glRotatef(180.0f, 0.0f, 1.0f, 0.0f);
-            }
-            glRotatef(staticRotation * 0.5f, 0.0f, 1.0f, 0.0f);
-            glRotatef(20.0f, 1.0f, 0.0f, 0.0f);
-        }
-        else {
-            if (cameraMode == FPS_CAMERA) {
-                glRotatef(-pitch, 1.0f, 0.0f, 0.0f);
-                glRotatef(-yaw, 0.0f, 1.0f, 0.0f);
-            }
-
-            if (camZScroll >= 0) {
-                glTranslatef(-camX, -camY, -camZScroll);
-            }
-            else {
-                glTranslatef(-camX, -camY, -camZScroll);
-                if (cameraMode != FPS_CAMERA) {
-                    glRotatef(180.0f, 0.0f, 1.0f, 0.0f);
-                }
-            }
-        }
+    void applyCameraTransform(const Mat4& view) {
+        glLoadMatrixf(view.Data());
     }
     /**
     * @brief Obsługuje ruch myszy (FPS).
@@ -259,11 +392,16 @@ public:
             xoffset *= mouseSensitivity;
             yoffset *= mouseSensitivity;
 
+            const float oldYaw = yaw, oldPitch = pitch;
             yaw -= xoffset;
             pitch += yoffset;
 
             if (pitch > 89.0f) pitch = 89.0f;
             if (pitch < -89.0f) pitch = -89.0f;
+            updateOrientation();
+            // Zdarzenia myszy przesuwają też poprzedni stan – interpolacja ich nie opóźnia
+            previousPose.yaw += yaw - oldYaw;
+            previousPose.pitch += pitch - oldPitch;
         }
     }
     /**
@@ -271,9 +409,11 @@ public:
      * @param yoffset Przesunięcie scrolla.
      */
     void handleMouseScroll(float yoffset) {
+        const float oldZ = camZScroll;
         camZScroll += yoffset * scrollSpeed;
         if (camZScroll < minZ) camZScroll = minZ;
         if (camZScroll > maxZ) camZScroll = maxZ;
+        previousPose.camZScroll += camZScroll - oldZ;
         std::cout << "Pozycja Z: " << camZScroll << std::endl;
     }
     /**
@@ -294,48 +434,56 @@ public:
         camZScroll = 10.0f;
         yaw = -90.0f;
         pitch = 0.0f;
+        updateOrientation();
         staticRotation = 0.0;
         rotateCamera = false;
         cameraMode = STATIC_CAMERA;
+        beginStep(); // skok bez interpolacji
+        bindCameraKeys();
         glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_NORMAL);
         std::cout << "Kamera zresetowana do pozycji domyślnej" << std::endl;
     }
     /**
-    * @brief Konfiguruje oświetlenie OpenGL.
+    * @brief Konfiguruje oświetlenie.
+    *
+    * Parametry światła i materiału trafiają do LightingState, skąd shader
+    * oświetlenia czyta je z bloków uniform. GL_LIGHTING dotyczy tylko potoku
+    * stałych funkcji (kontekst bez GLSL).
     */
     // === METODY OŚWIETLENIA ===
     void setupLighting() {
-        if (lightingEnabled) {
-            glEnable(GL_LIGHTING);
-            glEnable(GL_LIGHT0);
-
-            glLightfv(GL_LIGHT0, GL_POSITION, lightPosition);
-            glLightfv(GL_LIGHT0, GL_AMBIENT, lightAmbient);
-            glLightfv(GL_LIGHT0, GL_DIFFUSE, lightDiffuse);
-            glLightfv(GL_LIGHT0, GL_SPECULAR, lightSpecular);
-
-            glEnable(GL_COLOR_MATERIAL);
-            glColorMaterial(GL_FRONT_AND_BACK, GL_AMBIENT_AND_DIFFUSE);
-
-            float mat_specular[] = { 0.5f, 0.5f, 0.5f, 1.0f };
-            float mat_shininess[] = { 50.0f };
-            glMaterialfv(GL_FRONT_AND_BACK, GL_SPECULAR, mat_specular);
-            glMaterialfv(GL_FRONT_AND_BACK, GL_SHININESS, mat_shininess);
+        syncLight();
+        float mat_specular[] = { 0.5f, 0.5f, 0.5f, 1.0f };
+        lighting.SetMaterial(mat_specular, 50.0f);
 
-            updateLightPosition();
-        }
-        else {
-            glDisable(GL_LIGHTING);
-            glDisable(GL_LIGHT0);
+        glState->SetEnabled(GL_LIGHTING, lightingEnabled);
+    }
+    /**
+     * @brief Przepisuje parametry światła do LightingState.
+     */
+    void syncLight() {
+        LightSource light;
+        for (int i = 0; i < 4; i++) {
+            light.position[i] = lightPosition[i];
+            light.ambient[i] = lightAmbient[i];
+            light.diffuse[i] = lightDiffuse[i];
+            light.specular[i] = lightSpecular[i];
         }
+        lighting.SetLight(0, light);
     }
     /**
-     * @brief Aktualizuje pozycję światła.
+     * @brief Aktualizuje pozycję światła dla bieżącej kamery (raz na klatkę).
+     * @param view Macierz widoku klatki.
      */
-    void updateLightPosition() {
-        // Aktualizacja pozycji światła (można dodać animację)
-        glLightfv(GL_LIGHT0, GL_POSITION, lightPosition);
+    void updateLightPosition(const Mat4& view) {
+        lighting.Update(view);
+        // Bez GLSL światła ładowane są do potoku stałych funkcji
+        if (!GetGLCapabilities().shaders && lightingEnabled) lighting.ApplyFixedFunction();
     }
+    /**
+     * @brief Zwraca stan oświetlenia dla shadera.
+     */
+    const LightingState& getLighting() const { return lighting; }
     /**
      * @brief Włącza lub wyłącza oświetlenie.
      */
@@ -352,31 +500,49 @@ public:
         lightPosition[1] = y;
         lightPosition[2] = z;
         lightPosition[3] = w;
-        if (lightingEnabled) {
-            glLightfv(GL_LIGHT0, GL_POSITION, lightPosition);
-        }
+        syncLight();
     }
     /**
     * @brief Ustawia kolor światła.
     */
     void setLightColor(float r, float g, float b, float a = 1.0f) {
         lightDiffuse[0] = r; lightDiffuse[1] = g; lightDiffuse[2] = b; lightDiffuse[3] = a;
-        if (lightingEnabled) {
-            glLightfv(GL_LIGHT0, GL_DIFFUSE, lightDiffuse);
-        }
+        syncLight();
+    }
+    /**
+     * @brief Zwraca kierunek do światła 0 w układzie świata.
+     *
+     * Dla światła punktowego – kierunek od początku układu do jego pozycji.
+     */
+    Vec3 getLightDirection() const {
+        return Normalize(Vec3(lightPosition[0], lightPosition[1], lightPosition[2]));
     }
+    /**
+     * @brief Włącza lub wyłącza cienie.
+     */
+    void toggleShadows() {
+        shadowsEnabled = !shadowsEnabled;
+        std::cout << "Cienie: " << (shadowsEnabled ? "Włączone" : "Wyłączone") << std::endl;
+    }
+    /**
+     * @brief Ustawia rysowanie cieni.
+     */
+    void setShadowsEnabled(bool enabled) { shadowsEnabled = enabled; }
+    bool isShadowsEnabled() const { return shadowsEnabled; }
     /**
      * @brief Przełącza tryb cieniowania (flat/smooth).
+     *
+     * Przy dostępnym GLSL tryb wybiera wariant LitShader (LIT_SMOOTH/LIT_FLAT).
      */
     // === METODY CIENIOWANIA ===
     void toggleShading() {
         smoothShading = !smoothShading;
         if (smoothShading) {
-            glShadeModel(GL_SMOOTH);
+            glState->ShadeModel(GL_SMOOTH);
             std::cout << "Cieniowanie: Gouraud (smooth)" << std::endl;
         }
         else {
-            glShadeModel(GL_FLAT);
+            glState->ShadeModel(GL_FLAT);
             std::cout << "Cieniowanie: Płaskie (flat)" << std::endl;
         }
     }
@@ -396,12 +562,15 @@ public:
     }
     /**
      * @brief Rysuje osie świata.
+     *
+     * Oświetlenie wyłączane jest przez pamięć stanu – włącza je ponownie
+     * dopiero pierwszy oświetlony obiekt sceny.
      */
     void drawAxes() {
         if (!showAxes) return;
 
-        glDisable(GL_LIGHTING);
-        glLineWidth(3.0f);
+        glState->SetEnabled(GL_LIGHTING, false);
+        glState->LineWidth(3.0f);
 
         glBegin(GL_LINES);
         // Oś X - CZERWONA
@@ -418,10 +587,7 @@ public:
         glVertex3f(0.0f, 0.0f, 10.0f);
         glEnd();
 
-        glLineWidth(1.0f);
-        if (lightingEnabled) {
-            glEnable(GL_LIGHTING);
-        }
+        glState->LineWidth(1.0f);
     }
 
     // === GETTERY I SETTERY ===
@@ -458,6 +624,7 @@ public:
         std::cout << "Obrót kamery: " << (rotateCamera ? "Włączony" : "Wyłączony") << "\n";
         std::cout << "Oświetlenie: " << (lightingEnabled ? "Włączone" : "Wyłączone") << "\n";
         std::cout << "Cieniowanie: " << (smoothShading ? "Gouraud" : "Płaskie") << "\n";
+        std::cout << "Cienie: " << (shadowsEnabled ? "Włączone" : "Wyłączone") << "\n";
         std::cout << "Osie: " << (showAxes ? "Widoczne" : "Ukryte") << "\n";
         std::cout << "Prędkość ruchu: " << moveSpeed << "\n";
         std::cout << "Czułość myszy: " << mouseSensitivity << std::endl;
@@ -489,69 +656,151 @@ private:
     bool isPerspective;     ///< Czy rzutowanie perspektywiczne
     bool vsyncEnabled;      ///< Czy VSync jest włączony
     bool depthTestEnabled;  ///< Czy test głębokości jest włączony
+    bool headless;          ///< Czy silnik działa bez widocznego okna
+
+    /// Parametry trybu bez okna
+    int headlessFrames = 1;                 ///< Liczba klatek do wyrenderowania
+    std::string headlessPrefix = "frame";   ///< Prefiks plików z klatkami
+    OffscreenTarget offscreenTarget;        ///< Bufor ramki dla trybu bez okna
+    bool softwareRender = false;            ///< Klatki bez okna rysowane przez rasteryzer programowy
+    SoftwareRasterizer softwareRasterizer;  ///< Rasteryzer CPU (węzły bez GPU)
+    BitmapHandler softwareTexture;          ///< Tekstura sześcianu dla rasteryzera (RGBA)
+    std::vector<unsigned char> headlessPixels; ///< Piksele odczytanej klatki
+    double headlessTotalMs = 0.0;           ///< Suma czasów renderowania klatek
+    double headlessWorstMs = 0.0;           ///< Najdłuższy czas renderowania klatki
+    int headlessSaved = 0;                  ///< Zapisane pliki PPM
 
     /// Kolor czyszczenia ekranu (RGBA)
     float clearColor[4];
 
-    /// Docelowa liczba klatek na sekundę
+    /// Docelowa liczba klatek na sekundę (wątek główny; renderowanie dostaje ją w COMMAND_CAMERA)
     int targetFPS;
 
     /// Czas ostatniej klatki
     double lastFrameTime;
 
+    /// Ogranicznik FPS (sen + krótkie aktywne czekanie) ze statystykami
+    FramePacer framePacer;
+
+    /// Stały krok symulacji (--sim-rate, domyślnie 120 Hz) niezależny od tempa klatek
+    FixedTimestep simulationClock;
+
+    /// Wejście: callbacki okna kolejkują zdarzenia, processInput odbiera je raz na klatkę
+    InputSystem input;
+    std::vector<InputEvent> inputEvents;    ///< Zdarzenia odebrane w bieżącej klatce
+
+    /// Wątek renderowania z listami poleceń (--render-thread); nullptr – symulacja i GL na jednym wątku
+    std::unique_ptr<RenderThread> renderThread;
+    RenderCommandList* recordingList = nullptr; ///< Lista nagrywana przez wątek główny (zdarzenia z processInput)
+    /// Polecenia list wątku renderowania
+    enum EngineCommand { COMMAND_KEY, COMMAND_RESIZE, COMMAND_CAMERA, COMMAND_LIGHTS, COMMAND_INPUT };
+
+    /// Stan klatki czytany przez renderowanie – z symulacji albo z listy poleceń
+    Mat4 frameView;                            ///< Macierz widoku kamery
+    const PointLight* frameLights = nullptr;   ///< Światła dynamiczne klatki
+    size_t frameLightCount = 0;
+    InputStamp frameInput;                     ///< Najstarsze wejście pokazywane w klatce (pomiar opóźnienia)
+    int frameTargetFPS = 60;                   ///< Docelowe FPS klatki (budżet na nakładce profilera)
+
+    /// Profiler etapów klatki (bufor ostatnich klatek, eksport CSV/Chrome Trace)
+    FrameProfiler profiler;
+    bool showProfilerOverlay = false; ///< Czy wykres profilera jest rysowany
+
     /// Macierze projekcji
-    float projectionMatrix[16];
-    float orthoMatrix[16];
-    float perspectiveMatrix[16];
+    Mat4 projectionMatrix;
+    Mat4 orthoMatrix;
+    Mat4 perspectiveMatrix;
 
     /// Wskaźnik na obiekt gracza/kamery
     Player* player;
 
+    /// Cache tekstur (każdy plik dekodowany tylko raz)
+    TextureCache textureCache;
+    /// Najwięcej bajtów tekstur wczytanych w tle wysyłanych w jednej klatce
+    size_t textureUploadBudget = 1024 * 1024;
+    /// Uchwyt tekstury sześcianu
+    TextureHandle myTexture = INVALID_TEXTURE;
+
+    /// Siatki prymitywów w buforach GPU
+    Mesh cubeMesh;
+    Mesh pyramidMesh;
+    SphereMeshCache sphereCache;    ///< Siatki kuli dla każdej liczby segmentów
+    const Mesh* currentSphere = nullptr; ///< Siatka kuli dla bieżącego sphereSegments
+    bool useImmediateMode = false;  ///< Rysowanie przez glBegin/glEnd (do porównań)
+    Mesh gridMesh;                  ///< Siatka podłoża (linie)
+
+    /// Obiekty sceny (pozycje, siatki, materiały w tablicach SoA)
+    Scene scene;
+    int sphereMeshId = -1;          ///< Numer siatki kuli w scenie (podmieniany przy zmianie LOD)
+
+    /// Shader oświetlenia na piksel (warianty smooth/flat, zwykły/instancjonowany, klastrowy)
+    LitShader litShader;
+
+    /// Dynamiczne światła punktowe przypisywane do klastrów bryły widzenia
+    ClusteredLighting clusteredLighting;
+    std::vector<PointLight> dynamicLights;     ///< Światła bieżącej klatki
+    std::vector<PointLight> dynamicLightBase;  ///< Położenia początkowe (obracane wokół osi Y)
+    float dynamicLightAngle = 0.0f;            ///< Bieżący kąt obrotu świateł
+    float previousLightAngle = 0.0f;           ///< Kąt sprzed ostatniego kroku symulacji (interpolacja)
+    int dynamicLightLevel = 0;                 ///< Poziom liczby świateł (klawisz F3)
+    bool clustersActive = false;               ///< Czy klatka rysowana jest z listami klastrów
+
+    /// Kaskadowe mapy cieni światła 0
+    ShadowMap shadowMap;
+    std::vector<unsigned char> shadowMask;     ///< Obiekty rzucające cień w bieżącej kaskadzie
+    bool shadowsActive = false;                ///< Czy klatka rysowana jest z cieniami
+
+    /// Kolejka obiektów sceny sortowana po stanie (ścieżka PER_OBJECT)
+    RenderQueue renderQueue;
+    /// Kopia stanu GL pomijająca wywołania bez efektu (F8 – sprawdzanie glGet*)
+    GLStateCache stateCache;
+
+    /// Rysowanie obiektów sceny partiami instancji (jedna partia na parę siatka+materiał)
+    InstanceRenderer instanceRenderer;
+    InstancePath instancePath = INSTANCE_PATH_PER_OBJECT;     ///< Bieżąca ścieżka rysowania sceny
+    std::vector<std::unique_ptr<InstanceBatch>> sceneBatches; ///< Partie zbudowane ze sceny
+    std::vector<int> batchMeshIds;      ///< Siatka każdej partii
+    std::vector<int> batchMaterialIds;  ///< Materiał każdej partii
+    unsigned int batchRevision = ~0u;   ///< Wersja sceny, z której zbudowano partie
+    std::vector<std::vector<unsigned int>> batchObjects;       ///< Obiekty sceny w każdej partii
+    std::vector<std::unique_ptr<InstanceBatch>> visibleBatches; ///< Widoczne instancje partii (co klatkę)
+
+    /// Odrzucanie obiektów poza bryłą widzenia
+    enum CullMode { CULL_OFF, CULL_FLAT, CULL_BVH, CULL_MODE_COUNT };
+    CullMode cullMode = CULL_BVH;           ///< Bieżący tryb cullingu
+    std::vector<unsigned char> visibleMask; ///< Widoczność obiektów sceny w bieżącej klatce
+    SceneBVH sceneBvh;                      ///< Hierarchia brył otaczających sceny
+    unsigned int bvhRevision = ~0u;         ///< Wersja sceny, z której zbudowano BVH
+    CullStats cullStats;                    ///< Liczniki ostatniego cullingu
+
+    /// Zakres głębokości projekcji (także zakres warstw klastrów)
+    const float nearPlane = 0.1f;
+    const float farPlane = 100.0f;
+
     /// Parametry geometrii kuli
     int sphereSegments = 16;
     const int minSegments = 8;
     const int maxSegments = 64;
     const int baseSegments = 16;
 
-    /**
-     * @brief Ustawia macierz jednostkową.
-     * @param matrix Wskaźnik na tablicę 4x4
-     */
-    void setIdentityMatrix(float* matrix) {
-        for (int i = 0; i < 16; i++) matrix[i] = 0.0f;
-        matrix[0] = matrix[5] = matrix[10] = matrix[15] = 1.0f;
-    }
     /**
     * @brief Tworzy macierz rzutowania ortogonalnego.
     */
     void setOrthographic(float left, float right, float bottom, float top, float near, float far) {
-        setIdentityMatrix(orthoMatrix);
-        orthoMatrix[0] = 2.0f / (right - left);
-        orthoMatrix[5] = 2.0f / (top - bottom);
-        orthoMatrix[10] = -2.0f / (far - near);
-        orthoMatrix[12] = -(right + left) / (right - left);
-        orthoMatrix[13] = -(top + bottom) / (top - bottom);
-        orthoMatrix[14] = -(far + near) / (far - near);
+        orthoMatrix = Mat4::Orthographic(left, right, bottom, top, near, far);
     }
     /**
      * @brief Tworzy macierz rzutowania perspektywicznego.
      */
     void setPerspective(float fov, float aspect, float near, float far) {
-        setIdentityMatrix(perspectiveMatrix);
-        float f = 1.0f / tan(fov * 3.14159f / 360.0f);
-        perspectiveMatrix[0] = f / aspect;
-        perspectiveMatrix[5] = f;
-        perspectiveMatrix[10] = (far + near) / (near - far);
-        perspectiveMatrix[11] = -1.0f;
-        perspectiveMatrix[14] = (2.0f * far * near) / (near - far);
-        perspectiveMatrix[15] = 0.0f;
+        perspectiveMatrix = Mat4::Perspective(Radians(fov), aspect, near, far);
     }
     /**
      * @brief Wgrywa aktualną macierz projekcji do OpenGL.
      */
     void applyProjectionMatrix() {
         glMatrixMode(GL_PROJECTION);
-        glLoadMatrixf(projectionMatrix);
+        glLoadMatrixf(projectionMatrix.Data());
         glMatrixMode(GL_MODELVIEW);
     }
     /**
@@ -561,15 +810,63 @@ private:
         float aspect = (float)width / (float)height;
 
         if (isPerspective) {
-            setPerspective(60.0f, aspect, 0.1f, 100.0f);
-            for (int i = 0; i < 16; i++) projectionMatrix[i] = perspectiveMatrix[i];
+            setPerspective(60.0f, aspect, nearPlane, farPlane);
+            projectionMatrix = perspectiveMatrix;
         }
         else {
-            setOrthographic(-10.0f * aspect, 10.0f * aspect, -10.0f, 10.0f, 0.1f, 100.0f);
-            for (int i = 0; i < 16; i++) projectionMatrix[i] = orthoMatrix[i];
+            setOrthographic(-10.0f * aspect, 10.0f * aspect, -10.0f, 10.0f, nearPlane, farPlane);
+            projectionMatrix = orthoMatrix;
         }
         applyProjectionMatrix();
     }
+    /**
+     * @brief Ustawia wskazówki tworzenia okna i kontekstu.
+     */
+    void applyWindowHints() {
+        glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 2);
+        glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 1);
+        glfwWindowHint(GLFW_RESIZABLE, GLFW_TRUE);
+        glfwWindowHint(GLFW_VISIBLE, headless ? GLFW_FALSE : GLFW_TRUE);
+    }
+    /**
+     * @brief Inicjalizuje GLFW i tworzy okno z kontekstem OpenGL.
+     *
+     * W trybie bez okna tworzone jest ukryte okno; jeśli brak wyświetlacza,
+     * używana jest platforma "null" GLFW z programowym kontekstem OSMesa.
+     * @return True jeśli kontekst został utworzony.
+     */
+    bool createContext(const char* title) {
+        if (glfwInit()) {
+            applyWindowHints();
+            window = glfwCreateWindow(width, height, title, NULL, NULL);
+            if (window) return true;
+            glfwTerminate();
+            if (!headless) {
+                std::cerr << "Błąd tworzenia okna!" << std::endl;
+                return false;
+            }
+        }
+        else if (!headless) {
+            std::cerr << "Błąd inicjalizacji GLFW!" << std::endl;
+            return false;
+        }
+
+        std::cerr << "Brak wyświetlacza - próba kontekstu programowego (OSMesa)" << std::endl;
+        glfwInitHint(GLFW_PLATFORM, GLFW_PLATFORM_NULL);
+        if (!glfwInit()) {
+            std::cerr << "Błąd inicjalizacji GLFW!" << std::endl;
+            return false;
+        }
+        applyWindowHints();
+        glfwWindowHint(GLFW_CONTEXT_CREATION_API, GLFW_OSMESA_CONTEXT_API);
+        window = glfwCreateWindow(width, height, title, NULL, NULL);
+        if (!window) {
+            std::cerr << "Błąd tworzenia kontekstu poza ekranem!" << std::endl;
+            glfwTerminate();
+            return false;
+        }
+        return true;
+    }
 
 public:
     /**
@@ -577,11 +874,12 @@ public:
     * @param w Szerokość okna
     * @param h Wysokość okna
     * @param title Tytuł okna
+    * @param headlessMode Renderowanie poza ekranem (bez widocznego okna)
     */
-    Engine(int w = 800, int h = 600, const char* title = "3D Engine")
-        : width(w), height(h), isFullscreen(false), isPerspective(true),
-        vsyncEnabled(true), depthTestEnabled(true), targetFPS(60),
-        lastFrameTime(0) {
+    Engine(int w = 800, int h = 600, const char* title = "3D Engine", bool headlessMode = false)
+        : window(nullptr), width(w), height(h), isFullscreen(false), isPerspective(true),
+        vsyncEnabled(!headlessMode), depthTestEnabled(true), headless(headlessMode), targetFPS(60),
+        lastFrameTime(0), player(nullptr) {
 
         srand(static_cast<unsigned>(time(nullptr)));
 
@@ -590,19 +888,7 @@ public:
         clearColor[2] = 0.3f;
         clearColor[3] = 1.0f;
 
-        if (!glfwInit()) {
-            std::cerr << "Błąd inicjalizacji GLFW!" << std::endl;
-            return;
-        }
-
-        glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 2);
-        glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 1);
-        glfwWindowHint(GLFW_RESIZABLE, GLFW_TRUE);
-
-        window = glfwCreateWindow(width, height, title, NULL, NULL);
-        if (!window) {
-            std::cerr << "Błąd tworzenia okna!" << std::endl;
-            glfwTerminate();
+        if (!createContext(title)) {
             return;
         }
 
@@ -617,17 +903,24 @@ public:
         glfwSetWindowCloseCallback(window, closeCallbackStatic);
         glfwSetCursorPosCallback(window, mouseMoveCallbackStatic);
 
-        glEnable(GL_DEPTH_TEST);
+        stateCache.SetEnabled(GL_DEPTH_TEST, true);
         glDepthFunc(GL_LESS);
-        glEnable(GL_CULL_FACE);
+        stateCache.SetEnabled(GL_CULL_FACE, true);
         glCullFace(GL_BACK);
-        glEnable(GL_NORMALIZE);
+        stateCache.SetEnabled(GL_NORMALIZE, true);
 
-        player = new Player(window);
+        LoadGLExtensions();
+        litShader.Init();
+        if (instanceRenderer.Init(&litShader)) instancePath = INSTANCE_PATH_HARDWARE;
+
+        player = new Player(window, stateCache, input);
         updateProjection();
+        LoadMyTexture();
+        buildMeshes();
+        buildScene();
         lastFrameTime = glfwGetTime();
 
-        printControlInfo();
+        if (!headless) printControlInfo();
     }
     /**
      * @brief Destruktor silnika.
@@ -640,6 +933,22 @@ public:
      */
     void shutdown() {
         std::cout << "Zamykanie silnika..." << std::endl;
+        textureCache.Release(myTexture);
+        myTexture = INVALID_TEXTURE;
+        textureCache.PrintStats();
+        textureCache.Clear();
+        framePacer.PrintStats();
+        cubeMesh.ReleaseGPU();
+        pyramidMesh.ReleaseGPU();
+        gridMesh.ReleaseGPU();
+        sceneBatches.clear();
+        visibleBatches.clear();
+        instanceRenderer.Release();
+        clusteredLighting.ReleaseGPU();
+        shadowMap.ReleaseGPU();
+        litShader.Release();
+        sphereCache.Clear();
+        currentSphere = nullptr;
         if (player) delete player;
         if (window) glfwDestroyWindow(window);
         glfwTerminate();
@@ -669,18 +978,25 @@ public:
         GLFWmonitor* monitor = glfwGetPrimaryMonitor();
         const GLFWvidmode* mode = glfwGetVideoMode(monitor);
 
+        int w = 800, h = 600;
         if (isFullscreen) {
-            glfwSetWindowMonitor(window, monitor, 0, 0, mode->width, mode->height, mode->refreshRate);
-            width = mode->width;
-            height = mode->height;
+            w = mode->width;
+            h = mode->height;
+            glfwSetWindowMonitor(window, monitor, 0, 0, w, h, mode->refreshRate);
         }
         else {
-            glfwSetWindowMonitor(window, NULL, 100, 100, 800, 600, 0);
-            width = 800;
-            height = 600;
+            glfwSetWindowMonitor(window, NULL, 100, 100, w, h, 0);
         }
 
-        updateProjection();
+        // Rozmiar i projekcja należą do wątku renderowania
+        if (renderThreadActive()) {
+            recordCommand(COMMAND_RESIZE, w, h);
+        }
+        else {
+            width = w;
+            height = h;
+            updateProjection();
+        }
         std::cout << "Tryb: " << (isFullscreen ? "Pełny ekran" : "Okno") << std::endl;
     }
     /**
@@ -704,16 +1020,34 @@ public:
     */
     void toggleDepthTest() {
         depthTestEnabled = !depthTestEnabled;
-        if (depthTestEnabled) glEnable(GL_DEPTH_TEST);
-        else glDisable(GL_DEPTH_TEST);
+        stateCache.SetEnabled(GL_DEPTH_TEST, depthTestEnabled);
         std::cout << "Test głębokości: " << (depthTestEnabled ? "Włączony" : "Wyłączony") << std::endl;
     }
+    /**
+     * @brief Przełącza ścieżkę rysowania sceny (instancing / scalona / osobno).
+     */
+    void cycleInstancePath() {
+        instancePath = static_cast<InstancePath>((instancePath + 1) % INSTANCE_PATH_COUNT);
+        if (instancePath == INSTANCE_PATH_HARDWARE && !instanceRenderer.IsHardwareSupported()) {
+            instancePath = INSTANCE_PATH_MERGED;
+        }
+        std::cout << "Rysowanie sceny: " << GetInstancePathName(instancePath) << std::endl;
+    }
+    /**
+     * @brief Przełącza ścieżkę rysowania siatek (bufory GPU / glBegin-glEnd).
+     */
+    void toggleImmediateMode() {
+        useImmediateMode = !useImmediateMode;
+        std::cout << "Rysowanie siatek: " << (useImmediateMode ? "tryb natychmiastowy (glBegin/glEnd)"
+            : (cubeMesh.IsUploaded() ? "bufory GPU (VBO/IBO)" : "tablice wierzchołków")) << std::endl;
+    }
     /**
      * @brief Zwiększa szczegółowość kuli.
      */
     void increaseSphereDetail() {
         if (sphereSegments * 2 <= maxSegments) {
             sphereSegments *= 2;
+            setSphereMesh(sphereCache.Get(sphereSegments));
             std::cout << "Zwiększono liczbę segmentów kuli: " << sphereSegments;
             std::cout << " (poligony: ~" << (sphereSegments * sphereSegments * 2) << ")" << std::endl;
         }
@@ -727,6 +1061,7 @@ public:
     void decreaseSphereDetail() {
         if (sphereSegments / 2 >= minSegments) {
             sphereSegments /= 2;
+            setSphereMesh(sphereCache.Get(sphereSegments));
             std::cout << "Zmniejszono liczbę segmentów kuli: " << sphereSegments;
             std::cout << " (poligony: ~" << (sphereSegments * sphereSegments * 2) << ")" << std::endl;
         }
@@ -739,6 +1074,7 @@ public:
     */
     void resetSphereDetail() {
         sphereSegments = baseSegments;
+        setSphereMesh(sphereCache.Get(sphereSegments));
         std::cout << "Zresetowano liczbę segmentów kuli: " << sphereSegments;
         std::cout << " (poligony: ~" << (sphereSegments * sphereSegments * 2) << ")" << std::endl;
     }
@@ -751,236 +1087,1410 @@ public:
     }
     /**
      * @brief Ogranicza liczbę klatek na sekundę.
+     *
+     * Wątek śpi przez większość czasu oczekiwania, a aktywnie czeka tylko
+     * przez ostatni ułamek milisekundy (zob. FramePacer).
      */
     void limitFPS() {
-        double targetFrameTime = 1.0 / targetFPS;
-        double currentTime = glfwGetTime();
-        double elapsed = currentTime - lastFrameTime;
+        framePacer.SetTargetFPS(targetFPS);
+        framePacer.WaitForNextFrame();
+    }
+    /**
+     * @brief Buduje siatki prymitywów i wysyła je do GPU.
+     */
+    void buildMeshes() {
+        cubeMesh.BuildCube();
+        cubeMesh.Upload();
+        pyramidMesh.BuildPyramid();
+        pyramidMesh.Upload();
+        gridMesh.BuildGrid(5, 0.5f, 0.5f, 0.5f);
+        gridMesh.Upload();
+        // Wszystkie poziomy osiągalne klawiszami T/Y budowane z góry
+        sphereCache.Prewarm(minSegments, maxSegments);
+        setSphereMesh(sphereCache.Get(sphereSegments));
+    }
+    /**
+     * @brief Ustawia bieżącą siatkę kuli (także w tabeli siatek sceny).
+     */
+    void setSphereMesh(const Mesh* mesh) {
+        currentSphere = mesh;
+        scene.SetMesh(sphereMeshId, mesh);
+    }
+    /**
+     * @brief Rejestruje siatki i materiały oraz tworzy domyślną scenę.
+     */
+    void buildScene() {
+        scene.AddMesh("cube", &cubeMesh);
+        scene.AddMesh("pyramid", &pyramidMesh);
+        sphereMeshId = scene.AddMesh("sphere", currentSphere);
+        scene.AddMesh("grid", &gridMesh);
 
-        if (elapsed < targetFrameTime) {
-            double sleepTime = (targetFrameTime - elapsed);
-            if (sleepTime > 0) {
-                double start = glfwGetTime();
-                while (glfwGetTime() - start < sleepTime) {}
-            }
+        SceneMaterial textured;
+        textured.texture = myTexture;
+        scene.AddMaterial("textured", textured);
+
+        SceneMaterial vertexColor;
+        scene.AddMaterial("vertexColor", vertexColor);
+
+        SceneMaterial sphere;
+        sphere.flatColorVariant = Mesh::SPHERE_FLAT_COLORS;
+        scene.AddMaterial("sphere", sphere);
+
+        SceneMaterial unlit;
+        unlit.lit = false;
+        scene.AddMaterial("unlit", unlit);
+
+        buildDefaultScene();
+    }
+    /**
+     * @brief Wypełnia scenę trzema bryłami i siatką podłoża.
+     */
+    void buildDefaultScene() {
+        scene.ClearObjects();
+        scene.AddObject(scene.FindMesh("cube"), scene.FindMaterial("textured"), -4.0f, 0.0f, 0.0f, 1.0f);
+        scene.AddObject(scene.FindMesh("pyramid"), scene.FindMaterial("vertexColor"), 0.0f, 0.0f, 0.0f, 1.5f);
+        scene.AddObject(sphereMeshId, scene.FindMaterial("sphere"), 4.0f, 0.0f, 0.0f, 1.5f);
+        scene.AddObject(scene.FindMesh("grid"), scene.FindMaterial("unlit"), 0.0f, 0.0f, 0.0f, 1.0f);
+    }
+    /**
+     * @brief Zastępuje scenę wczytaną z pliku.
+     * @param filePath Plik w formacie Scene::LoadFromFile
+     */
+    void loadScene(const std::string& filePath) {
+        scene.ClearObjects();
+        scene.LoadFromFile(filePath);
+        std::cout << "Wczytano scenę " << filePath << ": " << scene.GetObjectCount() << " obiektów" << std::endl;
+    }
+    /**
+     * @brief Wypełnia scenę kwadratową siatką count obiektów (test obciążenia).
+     * @param count Liczba obiektów (sześciany, piramidy i kule na przemian)
+     */
+    void buildStressScene(int count) {
+        if (sphereMeshId < 0) return;
+        const int meshIds[3] = { scene.FindMesh("cube"), scene.FindMesh("pyramid"), sphereMeshId };
+        const int materialIds[3] = { scene.FindMaterial("textured"), scene.FindMaterial("vertexColor"), scene.FindMaterial("sphere") };
+        const float spacing = 3.0f;
+        int side = static_cast<int>(std::ceil(std::sqrt(static_cast<double>(count))));
+        float offset = (side - 1) * spacing * 0.5f;
+
+        scene.ClearObjects();
+        scene.Reserve(count);
+        for (int i = 0; i < count; i++) {
+            int kind = i % 3;
+            scene.AddObject(meshIds[kind], materialIds[kind],
+                (i % side) * spacing - offset, (i / side) * spacing - offset, 0.0f, 1.0f);
         }
+        std::cout << "Scena testowa: " << count << " obiektów (" << side << "x" << side << ")" << std::endl;
     }
     /**
-     * @brief Rysuje sześcian.
-     */
-    void drawCube(float x, float y, float z, float size = 1.0f) {
-        glPushMatrix();
-        glTranslatef(x, y, z);
-        glScalef(size, size, size);
-
-        // 1. Włączamy teksturowanie i wybieramy teksturę
-        glEnable(GL_TEXTURE_2D);
-        glBindTexture(GL_TEXTURE_2D, myTexture);
-
-        // 2. Ustawiamy kolor na biały (inaczej tekstura będzie zabarwiona)
-        glColor3f(1.0f, 1.0f, 1.0f);
-
-        glBegin(GL_QUADS);
-
-        // Przód
-        glNormal3f(0.0f, 0.0f, 1.0f);
-        glTexCoord2f(0.0f, 0.0f); glVertex3f(-0.5f, -0.5f, 0.5f);
-        glTexCoord2f(1.0f, 0.0f); glVertex3f(0.5f, -0.5f, 0.5f);
-        glTexCoord2f(1.0f, 1.0f); glVertex3f(0.5f, 0.5f, 0.5f);
-        glTexCoord2f(0.0f, 1.0f); glVertex3f(-0.5f, 0.5f, 0.5f);
-
-        // Tył
-        glNormal3f(0.0f, 0.0f, -1.0f);
-        glTexCoord2f(1.0f, 0.0f); glVertex3f(-0.5f, -0.5f, -0.5f);
-        glTexCoord2f(1.0f, 1.0f); glVertex3f(-0.5f, 0.5f, -0.5f);
-        glTexCoord2f(0.0f, 1.0f); glVertex3f(0.5f, 0.5f, -0.5f);
-        glTexCoord2f(0.0f, 0.0f); glVertex3f(0.5f, -0.5f, -0.5f);
-
-        // Góra
-        glNormal3f(0.0f, 1.0f, 0.0f);
-        glTexCoord2f(0.0f, 1.0f); glVertex3f(-0.5f, 0.5f, -0.5f);
-        glTexCoord2f(0.0f, 0.0f); glVertex3f(-0.5f, 0.5f, 0.5f);
-        glTexCoord2f(1.0f, 0.0f); glVertex3f(0.5f, 0.5f, 0.5f);
-        glTexCoord2f(1.0f, 1.0f); glVertex3f(0.5f, 0.5f, -0.5f);
-
-        // Dół
-        glNormal3f(0.0f, -1.0f, 0.0f);
-        glTexCoord2f(1.0f, 1.0f); glVertex3f(-0.5f, -0.5f, -0.5f);
-        glTexCoord2f(0.0f, 1.0f); glVertex3f(0.5f, -0.5f, -0.5f);
-        glTexCoord2f(0.0f, 0.0f); glVertex3f(0.5f, -0.5f, 0.5f);
-        glTexCoord2f(1.0f, 0.0f); glVertex3f(-0.5f, -0.5f, 0.5f);
-
-        // Lewo
-        glNormal3f(-1.0f, 0.0f, 0.0f);
-        glTexCoord2f(0.0f, 0.0f); glVertex3f(-0.5f, -0.5f, -0.5f);
-        glTexCoord2f(1.0f, 0.0f); glVertex3f(-0.5f, -0.5f, 0.5f);
-        glTexCoord2f(1.0f, 1.0f); glVertex3f(-0.5f, 0.5f, 0.5f);
-        glTexCoord2f(0.0f, 1.0f); glVertex3f(-0.5f, 0.5f, -0.5f);
-
-        // Prawo
-        glNormal3f(1.0f, 0.0f, 0.0f);
-        glTexCoord2f(1.0f, 0.0f); glVertex3f(0.5f, -0.5f, -0.5f);
-        glTexCoord2f(1.0f, 1.0f); glVertex3f(0.5f, 0.5f, -0.5f);
-        glTexCoord2f(0.0f, 1.0f); glVertex3f(0.5f, 0.5f, 0.5f);
-        glTexCoord2f(0.0f, 0.0f); glVertex3f(0.5f, -0.5f, 0.5f);
+     * @brief Rysuje siatkę wybraną ścieżką (retained lub natychmiastową).
+     * @param colorVariant Numer wariantu kolorów siatki.
+     */
+    void drawMesh(const Mesh& mesh, int colorVariant = 0) {
+        if (useImmediateMode) mesh.DrawImmediate(colorVariant);
+        else mesh.Draw(colorVariant);
+    }
+    /**
+     * @brief Rysuje wszystkie obiekty sceny.
+     *
+     * Dane obiektów czytane są z tablic SoA sceny. W trybie natychmiastowym
+     * i ścieżce PER_OBJECT każdy obiekt jest rysowany osobno, w pozostałych
+     * ścieżkach – partiami instancji. Oświetlenie liczy LitShader (jeśli
+     * kontekst obsługuje GLSL), w wariancie zgodnym z trybem cieniowania;
+     * przy aktywnych światłach dynamicznych – w wariancie klastrowym,
+     * przy włączonych cieniach – z atlasem map cieni.
+     */
+    void drawScene() {
+        const bool shaded = litShader.IsValid();
+        if (shaded) {
+            // Brakujący blok wyłącza odpowiednią flagę wariantu
+            unsigned int variant = (player->isSmoothShading() ? LIT_SMOOTH : LIT_FLAT) | LIT_CLUSTERED | LIT_SHADOWED;
+            litShader.Begin(player->getLighting(), variant,
+                clustersActive ? &clusteredLighting.GetBlock() : nullptr,
+                shadowsActive ? &shadowMap.GetBlock() : nullptr);
+        }
 
-        glEnd();
+        if (useImmediateMode || instancePath == INSTANCE_PATH_PER_OBJECT) drawSceneObjects();
+        else drawSceneBatches();
 
-        // Wyłączamy teksturowanie po narysowaniu obiektu
-        glDisable(GL_TEXTURE_2D);
-        glPopMatrix();
+        if (shaded) litShader.End();
     }
+    /**
+     * @brief Rysuje obiekty sceny pojedynczo (glPushMatrix/glTranslatef/glScalef na obiekt).
+     *
+     * Widoczne obiekty trafiają do kolejki z kluczem (przebieg, shader,
+     * tekstura, materiał, siatka, głębokość), a po sortowaniu są rysowane
+     * przez pamięć stanu – obiekty o tej samej teksturze i oświetleniu nie
+     * powtarzają glEnable/glBindTexture.
+     */
+    void drawSceneObjects() {
+        const float* positionX = scene.GetPositionsX();
+        const float* positionY = scene.GetPositionsY();
+        const float* positionZ = scene.GetPositionsZ();
+        const float* scales = scene.GetScales();
+        const int* meshIds = scene.GetMeshIds();
+        const int* materialIds = scene.GetMaterialIds();
+        const bool smooth = player->isSmoothShading();
+        const bool lighting = player->isLightingEnabled();
+
+        const bool culled = visibleMask.size() == scene.GetObjectCount();
+        {
+            PROFILE_ZONE(profiler, "Queue");
+            // Głębokość w układzie kamery: trzeci wiersz macierzy widoku
+            const float* m = frameView.Data();
+            const float depthScale = 1.0f / farPlane;
+
+            renderQueue.Clear();
+            renderQueue.Reserve(scene.GetObjectCount());
+            for (size_t i = 0; i < scene.GetObjectCount(); i++) {
+                if (culled && !visibleMask[i]) continue;
+                if (!scene.GetMesh(meshIds[i])) continue;
+                const SceneMaterial& material = scene.GetMaterial(materialIds[i]);
+
+                const bool textured = material.texture != INVALID_TEXTURE;
+                const bool lit = lighting && material.lit;
+                float depth = -(m[2] * positionX[i] + m[6] * positionY[i] + m[10] * positionZ[i] + m[14]) * depthScale;
+                renderQueue.Push(RenderQueue::MakeKey(material.lit ? RENDER_PASS_OPAQUE : RENDER_PASS_UNLIT,
+                    (textured ? 1u : 0u) | (lit ? 2u : 0u), material.texture, materialIds[i], meshIds[i], depth),
+                    static_cast<uint32_t>(i));
+            }
+            renderQueue.Sort();
+        }
 
+        const DrawPacket* packets = renderQueue.GetPackets();
+        for (size_t p = 0; p < renderQueue.GetSize(); p++) {
+            const size_t i = packets[p].item;
+            const SceneMaterial& material = scene.GetMaterial(materialIds[i]);
+
+            GLuint texture = textureCache.GetGLName(material.texture);
+            stateCache.SetEnabled(GL_TEXTURE_2D, texture != 0);
+            if (texture) stateCache.BindTexture(texture);
+            stateCache.SetEnabled(GL_LIGHTING, lighting && material.lit);
+            litShader.SetMaterial(texture != 0, lighting && material.lit);
+
+            glPushMatrix();
+            glTranslatef(positionX[i], positionY[i], positionZ[i]);
+            glScalef(scales[i], scales[i], scales[i]);
+            // Kolor bazowy (biały nie zabarwia tekstury)
+            glColor4fv(material.color);
+
+            // Wariant kolorów zależy od trybu cieniowania – bez przebudowy geometrii
+            drawMesh(*scene.GetMesh(meshIds[i]), smooth ? 0 : material.flatColorVariant);
+            glPopMatrix();
+        }
+        stateCache.SetEnabled(GL_TEXTURE_2D, false);
+    }
+    /**
+     * @brief Grupuje obiekty sceny w partie instancji według pary (siatka, materiał).
+     */
+    void rebuildSceneBatches() {
+        sceneBatches.clear();
+        visibleBatches.clear();
+        batchObjects.clear();
+        batchMeshIds.clear();
+        batchMaterialIds.clear();
+
+        const float* positionX = scene.GetPositionsX();
+        const float* positionY = scene.GetPositionsY();
+        const float* positionZ = scene.GetPositionsZ();
+        const float* scales = scene.GetScales();
+        const int* meshIds = scene.GetMeshIds();
+        const int* materialIds = scene.GetMaterialIds();
+
+        for (size_t i = 0; i < scene.GetObjectCount(); i++) {
+            size_t batch = 0;
+            while (batch < sceneBatches.size() &&
+                (batchMeshIds[batch] != meshIds[i] || batchMaterialIds[batch] != materialIds[i])) {
+                batch++;
+            }
+            if (batch == sceneBatches.size()) {
+                sceneBatches.push_back(std::unique_ptr<InstanceBatch>(new InstanceBatch(scene.GetMesh(meshIds[i]))));
+                visibleBatches.push_back(std::unique_ptr<InstanceBatch>(new InstanceBatch(scene.GetMesh(meshIds[i]), GL_STREAM_DRAW)));
+                batchObjects.push_back(std::vector<unsigned int>());
+                batchMeshIds.push_back(meshIds[i]);
+                batchMaterialIds.push_back(materialIds[i]);
+            }
+            sceneBatches[batch]->Add(positionX[i], positionY[i], positionZ[i], scales[i],
+                scene.GetMaterial(materialIds[i]).color);
+            batchObjects[batch].push_back(static_cast<unsigned int>(i));
+        }
+        batchRevision = scene.GetRevision();
+    }
+    /**
+     * @brief Wypełnia partie widocznymi instancjami według visibleMask.
+     */
+    void updateVisibleBatches() {
+        const float* positionX = scene.GetPositionsX();
+        const float* positionY = scene.GetPositionsY();
+        const float* positionZ = scene.GetPositionsZ();
+        const float* scales = scene.GetScales();
+
+        for (size_t b = 0; b < visibleBatches.size(); b++) {
+            InstanceBatch& batch = *visibleBatches[b];
+            const float* color = scene.GetMaterial(batchMaterialIds[b]).color;
+            batch.Clear();
+            for (unsigned int object : batchObjects[b]) {
+                if (visibleMask[object]) {
+                    batch.Add(positionX[object], positionY[object], positionZ[object], scales[object], color);
+                }
+            }
+        }
+    }
     /**
-     * @brief Rysuje piramidę.
+     * @brief Rysuje scenę partiami instancji (jedno wywołanie na partię).
+     *
+     * Instancing sprzętowy rysuje tylko widoczne instancje (bufor wysyłany co
+     * klatkę); siatka scalona jest statyczna, więc jest rysowana w całości.
      */
-    void drawPyramid(float x, float y, float z, float size = 1.0f) {
-        glPushMatrix();
-        glTranslatef(x, y, z);
-        glScalef(size, size, size);
+    void drawSceneBatches() {
+        if (batchRevision != scene.GetRevision()) rebuildSceneBatches();
+        const bool culled = instancePath == INSTANCE_PATH_HARDWARE && cullMode != CULL_OFF &&
+            visibleMask.size() == scene.GetObjectCount();
+        if (culled) updateVisibleBatches();
+
+        const bool smooth = player->isSmoothShading();
+        const bool lighting = player->isLightingEnabled();
+        for (size_t b = 0; b < sceneBatches.size(); b++) {
+            const SceneMaterial& material = scene.GetMaterial(batchMaterialIds[b]);
+
+            GLuint texture = textureCache.GetGLName(material.texture);
+            stateCache.SetEnabled(GL_TEXTURE_2D, texture != 0);
+            if (texture) stateCache.BindTexture(texture);
+            stateCache.SetEnabled(GL_LIGHTING, lighting && material.lit);
+            litShader.SetMaterial(texture != 0, lighting && material.lit);
+
+            InstanceBatch& batch = culled ? *visibleBatches[b] : *sceneBatches[b];
+            instanceRenderer.Draw(batch, instancePath, smooth ? 0 : material.flatColorVariant);
+        }
+        stateCache.SetEnabled(GL_TEXTURE_2D, false);
+    }
+    /**
+     * @brief Wyznacza widoczność obiektów sceny dla bieżącej kamery.
+     *
+     * Bryła widzenia pochodzi z projectionMatrix i macierzy widoku klatki
+     * (frameView) – bez odczytu stanu sterownika.
+     */
+    void cullScene() {
+        const size_t count = scene.GetObjectCount();
+        visibleMask.resize(count);
+        cullStats = CullStats();
+        cullStats.objects = count;
+
+        if (cullMode == CULL_OFF) {
+            std::fill(visibleMask.begin(), visibleMask.end(), static_cast<unsigned char>(1));
+            cullStats.visible = count;
+            return;
+        }
 
-        glBegin(GL_TRIANGLES);
-        // Podstawa
-        glNormal3f(0.0f, -1.0f, 0.0f);
-        glColor3f(1.0f, 0.5f, 0.0f);
-        glVertex3f(-0.5f, -0.5f, -0.5f); glVertex3f(0.5f, -0.5f, -0.5f); glVertex3f(0.5f, -0.5f, 0.5f);
-        glVertex3f(-0.5f, -0.5f, -0.5f); glVertex3f(0.5f, -0.5f, 0.5f); glVertex3f(-0.5f, -0.5f, 0.5f);
-        // Ściany
-        glNormal3f(0.0f, 0.447f, 0.894f);
-        glColor3f(0.0f, 0.0f, 1.0f);
-        glVertex3f(0.0f, 0.5f, 0.0f); glVertex3f(-0.5f, -0.5f, 0.5f); glVertex3f(0.5f, -0.5f, 0.5f);
-        glNormal3f(0.0f, 0.447f, -0.894f);
-        glColor3f(0.0f, 1.0f, 0.0f);
-        glVertex3f(0.0f, 0.5f, 0.0f); glVertex3f(0.5f, -0.5f, -0.5f); glVertex3f(-0.5f, -0.5f, -0.5f);
-        glNormal3f(-0.894f, 0.447f, 0.0f);
-        glColor3f(1.0f, 1.0f, 0.0f);
-        glVertex3f(0.0f, 0.5f, 0.0f); glVertex3f(-0.5f, -0.5f, -0.5f); glVertex3f(-0.5f, -0.5f, 0.5f);
-        glNormal3f(0.894f, 0.447f, 0.0f);
-        glColor3f(1.0f, 0.0f, 0.0f);
-        glVertex3f(0.0f, 0.5f, 0.0f); glVertex3f(0.5f, -0.5f, 0.5f); glVertex3f(0.5f, -0.5f, -0.5f);
-        glEnd();
+        Mat4 viewProjection = projectionMatrix * frameView;
+        Frustum frustum;
+        ExtractFrustum(viewProjection.Data(), frustum);
+
+        if (cullMode == CULL_FLAT) {
+            // Fragmenty po 16 tys. sfer w systemie zadań; każdy pisze własny zakres maski
+            std::atomic<size_t> visible(0);
+            GetJobSystem().ParallelFor(count, 16384, [&](size_t begin, size_t end) {
+                visible += CullSpheres(frustum, scene.GetPositionsX() + begin, scene.GetPositionsY() + begin,
+                    scene.GetPositionsZ() + begin, scene.GetRadii() + begin, end - begin, visibleMask.data() + begin);
+            });
+            cullStats.visible = visible;
+            cullStats.sphereTests = count;
+            cullStats.culled = count - cullStats.visible;
+        }
+        else {
+            updateSceneBvh();
+            sceneBvh.Cull(frustum, scene.GetPositionsX(), scene.GetPositionsY(), scene.GetPositionsZ(),
+                scene.GetRadii(), visibleMask.data(), cullStats);
+        }
+    }
+    /**
+     * @brief Zmienia liczbę dynamicznych świateł punktowych (kolejny poziom).
+     *
+     * Światła rozmieszczane są losowo nad obszarem sceny, z losowym kolorem
+     * i zasięgiem proporcjonalnym do odstępu między nimi.
+     */
+    void cycleDynamicLights() {
+        static const int levels[] = { 0, 16, 128, 512, 2048 };
+        dynamicLightLevel = (dynamicLightLevel + 1) % 5;
+        setDynamicLightCount(levels[dynamicLightLevel]);
+        if (!ClusteredLighting::IsSupported() || !litShader.IsValid(LIT_CLUSTERED)) {
+            std::cout << "Światła dynamiczne: brak obsługi (wymagane GLSL i tekstury float)" << std::endl;
+            return;
+        }
+        std::cout << "Światła dynamiczne: " << dynamicLightBase.size() << std::endl;
+    }
+    /**
+     * @brief Tworzy count losowych świateł punktowych nad sceną.
+     */
+    void setDynamicLightCount(int count) {
+        auto random = []() { return (float)rand() / RAND_MAX; };
+        const float extent = 6.0f + std::sqrt(static_cast<float>(scene.GetObjectCount()));
+        const float radius = 2.0f * extent / std::sqrt(static_cast<float>(std::max(count, 1)));
+
+        dynamicLightBase.resize(count);
+        for (PointLight& light : dynamicLightBase) {
+            light.position[0] = (random() * 2.0f - 1.0f) * extent;
+            light.position[1] = random() * 3.0f;
+            light.position[2] = (random() * 2.0f - 1.0f) * extent;
+            light.radius = std::max(radius, 1.5f) * (0.75f + random() * 0.5f);
+            for (int k = 0; k < 3; k++) light.color[k] = 0.25f + random() * 0.75f;
+            light.intensity = 1.5f;
+        }
+        dynamicLights = dynamicLightBase;
+        dynamicLightAngle = 0.0f;
+        previousLightAngle = 0.0f;
+    }
+    /**
+     * @brief Obraca światła dynamiczne wokół osi Y (krok symulacji).
+     */
+    void updateDynamicLights(float deltaTime) {
+        previousLightAngle = dynamicLightAngle;
+        if (dynamicLightBase.empty()) return;
+        dynamicLightAngle += deltaTime * 0.5f;
+    }
+    /**
+     * @brief Ustawia położenia świateł dynamicznych dla chwili alpha między dwoma ostatnimi krokami.
+     */
+    void interpolateDynamicLights(float alpha) {
+        const float angle = previousLightAngle + (dynamicLightAngle - previousLightAngle) * alpha;
+        const float c = std::cos(angle), s = std::sin(angle);
+        for (size_t i = 0; i < dynamicLightBase.size(); i++) {
+            const float* base = dynamicLightBase[i].position;
+            dynamicLights[i].position[0] = c * base[0] + s * base[2];
+            dynamicLights[i].position[2] = -s * base[0] + c * base[2];
+        }
+    }
+    /**
+     * @brief Przypisuje światła dynamiczne do klastrów i wysyła listy do GPU.
+     *
+     * Bez świateł, oświetlenia lub obsługi wariantu klastrowego klatka
+     * rysowana jest zwykłym wariantem LitShader.
+     */
+    void buildClusters() {
+        clustersActive = false;
+        if (frameLightCount == 0 || !player->isLightingEnabled() || !litShader.IsValid(LIT_CLUSTERED)) return;
+
+        clusteredLighting.Build(frameLights, frameLightCount, frameView, projectionMatrix, nearPlane, farPlane);
+        bool uploaded = clusteredLighting.Upload(width, height);
+        // Upload wiąże tekstury klastrów z jednostką 0
+        stateCache.Invalidate();
+        if (!uploaded) return;
+        clusteredLighting.BindTextures(LIT_CLUSTER_TEXTURE_UNIT);
+        clustersActive = true;
+    }
+    /**
+     * @brief Wypisuje liczniki ostatniego przypisania świateł do klastrów.
+     */
+    void printClusterStats() const {
+        const ClusterStats& stats = clusteredLighting.GetStats();
+        std::cout << "Klastry świateł: " << stats.visibleLights << " / " << stats.lights << " świateł widocznych, "
+            << stats.activeClusters << " / " << ClusteredLighting::CLUSTER_COUNT << " klastrów z listą (max "
+            << stats.maxPerCluster << ", przepełnienia " << stats.overflow << ") | przypisanie " << stats.binMs
+            << " ms, pakowanie " << stats.packMs << " ms, wysyłka " << stats.uploadMs << " ms ("
+            << clusteredLighting.GetThreadCount() << " wątków)" << std::endl;
+    }
+    /**
+     * @brief Przebudowuje BVH sceny, jeśli scena zmieniła się od ostatniej budowy.
+     */
+    void updateSceneBvh() {
+        if (bvhRevision == scene.GetRevision()) return;
+        sceneBvh.Build(scene.GetPositionsX(), scene.GetPositionsY(), scene.GetPositionsZ(),
+            scene.GetRadii(), scene.GetObjectCount());
+        bvhRevision = scene.GetRevision();
+    }
+    /**
+     * @brief Rysuje kaskadowe mapy cieni światła 0.
+     *
+     * Obiekty rzucające cień wybierane są osobno dla każdej kaskady przez
+     * BVH sceny i bryłę kaskady wydłużoną w stronę światła, więc koszt
+     * zależy od liczby obiektów w zasięgu kaskad, a nie od rozmiaru sceny.
+     */
+    void renderShadows() {
+        shadowsActive = false;
+        if (!player->isShadowsEnabled() || !player->isLightingEnabled() || !litShader.IsValid(LIT_SHADOWED)) return;
+        if (!shadowMap.Prepare()) return;
+
+        shadowMap.Update(player->getLightDirection(), frameView, projectionMatrix, nearPlane, farPlane);
+        updateSceneBvh();
+        shadowMask.resize(scene.GetObjectCount());
+
+        ShadowStats& stats = shadowMap.GetStats();
+        stats.totalCasters = 0;
+        stats.nodeTests = 0;
+        for (int cascade = 0; cascade < shadowMap.GetCascadeCount(); cascade++) {
+            CullStats casterStats;
+            sceneBvh.Cull(shadowMap.GetCasterFrustum(cascade), scene.GetPositionsX(), scene.GetPositionsY(),
+                scene.GetPositionsZ(), scene.GetRadii(), shadowMask.data(), casterStats);
+            stats.nodeTests += casterStats.nodeTests;
+
+            shadowMap.BeginCascade(cascade);
+            stats.casters[cascade] = drawShadowCasters();
+            stats.totalCasters += stats.casters[cascade];
+        }
+        shadowMap.End();
 
-        glPopMatrix();
+        // Powrót do celu renderowania klatki i projekcji kamery
+        if (headless) offscreenTarget.Bind();
+        else glViewport(0, 0, width, height);
+        applyProjectionMatrix();
+        // ShadowMap zmienia stan bezpośrednio (włącza m.in. test głębokości) – przywracamy ustawienia użytkownika
+        stateCache.Invalidate();
+        stateCache.SetEnabled(GL_DEPTH_TEST, depthTestEnabled);
+        if (player->isLightingEnabled()) stateCache.SetEnabled(GL_LIGHTING, true);
+        shadowsActive = true;
     }
     /**
-    * @brief Rysuje kulę z regulowaną liczbą segmentów.
-    */
-    void drawSphere(float x, float y, float z, float radius = 1.0f) {
-        glPushMatrix();
-        glTranslatef(x, y, z);
-        glScalef(radius, radius, radius);
-
-        bool smooth = player->isSmoothShading();
-
-        for (int i = 0; i < sphereSegments; i++) {
-            float lat0 = (float)M_PI * (-0.5f + (float)i / sphereSegments);
-            float lat1 = (float)M_PI * (-0.5f + (float)(i + 1) / sphereSegments);
-
-            glBegin(GL_QUAD_STRIP);
-            for (int j = 0; j <= sphereSegments; j++) {
-                float lng = 2.0f * (float)M_PI * (float)j / sphereSegments;
-
-                float x0 = cos(lat0) * cos(lng);
-                float y0 = sin(lat0);
-                float z0 = cos(lat0) * sin(lng);
-                float x1 = cos(lat1) * cos(lng);
-                float y1 = sin(lat1);
-                float z1 = cos(lat1) * sin(lng);
-
-                glNormal3f(x0, y0, z0);
-                if (smooth) {
-                    float r = 0.5f + 0.5f * y0;
-                    float g = 0.5f + 0.5f * x0;
-                    float b = 0.5f + 0.5f * z0;
-                    glColor3f(r, g, b);
-                }
-                else {
-                    glColor3f(0.8f, 0.2f, 0.8f);
+     * @brief Rysuje do mapy cieni obiekty zaznaczone w shadowMask (tylko głębokość).
+     * @return Liczba narysowanych obiektów.
+     */
+    size_t drawShadowCasters() {
+        const float* positionX = scene.GetPositionsX();
+        const float* positionY = scene.GetPositionsY();
+        const float* positionZ = scene.GetPositionsZ();
+        const float* scales = scene.GetScales();
+        const int* meshIds = scene.GetMeshIds();
+        const int* materialIds = scene.GetMaterialIds();
+        size_t drawn = 0;
+
+        for (size_t i = 0; i < scene.GetObjectCount(); i++) {
+            if (!shadowMask[i]) continue;
+            const Mesh* mesh = scene.GetMesh(meshIds[i]);
+            // Obiekty nieoświetlone (siatka podłoża) nie rzucają cienia
+            if (!mesh || !scene.GetMaterial(materialIds[i]).lit) continue;
+
+            glPushMatrix();
+            glTranslatef(positionX[i], positionY[i], positionZ[i]);
+            glScalef(scales[i], scales[i], scales[i]);
+            drawMesh(*mesh);
+            glPopMatrix();
+            drawn++;
+        }
+        return drawn;
+    }
+    /**
+     * @brief Wypisuje liczniki ostatniego przebiegu cieni.
+     */
+    void printShadowStats() const {
+        const ShadowStats& stats = shadowMap.GetStats();
+        std::cout << "Cienie: " << shadowMap.GetSettings().cascadeCount << " kaskad x "
+            << shadowMap.GetSettings().resolution << " px, zasięg " << shadowMap.GetSettings().distance;
+        if (!shadowsActive) {
+            std::cout << " (nieaktywne)" << std::endl;
+            return;
+        }
+        std::cout << " | rzucające cień:";
+        for (int cascade = 0; cascade < shadowMap.GetCascadeCount(); cascade++) {
+            std::cout << " " << stats.casters[cascade] << " (do " << stats.splits[cascade + 1] << ")";
+        }
+        std::cout << ", razem " << stats.totalCasters << " / " << scene.GetObjectCount()
+            << ", węzłów BVH: " << stats.nodeTests << std::endl;
+    }
+    /**
+     * @brief Ustawia rozdzielczość i liczbę kaskad map cieni.
+     */
+    void setShadowSettings(int resolution, int cascadeCount) {
+        ShadowSettings settings = shadowMap.GetSettings();
+        if (resolution > 0) settings.resolution = resolution;
+        if (cascadeCount > 0) settings.cascadeCount = cascadeCount;
+        shadowMap.SetSettings(settings);
+    }
+    /**
+     * @brief Zmienia liczbę kaskad cieni (1..MAX_CASCADES).
+     */
+    void cycleShadowCascades() {
+        setShadowSettings(0, shadowMap.GetSettings().cascadeCount % ShadowMap::MAX_CASCADES + 1);
+        printShadowStats();
+    }
+    /**
+     * @brief Zmienia rozdzielczość map cieni (512..4096).
+     */
+    void cycleShadowResolution() {
+        int resolution = shadowMap.GetSettings().resolution * 2;
+        setShadowSettings(resolution > 4096 ? 512 : resolution, 0);
+        printShadowStats();
+    }
+    /**
+     * @brief Włącza/wyłącza cienie.
+     */
+    void setShadowsEnabled(bool enabled) {
+        player->setShadowsEnabled(enabled);
+        if (enabled && !litShader.IsValid(LIT_SHADOWED)) {
+            std::cout << "Cienie: brak obsługi (wymagane FBO, GLSL i tekstury głębokości)" << std::endl;
+        }
+    }
+    /**
+     * @brief Przełącza cienie (klawisz Z).
+     */
+    void toggleShadows() {
+        player->toggleShadows();
+        if (player->isShadowsEnabled()) setShadowsEnabled(true);
+    }
+    /**
+     * @brief Zwraca nazwę trybu cullingu.
+     */
+    static const char* getCullModeName(CullMode mode) {
+        switch (mode) {
+        case CULL_OFF: return "wyłączony";
+        case CULL_FLAT: return "płaski (SIMD)";
+        default: return "hierarchiczny (BVH)";
+        }
+    }
+    /**
+     * @brief Wypisuje liczniki ostatniego cullingu.
+     */
+    void printCullStats() const {
+        std::cout << "Culling: " << getCullModeName(cullMode) << " | widoczne " << cullStats.visible
+            << " / " << cullStats.objects << ", odrzucone " << cullStats.culled
+            << " (testy sfer: " << cullStats.sphereTests << ", węzłów BVH: " << cullStats.nodeTests << ")" << std::endl;
+    }
+    /**
+     * @brief Zmienia tryb cullingu (wyłączony / płaski / BVH).
+     */
+    void cycleCullMode() {
+        cullMode = static_cast<CullMode>((cullMode + 1) % CULL_MODE_COUNT);
+        printCullStats();
+    }
+    /**
+     * @brief Mierzy czas klatki z count sześcianami dla każdej ścieżki instancingu.
+     *
+     * Sześciany tworzą sześcienną siatkę widzianą z ukosa; każda klatka jest
+     * kończona glFinish, więc czas obejmuje pracę CPU i GPU.
+     * @param count Liczba sześcianów
+     * @param frames Liczba mierzonych klatek na ścieżkę
+     */
+    void runInstancingBenchmark(int count, int frames = 30) {
+        if (!window || count <= 0) return;
+        waitForTextures();
+
+        const float spacing = 2.0f;
+        int side = static_cast<int>(std::ceil(std::cbrt(static_cast<double>(count))));
+        float offset = (side - 1) * spacing * 0.5f;
+
+        InstanceBatch batch(&cubeMesh);
+        batch.Reserve(count);
+        for (int i = 0; i < count; i++) {
+            int x = i % side, y = (i / side) % side, z = i / (side * side);
+            float color[4] = { (float)x / side, (float)y / side, (float)z / side, 1.0f };
+            batch.Add(x * spacing - offset, y * spacing - offset, z * spacing - offset, 1.0f, color);
+        }
+
+        // Własne rzutowanie: cała siatka musi się zmieścić w bryle widzenia
+        float aspect = (float)width / (float)height;
+        float distance = offset * 3.0f + 5.0f;
+        Mat4 projection = Mat4::Perspective(Radians(60.0f), aspect, 1.0f, distance * 3.0f);
+        glMatrixMode(GL_PROJECTION);
+        glLoadMatrixf(projection.Data());
+        glMatrixMode(GL_MODELVIEW);
+        glfwSwapInterval(0);
+
+        GLuint texture = textureCache.GetGLName(myTexture);
+        const bool lighting = player->isLightingEnabled();
+        std::cout << "\n=== TEST INSTANCINGU: " << count << " sześcianów, " << frames << " klatek ===\n";
+
+        for (int p = 0; p < INSTANCE_PATH_COUNT; p++) {
+            InstancePath path = static_cast<InstancePath>(p);
+            if (path == INSTANCE_PATH_HARDWARE && !instanceRenderer.IsHardwareSupported()) {
+                std::cout << "  " << GetInstancePathName(path) << ": niedostępny w tym kontekście\n";
+                continue;
+            }
+
+            double total = 0.0, best = 1e9, worst = 0.0, setupMs = 0.0;
+            for (int frame = -1; frame < frames; frame++) {
+                double start = glfwGetTime();
+                clearScreen();
+                Mat4 view = Mat4::Translation(0.0f, 0.0f, -distance)
+                    * Mat4::Rotation(Radians(25.0f), Vec3(1.0f, 0.0f, 0.0f))
+                    * Mat4::Rotation(Radians(35.0f + frame * 0.5f), Vec3(0.0f, 1.0f, 0.0f));
+                glLoadMatrixf(view.Data());
+                player->updateLightPosition(view);
+                if (texture) {
+                    stateCache.SetEnabled(GL_TEXTURE_2D, true);
+                    stateCache.BindTexture(texture);
                 }
-                glVertex3f(x0, y0, z0);
-
-                glNormal3f(x1, y1, z1);
-                if (smooth) {
-                    float r = 0.5f + 0.5f * y1;
-                    float g = 0.5f + 0.5f * x1;
-                    float b = 0.5f + 0.5f * z1;
-                    glColor3f(r, g, b);
+                if (litShader.IsValid()) {
+                    litShader.Begin(player->getLighting(), LIT_SMOOTH);
+                    litShader.SetMaterial(texture != 0, lighting);
                 }
-                glVertex3f(x1, y1, z1);
+                instanceRenderer.ResetDrawCalls();
+                instanceRenderer.Draw(batch, path, 0);
+                litShader.End();
+                stateCache.SetEnabled(GL_TEXTURE_2D, false);
+                glFinish();
+                double ms = (glfwGetTime() - start) * 1000.0;
+
+                // Klatka -1: wysyłka bufora instancji / budowa siatki scalonej
+                if (frame < 0) { setupMs = ms; continue; }
+                total += ms;
+                if (ms < best) best = ms;
+                if (ms > worst) worst = ms;
+                if (!headless) glfwSwapBuffers(window);
             }
-            glEnd();
+
+            double mean = total / frames;
+            std::cout << std::fixed << std::setprecision(2)
+                << "  " << std::left << std::setw(28) << GetInstancePathName(path) << std::right
+                << " przygotowanie " << std::setw(8) << setupMs << " ms | klatka średnio " << std::setw(8) << mean
+                << " ms (min " << best << ", max " << worst << ") | wywołań: " << instanceRenderer.GetDrawCalls()
+                << " | " << (count / (mean / 1000.0)) / 1e6 << " mln instancji/s\n";
         }
+        std::cout << std::defaultfloat << std::endl;
 
-        glPopMatrix();
+        batch.ReleaseGPU();
+        glfwSwapInterval(vsyncEnabled ? 1 : 0);
+        updateProjection();
     }
     /**
-     * @brief Wczytuje teksturę z pliku JPG.
+     * @brief Porównuje koszt próbkowania tekstury z mipmapami i bez na dalekiej siatce sześcianów.
+     *
+     * Sześciany side x side leżą na płaszczyźnie od 20 do ~200 jednostek
+     * przed kamerą patrzącą lekko w dół, więc tekstura jest silnie
+     * pomniejszona i oglądana pod ostrym kątem. Mierzone są tryby: bez
+     * mipmap, mipmapy trilinearne i mipmapy z największą anizotropią.
+     * Przed pomiarem sprawdzany jest łańcuch mipmap CPU (SIMD i skalarny).
+     * @param side Liczba sześcianów w boku siatki
+     * @param frames Liczba mierzonych klatek na tryb
      */
-    void LoadMyTexture() {
-        BitmapHandler loader;
-        if (loader.Load("textura.jpg")) { // Sprawdź czy nazwa pliku się zgadza!
-            glGenTextures(1, &myTexture);
-            glBindTexture(GL_TEXTURE_2D, myTexture);
+    void runMipmapBenchmark(int side, int frames = 60) {
+        if (!window || side <= 0) return;
+        waitForTextures();
+
+        std::cout << "\n=== TEST MIPMAP: " << side * side << " sześcianów, " << frames << " klatek ===\n";
+
+        // Łańcuch CPU: zgodność ścieżki SIMD ze skalarną i czas budowy
+        BitmapHandler image;
+        if (image.Load("textura.jpg", true)) {
+            MipChain simd, scalar;
+            double simdMs = 1e9, scalarMs = 1e9;
+            for (int r = 0; r < 5; r++) {
+                double start = glfwGetTime();
+                simd.Build(image.GetData(), image.GetWidth(), image.GetHeight(), image.GetChannels(), true);
+                simdMs = std::min(simdMs, (glfwGetTime() - start) * 1000.0);
+                start = glfwGetTime();
+                scalar.Build(image.GetData(), image.GetWidth(), image.GetHeight(), image.GetChannels(), false);
+                scalarMs = std::min(scalarMs, (glfwGetTime() - start) * 1000.0);
+            }
+            bool same = simd.GetByteSize() == scalar.GetByteSize() && (simd.GetLevelCount() == 0 ||
+                std::equal(simd.GetLevelData(1), simd.GetLevelData(1) + simd.GetByteSize(), scalar.GetLevelData(1)));
+            std::cout << std::fixed << std::setprecision(2) << "  Łańcuch CPU " << image.GetWidth() << "x"
+                << image.GetHeight() << "x" << image.GetChannels() << " (" << simd.GetLevelCount() << " poziomów, "
+                << simd.GetByteSize() / 1024 << " KB): " << MipChain::GetSimdName() << " " << simdMs
+                << " ms, skalarny " << scalarMs << " ms" << (same ? "" : "  BŁĄD: różne wyniki") << "\n"
+                << std::defaultfloat;
+        }
+
+        GLuint texture = textureCache.GetGLName(myTexture);
+        if (!texture) {
+            std::cout << "  Brak tekstury – pomiar próbkowania pominięty" << std::endl;
+            return;
+        }
+
+        const float spacing = 180.0f / side;
+        InstanceBatch batch(&cubeMesh);
+        batch.Reserve(side * side);
+        const float white[4] = { 1.0f, 1.0f, 1.0f, 1.0f };
+        for (int z = 0; z < side; z++) {
+            for (int x = 0; x < side; x++) {
+                batch.Add((x - side * 0.5f) * spacing, 0.0f, -20.0f - z * spacing, spacing * 0.4f, white);
+            }
+        }
+        InstancePath path = instanceRenderer.IsHardwareSupported() ? INSTANCE_PATH_HARDWARE : INSTANCE_PATH_MERGED;
+
+        float aspect = (float)width / (float)height;
+        Mat4 projection = Mat4::Perspective(Radians(60.0f), aspect, 1.0f, 400.0f);
+        Mat4 view = Mat4::LookAt(Vec3(0.0f, 6.0f, 0.0f), Vec3(0.0f, 0.0f, -60.0f), Vec3(0.0f, 1.0f, 0.0f));
+        glMatrixMode(GL_PROJECTION);
+        glLoadMatrixf(projection.Data());
+        glMatrixMode(GL_MODELVIEW);
+        glfwSwapInterval(0);
+
+        struct SamplingMode { const char* name; GLint minFilter; float anisotropy; };
+        const float maxAnisotropy = GetGLCapabilities().maxAnisotropy;
+        const SamplingMode modes[] = {
+            { "bez mipmap (GL_LINEAR)", GL_LINEAR, 1.0f },
+            { "mipmapy trilinearne", GL_LINEAR_MIPMAP_LINEAR, 1.0f },
+            { "mipmapy + anizotropia", GL_LINEAR_MIPMAP_LINEAR, maxAnisotropy },
+        };
+        const bool hasMipmaps = textureCache.GetLevelCount(myTexture) > 1;
+        const bool lighting = player->isLightingEnabled();
+
+        for (const SamplingMode& mode : modes) {
+            if (mode.minFilter != GL_LINEAR && !hasMipmaps) {
+                std::cout << "  " << mode.name << ": tekstura bez mipmap\n";
+                continue;
+            }
+            if (mode.anisotropy > 1.0f && maxAnisotropy <= 1.0f) continue;
 
-            // Niezbędne parametry, aby tekstura nie była czarna
-            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+            stateCache.BindTexture(texture);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, mode.minFilter);
+            if (maxAnisotropy > 1.0f) glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MAX_ANISOTROPY_EXT, mode.anisotropy);
 
-            // JPG nie ma kanału Alpha, więc wymuszamy GL_RGB
-            GLenum format = (loader.GetChannels() == 4) ? GL_RGBA : GL_RGB;
+            double total = 0.0, best = 1e9;
+            for (int frame = -1; frame < frames; frame++) {
+                double start = glfwGetTime();
+                clearScreen();
+                glLoadMatrixf(view.Data());
+                player->updateLightPosition(view);
+                stateCache.SetEnabled(GL_TEXTURE_2D, true);
+                stateCache.BindTexture(texture);
+                if (litShader.IsValid()) {
+                    litShader.Begin(player->getLighting(), LIT_SMOOTH);
+                    litShader.SetMaterial(true, lighting);
+                }
+                instanceRenderer.Draw(batch, path, 0);
+                litShader.End();
+                stateCache.SetEnabled(GL_TEXTURE_2D, false);
+                glFinish();
+                double ms = (glfwGetTime() - start) * 1000.0;
+
+                // Klatka -1: wysyłka bufora instancji
+                if (frame < 0) continue;
+                total += ms;
+                if (ms < best) best = ms;
+                if (!headless) glfwSwapBuffers(window);
+            }
+            std::cout << std::fixed << std::setprecision(2) << "  " << std::left << std::setw(26) << mode.name
+                << std::right;
+            if (mode.anisotropy > 1.0f) std::cout << std::setprecision(0) << mode.anisotropy << "x" << std::setprecision(2);
+            std::cout << " klatka średnio " << std::setw(8) << total / frames << " ms (min " << best << ")\n"
+                << std::defaultfloat;
+        }
+        std::cout << std::endl;
+        textureCache.PrintMemoryReport();
 
-            // Poprawka dla obrazów o wymiarach niebędących potęgą dwójki
-            glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+        // Przywrócenie filtrowania tekstury i stanu
+        textureCache.ApplySampling(myTexture);
+        stateCache.Invalidate();
+        batch.ReleaseGPU();
+        glfwSwapInterval(vsyncEnabled ? 1 : 0);
+        updateProjection();
+    }
+    /**
+     * @brief Mierzy przepustowość wysyłki tekstury w każdym trybie PixelUploadRing.
+     *
+     * Tekstura 1024x1024 RGBA jest zapisywana pasami po 256 wierszy (1 MB na
+     * "klatkę", pierścień 4 segmentów). Czas CPU kończy się po ostatnim
+     * wywołaniu, łączny – po glFinish; zawartość jest sprawdzana glGetTexImage.
+     * @param megabytes Ilość danych na tryb
+     */
+    void runUploadBenchmark(int megabytes) {
+        if (!window || megabytes <= 0) return;
+        const int side = 1024;
+        const int stripeRows = 256;
+        const size_t rowBytes = static_cast<size_t>(side) * 4;
+        const size_t stripeBytes = rowBytes * stripeRows;
+        const int stripes = std::max(1, static_cast<int>(megabytes * 1024 * 1024 / stripeBytes));
+
+        std::vector<unsigned char> source(rowBytes * side), readback(rowBytes * side);
+        for (size_t i = 0; i < source.size(); i++) source[i] = static_cast<unsigned char>(i * 31 + (i >> 12));
+
+        std::cout << "\n=== TEST WYSYŁKI TEKSTUR: " << megabytes << " MB pasami po " << stripeBytes / 1024
+            << " KB ===\n";
+        GLuint texture = 0;
+        glGenTextures(1, &texture);
+        stateCache.BindTexture(texture);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+        glPixelStorei(GL_PACK_ALIGNMENT, 1);
+
+        for (int m = 0; m < PIXEL_UPLOAD_MODE_COUNT; m++) {
+            const PixelUploadMode mode = static_cast<PixelUploadMode>(m);
+            PixelUploadRing ring;
+            std::cout << "  " << std::left << std::setw(24) << PixelUploadRing::GetModeName(mode) << std::right;
+            if (!ring.Init(4 * stripeBytes, mode)) {
+                std::cout << " niedostępny\n";
+                continue;
+            }
+            glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, side, side, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+            glFinish();
+
+            bool ok = true;
+            double start = glfwGetTime();
+            for (int i = 0; i < stripes && ok; i++) {
+                const int row = (i % (side / stripeRows)) * stripeRows;
+                void* staging = ring.Map(stripeBytes);
+                ok = staging != nullptr;
+                if (!ok) break;
+                memcpy(staging, source.data() + row * rowBytes, stripeBytes);
+                ring.TexSubImage2D(GL_TEXTURE_2D, 0, 0, row, side, stripeRows, GL_RGBA, GL_UNSIGNED_BYTE);
+                ring.EndFrame();
+            }
+            const double cpuMs = (glfwGetTime() - start) * 1000.0;
+            glFinish();
+            const double totalMs = (glfwGetTime() - start) * 1000.0;
 
-            glTexImage2D(GL_TEXTURE_2D, 0, format,
-                loader.GetWidth(), loader.GetHeight(),
-                0, format, GL_UNSIGNED_BYTE, loader.GetData());
+            if (ok && stripes >= side / stripeRows) {
+                glGetTexImage(GL_TEXTURE_2D, 0, GL_RGBA, GL_UNSIGNED_BYTE, readback.data());
+                ok = readback == source;
+            }
+            const PixelUploadStats& stats = ring.GetStats();
+            std::cout << std::fixed << std::setprecision(2) << " " << std::setw(9)
+                << stats.bytes / (1024.0 * 1024.0) / std::max(totalMs / 1000.0, 1e-9) << " MB/s"
+                << " (CPU " << cpuMs << " ms, łącznie " << totalMs << " ms, czekanie na płoty "
+                << stats.fenceWaits << "x / " << stats.fenceWaitMs << " ms)"
+                << (ok ? "" : "  BŁĄD: zła zawartość tekstury") << "\n" << std::defaultfloat;
+            ring.Shutdown();
+        }
+        std::cout << "  Tekstury w tle używają: "
+            << PixelUploadRing::GetModeName(PixelUploadRing::IsModeSupported(textureCache.GetUploadMode())
+                ? textureCache.GetUploadMode() : PixelUploadRing::GetBestMode()) << std::endl;
 
-            loader.Free();
+        glDeleteTextures(1, &texture);
+        stateCache.Invalidate();
+    }
+    /**
+     * @brief Wybiera tryb pierścienia PBO wysyłki tekstur wczytanych w tle.
+     */
+    void setTextureUploadMode(PixelUploadMode mode) {
+        if (!PixelUploadRing::IsModeSupported(mode)) {
+            std::cout << "Tryb wysyłki \"" << PixelUploadRing::GetModeName(mode) << "\" niedostępny, użyty: "
+                << PixelUploadRing::GetModeName(PixelUploadRing::GetBestMode()) << std::endl;
+            mode = PixelUploadRing::GetBestMode();
         }
-        else {
+        textureCache.SetUploadMode(mode);
+    }
+    /**
+     * @brief Ustawia anizotropię tekstur z mipmapami.
+     */
+    void setAnisotropy(float anisotropy) {
+        float applied = textureCache.SetAnisotropy(anisotropy);
+        // SetAnisotropy wiąże tekstury bezpośrednio
+        stateCache.Invalidate();
+        std::cout << "Filtrowanie anizotropowe: " << applied << "x (maks. "
+            << GetGLCapabilities().maxAnisotropy << "x)" << std::endl;
+    }
+    /**
+     * @brief Zmienia anizotropię (1, 2, 4, 8, 16 – do maksimum sterownika).
+     */
+    void cycleAnisotropy() {
+        float next = textureCache.GetAnisotropy() * 2.0f;
+        setAnisotropy(next > GetGLCapabilities().maxAnisotropy ? 1.0f : next);
+    }
+    /**
+     * @brief Wypisuje pamięć GPU tekstur, metryki strumieniowania i pamięć dekodowania.
+     */
+    void printTextureMemory() const {
+        textureCache.PrintMemoryReport();
+        textureCache.PrintStreamingStats();
+        PrintImageMemoryReport();
+    }
+    /**
+     * @brief Czeka na tekstury wczytywane w tle (testy i renderowanie bez okna).
+     */
+    void waitForTextures() {
+        if (textureCache.GetStreamingCount() == 0) return;
+        textureCache.FinishStreaming();
+        stateCache.Invalidate();
+    }
+    /**
+     * @brief Ustawia budżet wysyłki tekstur na klatkę.
+     * @param kilobytes Budżet w KB (0: bez limitu).
+     */
+    void setTextureUploadBudget(int kilobytes) {
+        textureUploadBudget = kilobytes > 0 ? static_cast<size_t>(kilobytes) * 1024 : static_cast<size_t>(-1);
+    }
+    /**
+     * @brief Wybiera liczenie mipmap przez sterownik zamiast na CPU i wczytuje teksturę ponownie.
+     */
+    void setGpuMipmaps(bool enabled) {
+        textureCache.SetMipGenerator(enabled ? MIP_GENERATOR_GPU : MIP_GENERATOR_CPU);
+        textureCache.Reload(myTexture);
+        stateCache.Invalidate();
+        std::cout << "Mipmapy: " << (enabled && GetGLCapabilities().generateMipmap ? "GL_GENERATE_MIPMAP" : "CPU")
+            << std::endl;
+    }
+    /**
+     * @brief Wczytuje teksturę z pliku JPG (przez cache tekstur).
+     *
+     * Plik jest dekodowany tylko przy pierwszym wywołaniu; kolejne wywołania
+     * trafiają w cache i zwalniają poprzednio trzymany uchwyt. Dekodowanie
+     * odbywa się w tle – do czasu wysyłki obiekty mają teksturę zastępczą.
+     */
+    void LoadMyTexture() {
+        TextureHandle handle = textureCache.AcquireAsync("textura.jpg", TEXTURE_FLIP_Y | TEXTURE_MIPMAPS); // Sprawdź czy nazwa pliku się zgadza!
+        if (handle == INVALID_TEXTURE) {
             std::cerr << "Blad: Nie znaleziono pliku JPG!" << std::endl;
         }
+        textureCache.Release(myTexture);
+        myTexture = handle;
+        // Wysyłanie i usuwanie tekstur zmienia wiązanie jednostki 0
+        stateCache.Invalidate();
+    }
+    /**
+     * @brief Ustawia parametry renderowania bez okna.
+     * @param frames Liczba klatek do wyrenderowania
+     * @param prefix Prefiks ścieżki plików wynikowych (np. "out/frame")
+     */
+    void setHeadlessCapture(int frames, const std::string& prefix) {
+        headlessFrames = frames > 0 ? frames : 1;
+        headlessPrefix = prefix;
+    }
+    /**
+     * @brief Przełącza klatki bez okna na rasteryzer programowy.
+     * @param threads Liczba wątków rasteryzera (0: liczba rdzeni)
+     */
+    void setSoftwareRendering(int threads) {
+        softwareRender = true;
+        softwareRasterizer.SetThreadCount(threads);
+        softwareTexture.Load("textura.jpg", true, PIXEL_FORMAT_RGBA);
+    }
+    /**
+     * @brief Ustawia częstotliwość kroków symulacji.
+     * @param rate Kroki na sekundę (np. 120)
+     */
+    void setSimulationRate(int rate) {
+        simulationClock.SetRate(rate);
+        std::cout << "Symulacja: " << simulationClock.GetRate() << " Hz" << std::endl;
+    }
+    /**
+     * @brief Przenosi renderowanie na osobny wątek z pierścieniem list poleceń.
+     * @param buffers Liczba list (2: podwójne, 3: potrójne buforowanie)
+     */
+    void setRenderThread(int buffers) {
+        renderThread.reset(new RenderThread(buffers));
+        std::cout << "Wątek renderowania: " << renderThread->GetBufferCount() << " listy poleceń" << std::endl;
+    }
+    /**
+     * @brief Rysuje klatkę sceny rasteryzerem programowym (ta sama kamera, scena i tryb cieniowania).
+     *
+     * Obiekty z teksturą używają softwareTexture – scena ma jedną teksturę (myTexture).
+     */
+    void renderSoftwareFrame() {
+        PROFILE_ZONE(profiler, "Software");
+        {
+            PROFILE_ZONE(profiler, "Cull");
+            cullScene();
+        }
+        if (softwareRasterizer.GetWidth() != width || softwareRasterizer.GetHeight() != height) {
+            softwareRasterizer.Resize(width, height);
+        }
+        softwareRasterizer.Clear(clearColor);
+        softwareRasterizer.SetCamera(frameView, projectionMatrix);
+        softwareRasterizer.SetLighting(player->isLightingEnabled() ? &player->getLighting() : nullptr);
+        const bool smooth = player->isSmoothShading();
+        softwareRasterizer.SetSmoothShading(smooth);
+
+        const float* positionX = scene.GetPositionsX();
+        const float* positionY = scene.GetPositionsY();
+        const float* positionZ = scene.GetPositionsZ();
+        const float* scales = scene.GetScales();
+        const int* meshIds = scene.GetMeshIds();
+        const int* materialIds = scene.GetMaterialIds();
+        for (size_t i = 0; i < scene.GetObjectCount(); i++) {
+            const Mesh* mesh = scene.GetMesh(meshIds[i]);
+            if (!visibleMask[i] || !mesh) continue;
+            const SceneMaterial& material = scene.GetMaterial(materialIds[i]);
+            const Mat4 model = Mat4::Translation(positionX[i], positionY[i], positionZ[i])
+                * Mat4::Scale(scales[i], scales[i], scales[i]);
+            softwareRasterizer.DrawMesh(*mesh, model, material.color,
+                material.texture != INVALID_TEXTURE ? &softwareTexture : nullptr, material.lit,
+                smooth ? 0 : material.flatColorVariant);
+        }
+        {
+            PROFILE_ZONE(profiler, "Rasterize");
+            softwareRasterizer.Flush();
+        }
+    }
+    /**
+     * @brief Rysuje jedną klatkę standardowej sceny.
+     */
+    void renderFrame() {
+        PROFILE_ZONE(profiler, "Render");
+        {
+            PROFILE_ZONE(profiler, "Clear");
+            clearScreen();
+        }
+        {
+            PROFILE_ZONE(profiler, "Shadows");
+            renderShadows();
+        }
+        {
+            PROFILE_ZONE(profiler, "Camera");
+            player->applyCameraTransform(frameView);
+            player->updateLightPosition(frameView);
+            player->drawAxes();
+        }
+        {
+            PROFILE_ZONE(profiler, "Cull");
+            cullScene();
+        }
+        {
+            PROFILE_ZONE(profiler, "Clusters");
+            buildClusters();
+        }
+        if (shadowsActive) shadowMap.BindTexture(LIT_SHADOW_TEXTURE_UNIT);
+        {
+            PROFILE_ZONE(profiler, "DrawScene");
+            drawScene();
+        }
+        if (clustersActive) clusteredLighting.UnbindTextures(LIT_CLUSTER_TEXTURE_UNIT);
+        if (shadowsActive) shadowMap.UnbindTexture(LIT_SHADOW_TEXTURE_UNIT);
+
+        if (player->isLightingEnabled()) {
+            stateCache.SetEnabled(GL_LIGHTING, true);
+            glEnable(GL_LIGHT0);
+        }
+    }
+    /**
+     * @brief Wypisuje liczniki kolejki rysowania i wywołań stanu ostatniej klatki.
+     */
+    void printRenderQueueStats() const {
+        const GLStateStats& stats = stateCache.GetFrameStats();
+        std::cout << "Kolejka rysowania: " << renderQueue.GetSize() << " pakietów\n";
+        std::cout << "Wywołania stanu GL (wykonane / pominięte):\n";
+        for (int c = 0; c < STATE_CATEGORY_COUNT; c++) {
+            std::cout << "  " << std::left << std::setw(20) << GLStateCache::GetCategoryName(c) << std::right
+                << std::setw(6) << stats.issued[c] << " / " << stats.skipped[c] << "\n";
+        }
+        size_t total = stats.TotalIssued() + stats.TotalSkipped();
+        std::cout << "  Razem: " << stats.TotalIssued() << " / " << stats.TotalSkipped();
+        if (total) std::cout << " (" << std::fixed << std::setprecision(1)
+            << (100.0 * stats.TotalSkipped() / total) << "% pominiętych)" << std::defaultfloat;
+        if (stateCache.IsValidating()) {
+            std::cout << "\n  Sprawdzanie: " << stats.queries << " zapytań glGet, " << stats.mismatches << " różnic";
+        }
+        std::cout << std::endl;
+    }
+    /**
+     * @brief Włącza lub wyłącza porównywanie kopii stanu GL ze sterownikiem.
+     */
+    void setStateValidation(bool enabled) {
+        stateCache.SetValidation(enabled);
+        std::cout << "Sprawdzanie stanu GL: " << (enabled ? "Włączone" : "Wyłączone") << std::endl;
+    }
+    /**
+     * @brief Zapisuje wyniki profilera do plików CSV i Chrome Trace.
+     * @param prefix Prefiks ścieżek plików wynikowych
+     */
+    void exportProfile(const std::string& prefix) {
+        bool csv = profiler.ExportCSV(prefix + ".csv");
+        bool trace = profiler.ExportChromeTrace(prefix + "_trace.json");
+        if (csv && trace) {
+            std::cout << "Zapisano profil " << profiler.GetFrameCount() << " klatek: "
+                << prefix << ".csv, " << prefix << "_trace.json" << std::endl;
+        }
+    }
+    /**
+     * @brief Włącza/wyłącza wykres czasu klatek na ekranie.
+     */
+    void toggleProfilerOverlay() {
+        showProfilerOverlay = !showProfilerOverlay;
+        std::cout << "Wykres profilera: " << (showProfilerOverlay ? "Widoczny" : "Ukryty")
+            << " (biała linia = celowy czas klatki)" << std::endl;
     }
     /**
      * @brief Główna pętla silnika.
      */
     void run() {
+        if (!window) return;
+        if (headless) {
+            runHeadless();
+            return;
+        }
+
+        if (renderThread) {
+            runThreaded();
+            return;
+        }
+
+        // Zdarzenia odbierane tuż po czekaniu limitu FPS – czekanie nie wydłuża opóźnienia wejścia
         while (!glfwWindowShouldClose(window)) {
+            profiler.BeginFrame();
+            {
+                PROFILE_ZONE(profiler, "LimitFPS");
+                limitFPS();
+            }
             double currentTime = glfwGetTime();
-            float deltaTime = static_cast<float>(currentTime - lastFrameTime);
+            double frameSeconds = currentTime - lastFrameTime;
             lastFrameTime = currentTime;
-            LoadMyTexture();
-            player->updateStaticRotation(deltaTime);
-            player->handleCameraMovement(deltaTime);
+            {
+                PROFILE_ZONE(profiler, "PollEvents");
+                glfwPollEvents();
+                processInput();
+            }
+            prepareFrame();
+            {
+                PROFILE_ZONE(profiler, "Update");
+                simulate(frameSeconds);
+            }
+            captureFrameState();
+            presentFrame();
+            recordInputLatency();
+            profiler.EndFrame();
+        }
+        input.PrintStats();
+    }
+    /**
+     * @brief Główna pętla z osobnym wątkiem renderowania.
+     *
+     * Wątek główny obsługuje zdarzenia okna, symuluje kamerę i światła
+     * i nagrywa listę poleceń klatki N+1, a wątek renderowania (właściciel
+     * kontekstu GL) wykonuje listę klatki N. Klawisze zmieniające stan
+     * renderowania trafiają do listy, klawisze kamery i okna działają od razu.
+     */
+    void runThreaded() {
+        glfwMakeContextCurrent(NULL);
+        renderThread->Start([this](const RenderCommandList& list) { executeFrame(list); },
+            [this] { glfwMakeContextCurrent(window); },
+            [] { glfwMakeContextCurrent(NULL); });
+
+        while (!glfwWindowShouldClose(window)) {
             limitFPS();
-            clearScreen();
+            RenderCommandList& list = renderThread->BeginRecord();
+            double currentTime = glfwGetTime();
+            double frameSeconds = currentTime - lastFrameTime;
+            lastFrameTime = currentTime;
 
-            player->applyCameraTransform();
-            player->drawAxes();
+            recordingList = &list;
+            glfwPollEvents();
+            processInput();
+            simulate(frameSeconds);
+            recordFrameState(list);
+            recordingList = nullptr;
+            renderThread->Submit();
+        }
 
-            drawCube(-4.0f, 0.0f, 0.0f, 1.0f);
-            drawPyramid(0.0f, 0.0f, 0.0f, 1.5f);
-            drawSphere(4.0f, 0.0f, 0.0f, 1.5f);
-            glDisable(GL_LIGHTING);
-            glBegin(GL_LINES);
-            glColor3f(0.5f, 0.5f, 0.5f);
-            for (int i = -5; i <= 5; i++) {
-                glVertex3f((float)i, -5.0f, 0.0f); glVertex3f((float)i, 5.0f, 0.0f);
-                glVertex3f(-5.0f, (float)i, 0.0f); glVertex3f(5.0f, (float)i, 0.0f);
+        renderThread->Stop();
+        glfwMakeContextCurrent(window);
+        renderThread->PrintStats();
+        simulationClock.PrintStats();
+        input.PrintStats();
+    }
+    /**
+     * @brief Wykonuje listę poleceń i rysuje klatkę (wątek renderowania).
+     */
+    void executeFrame(const RenderCommandList& list) {
+        profiler.BeginFrame();
+        prepareFrame();
+        executeCommands(list);
+        presentFrame();
+        recordInputLatency();
+        profiler.EndFrame();
+    }
+    /**
+     * @brief Wysyła tekstury wczytane w tle i otwiera klatkę kopii stanu GL.
+     */
+    void prepareFrame() {
+        {
+            PROFILE_ZONE(profiler, "Textures");
+            textureCache.BeginFrame();
+            // Wysyłka tekstur wczytanych w tle (wiąże tekstury bezpośrednio)
+            if (textureCache.Update(textureUploadBudget)) stateCache.Invalidate();
+        }
+        stateCache.BeginFrame();
+    }
+    /**
+     * @brief Rysuje klatkę z nakładką profilera i zamienia bufory.
+     */
+    void presentFrame() {
+        renderFrame();
+        if (showProfilerOverlay) {
+            PROFILE_ZONE(profiler, "Overlay");
+            profiler.DrawOverlay(width, height, 1000.0 / frameTargetFPS);
+        }
+        {
+            PROFILE_ZONE(profiler, "SwapBuffers");
+            glfwSwapBuffers(window);
+        }
+    }
+    /**
+     * @brief Odbiera zdarzenia wejścia jednym przebiegiem i wykonuje przypisane im działania.
+     *
+     * Stan akcji ruchu (InputSystem::IsDown) jest gotowy przed krokami
+     * symulacji; klawisze poleceń działają jak wcześniej z callbacków.
+     */
+    void processInput() {
+        inputEvents.clear();
+        input.Update(inputEvents);
+        for (const InputEvent& event : inputEvents) {
+            switch (event.type) {
+            case INPUT_KEY: if (event.action == InputSystem::PRESS) keyCallback(event.code); break;
+            case INPUT_MOUSE_BUTTON: if (event.action == InputSystem::PRESS) mouseCallback(event.code); break;
+            case INPUT_CURSOR: mouseMoveCallback(event.x, event.y); break;
+            case INPUT_SCROLL: scrollCallback(event.x, event.y); break;
             }
-            glEnd();
+        }
+    }
+    /**
+     * @brief Zapisuje opóźnienie wejście -> obraz po zamianie buforów klatki.
+     */
+    void recordInputLatency() {
+        input.RecordPresent(frameInput, InputSystem::Now());
+        frameInput = InputStamp();
+    }
+    /**
+     * @brief Wykonuje kroki symulacji przypadające na czas klatki.
+     *
+     * Kamera i światła całkowane są stałym krokiem simulationClock, więc
+     * wynik zależy od liczby kroków, a nie od tempa klatek; renderowanie
+     * interpoluje stan między dwoma ostatnimi krokami (captureFrameState).
+     * @return Liczba wykonanych kroków.
+     */
+    int simulate(double frameSeconds) {
+        const int steps = simulationClock.Advance(frameSeconds);
+        const float step = static_cast<float>(simulationClock.GetStep());
+        for (int i = 0; i < steps; i++) {
+            player->beginStep();
+            player->updateStaticRotation(step);
+            player->handleCameraMovement(step);
+            updateDynamicLights(step);
+        }
+        return steps;
+    }
+    /**
+     * @brief Przejmuje stan symulacji do renderowania na tym samym wątku.
+     */
+    void captureFrameState() {
+        const float alpha = simulationClock.GetAlpha();
+        frameView = player->getViewMatrix(alpha);
+        interpolateDynamicLights(alpha);
+        frameInput = input.TakeFrameStamp();
+        frameLights = dynamicLights.data();
+        frameLightCount = dynamicLights.size();
+        frameTargetFPS = targetFPS;
+    }
+    /**
+     * @brief Nagrywa kopię stanu symulacji – symulacja może biec dalej w trakcie renderowania.
+     */
+    void recordFrameState(RenderCommandList& list) {
+        const float alpha = simulationClock.GetAlpha();
+        const Mat4 view = player->getViewMatrix(alpha);
+        interpolateDynamicLights(alpha);
+        list.PushData(COMMAND_CAMERA, view.Data(), sizeof(view.m), targetFPS);
+        list.PushData(COMMAND_LIGHTS, dynamicLights.data(), dynamicLights.size() * sizeof(PointLight),
+            static_cast<int>(dynamicLights.size()));
+        const InputStamp stamp = input.TakeFrameStamp();
+        if (stamp.IsValid()) list.PushData(COMMAND_INPUT, &stamp, sizeof(stamp));
+    }
+    /**
+     * @brief Wykonuje polecenia listy (wątek renderowania).
+     */
+    void executeCommands(const RenderCommandList& list) {
+        for (const RenderCommand& command : list.GetCommands()) {
+            switch (command.type) {
+            case COMMAND_KEY: renderKey(command.args[0]); break;
+            case COMMAND_RESIZE: resize(command.args[0], command.args[1]); break;
+            case COMMAND_CAMERA:
+                std::memcpy(frameView.m, list.GetData(command), sizeof(frameView.m));
+                frameTargetFPS = command.args[0];
+                break;
+            case COMMAND_LIGHTS:
+                frameLights = static_cast<const PointLight*>(list.GetData(command));
+                frameLightCount = static_cast<size_t>(command.args[0]);
+                break;
+            case COMMAND_INPUT: std::memcpy(&frameInput, list.GetData(command), sizeof(frameInput)); break;
+            }
+        }
+    }
+    /**
+     * @brief Czy wątek renderowania działa (stan GL należy do niego).
+     */
+    bool renderThreadActive() const {
+        return renderThread && renderThread->IsRunning();
+    }
+    /**
+     * @brief Dopisuje polecenie do listy nagrywanej przez wątek główny.
+     */
+    void recordCommand(EngineCommand type, int arg0, int arg1 = 0) {
+        if (recordingList) recordingList->Push(type, arg0, arg1);
+    }
+    /**
+     * @brief Renderuje headlessFrames klatek poza ekranem i zapisuje je do plików PPM.
+     *
+     * Krok czasu jest stały (1 / targetFPS), więc kolejne uruchomienia dają
+     * identyczne klatki – nadaje się do testów regresji obrazu i wydajności.
+     */
+    void runHeadless() {
+        // Klatki mają być powtarzalne – bez tekstury zastępczej
+        waitForTextures();
+        bool usesFbo = !softwareRender && offscreenTarget.Create(width, height);
+        if (!softwareRender) offscreenTarget.Bind();
+        std::cout << "Renderowanie bez okna: " << headlessFrames << " klatek " << width << "x" << height
+            << (softwareRender ? " (rasteryzer programowy)" : usesFbo ? " (FBO)" : " (domyślny bufor)") << std::endl;
+
+        // Stały czas klatki – liczba kroków symulacji na klatkę powtarzalna
+        const double frameSeconds = 1.0 / targetFPS;
+        simulationClock.Reset();
+        headlessTotalMs = headlessWorstMs = 0.0;
+        headlessSaved = 0;
+
+        // Z wątkiem renderowania symulacja klatki N+1 biegnie w trakcie renderowania klatki N
+        if (renderThread) {
+            glfwMakeContextCurrent(NULL);
+            renderThread->Start([this](const RenderCommandList& list) {
+                executeCommands(list);
+                renderHeadlessFrame(static_cast<int>(list.GetFrame()));
+            }, [this] { glfwMakeContextCurrent(window); }, [] { glfwMakeContextCurrent(NULL); });
+        }
 
-            if (player->isLightingEnabled()) {
-                glEnable(GL_LIGHTING);
-                glEnable(GL_LIGHT0);
+        for (int frame = 0; frame < headlessFrames; frame++) {
+            if (renderThread) {
+                RenderCommandList& list = renderThread->BeginRecord();
+                simulate(frameSeconds);
+                recordFrameState(list);
+                renderThread->Submit();
+            }
+            else {
+                simulate(frameSeconds);
+                captureFrameState();
+                renderHeadlessFrame(frame);
             }
+        }
 
-            glfwSwapBuffers(window);
-            glfwPollEvents();
+        if (renderThread) {
+            renderThread->Stop();
+            glfwMakeContextCurrent(window);
+        }
+        if (!softwareRender) {
+            offscreenTarget.Unbind();
+            offscreenTarget.Destroy();
+        }
+        std::cout << "Zapisano " << headlessSaved << "/" << headlessFrames << " klatek (" << headlessPrefix << "_NNNN.ppm)\n";
+        std::cout << "Czas renderowania: średnio " << headlessTotalMs / headlessFrames << " ms, max " << headlessWorstMs << " ms" << std::endl;
+        printCullStats();
+        if (!dynamicLights.empty()) printClusterStats();
+        if (player->isShadowsEnabled()) printShadowStats();
+        if (softwareRender) softwareRasterizer.PrintStats();
+        else printRenderQueueStats();
+        GetJobSystem().PrintStats();
+        if (renderThread) renderThread->PrintStats();
+        simulationClock.PrintStats();
+        profiler.PrintSummary();
+        exportProfile(headlessPrefix + "_profile");
+    }
+    /**
+     * @brief Renderuje jedną klatkę bez okna, odczytuje ją i zapisuje do PPM.
+     */
+    void renderHeadlessFrame(int frame) {
+        profiler.BeginFrame();
+        textureCache.BeginFrame();
+        if (textureCache.Update(textureUploadBudget)) stateCache.Invalidate();
+        stateCache.BeginFrame();
+
+        double start = glfwGetTime();
+        if (softwareRender) {
+            renderSoftwareFrame();
+        }
+        else {
+            renderFrame();
+            PROFILE_ZONE(profiler, "Finish");
+            glFinish();
+        }
+        double frameMs = (glfwGetTime() - start) * 1000.0;
+        headlessTotalMs += frameMs;
+        if (frameMs > headlessWorstMs) headlessWorstMs = frameMs;
+
+        {
+            PROFILE_ZONE(profiler, "ReadPixels");
+            if (softwareRender) softwareRasterizer.ReadPixels(headlessPixels);
+            else offscreenTarget.ReadPixels(headlessPixels);
         }
+        std::ostringstream path;
+        path << headlessPrefix << "_" << std::setw(4) << std::setfill('0') << frame << ".ppm";
+        {
+            PROFILE_ZONE(profiler, "SavePPM");
+            if (BitmapHandler::SavePPM(path.str(), width, height, headlessPixels.data(), true)) headlessSaved++;
+        }
+        profiler.EndFrame();
     }
     /**
      * @brief Wyświetla informacje o sterowaniu.
@@ -1010,6 +2520,20 @@ public:
         std::cout << "  [T]       - Zwiększ liczbę segmentów kuli (x2)\n";
         std::cout << "  [Y]       - Zmniejsz liczbę segmentów kuli (/2)\n";
         std::cout << "  [B]       - Resetuj liczbę segmentów kuli\n";
+        std::cout << "  [M]       - Przełącz rysowanie siatek (VBO / glBegin-glEnd)\n";
+        std::cout << "  [N]       - Zmień ścieżkę rysowania sceny (instancing / scalona / osobno)\n";
+        std::cout << "  [Q]       - Zmień tryb cullingu (wyłączony / płaski SIMD / BVH)\n";
+        std::cout << "  [F1]      - Pokaż/ukryj wykres czasu klatek (profiler)\n";
+        std::cout << "  [F2]      - Podsumowanie profilera i zapis do profile.csv / profile_trace.json\n";
+        std::cout << "  [F3]      - Zmień liczbę świateł dynamicznych (0/16/128/512/2048, klastry)\n";
+        std::cout << "  [F4]      - Wypisz statystyki klastrów świateł\n";
+        std::cout << "  [Z]       - Włącz/wyłącz cienie (kaskadowe mapy cieni)\n";
+        std::cout << "  [F5]      - Zmień liczbę kaskad cieni (1-4)\n";
+        std::cout << "  [F6]      - Zmień rozdzielczość map cieni (512-4096)\n";
+        std::cout << "  [F7]      - Wypisz statystyki kolejki rysowania i wywołań stanu GL\n";
+        std::cout << "  [F8]      - Sprawdzanie kopii stanu GL zapytaniami glGet (debug)\n";
+        std::cout << "  [F9]      - Zmień filtrowanie anizotropowe (1x-16x)\n";
+        std::cout << "  [F10]     - Wypisz pamięć GPU tekstur i metryki wczytywania w tle\n";
         std::cout << "  [H]       - Wyświetl pomoc\n";
         std::cout << "  [↑]/[↓]   - Zwiększ/zmniejsz limit FPS (+/-10)\n";
         std::cout << "\nSTEROWANIE MYSZĄ:\n";
@@ -1023,7 +2547,23 @@ public:
         std::cout << "  VSync: " << (vsyncEnabled ? "Włączony" : "Wyłączony") << "\n";
         std::cout << "  Test głębokości: " << (depthTestEnabled ? "Włączony" : "Wyłączony") << "\n";
         std::cout << "  Segmenty kuli: " << sphereSegments << "\n";
+        std::cout << "  Obiekty sceny: " << scene.GetObjectCount() << "\n";
+        std::cout << "  Rysowanie sceny: " << GetInstancePathName(instancePath) << "\n";
+        std::cout << "  ";
+        printCullStats();
+        std::cout << "  Światła dynamiczne: " << dynamicLights.size() << "\n";
+        std::cout << "  ";
+        printShadowStats();
         std::cout << "  Celowy FPS: " << targetFPS << "\n";
+        std::cout << "  ";
+        simulationClock.PrintStats();
+        std::cout << "  ";
+        input.PrintStats();
+        std::cout << "  Wątek renderowania: ";
+        if (renderThread) std::cout << renderThread->GetBufferCount() << " listy poleceń\n";
+        else std::cout << "Wyłączony\n";
+        textureCache.PrintStats();
+        framePacer.PrintStats();
         player->printPlayerInfo();
         std::cout << "=============================\n" << std::endl;
     }
@@ -1032,21 +2572,21 @@ public:
      */
     static void keyCallbackStatic(GLFWwindow* window, int key, int scancode, int action, int mods) {
         Engine* engine = static_cast<Engine*>(glfwGetWindowUserPointer(window));
-        if (engine && action == GLFW_PRESS) engine->keyCallback(key);
+        if (engine) engine->queueInput(INPUT_KEY, key, action);
     }
     /**
     * @brief Callback kliknięcia myszy GLFW.
      */
     static void mouseCallbackStatic(GLFWwindow* window, int button, int action, int mods) {
         Engine* engine = static_cast<Engine*>(glfwGetWindowUserPointer(window));
-        if (engine && action == GLFW_PRESS) engine->mouseCallback(button);
+        if (engine) engine->queueInput(INPUT_MOUSE_BUTTON, button, action);
     }
     /**
      * @brief Callback scrolla myszy GLFW.
      */
     static void scrollCallbackStatic(GLFWwindow* window, double xoffset, double yoffset) {
         Engine* engine = static_cast<Engine*>(glfwGetWindowUserPointer(window));
-        if (engine) engine->scrollCallback(xoffset, yoffset);
+        if (engine) engine->queueInput(INPUT_SCROLL, 0, 0, xoffset, yoffset);
     }
     /**
     * @brief Callback zmiany rozmiaru okna.
@@ -1067,19 +2607,65 @@ public:
      */
     static void mouseMoveCallbackStatic(GLFWwindow* window, double xpos, double ypos) {
         Engine* engine = static_cast<Engine*>(glfwGetWindowUserPointer(window));
-        if (engine) engine->mouseMoveCallback(xpos, ypos);
+        if (engine) engine->queueInput(INPUT_CURSOR, 0, 0, xpos, ypos);
     }
 
 private:
+    /**
+     * @brief Dodaje zdarzenie okna ze znacznikiem czasu do kolejki wejścia.
+     */
+    void queueInput(InputEventType type, int code, int action, double x = 0.0, double y = 0.0) {
+        InputEvent event;
+        event.type = type;
+        event.code = code;
+        event.action = action;
+        event.x = x;
+        event.y = y;
+        event.time = InputSystem::Now();
+        input.Push(event);
+    }
     /**
      * @brief Obsługuje klawiaturę.
+     *
+     * Klawisze okna, kamery i świateł działają od razu na wątku głównym,
+     * pozostałe zmieniają stan renderowania – przy działającym wątku
+     * renderowania trafiają do nagrywanej listy poleceń.
      */
     void keyCallback(int key) {
+        if (simulationKey(key)) return;
+        if (renderThreadActive()) recordCommand(COMMAND_KEY, key);
+        else renderKey(key);
+    }
+    /**
+     * @brief Klawisze wątku głównego (okno, kamera, tempo klatek, światła dynamiczne).
+     * @return True, jeśli klawisz nie zmienia stanu renderowania.
+     */
+    bool simulationKey(int key) {
+        switch (key) {
+        case GLFW_KEY_ESCAPE: glfwSetWindowShouldClose(window, GLFW_TRUE); return true;
+        case GLFW_KEY_H:
+            // Pomoc czyta stan renderowania – wątek renderowania musi być bezczynny
+            if (renderThreadActive()) renderThread->Flush();
+            printControlInfo();
+            return true;
+        case GLFW_KEY_F: toggleFullscreen(); return true;
+        case GLFW_KEY_R: player->resetCamera(); return false; // reszta resetu w renderKey
+        case GLFW_KEY_SPACE: player->toggleRotation(); return true;
+        case GLFW_KEY_UP: targetFPS += 10; std::cout << "Celowe FPS: " << targetFPS << std::endl; return true;
+        case GLFW_KEY_DOWN: if (targetFPS > 10) { targetFPS -= 10; std::cout << "Celowe FPS: " << targetFPS << std::endl; } return true;
+        case GLFW_KEY_1: player->setCameraMode(Player::STATIC_CAMERA); return true;
+        case GLFW_KEY_2: player->setCameraMode(Player::FPS_CAMERA); return true;
+        case GLFW_KEY_3: player->setCameraMode(Player::MANUAL_CAMERA); return true;
+        case GLFW_KEY_F3: cycleDynamicLights(); return true;
+        }
+        return false;
+    }
+    /**
+     * @brief Klawisze zmieniające stan renderowania (wątek z kontekstem GL).
+     */
+    void renderKey(int key) {
         switch (key) {
-        case GLFW_KEY_ESCAPE: glfwSetWindowShouldClose(window, GLFW_TRUE); break;
-        case GLFW_KEY_H: printControlInfo(); break;
         case GLFW_KEY_P: toggleProjection(); break;
-        case GLFW_KEY_F: toggleFullscreen(); break;
         case GLFW_KEY_V: toggleVSync(); break;
         case GLFW_KEY_D: toggleDepthTest(); break;
         case GLFW_KEY_C:
@@ -1090,22 +2676,28 @@ private:
             setClearColor(0.2f, 0.3f, 0.3f, 1.0f);
             isPerspective = true;
             updateProjection();
-            player->resetCamera();
             resetSphereDetail();
             std::cout << "Zresetowano widok" << std::endl;
             break;
-        case GLFW_KEY_SPACE: player->toggleRotation(); break;
-        case GLFW_KEY_UP: targetFPS += 10; std::cout << "Celowe FPS: " << targetFPS << std::endl; break;
-        case GLFW_KEY_DOWN: if (targetFPS > 10) { targetFPS -= 10; std::cout << "Celowe FPS: " << targetFPS << std::endl; } break;
-        case GLFW_KEY_1: player->setCameraMode(Player::STATIC_CAMERA); break;
-        case GLFW_KEY_2: player->setCameraMode(Player::FPS_CAMERA); break;
-        case GLFW_KEY_3: player->setCameraMode(Player::MANUAL_CAMERA); break;
         case GLFW_KEY_L: player->toggleLighting(); break;
         case GLFW_KEY_X: player->toggleAxes(); break;
         case GLFW_KEY_G: player->toggleShading(); break;
         case GLFW_KEY_T: increaseSphereDetail(); break;
         case GLFW_KEY_Y: decreaseSphereDetail(); break;
         case GLFW_KEY_B: resetSphereDetail(); break;
+        case GLFW_KEY_M: toggleImmediateMode(); break;
+        case GLFW_KEY_N: cycleInstancePath(); break;
+        case GLFW_KEY_Q: cycleCullMode(); break;
+        case GLFW_KEY_F1: toggleProfilerOverlay(); break;
+        case GLFW_KEY_F2: profiler.PrintSummary(); exportProfile("profile"); break;
+        case GLFW_KEY_F4: printClusterStats(); break;
+        case GLFW_KEY_Z: toggleShadows(); break;
+        case GLFW_KEY_F5: cycleShadowCascades(); break;
+        case GLFW_KEY_F6: cycleShadowResolution(); break;
+        case GLFW_KEY_F7: printRenderQueueStats(); break;
+        case GLFW_KEY_F8: setStateValidation(!stateCache.IsValidating()); break;
+        case GLFW_KEY_F9: cycleAnisotropy(); break;
+        case GLFW_KEY_F10: printTextureMemory(); break;
         }
     }
     /**
@@ -1130,6 +2722,13 @@ private:
      * @brief Obsługuje zmianę rozmiaru okna.
      */
     void resizeCallback(int w, int h) {
+        if (renderThreadActive()) recordCommand(COMMAND_RESIZE, w, h);
+        else resize(w, h);
+    }
+    /**
+     * @brief Dopasowuje viewport i projekcję do nowego rozmiaru okna.
+     */
+    void resize(int w, int h) {
         width = w;
         height = h;
         glViewport(0, 0, w, h);
@@ -1154,9 +2753,197 @@ private:
  * @brief Punkt wejścia programu.
  * @return Kod zakończenia aplikacji.
  */
-int main() {
+int main(int argc, char* argv[]) {
     setlocale(LC_CTYPE, "Polish");
-    Engine engine(1024, 768, "3D Game Engine with Player Class");
-    engine.run();
+
+    // --headless [N] [--output prefiks] : N klatek poza ekranem zapisanych do PPM
+    // --scene plik : scena z pliku tekstowego, --objects N : scena testowa z N obiektów
+    // --lights N : światła dynamiczne
+    bool headless = false;
+    int headlessFrames = 1;
+    std::string outputPrefix = "frame";
+    std::string sceneFile;
+    int stressObjects = 0;
+    int benchInstances = 0;
+    int benchMath = 0;
+    int benchPixels = 0;
+    int benchDecode = 0;
+    int benchRaster = 0;
+    int softwareThreads = -1;
+    int jobThreads = 0;
+    int benchJobs = -1;
+    int renderBuffers = 0;
+    int simulationRate = 0;
+    int benchTimestep = 0;
+    int benchInput = 0;
+    int benchLights = 0;
+    int dynamicLights = 0;
+    bool shadows = false;
+    int shadowSize = 0;
+    int shadowCascades = 0;
+    bool validateState = false;
+    int benchMipmaps = 0;
+    float anisotropy = 0.0f;
+    bool gpuMipmaps = false;
+    int uploadBudgetKB = -1;
+    int uploadMode = -1;
+    int benchUploads = 0;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--headless") {
+            headless = true;
+            if (i + 1 < argc && isdigit((unsigned char)argv[i + 1][0])) headlessFrames = atoi(argv[++i]);
+        }
+        else if (arg == "--output" && i + 1 < argc) {
+            outputPrefix = argv[++i];
+        }
+        else if (arg == "--scene" && i + 1 < argc) {
+            sceneFile = argv[++i];
+        }
+        else if (arg == "--objects" && i + 1 < argc) {
+            stressObjects = atoi(argv[++i]);
+        }
+        else if (arg == "--bench-math") {
+            benchMath = 1000000;
+            if (i + 1 < argc && isdigit((unsigned char)argv[i + 1][0])) benchMath = atoi(argv[++i]);
+        }
+        else if (arg == "--bench-pixels") {
+            benchPixels = 4;
+            if (i + 1 < argc && isdigit((unsigned char)argv[i + 1][0])) benchPixels = atoi(argv[++i]);
+        }
+        else if (arg == "--bench-decode") {
+            benchDecode = 50;
+            if (i + 1 < argc && isdigit((unsigned char)argv[i + 1][0])) benchDecode = atoi(argv[++i]);
+        }
+        else if (arg == "--bench-raster") {
+            benchRaster = 2000;
+            if (i + 1 < argc && isdigit((unsigned char)argv[i + 1][0])) benchRaster = atoi(argv[++i]);
+        }
+        else if (arg == "--jobs" && i + 1 < argc) {
+            jobThreads = atoi(argv[++i]);
+        }
+        else if (arg == "--bench-jobs") {
+            benchJobs = 0;
+            if (i + 1 < argc && isdigit((unsigned char)argv[i + 1][0])) benchJobs = atoi(argv[++i]);
+        }
+        else if (arg == "--sim-rate" && i + 1 < argc) {
+            simulationRate = atoi(argv[++i]);
+        }
+        else if (arg == "--bench-timestep") {
+            benchTimestep = FixedTimestep::DEFAULT_RATE;
+            if (i + 1 < argc && isdigit((unsigned char)argv[i + 1][0])) benchTimestep = atoi(argv[++i]);
+        }
+        else if (arg == "--bench-input") {
+            benchInput = 1000000;
+            if (i + 1 < argc && isdigit((unsigned char)argv[i + 1][0])) benchInput = atoi(argv[++i]);
+        }
+        else if (arg == "--render-thread") {
+            renderBuffers = RenderThread::MIN_BUFFERS;
+            if (i + 1 < argc && isdigit((unsigned char)argv[i + 1][0])) renderBuffers = atoi(argv[++i]);
+        }
+        else if (arg == "--software") {
+            softwareThreads = 0;
+            if (i + 1 < argc && isdigit((unsigned char)argv[i + 1][0])) softwareThreads = atoi(argv[++i]);
+        }
+        else if (arg == "--lights" && i + 1 < argc) {
+            dynamicLights = atoi(argv[++i]);
+        }
+        else if (arg == "--shadows") {
+            shadows = true;
+        }
+        else if (arg == "--shadow-size" && i + 1 < argc) {
+            shadowSize = atoi(argv[++i]);
+        }
+        else if (arg == "--cascades" && i + 1 < argc) {
+            shadowCascades = atoi(argv[++i]);
+        }
+        else if (arg == "--anisotropy" && i + 1 < argc) {
+            anisotropy = static_cast<float>(atof(argv[++i]));
+        }
+        else if (arg == "--upload-budget" && i + 1 < argc) {
+            uploadBudgetKB = atoi(argv[++i]);
+        }
+        else if (arg == "--upload-mode" && i + 1 < argc) {
+            std::string name = argv[++i];
+            const char* names[] = { "client", "orphan", "range", "persistent" };
+            for (int m = 0; m < PIXEL_UPLOAD_MODE_COUNT; m++) {
+                if (name == names[m]) uploadMode = m;
+            }
+        }
+        else if (arg == "--bench-uploads") {
+            benchUploads = 256;
+            if (i + 1 < argc && isdigit((unsigned char)argv[i + 1][0])) benchUploads = atoi(argv[++i]);
+        }
+        else if (arg == "--gpu-mipmaps") {
+            gpuMipmaps = true;
+        }
+        else if (arg == "--bench-mipmaps") {
+            benchMipmaps = 64;
+            if (i + 1 < argc && isdigit((unsigned char)argv[i + 1][0])) benchMipmaps = atoi(argv[++i]);
+        }
+        else if (arg == "--gl-validate") {
+            validateState = true;
+        }
+        else if (arg == "--bench-lights") {
+            benchLights = 4096;
+            if (i + 1 < argc && isdigit((unsigned char)argv[i + 1][0])) benchLights = atoi(argv[++i]);
+        }
+        else if (arg == "--bench-instancing") {
+            benchInstances = 100000;
+            if (i + 1 < argc && isdigit((unsigned char)argv[i + 1][0])) benchInstances = atoi(argv[++i]);
+        }
+    }
+
+    // --jobs N : liczba wątków wspólnego systemu zadań (domyślnie liczba rdzeni)
+    if (jobThreads > 0) SetJobSystemThreadCount(jobThreads);
+    // --bench-math [N] : zgodność i wydajność MathLib (SIMD vs skalarnie), bez okna
+    if (benchMath > 0) return RunMathBenchmark(benchMath);
+    // --bench-pixels [MP] : zgodność i przepustowość konwersji pikseli (SIMD vs skalarnie), bez okna
+    if (benchPixels > 0) return RunPixelBenchmark(benchPixels);
+    // --bench-decode [N] : wczytywanie textura.jpg przez stertę vs arenę i pulę buforów, bez okna
+    if (benchDecode > 0) return RunDecodeBenchmark("textura.jpg", benchDecode);
+    // --bench-raster [N] : rasteryzer programowy na scenie N obiektów, trójkąty/s dla 1, 2, 4... wątków, bez okna
+    if (benchRaster > 0) return RunRasterBenchmark(benchRaster);
+    // --bench-jobs [N] : poprawność systemu zadań i skalowanie etapów silnika do N wątków (0: liczba rdzeni), bez okna
+    if (benchJobs >= 0) return RunJobBenchmark(benchJobs);
+    // --bench-timestep [Hz] : stały krok symulacji – powtarzalność, przycięcie, interpolacja (domyślnie 120 Hz), bez okna
+    if (benchTimestep > 0) return RunTimestepBenchmark(benchTimestep);
+    // --bench-input [N] : kolejka zdarzeń wejścia, stan akcji i znaczniki opóźnienia (domyślnie 1 000 000 zdarzeń), bez okna
+    if (benchInput > 0) return RunInputBenchmark(benchInput);
+    // --bench-lights [N] : czas przypisania 1..N świateł do klastrów (domyślnie 4096), bez okna
+    if (benchLights > 0) return RunClusterBenchmark(benchLights);
+
+    Engine engine(1024, 768, "3D Game Engine with Player Class", headless);
+    if (headless) engine.setHeadlessCapture(headlessFrames, outputPrefix);
+    // --software [N] : klatki bez okna z rasteryzera programowego na N wątkach (0: liczba rdzeni)
+    if (headless && softwareThreads >= 0) engine.setSoftwareRendering(softwareThreads);
+    // --render-thread [N] : GL na osobnym wątku, N list poleceń (2 lub 3, domyślnie 2)
+    if (renderBuffers > 0) engine.setRenderThread(renderBuffers);
+    // --sim-rate N : kroki symulacji na sekundę (domyślnie 120), renderowanie interpoluje między krokami
+    if (simulationRate > 0) engine.setSimulationRate(simulationRate);
+    if (!sceneFile.empty()) engine.loadScene(sceneFile);
+    else if (stressObjects > 0) engine.buildStressScene(stressObjects);
+    // --lights N : N dynamicznych świateł punktowych (oświetlenie klastrowe)
+    if (dynamicLights > 0) engine.setDynamicLightCount(dynamicLights);
+    // --shadows [--shadow-size N] [--cascades N] : kaskadowe mapy cieni
+    engine.setShadowSettings(shadowSize, shadowCascades);
+    if (shadows) engine.setShadowsEnabled(true);
+    // --gl-validate : porównywanie kopii stanu GL z glGet* (F8)
+    if (validateState) engine.setStateValidation(true);
+    // --gpu-mipmaps : mipmapy liczone przez sterownik, --anisotropy N : filtrowanie anizotropowe
+    if (gpuMipmaps) engine.setGpuMipmaps(true);
+    if (anisotropy > 0.0f) engine.setAnisotropy(anisotropy);
+    // --upload-budget KB : budżet wysyłki tekstur wczytanych w tle na klatkę (0: bez limitu)
+    if (uploadBudgetKB >= 0) engine.setTextureUploadBudget(uploadBudgetKB);
+    // --upload-mode client|orphan|range|persistent : tryb pierścienia PBO (domyślnie najszybszy dostępny)
+    if (uploadMode >= 0) engine.setTextureUploadMode(static_cast<PixelUploadMode>(uploadMode));
+
+    // --bench-instancing [N] : porównanie ścieżek rysowania N sześcianów (domyślnie 100 000)
+    if (benchInstances > 0) engine.runInstancingBenchmark(benchInstances);
+    // --bench-mipmaps [N] : próbkowanie z mipmapami i bez na siatce N x N dalekich sześcianów (domyślnie 64)
+    else if (benchMipmaps > 0) engine.runMipmapBenchmark(benchMipmaps);
+    // --bench-uploads [MB] : przepustowość wysyłki tekstur w trybach pierścienia PBO (domyślnie 256 MB)
+    else if (benchUploads > 0) engine.runUploadBenchmark(benchUploads);
+    else engine.run();
     return 0;
 }
@@ -0,0 +1,144 @@
+﻿#include "MathBenchmark.h"
+#include "BenchmarkUtils.h"
+#include "MathLib.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+/**
+ * @brief Największa różnica elementów dwóch macierzy.
+ */
+static float MaxDifference(const Mat4& a, const Mat4& b) {
+    float worst = 0.0f;
+    for (int i = 0; i < 16; i++) worst = std::max(worst, std::fabs(a.m[i] - b.m[i]));
+    return worst;
+}
+
+/**
+ * @brief Losowa macierz przekształcenia (obrót, skala, przesunięcie) – dobrze uwarunkowana.
+ */
+static Mat4 RandomTransform() {
+    auto random = []() { return (float)rand() / RAND_MAX * 2.0f - 1.0f; };
+    Vec3 axis(random(), random(), random() + 1.5f);
+    float scale = 0.5f + (random() + 1.0f);
+    return Mat4::Translation(random() * 10.0f, random() * 10.0f, random() * 10.0f)
+        * Mat4::Rotation(random() * MATH_PI, axis)
+        * Mat4::Scale(scale, scale, scale);
+}
+
+/**
+ * @brief Wypisuje wynik sprawdzenia i zwraca go.
+ */
+static bool Check(const char* name, float error, float tolerance) {
+    bool ok = error <= tolerance;
+    std::cout << "  ";
+    PrintPadded(name, 40);
+    std::cout << (ok ? "OK" : "BŁĄD") << "  (max błąd " << std::scientific << std::setprecision(2) << error << ")\n"
+        << std::defaultfloat;
+    return ok;
+}
+
+/**
+ * @brief Mierzy czas wywołania operation dla każdej macierzy z zestawu.
+ * @return Nanosekundy na operację.
+ */
+template <typename Operation>
+static double Measure(int iterations, const std::vector<Mat4>& inputs, Operation operation) {
+    float sink = 0.0f;
+    size_t mask = inputs.size() - 1;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++) {
+        Mat4 r = operation(inputs[i & mask], inputs[(i + 1) & mask]);
+        sink += r.m[i & 15];
+    }
+    auto end = std::chrono::steady_clock::now();
+    // Wynik musi być użyty, inaczej kompilator usunie pętlę
+    if (sink == 12345.678f) std::cout << "";
+    return std::chrono::duration<double, std::nano>(end - start).count() / iterations;
+}
+
+/**
+ * @brief Sprawdza i mierzy operacje MathLib.
+ */
+int RunMathBenchmark(int iterations) {
+    if (iterations <= 0) iterations = 1000000;
+    srand(12345);
+
+    std::cout << "\n=== TEST BIBLIOTEKI MATEMATYCZNEJ (" << MathSimd::GetInstructionSet() << ") ===\n";
+
+    // --- Poprawność ---
+    bool ok = true;
+    float multiplyError = 0.0f, inverseError = 0.0f, identityError = 0.0f;
+    for (int i = 0; i < 10000; i++) {
+        Mat4 a = RandomTransform(), b = RandomTransform();
+        multiplyError = std::max(multiplyError, MaxDifference(MathScalar::Multiply(a, b), MathSimd::Multiply(a, b)));
+        Mat4 inverse = MathSimd::Inverse(a);
+        inverseError = std::max(inverseError, MaxDifference(MathScalar::Inverse(a), inverse));
+        identityError = std::max(identityError, MaxDifference(MathScalar::Multiply(a, inverse), Mat4::Identity()));
+    }
+    ok &= Check("Multiply: SIMD = skalarny", multiplyError, 1e-4f);
+    ok &= Check("Inverse: SIMD = skalarny", inverseError, 1e-4f);
+    ok &= Check("A * Inverse(A) = I", identityError, 1e-4f);
+
+    float quaternionError = 0.0f;
+    for (int i = 0; i < 1000; i++) {
+        Vec3 axis((float)rand() / RAND_MAX, (float)rand() / RAND_MAX + 0.1f, (float)rand() / RAND_MAX);
+        float angle = (float)rand() / RAND_MAX * 2.0f * MATH_PI;
+        Quat q = Quat::FromAxisAngle(axis, angle);
+        Vec3 v((float)rand() / RAND_MAX, (float)rand() / RAND_MAX, (float)rand() / RAND_MAX);
+        Vec3 a = q.Rotate(v), b = q.ToMat4().TransformVector(v);
+        quaternionError = std::max(quaternionError, Length(a - b));
+
+        // Złożenie kwaternionów odpowiada iloczynowi macierzy
+        Quat p = Quat::FromAxisAngle(Vec3(1.0f, 0.0f, 0.0f), angle * 0.5f);
+        quaternionError = std::max(quaternionError, MaxDifference((q * p).ToMat4(), q.ToMat4() * p.ToMat4()));
+    }
+    ok &= Check("Quat: Rotate = ToMat4, q*p = Mq*Mp", quaternionError, 1e-5f);
+
+    // glRotatef(90, 0, 1, 0) obraca oś X na -Z
+    Vec3 rotated = Mat4::Rotation(Radians(90.0f), Vec3(0.0f, 1.0f, 0.0f)).TransformVector(Vec3(1.0f, 0.0f, 0.0f));
+    ok &= Check("Rotation zgodny z glRotatef", Length(rotated - Vec3(0.0f, 0.0f, -1.0f)), 1e-6f);
+
+    Vec3 eye(3.0f, 4.0f, 5.0f), target(-1.0f, 0.5f, 2.0f);
+    Mat4 view = Mat4::LookAt(eye, target, Vec3(0.0f, 1.0f, 0.0f));
+    Vec3 eyeInView = view.TransformPoint(eye);
+    Vec3 targetInView = view.TransformPoint(target);
+    float lookAtError = std::max(Length(eyeInView),
+        std::max(std::fabs(targetInView.x), std::fabs(targetInView.y)));
+    if (targetInView.z >= 0.0f) lookAtError = 1.0f; // cel musi leżeć przed kamerą (-Z)
+    ok &= Check("LookAt: oko w 0, cel na osi -Z", lookAtError, 1e-5f);
+
+    Mat4 projection = Mat4::Perspective(Radians(60.0f), 4.0f / 3.0f, 0.1f, 100.0f);
+    Vec4 nearPoint = projection.Transform(Vec4(0.0f, 0.0f, -0.1f, 1.0f));
+    Vec4 farPoint = projection.Transform(Vec4(0.0f, 0.0f, -100.0f, 1.0f));
+    float depthError = std::max(std::fabs(nearPoint.z / nearPoint.w + 1.0f), std::fabs(farPoint.z / farPoint.w - 1.0f));
+    ok &= Check("Perspective: near -> -1, far -> 1", depthError, 1e-4f);
+
+    // --- Wydajność ---
+    std::vector<Mat4> inputs(1024);
+    for (Mat4& m : inputs) m = RandomTransform();
+
+    struct Row { const char* name; double scalar; double simd; };
+    Row rows[2] = {
+        { "Multiply", Measure(iterations, inputs, [](const Mat4& a, const Mat4& b) { return MathScalar::Multiply(a, b); }),
+            Measure(iterations, inputs, [](const Mat4& a, const Mat4& b) { return MathSimd::Multiply(a, b); }) },
+        { "Inverse", Measure(iterations, inputs, [](const Mat4& a, const Mat4&) { return MathScalar::Inverse(a); }),
+            Measure(iterations, inputs, [](const Mat4& a, const Mat4&) { return MathSimd::Inverse(a); }) },
+    };
+
+    std::cout << "\n  Operacja    skalarny [ns]   " << MathSimd::GetInstructionSet() << " [ns]   przyspieszenie  ("
+        << iterations << " operacji)\n";
+    std::cout << std::fixed << std::setprecision(2);
+    for (const Row& row : rows) {
+        std::cout << "  " << std::left << std::setw(10) << row.name << std::right
+            << std::setw(15) << row.scalar << std::setw(12) << row.simd
+            << std::setw(15) << row.scalar / row.simd << "x\n";
+    }
+    std::cout << std::defaultfloat;
+    return BenchmarkSummary(ok);
+}
@@ -0,0 +1,15 @@
+﻿#pragma once
+#ifndef MATH_BENCHMARK_H
+#define MATH_BENCHMARK_H
+
+/**
+ * @brief Sprawdza zgodność wersji SIMD z wersjami skalarnymi biblioteki
+ *        MathLib i mierzy ich wydajność.
+ *
+ * Nie wymaga kontekstu OpenGL.
+ * @param iterations Liczba operacji w każdym pomiarze.
+ * @return 0 jeśli wszystkie sprawdzenia przeszły, 1 w przeciwnym razie.
+ */
+int RunMathBenchmark(int iterations);
+
+#endif
@@ -0,0 +1,384 @@
+﻿#include "MathLib.h"
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__SSE__)
+#include <xmmintrin.h>
+#define MATH_SSE 1
+#endif
+#if defined(__AVX__)
+#include <immintrin.h>
+#define MATH_AVX 1
+#endif
+
+// === Mat4 ===
+
+/**
+ * @brief Macierz jednostkowa.
+ */
+Mat4 Mat4::Identity() {
+    Mat4 r;
+    for (int i = 0; i < 16; i++) r.m[i] = 0.0f;
+    r.m[0] = r.m[5] = r.m[10] = r.m[15] = 1.0f;
+    return r;
+}
+
+/**
+ * @brief Przesunięcie (odpowiednik glTranslatef).
+ */
+Mat4 Mat4::Translation(float x, float y, float z) {
+    Mat4 r = Identity();
+    r.m[12] = x;
+    r.m[13] = y;
+    r.m[14] = z;
+    return r;
+}
+
+/**
+ * @brief Skalowanie (odpowiednik glScalef).
+ */
+Mat4 Mat4::Scale(float x, float y, float z) {
+    Mat4 r = Identity();
+    r.m[0] = x;
+    r.m[5] = y;
+    r.m[10] = z;
+    return r;
+}
+
+/**
+ * @brief Obrót o kąt w radianach wokół osi (odpowiednik glRotatef).
+ */
+Mat4 Mat4::Rotation(float radians, const Vec3& axis) {
+    return Quat::FromAxisAngle(axis, radians).ToMat4();
+}
+
+/**
+ * @brief Rzutowanie perspektywiczne (odpowiednik gluPerspective).
+ */
+Mat4 Mat4::Perspective(float fovY, float aspect, float nearPlane, float farPlane) {
+    Mat4 r = Identity();
+    float f = 1.0f / std::tan(fovY * 0.5f);
+    r.m[0] = f / aspect;
+    r.m[5] = f;
+    r.m[10] = (farPlane + nearPlane) / (nearPlane - farPlane);
+    r.m[11] = -1.0f;
+    r.m[14] = (2.0f * farPlane * nearPlane) / (nearPlane - farPlane);
+    r.m[15] = 0.0f;
+    return r;
+}
+
+/**
+ * @brief Rzutowanie ortogonalne (odpowiednik glOrtho).
+ */
+Mat4 Mat4::Orthographic(float left, float right, float bottom, float top, float nearPlane, float farPlane) {
+    Mat4 r = Identity();
+    r.m[0] = 2.0f / (right - left);
+    r.m[5] = 2.0f / (top - bottom);
+    r.m[10] = -2.0f / (farPlane - nearPlane);
+    r.m[12] = -(right + left) / (right - left);
+    r.m[13] = -(top + bottom) / (top - bottom);
+    r.m[14] = -(farPlane + nearPlane) / (farPlane - nearPlane);
+    return r;
+}
+
+/**
+ * @brief Macierz widoku (odpowiednik gluLookAt).
+ */
+Mat4 Mat4::LookAt(const Vec3& eye, const Vec3& target, const Vec3& up) {
+    Vec3 forward = Normalize(target - eye);
+    Vec3 side = Normalize(Cross(forward, up));
+    Vec3 realUp = Cross(side, forward);
+
+    Mat4 r = Identity();
+    r.m[0] = side.x;  r.m[4] = side.y;  r.m[8] = side.z;
+    r.m[1] = realUp.x; r.m[5] = realUp.y; r.m[9] = realUp.z;
+    r.m[2] = -forward.x; r.m[6] = -forward.y; r.m[10] = -forward.z;
+    r.m[12] = -Dot(side, eye);
+    r.m[13] = -Dot(realUp, eye);
+    r.m[14] = Dot(forward, eye);
+    return r;
+}
+
+/**
+ * @brief Przekształca punkt (w = 1).
+ */
+Vec3 Mat4::TransformPoint(const Vec3& p) const {
+    return Vec3(m[0] * p.x + m[4] * p.y + m[8] * p.z + m[12],
+        m[1] * p.x + m[5] * p.y + m[9] * p.z + m[13],
+        m[2] * p.x + m[6] * p.y + m[10] * p.z + m[14]);
+}
+
+/**
+ * @brief Przekształca kierunek (w = 0).
+ */
+Vec3 Mat4::TransformVector(const Vec3& v) const {
+    return Vec3(m[0] * v.x + m[4] * v.y + m[8] * v.z,
+        m[1] * v.x + m[5] * v.y + m[9] * v.z,
+        m[2] * v.x + m[6] * v.y + m[10] * v.z);
+}
+
+/**
+ * @brief Przekształca wektor jednorodny.
+ */
+Vec4 Mat4::Transform(const Vec4& v) const {
+    return Vec4(m[0] * v.x + m[4] * v.y + m[8] * v.z + m[12] * v.w,
+        m[1] * v.x + m[5] * v.y + m[9] * v.z + m[13] * v.w,
+        m[2] * v.x + m[6] * v.y + m[10] * v.z + m[14] * v.w,
+        m[3] * v.x + m[7] * v.y + m[11] * v.z + m[15] * v.w);
+}
+
+// === Quat ===
+
+/**
+ * @brief Obrót o kąt w radianach wokół osi.
+ */
+Quat Quat::FromAxisAngle(const Vec3& axis, float radians) {
+    Vec3 n = Normalize(axis);
+    float s = std::sin(radians * 0.5f);
+    return Quat(n.x * s, n.y * s, n.z * s, std::cos(radians * 0.5f));
+}
+
+/**
+ * @brief Złożenie obrotów (iloczyn Hamiltona).
+ */
+Quat Quat::operator*(const Quat& o) const {
+    return Quat(w * o.x + x * o.w + y * o.z - z * o.y,
+        w * o.y - x * o.z + y * o.w + z * o.x,
+        w * o.z + x * o.y - y * o.x + z * o.w,
+        w * o.w - x * o.x - y * o.y - z * o.z);
+}
+
+/**
+ * @brief Obraca wektor.
+ */
+Vec3 Quat::Rotate(const Vec3& v) const {
+    // v' = v + 2w(q x v) + 2q x (q x v)
+    Vec3 q(x, y, z);
+    Vec3 t = Cross(q, v) * 2.0f;
+    return v + t * w + Cross(q, t);
+}
+
+/**
+ * @brief Zwraca kwaternion o długości 1.
+ */
+Quat Quat::Normalized() const {
+    float length = std::sqrt(x * x + y * y + z * z + w * w);
+    if (length <= 0.0f) return Quat();
+    float inverse = 1.0f / length;
+    return Quat(x * inverse, y * inverse, z * inverse, w * inverse);
+}
+
+/**
+ * @brief Macierz obrotu.
+ */
+Mat4 Quat::ToMat4() const {
+    Mat4 r = Mat4::Identity();
+    float xx = x * x, yy = y * y, zz = z * z;
+    float xy = x * y, xz = x * z, yz = y * z;
+    float wx = w * x, wy = w * y, wz = w * z;
+    r.m[0] = 1.0f - 2.0f * (yy + zz);
+    r.m[1] = 2.0f * (xy + wz);
+    r.m[2] = 2.0f * (xz - wy);
+    r.m[4] = 2.0f * (xy - wz);
+    r.m[5] = 1.0f - 2.0f * (xx + zz);
+    r.m[6] = 2.0f * (yz + wx);
+    r.m[8] = 2.0f * (xz + wy);
+    r.m[9] = 2.0f * (yz - wx);
+    r.m[10] = 1.0f - 2.0f * (xx + yy);
+    return r;
+}
+
+// === Wersje skalarne ===
+
+/**
+ * @brief Mnożenie macierzy (wzorcowe).
+ */
+Mat4 MathScalar::Multiply(const Mat4& a, const Mat4& b) {
+    Mat4 r;
+    for (int column = 0; column < 4; column++) {
+        for (int row = 0; row < 4; row++) {
+            float sum = 0.0f;
+            for (int k = 0; k < 4; k++) sum += a.m[k * 4 + row] * b.m[column * 4 + k];
+            r.m[column * 4 + row] = sum;
+        }
+    }
+    return r;
+}
+
+/**
+ * @brief Odwracanie macierzy przez dopełnienia algebraiczne (wzorcowe).
+ *
+ * Dla macierzy osobliwej zwraca macierz jednostkową.
+ */
+Mat4 MathScalar::Inverse(const Mat4& a) {
+    const float* m = a.m;
+    Mat4 r;
+    float* inv = r.m;
+
+    inv[0] = m[5] * m[10] * m[15] - m[5] * m[11] * m[14] - m[9] * m[6] * m[15] + m[9] * m[7] * m[14] + m[13] * m[6] * m[11] - m[13] * m[7] * m[10];
+    inv[4] = -m[4] * m[10] * m[15] + m[4] * m[11] * m[14] + m[8] * m[6] * m[15] - m[8] * m[7] * m[14] - m[12] * m[6] * m[11] + m[12] * m[7] * m[10];
+    inv[8] = m[4] * m[9] * m[15] - m[4] * m[11] * m[13] - m[8] * m[5] * m[15] + m[8] * m[7] * m[13] + m[12] * m[5] * m[11] - m[12] * m[7] * m[9];
+    inv[12] = -m[4] * m[9] * m[14] + m[4] * m[10] * m[13] + m[8] * m[5] * m[14] - m[8] * m[6] * m[13] - m[12] * m[5] * m[10] + m[12] * m[6] * m[9];
+    inv[1] = -m[1] * m[10] * m[15] + m[1] * m[11] * m[14] + m[9] * m[2] * m[15] - m[9] * m[3] * m[14] - m[13] * m[2] * m[11] + m[13] * m[3] * m[10];
+    inv[5] = m[0] * m[10] * m[15] - m[0] * m[11] * m[14] - m[8] * m[2] * m[15] + m[8] * m[3] * m[14] + m[12] * m[2] * m[11] - m[12] * m[3] * m[10];
+    inv[9] = -m[0] * m[9] * m[15] + m[0] * m[11] * m[13] + m[8] * m[1] * m[15] - m[8] * m[3] * m[13] - m[12] * m[1] * m[11] + m[12] * m[3] * m[9];
+    inv[13] = m[0] * m[9] * m[14] - m[0] * m[10] * m[13] - m[8] * m[1] * m[14] + m[8] * m[2] * m[13] + m[12] * m[1] * m[10] - m[12] * m[2] * m[9];
+    inv[2] = m[1] * m[6] * m[15] - m[1] * m[7] * m[14] - m[5] * m[2] * m[15] + m[5] * m[3] * m[14] + m[13] * m[2] * m[7] - m[13] * m[3] * m[6];
+    inv[6] = -m[0] * m[6] * m[15] + m[0] * m[7] * m[14] + m[4] * m[2] * m[15] - m[4] * m[3] * m[14] - m[12] * m[2] * m[7] + m[12] * m[3] * m[6];
+    inv[10] = m[0] * m[5] * m[15] - m[0] * m[7] * m[13] - m[4] * m[1] * m[15] + m[4] * m[3] * m[13] + m[12] * m[1] * m[7] - m[12] * m[3] * m[5];
+    inv[14] = -m[0] * m[5] * m[14] + m[0] * m[6] * m[13] + m[4] * m[1] * m[14] - m[4] * m[2] * m[13] - m[12] * m[1] * m[6] + m[12] * m[2] * m[5];
+    inv[3] = -m[1] * m[6] * m[11] + m[1] * m[7] * m[10] + m[5] * m[2] * m[11] - m[5] * m[3] * m[10] - m[9] * m[2] * m[7] + m[9] * m[3] * m[6];
+    inv[7] = m[0] * m[6] * m[11] - m[0] * m[7] * m[10] - m[4] * m[2] * m[11] + m[4] * m[3] * m[10] + m[8] * m[2] * m[7] - m[8] * m[3] * m[6];
+    inv[11] = -m[0] * m[5] * m[11] + m[0] * m[7] * m[9] + m[4] * m[1] * m[11] - m[4] * m[3] * m[9] - m[8] * m[1] * m[7] + m[8] * m[3] * m[5];
+    inv[15] = m[0] * m[5] * m[10] - m[0] * m[6] * m[9] - m[4] * m[1] * m[10] + m[4] * m[2] * m[9] + m[8] * m[1] * m[6] - m[8] * m[2] * m[5];
+
+    float det = m[0] * inv[0] + m[1] * inv[4] + m[2] * inv[8] + m[3] * inv[12];
+    if (det == 0.0f) return Mat4::Identity();
+
+    float inverseDet = 1.0f / det;
+    for (int i = 0; i < 16; i++) inv[i] *= inverseDet;
+    return r;
+}
+
+// === Wersje SIMD ===
+
+#ifdef MATH_SSE
+#define MATH_SHUFFLE_MASK(x, y, z, w) ((x) | ((y) << 2) | ((z) << 4) | ((w) << 6))
+#define MATH_SWIZZLE(v, x, y, z, w) _mm_shuffle_ps((v), (v), MATH_SHUFFLE_MASK(x, y, z, w))
+#define MATH_SHUFFLE(a, b, x, y, z, w) _mm_shuffle_ps((a), (b), MATH_SHUFFLE_MASK(x, y, z, w))
+
+// Macierze 2x2 zapisane w jednym rejestrze jako (m00, m01, m10, m11)
+
+/** @brief A * B dla macierzy 2x2. */
+static inline __m128 Mat2Mul(__m128 a, __m128 b) {
+    return _mm_add_ps(_mm_mul_ps(a, MATH_SWIZZLE(b, 0, 3, 0, 3)),
+        _mm_mul_ps(MATH_SWIZZLE(a, 1, 0, 3, 2), MATH_SWIZZLE(b, 2, 1, 2, 1)));
+}
+
+/** @brief adj(A) * B dla macierzy 2x2. */
+static inline __m128 Mat2AdjMul(__m128 a, __m128 b) {
+    return _mm_sub_ps(_mm_mul_ps(MATH_SWIZZLE(a, 3, 3, 0, 0), b),
+        _mm_mul_ps(MATH_SWIZZLE(a, 1, 1, 2, 2), MATH_SWIZZLE(b, 2, 3, 0, 1)));
+}
+
+/** @brief A * adj(B) dla macierzy 2x2. */
+static inline __m128 Mat2MulAdj(__m128 a, __m128 b) {
+    return _mm_sub_ps(_mm_mul_ps(a, MATH_SWIZZLE(b, 3, 0, 3, 0)),
+        _mm_mul_ps(MATH_SWIZZLE(a, 1, 0, 3, 2), MATH_SWIZZLE(b, 2, 1, 2, 1)));
+}
+#endif
+
+/**
+ * @brief Mnożenie macierzy (SIMD).
+ *
+ * Kolumna j wyniku to kombinacja liniowa kolumn a ze współczynnikami
+ * z kolumny j macierzy b. AVX liczy dwie kolumny wyniku naraz.
+ */
+Mat4 MathSimd::Multiply(const Mat4& a, const Mat4& b) {
+#if defined(MATH_AVX)
+    Mat4 r;
+    __m256 a0 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(a.m + 0));
+    __m256 a1 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(a.m + 4));
+    __m256 a2 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(a.m + 8));
+    __m256 a3 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(a.m + 12));
+    for (int column = 0; column < 4; column += 2) {
+        __m256 bb = _mm256_loadu_ps(b.m + column * 4);
+        __m256 sum = _mm256_mul_ps(a0, _mm256_permute_ps(bb, 0x00));
+        sum = _mm256_add_ps(sum, _mm256_mul_ps(a1, _mm256_permute_ps(bb, 0x55)));
+        sum = _mm256_add_ps(sum, _mm256_mul_ps(a2, _mm256_permute_ps(bb, 0xAA)));
+        sum = _mm256_add_ps(sum, _mm256_mul_ps(a3, _mm256_permute_ps(bb, 0xFF)));
+        _mm256_storeu_ps(r.m + column * 4, sum);
+    }
+    return r;
+#elif defined(MATH_SSE)
+    Mat4 r;
+    __m128 a0 = _mm_loadu_ps(a.m + 0);
+    __m128 a1 = _mm_loadu_ps(a.m + 4);
+    __m128 a2 = _mm_loadu_ps(a.m + 8);
+    __m128 a3 = _mm_loadu_ps(a.m + 12);
+    for (int column = 0; column < 4; column++) {
+        const float* bc = b.m + column * 4;
+        __m128 sum = _mm_mul_ps(a0, _mm_set1_ps(bc[0]));
+        sum = _mm_add_ps(sum, _mm_mul_ps(a1, _mm_set1_ps(bc[1])));
+        sum = _mm_add_ps(sum, _mm_mul_ps(a2, _mm_set1_ps(bc[2])));
+        sum = _mm_add_ps(sum, _mm_mul_ps(a3, _mm_set1_ps(bc[3])));
+        _mm_storeu_ps(r.m + column * 4, sum);
+    }
+    return r;
+#else
+    return MathScalar::Multiply(a, b);
+#endif
+}
+
+/**
+ * @brief Odwracanie macierzy metodą bloków 2x2 (SIMD).
+ *
+ * M = [A B; C D], odwrotność liczona z dopełnień bloków 2x2 i wyznacznika
+ * |M| = |A||D| + |B||C| - tr(adj(A)B adj(D)C). Algorytm nie zależy od
+ * układu (wierszowy/kolumnowy), bo inv(M^T) = inv(M)^T.
+ * Dla macierzy osobliwej zwraca macierz jednostkową.
+ */
+Mat4 MathSimd::Inverse(const Mat4& a) {
+#ifdef MATH_SSE
+    __m128 c0 = _mm_loadu_ps(a.m + 0);
+    __m128 c1 = _mm_loadu_ps(a.m + 4);
+    __m128 c2 = _mm_loadu_ps(a.m + 8);
+    __m128 c3 = _mm_loadu_ps(a.m + 12);
+
+    __m128 A = _mm_movelh_ps(c0, c1);
+    __m128 B = _mm_movehl_ps(c1, c0);
+    __m128 C = _mm_movelh_ps(c2, c3);
+    __m128 D = _mm_movehl_ps(c3, c2);
+
+    // Wyznaczniki bloków (|A|, |B|, |C|, |D|)
+    __m128 detSub = _mm_sub_ps(
+        _mm_mul_ps(MATH_SHUFFLE(c0, c2, 0, 2, 0, 2), MATH_SHUFFLE(c1, c3, 1, 3, 1, 3)),
+        _mm_mul_ps(MATH_SHUFFLE(c0, c2, 1, 3, 1, 3), MATH_SHUFFLE(c1, c3, 0, 2, 0, 2)));
+    __m128 detA = MATH_SWIZZLE(detSub, 0, 0, 0, 0);
+    __m128 detB = MATH_SWIZZLE(detSub, 1, 1, 1, 1);
+    __m128 detC = MATH_SWIZZLE(detSub, 2, 2, 2, 2);
+    __m128 detD = MATH_SWIZZLE(detSub, 3, 3, 3, 3);
+
+    __m128 DC = Mat2AdjMul(D, C);
+    __m128 AB = Mat2AdjMul(A, B);
+    __m128 X = _mm_sub_ps(_mm_mul_ps(detD, A), Mat2Mul(B, DC));
+    __m128 W = _mm_sub_ps(_mm_mul_ps(detA, D), Mat2Mul(C, AB));
+    __m128 Y = _mm_sub_ps(_mm_mul_ps(detB, C), Mat2MulAdj(D, AB));
+    __m128 Z = _mm_sub_ps(_mm_mul_ps(detC, B), Mat2MulAdj(A, DC));
+
+    __m128 detM = _mm_add_ps(_mm_mul_ps(detA, detD), _mm_mul_ps(detB, detC));
+    __m128 trace = _mm_mul_ps(AB, MATH_SWIZZLE(DC, 0, 2, 1, 3));
+    trace = _mm_add_ps(trace, MATH_SWIZZLE(trace, 2, 3, 0, 1));
+    trace = _mm_add_ps(trace, MATH_SWIZZLE(trace, 1, 0, 3, 2));
+    detM = _mm_sub_ps(detM, trace);
+
+    if (_mm_cvtss_f32(detM) == 0.0f) return Mat4::Identity();
+
+    const __m128 adjSign = _mm_setr_ps(1.0f, -1.0f, -1.0f, 1.0f);
+    __m128 inverseDet = _mm_div_ps(adjSign, detM);
+    X = _mm_mul_ps(X, inverseDet);
+    Y = _mm_mul_ps(Y, inverseDet);
+    Z = _mm_mul_ps(Z, inverseDet);
+    W = _mm_mul_ps(W, inverseDet);
+
+    Mat4 r;
+    _mm_storeu_ps(r.m + 0, MATH_SHUFFLE(X, Y, 3, 1, 3, 1));
+    _mm_storeu_ps(r.m + 4, MATH_SHUFFLE(X, Y, 2, 0, 2, 0));
+    _mm_storeu_ps(r.m + 8, MATH_SHUFFLE(Z, W, 3, 1, 3, 1));
+    _mm_storeu_ps(r.m + 12, MATH_SHUFFLE(Z, W, 2, 0, 2, 0));
+    return r;
+#else
+    return MathScalar::Inverse(a);
+#endif
+}
+
+/**
+ * @brief Nazwa używanego zestawu instrukcji.
+ */
+const char* MathSimd::GetInstructionSet() {
+#if defined(MATH_AVX)
+    return "AVX";
+#elif defined(MATH_SSE)
+    return "SSE";
+#else
+    return "skalarny";
+#endif
+}
@@ -0,0 +1,141 @@
+﻿#pragma once
+#ifndef MATH_LIB_H
+#define MATH_LIB_H
+
+#include <cmath>
+
+/**
+ * @file MathLib.h
+ * @brief Wektory, macierze 4x4 i kwaterniony z przyspieszeniem SIMD.
+ *
+ * Macierze są przechowywane kolumnowo, tak jak oczekuje glLoadMatrixf,
+ * a mnożenie a * b odpowiada kolejności wywołań glMultMatrixf (najpierw a,
+ * potem b). Mnożenie i odwracanie macierzy mają wersje SSE/AVX (MathSimd)
+ * oraz skalarne wersje wzorcowe (MathScalar) używane do porównań.
+ */
+
+/// Stała pi w pojedynczej precyzji
+const float MATH_PI = 3.14159265358979f;
+
+/**
+ * @brief Zamienia stopnie na radiany.
+ */
+inline float Radians(float degrees) { return degrees * (MATH_PI / 180.0f); }
+
+/**
+ * @brief Wektor trójwymiarowy.
+ */
+struct Vec3 {
+    float x, y, z;
+
+    Vec3() : x(0.0f), y(0.0f), z(0.0f) {}
+    Vec3(float x, float y, float z) : x(x), y(y), z(z) {}
+
+    Vec3 operator+(const Vec3& o) const { return Vec3(x + o.x, y + o.y, z + o.z); }
+    Vec3 operator-(const Vec3& o) const { return Vec3(x - o.x, y - o.y, z - o.z); }
+    Vec3 operator*(float s) const { return Vec3(x * s, y * s, z * s); }
+    Vec3 operator-() const { return Vec3(-x, -y, -z); }
+};
+
+inline float Dot(const Vec3& a, const Vec3& b) { return a.x * b.x + a.y * b.y + a.z * b.z; }
+inline Vec3 Cross(const Vec3& a, const Vec3& b) {
+    return Vec3(a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x);
+}
+inline float Length(const Vec3& v) { return std::sqrt(Dot(v, v)); }
+inline Vec3 Normalize(const Vec3& v) {
+    float length = Length(v);
+    return length > 0.0f ? v * (1.0f / length) : v;
+}
+
+/**
+ * @brief Wektor czterowymiarowy (współrzędne jednorodne).
+ */
+struct Vec4 {
+    float x, y, z, w;
+
+    Vec4() : x(0.0f), y(0.0f), z(0.0f), w(0.0f) {}
+    Vec4(float x, float y, float z, float w) : x(x), y(y), z(z), w(w) {}
+    Vec4(const Vec3& v, float w) : x(v.x), y(v.y), z(v.z), w(w) {}
+};
+
+/**
+ * @brief Macierz 4x4 w układzie kolumnowym (m[kolumna * 4 + wiersz]).
+ */
+struct Mat4 {
+    float m[16];
+
+    /// Macierz jednostkowa
+    static Mat4 Identity();
+    /// Przesunięcie (odpowiednik glTranslatef)
+    static Mat4 Translation(float x, float y, float z);
+    /// Skalowanie (odpowiednik glScalef)
+    static Mat4 Scale(float x, float y, float z);
+    /// Obrót o kąt w radianach wokół osi (odpowiednik glRotatef)
+    static Mat4 Rotation(float radians, const Vec3& axis);
+    /// Rzutowanie perspektywiczne (odpowiednik gluPerspective, fovY w radianach)
+    static Mat4 Perspective(float fovY, float aspect, float nearPlane, float farPlane);
+    /// Rzutowanie ortogonalne (odpowiednik glOrtho)
+    static Mat4 Orthographic(float left, float right, float bottom, float top, float nearPlane, float farPlane);
+    /// Macierz widoku kamery w eye patrzącej na target (odpowiednik gluLookAt)
+    static Mat4 LookAt(const Vec3& eye, const Vec3& target, const Vec3& up);
+
+    const float* Data() const { return m; }
+    float* Data() { return m; }
+
+    /// Przekształca punkt (w = 1)
+    Vec3 TransformPoint(const Vec3& p) const;
+    /// Przekształca kierunek (w = 0)
+    Vec3 TransformVector(const Vec3& v) const;
+    /// Przekształca wektor jednorodny
+    Vec4 Transform(const Vec4& v) const;
+};
+
+/**
+ * @brief Kwaternion jednostkowy opisujący orientację.
+ */
+struct Quat {
+    float x, y, z, w;
+
+    Quat() : x(0.0f), y(0.0f), z(0.0f), w(1.0f) {}
+    Quat(float x, float y, float z, float w) : x(x), y(y), z(z), w(w) {}
+
+    /// Obrót o kąt w radianach wokół osi
+    static Quat FromAxisAngle(const Vec3& axis, float radians);
+
+    /// Złożenie obrotów: najpierw o, potem this (jak mnożenie macierzy)
+    Quat operator*(const Quat& o) const;
+
+    /// Obraca wektor
+    Vec3 Rotate(const Vec3& v) const;
+    /// Zwraca kwaternion o długości 1
+    Quat Normalized() const;
+    /// Odwrotny obrót (sprzężenie kwaternionu jednostkowego)
+    Quat Conjugate() const { return Quat(-x, -y, -z, w); }
+    /// Macierz obrotu
+    Mat4 ToMat4() const;
+};
+
+/**
+ * @brief Wersje wzorcowe (skalarne) operacji macierzowych.
+ */
+namespace MathScalar {
+    Mat4 Multiply(const Mat4& a, const Mat4& b);
+    Mat4 Inverse(const Mat4& a);
+}
+
+/**
+ * @brief Wersje SIMD operacji macierzowych (SSE; AVX gdy kompilator go włącza).
+ *
+ * Na platformach bez SSE funkcje wołają wersje skalarne.
+ */
+namespace MathSimd {
+    Mat4 Multiply(const Mat4& a, const Mat4& b);
+    Mat4 Inverse(const Mat4& a);
+    /// Nazwa używanego zestawu instrukcji ("AVX", "SSE" lub "skalarny")
+    const char* GetInstructionSet();
+}
+
+inline Mat4 operator*(const Mat4& a, const Mat4& b) { return MathSimd::Multiply(a, b); }
+inline Mat4 Inverse(const Mat4& a) { return MathSimd::Inverse(a); }
+
+#endif
@@ -0,0 +1,374 @@
+﻿#include "Mesh.h"
+#include "GLExtensions.h"
+
+#include <cmath>
+#include <cstddef>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+/**
+ * @brief Konstruktor klasy Mesh.
+ * @param primitive Typ prymitywu (GL_TRIANGLES lub GL_LINES).
+ */
+Mesh::Mesh(GLenum primitive)
+    : primitive(primitive), vbo(0), ibo(0), colorVbo(0), boundingRadius(0.0f) {
+}
+
+/**
+ * @brief Destruktor klasy Mesh.
+ */
+Mesh::~Mesh() {
+    ReleaseGPU();
+}
+
+/**
+ * @brief Usuwa dane CPU i bufory GPU.
+ */
+void Mesh::Clear() {
+    ReleaseGPU();
+    vertices.clear();
+    indices.clear();
+    colorVariants.clear();
+    boundingRadius = 0.0f;
+}
+
+/**
+ * @brief Dodaje wierzchołek.
+ */
+unsigned int Mesh::AddVertex(const MeshVertex& vertex) {
+    const float* p = vertex.position;
+    float distance = std::sqrt(p[0] * p[0] + p[1] * p[1] + p[2] * p[2]);
+    if (distance > boundingRadius) boundingRadius = distance;
+    vertices.push_back(vertex);
+    return static_cast<unsigned int>(vertices.size() - 1);
+}
+
+/**
+ * @brief Dodaje wierzchołek z pojedynczych składowych.
+ */
+unsigned int Mesh::AddVertex(float x, float y, float z,
+    float nx, float ny, float nz,
+    float u, float v,
+    float r, float g, float b, float a) {
+    MeshVertex vertex = { { x, y, z }, { nx, ny, nz }, { u, v }, { r, g, b, a } };
+    return AddVertex(vertex);
+}
+
+/**
+ * @brief Dodaje trójkąt z trzech indeksów.
+ */
+void Mesh::AddTriangle(unsigned int a, unsigned int b, unsigned int c) {
+    indices.push_back(a);
+    indices.push_back(b);
+    indices.push_back(c);
+}
+
+/**
+ * @brief Dodaje odcinek z dwóch indeksów.
+ */
+void Mesh::AddLine(unsigned int a, unsigned int b) {
+    indices.push_back(a);
+    indices.push_back(b);
+}
+
+/**
+ * @brief Dodaje wariant kolorów (po jednym kolorze na wierzchołek).
+ * @return Numer wariantu lub -1 przy złej liczbie kolorów.
+ */
+int Mesh::AddColorVariant(const std::vector<MeshColor>& colors) {
+    if (colors.size() != vertices.size() || colors.empty()) return -1;
+    colorVariants.insert(colorVariants.end(), colors.begin(), colors.end());
+    return GetColorVariantCount() - 1;
+}
+
+/**
+ * @brief Wysyła dane do VBO/IBO.
+ * @return True jeśli bufory GPU zostały utworzone.
+ */
+bool Mesh::Upload() {
+    ReleaseGPU();
+    if (!GetGLCapabilities().vertexBufferObjects || vertices.empty() || indices.empty()) {
+        return false;
+    }
+
+    glGenBuffers(1, &vbo);
+    glBindBuffer(GL_ARRAY_BUFFER, vbo);
+    glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(MeshVertex), vertices.data(), GL_STATIC_DRAW);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    glGenBuffers(1, &ibo);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ibo);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(unsigned int), indices.data(), GL_STATIC_DRAW);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+
+    if (!colorVariants.empty()) {
+        glGenBuffers(1, &colorVbo);
+        glBindBuffer(GL_ARRAY_BUFFER, colorVbo);
+        glBufferData(GL_ARRAY_BUFFER, colorVariants.size() * sizeof(MeshColor), colorVariants.data(), GL_STATIC_DRAW);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+    }
+    return true;
+}
+
+/**
+ * @brief Zwalnia bufory GPU (dane CPU pozostają).
+ */
+void Mesh::ReleaseGPU() {
+    if (vbo) glDeleteBuffers(1, &vbo);
+    if (ibo) glDeleteBuffers(1, &ibo);
+    if (colorVbo) glDeleteBuffers(1, &colorVbo);
+    vbo = 0;
+    ibo = 0;
+    colorVbo = 0;
+}
+
+/**
+ * @brief Ustawia wskaźniki tablic wierzchołków względem podanej bazy.
+ * @param base Adres danych CPU lub nullptr (offset w VBO).
+ */
+void Mesh::BindArrays(const char* base) const {
+    const GLsizei stride = sizeof(MeshVertex);
+
+    glEnableClientState(GL_VERTEX_ARRAY);
+    glVertexPointer(3, GL_FLOAT, stride, base + offsetof(MeshVertex, position));
+    glEnableClientState(GL_NORMAL_ARRAY);
+    glNormalPointer(GL_FLOAT, stride, base + offsetof(MeshVertex, normal));
+    glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+    glTexCoordPointer(2, GL_FLOAT, stride, base + offsetof(MeshVertex, uv));
+    glEnableClientState(GL_COLOR_ARRAY);
+    glColorPointer(4, GL_FLOAT, stride, base + offsetof(MeshVertex, color));
+}
+
+/**
+ * @brief Wyłącza tablice wierzchołków.
+ */
+void Mesh::UnbindArrays() const {
+    glDisableClientState(GL_COLOR_ARRAY);
+    glDisableClientState(GL_TEXTURE_COORD_ARRAY);
+    glDisableClientState(GL_NORMAL_ARRAY);
+    glDisableClientState(GL_VERTEX_ARRAY);
+}
+
+/**
+ * @brief Rysuje siatkę ścieżką retained.
+ *
+ * Gdy VBO nie jest dostępne, te same dane są podawane jako tablice
+ * po stronie klienta (OpenGL 1.1) – nadal jedno wywołanie na siatkę.
+ */
+void Mesh::Draw(int colorVariant) const {
+    DrawElements(colorVariant, 0);
+}
+
+/**
+ * @brief Rysuje instanceCount kopii siatki jednym wywołaniem.
+ */
+void Mesh::DrawInstanced(int instanceCount, int colorVariant) const {
+    if (instanceCount > 0) DrawElements(colorVariant, instanceCount);
+}
+
+/**
+ * @brief Zwraca kolory wariantu lub nullptr.
+ */
+const MeshColor* Mesh::GetColorVariant(int colorVariant) const {
+    if (colorVariant <= 0 || colorVariant >= GetColorVariantCount()) return nullptr;
+    return &colorVariants[(colorVariant - 1) * vertices.size()];
+}
+
+/**
+ * @brief Wspólna część Draw/DrawInstanced (0 instancji = zwykłe rysowanie).
+ */
+void Mesh::DrawElements(int colorVariant, int instanceCount) const {
+    if (vertices.empty() || indices.empty()) return;
+
+    GLsizei count = static_cast<GLsizei>(indices.size());
+    bool variant = colorVariant > 0 && colorVariant < GetColorVariantCount();
+    size_t variantStart = variant ? (colorVariant - 1) * vertices.size() : 0;
+
+    if (vbo) {
+        glBindBuffer(GL_ARRAY_BUFFER, vbo);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ibo);
+        BindArrays(nullptr);
+        if (variant) {
+            // Wskaźnik koloru zapamiętuje bufor związany w chwili wywołania
+            glBindBuffer(GL_ARRAY_BUFFER, colorVbo);
+            glColorPointer(4, GL_FLOAT, 0, static_cast<const char*>(nullptr) + variantStart * sizeof(MeshColor));
+        }
+        if (instanceCount > 0) glDrawElementsInstanced(primitive, count, GL_UNSIGNED_INT, nullptr, instanceCount);
+        else glDrawElements(primitive, count, GL_UNSIGNED_INT, nullptr);
+        UnbindArrays();
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+    }
+    else {
+        BindArrays(reinterpret_cast<const char*>(vertices.data()));
+        if (variant) {
+            glColorPointer(4, GL_FLOAT, 0, colorVariants[variantStart].rgba);
+        }
+        if (instanceCount > 0) glDrawElementsInstanced(primitive, count, GL_UNSIGNED_INT, indices.data(), instanceCount);
+        else glDrawElements(primitive, count, GL_UNSIGNED_INT, indices.data());
+        UnbindArrays();
+    }
+}
+
+/**
+ * @brief Rysuje siatkę w trybie natychmiastowym (glBegin/glEnd).
+ */
+void Mesh::DrawImmediate(int colorVariant) const {
+    bool variant = colorVariant > 0 && colorVariant < GetColorVariantCount();
+    const MeshColor* colors = variant ? &colorVariants[(colorVariant - 1) * vertices.size()] : nullptr;
+
+    glBegin(primitive);
+    for (unsigned int index : indices) {
+        const MeshVertex& v = vertices[index];
+        glNormal3fv(v.normal);
+        glTexCoord2fv(v.uv);
+        glColor4fv(colors ? colors[index].rgba : v.color);
+        glVertex3fv(v.position);
+    }
+    glEnd();
+}
+
+/**
+ * @brief Buduje sześcian jednostkowy z UV dla tekstury.
+ */
+void Mesh::BuildCube() {
+    Clear();
+    primitive = GL_TRIANGLES;
+
+    // Każda ściana: normalna + 4 wierzchołki (x, y, z, u, v) w kolejności CCW
+    struct Face { float n[3]; float v[4][5]; };
+    static const Face faces[6] = {
+        // Przód
+        { { 0.0f, 0.0f, 1.0f }, { { -0.5f, -0.5f, 0.5f, 0.0f, 0.0f }, { 0.5f, -0.5f, 0.5f, 1.0f, 0.0f },
+                                  { 0.5f, 0.5f, 0.5f, 1.0f, 1.0f }, { -0.5f, 0.5f, 0.5f, 0.0f, 1.0f } } },
+        // Tył
+        { { 0.0f, 0.0f, -1.0f }, { { -0.5f, -0.5f, -0.5f, 1.0f, 0.0f }, { -0.5f, 0.5f, -0.5f, 1.0f, 1.0f },
+                                   { 0.5f, 0.5f, -0.5f, 0.0f, 1.0f }, { 0.5f, -0.5f, -0.5f, 0.0f, 0.0f } } },
+        // Góra
+        { { 0.0f, 1.0f, 0.0f }, { { -0.5f, 0.5f, -0.5f, 0.0f, 1.0f }, { -0.5f, 0.5f, 0.5f, 0.0f, 0.0f },
+                                  { 0.5f, 0.5f, 0.5f, 1.0f, 0.0f }, { 0.5f, 0.5f, -0.5f, 1.0f, 1.0f } } },
+        // Dół
+        { { 0.0f, -1.0f, 0.0f }, { { -0.5f, -0.5f, -0.5f, 1.0f, 1.0f }, { 0.5f, -0.5f, -0.5f, 0.0f, 1.0f },
+                                   { 0.5f, -0.5f, 0.5f, 0.0f, 0.0f }, { -0.5f, -0.5f, 0.5f, 1.0f, 0.0f } } },
+        // Lewo
+        { { -1.0f, 0.0f, 0.0f }, { { -0.5f, -0.5f, -0.5f, 0.0f, 0.0f }, { -0.5f, -0.5f, 0.5f, 1.0f, 0.0f },
+                                   { -0.5f, 0.5f, 0.5f, 1.0f, 1.0f }, { -0.5f, 0.5f, -0.5f, 0.0f, 1.0f } } },
+        // Prawo
+        { { 1.0f, 0.0f, 0.0f }, { { 0.5f, -0.5f, -0.5f, 1.0f, 0.0f }, { 0.5f, 0.5f, -0.5f, 1.0f, 1.0f },
+                                  { 0.5f, 0.5f, 0.5f, 0.0f, 1.0f }, { 0.5f, -0.5f, 0.5f, 0.0f, 0.0f } } },
+    };
+
+    for (const Face& face : faces) {
+        unsigned int first = static_cast<unsigned int>(vertices.size());
+        for (const float* v : face.v) {
+            // Kolor biały, żeby tekstura nie była zabarwiona
+            AddVertex(v[0], v[1], v[2], face.n[0], face.n[1], face.n[2], v[3], v[4], 1.0f, 1.0f, 1.0f);
+        }
+        AddTriangle(first, first + 1, first + 2);
+        AddTriangle(first, first + 2, first + 3);
+    }
+}
+
+/**
+ * @brief Buduje piramidę o kolorowych ścianach.
+ */
+void Mesh::BuildPyramid() {
+    Clear();
+    primitive = GL_TRIANGLES;
+
+    // Normalna, kolor i trzy wierzchołki każdego trójkąta
+    struct Tri { float n[3]; float c[3]; float v[3][3]; };
+    static const Tri tris[6] = {
+        // Podstawa
+        { { 0.0f, -1.0f, 0.0f }, { 1.0f, 0.5f, 0.0f }, { { -0.5f, -0.5f, -0.5f }, { 0.5f, -0.5f, -0.5f }, { 0.5f, -0.5f, 0.5f } } },
+        { { 0.0f, -1.0f, 0.0f }, { 1.0f, 0.5f, 0.0f }, { { -0.5f, -0.5f, -0.5f }, { 0.5f, -0.5f, 0.5f }, { -0.5f, -0.5f, 0.5f } } },
+        // Ściany
+        { { 0.0f, 0.447f, 0.894f }, { 0.0f, 0.0f, 1.0f }, { { 0.0f, 0.5f, 0.0f }, { -0.5f, -0.5f, 0.5f }, { 0.5f, -0.5f, 0.5f } } },
+        { { 0.0f, 0.447f, -0.894f }, { 0.0f, 1.0f, 0.0f }, { { 0.0f, 0.5f, 0.0f }, { 0.5f, -0.5f, -0.5f }, { -0.5f, -0.5f, -0.5f } } },
+        { { -0.894f, 0.447f, 0.0f }, { 1.0f, 1.0f, 0.0f }, { { 0.0f, 0.5f, 0.0f }, { -0.5f, -0.5f, -0.5f }, { -0.5f, -0.5f, 0.5f } } },
+        { { 0.894f, 0.447f, 0.0f }, { 1.0f, 0.0f, 0.0f }, { { 0.0f, 0.5f, 0.0f }, { 0.5f, -0.5f, 0.5f }, { 0.5f, -0.5f, -0.5f } } },
+    };
+
+    for (const Tri& tri : tris) {
+        unsigned int first = static_cast<unsigned int>(vertices.size());
+        for (const float* v : tri.v) {
+            AddVertex(v[0], v[1], v[2], tri.n[0], tri.n[1], tri.n[2],
+                0.5f + v[0], 0.5f + v[2], tri.c[0], tri.c[1], tri.c[2]);
+        }
+        AddTriangle(first, first + 1, first + 2);
+    }
+}
+
+/**
+ * @brief Buduje kulę UV.
+ *
+ * Funkcje trygonometryczne liczone są raz na wiersz i raz na kolumnę
+ * (tablice sin/cos), a nie dla każdego wierzchołka.
+ * @param segments Liczba segmentów w obu kierunkach.
+ */
+void Mesh::BuildSphere(int segments) {
+    Clear();
+    primitive = GL_TRIANGLES;
+    if (segments < 3) segments = 3;
+
+    std::vector<float> sinLat(segments + 1), cosLat(segments + 1);
+    std::vector<float> sinLng(segments + 1), cosLng(segments + 1);
+    for (int i = 0; i <= segments; i++) {
+        float lat = (float)M_PI * (-0.5f + (float)i / segments);
+        float lng = 2.0f * (float)M_PI * (float)i / segments;
+        sinLat[i] = sin(lat);
+        cosLat[i] = cos(lat);
+        sinLng[i] = sin(lng);
+        cosLng[i] = cos(lng);
+    }
+
+    vertices.reserve((segments + 1) * (segments + 1));
+    for (int i = 0; i <= segments; i++) {
+        for (int j = 0; j <= segments; j++) {
+            float x = cosLat[i] * cosLng[j];
+            float y = sinLat[i];
+            float z = cosLat[i] * sinLng[j];
+
+            // Kolor z pozycji dla cieniowania Gourauda
+            AddVertex(x, y, z, x, y, z, (float)j / segments, (float)i / segments,
+                0.5f + 0.5f * y, 0.5f + 0.5f * x, 0.5f + 0.5f * z);
+        }
+    }
+
+    // Pasy szerokości geograficznej: odpowiednik GL_QUAD_STRIP podzielony na trójkąty
+    indices.reserve(segments * segments * 6);
+    unsigned int row = static_cast<unsigned int>(segments + 1);
+    for (unsigned int i = 0; i < (unsigned int)segments; i++) {
+        for (unsigned int j = 0; j < (unsigned int)segments; j++) {
+            unsigned int a = i * row + j;
+            unsigned int b = (i + 1) * row + j;
+            AddTriangle(a, b, b + 1);
+            AddTriangle(a, b + 1, a + 1);
+        }
+    }
+
+    // Wariant dla cieniowania płaskiego: jednolity kolor
+    MeshColor flat = { { 0.8f, 0.2f, 0.8f, 1.0f } };
+    AddColorVariant(std::vector<MeshColor>(vertices.size(), flat));
+}
+
+/**
+ * @brief Buduje siatkę linii w płaszczyźnie XY (od -halfSize do halfSize).
+ */
+void Mesh::BuildGrid(int halfSize, float r, float g, float b) {
+    Clear();
+    primitive = GL_LINES;
+
+    float extent = static_cast<float>(halfSize);
+    for (int i = -halfSize; i <= halfSize; i++) {
+        float t = static_cast<float>(i);
+        unsigned int a = AddVertex(t, -extent, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, r, g, b);
+        unsigned int c = AddVertex(t, extent, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, r, g, b);
+        AddLine(a, c);
+        a = AddVertex(-extent, t, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, r, g, b);
+        c = AddVertex(extent, t, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, r, g, b);
+        AddLine(a, c);
+    }
+}
@@ -0,0 +1,173 @@
+﻿#pragma once
+#ifndef MESH_H
+#define MESH_H
+
+#include <GLFW/glfw3.h>
+#include <vector>
+
+/**
+ * @brief Wierzchołek siatki w układzie przeplatanym (pozycja/normalna/UV/kolor).
+ */
+struct MeshVertex {
+    float position[3]; /**< Pozycja w przestrzeni obiektu */
+    float normal[3];   /**< Wektor normalny */
+    float uv[2];       /**< Współrzędne tekstury */
+    float color[4];    /**< Kolor RGBA */
+};
+
+/**
+ * @brief Kolor RGBA używany w dodatkowych wariantach kolorów siatki.
+ */
+struct MeshColor {
+    float rgba[4]; /**< Kolor RGBA */
+};
+
+/**
+ * @brief Siatka trójkątów/linii przechowywana w buforach GPU.
+ *
+ * Dane wierzchołków budowane są raz i wysyłane do VBO/IBO. Kopia CPU jest
+ * zachowywana, dzięki czemu ta sama siatka może być narysowana w trybie
+ * natychmiastowym (glBegin/glEnd) do porównań wydajności.
+ *
+ * Oprócz koloru w wierzchołku siatka może mieć dodatkowe warianty kolorów
+ * (osobny atrybut w buforze GPU); wybór wariantu przy rysowaniu nie wymaga
+ * przebudowy geometrii.
+ */
+class Mesh {
+public:
+    /**
+     * @brief Konstruktor klasy Mesh.
+     * @param primitive Typ prymitywu (GL_TRIANGLES lub GL_LINES).
+     */
+    explicit Mesh(GLenum primitive = GL_TRIANGLES);
+
+    /**
+     * @brief Destruktor klasy Mesh (zwalnia bufory GPU).
+     */
+    ~Mesh();
+
+    Mesh(const Mesh&) = delete;
+    Mesh& operator=(const Mesh&) = delete;
+
+    /**
+     * @brief Usuwa dane CPU i bufory GPU.
+     */
+    void Clear();
+
+    /**
+     * @brief Dodaje wierzchołek.
+     * @return Indeks dodanego wierzchołka.
+     */
+    unsigned int AddVertex(const MeshVertex& vertex);
+
+    /**
+     * @brief Dodaje wierzchołek z pojedynczych składowych.
+     * @return Indeks dodanego wierzchołka.
+     */
+    unsigned int AddVertex(float x, float y, float z,
+        float nx, float ny, float nz,
+        float u, float v,
+        float r, float g, float b, float a = 1.0f);
+
+    /**
+     * @brief Dodaje trójkąt z trzech indeksów.
+     */
+    void AddTriangle(unsigned int a, unsigned int b, unsigned int c);
+
+    /**
+     * @brief Dodaje odcinek z dwóch indeksów.
+     */
+    void AddLine(unsigned int a, unsigned int b);
+
+    /**
+     * @brief Dodaje wariant kolorów (po jednym kolorze na wierzchołek).
+     * @return Numer wariantu (0 to kolor zapisany w wierzchołkach) lub -1 przy złej liczbie kolorów.
+     */
+    int AddColorVariant(const std::vector<MeshColor>& colors);
+
+    /**
+     * @brief Wysyła dane do VBO/IBO (jeśli sterownik je obsługuje).
+     * @return True jeśli bufory GPU zostały utworzone.
+     */
+    bool Upload();
+
+    /**
+     * @brief Zwalnia bufory GPU (dane CPU pozostają).
+     */
+    void ReleaseGPU();
+
+    /**
+     * @brief Rysuje siatkę ścieżką retained (VBO lub tablice po stronie klienta).
+     * @param colorVariant Numer wariantu kolorów (0 = kolor wierzchołka).
+     */
+    void Draw(int colorVariant = 0) const;
+
+    /**
+     * @brief Rysuje instanceCount kopii siatki jednym wywołaniem.
+     *
+     * Atrybuty na instancję (glVertexAttribDivisor) ustawia wywołujący.
+     * Wymaga GLCapabilities::instancing.
+     */
+    void DrawInstanced(int instanceCount, int colorVariant = 0) const;
+
+    /**
+     * @brief Rysuje siatkę w trybie natychmiastowym (glBegin/glEnd).
+     * @param colorVariant Numer wariantu kolorów (0 = kolor wierzchołka).
+     */
+    void DrawImmediate(int colorVariant = 0) const;
+
+    /**
+     * @brief Buduje sześcian jednostkowy z UV dla tekstury.
+     */
+    void BuildCube();
+
+    /**
+     * @brief Buduje piramidę o kolorowych ścianach.
+     */
+    void BuildPyramid();
+
+    /**
+     * @brief Buduje kulę UV.
+     *
+     * Wariant 0 ma kolory wyliczone z pozycji (cieniowanie Gourauda),
+     * wariant SPHERE_FLAT_COLORS jednolity kolor (cieniowanie płaskie).
+     * @param segments Liczba segmentów w obu kierunkach.
+     */
+    void BuildSphere(int segments);
+
+    /**
+     * @brief Buduje siatkę linii w płaszczyźnie XY (od -halfSize do halfSize).
+     */
+    void BuildGrid(int halfSize, float r, float g, float b);
+
+    /// Numer wariantu kolorów kuli dla cieniowania płaskiego
+    static const int SPHERE_FLAT_COLORS = 1;
+
+    GLenum GetPrimitive() const { return primitive; }
+    bool IsUploaded() const { return vbo != 0; }
+    size_t GetVertexCount() const { return vertices.size(); }
+    size_t GetIndexCount() const { return indices.size(); }
+    int GetColorVariantCount() const { return 1 + static_cast<int>(colorVariants.size() / (vertices.empty() ? 1 : vertices.size())); }
+    const std::vector<MeshVertex>& GetVertices() const { return vertices; }
+    const std::vector<unsigned int>& GetIndices() const { return indices; }
+    /// Kolory wariantu (po jednym na wierzchołek) lub nullptr dla wariantu 0 / błędnego numeru
+    const MeshColor* GetColorVariant(int colorVariant) const;
+    /// Promień sfery otaczającej wierzchołki (środek w początku układu obiektu)
+    float GetBoundingRadius() const { return boundingRadius; }
+
+private:
+    void DrawElements(int colorVariant, int instanceCount) const;
+    void BindArrays(const char* base) const;
+    void UnbindArrays() const;
+
+    GLenum primitive;                  /**< Typ prymitywu */
+    std::vector<MeshVertex> vertices;  /**< Kopia wierzchołków po stronie CPU */
+    std::vector<unsigned int> indices; /**< Kopia indeksów po stronie CPU */
+    std::vector<MeshColor> colorVariants; /**< Dodatkowe warianty kolorów, jeden po drugim */
+    GLuint vbo;                        /**< Bufor wierzchołków */
+    GLuint ibo;                        /**< Bufor indeksów */
+    GLuint colorVbo;                   /**< Bufor dodatkowych wariantów kolorów */
+    float boundingRadius;              /**< Największa odległość wierzchołka od środka */
+};
+
+#endif
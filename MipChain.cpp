@@ -0,0 +1,139 @@
+﻿#include "MipChain.h"
+
+#include <algorithm>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__SSE2__)
+#include <emmintrin.h>
+#define MIP_SSE 1
+#endif
+
+/**
+ * @brief Liczba poziomów poniżej poziomu 0 dla podanych wymiarów.
+ */
+int MipChain::CountLevels(int width, int height) {
+    int count = 0;
+    while (width > 1 || height > 1) {
+        width = std::max(1, width / 2);
+        height = std::max(1, height / 2);
+        count++;
+    }
+    return count;
+}
+
+/**
+ * @brief Sumuje dwa wiersze bajt po bajcie do 16-bitowego bufora.
+ */
+static void SumRows(const unsigned char* row0, const unsigned char* row1, size_t count,
+    unsigned short* sums, bool useSimd) {
+    size_t i = 0;
+#ifdef MIP_SSE
+    if (useSimd) {
+        const __m128i zero = _mm_setzero_si128();
+        for (; i + 16 <= count; i += 16) {
+            __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row0 + i));
+            __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row1 + i));
+            __m128i low = _mm_add_epi16(_mm_unpacklo_epi8(a, zero), _mm_unpacklo_epi8(b, zero));
+            __m128i high = _mm_add_epi16(_mm_unpackhi_epi8(a, zero), _mm_unpackhi_epi8(b, zero));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(sums + i), low);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(sums + i + 8), high);
+        }
+    }
+#else
+    (void)useSimd;
+#endif
+    for (; i < count; i++) sums[i] = static_cast<unsigned short>(row0[i] + row1[i]);
+}
+
+/**
+ * @brief Zmniejsza obraz dwukrotnie filtrem pudełkowym.
+ */
+void MipChain::Downsample(const unsigned char* source, int width, int height, int channels,
+    unsigned char* target, bool useSimd) {
+    const int targetWidth = std::max(1, width / 2);
+    const int targetHeight = std::max(1, height / 2);
+    const size_t rowSize = static_cast<size_t>(width) * channels;
+    std::vector<unsigned short> sums(rowSize);
+
+    for (int y = 0; y < targetHeight; y++) {
+        const unsigned char* row0 = source + static_cast<size_t>(2 * y) * rowSize;
+        const unsigned char* row1 = source + static_cast<size_t>(std::min(2 * y + 1, height - 1)) * rowSize;
+        SumRows(row0, row1, rowSize, sums.data(), useSimd);
+
+        unsigned char* out = target + static_cast<size_t>(y) * targetWidth * channels;
+        int x = 0;
+#ifdef MIP_SSE
+        if (useSimd && channels == 4) {
+            // Dwa piksele wyniku z czterech sum: (p0, p1) i (p2, p3) -> (p0 + p1, p2 + p3)
+            const __m128i rounding = _mm_set1_epi16(2);
+            for (; 2 * x + 3 < width && x + 1 < targetWidth; x += 2) {
+                __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(sums.data() + 8 * x));
+                __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(sums.data() + 8 * x + 8));
+                __m128i total = _mm_add_epi16(_mm_unpacklo_epi64(a, b), _mm_unpackhi_epi64(a, b));
+                total = _mm_srli_epi16(_mm_add_epi16(total, rounding), 2);
+                _mm_storel_epi64(reinterpret_cast<__m128i*>(out + 4 * x), _mm_packus_epi16(total, total));
+            }
+        }
+#endif
+        for (; x < targetWidth; x++) {
+            const unsigned short* left = sums.data() + static_cast<size_t>(2 * x) * channels;
+            const unsigned short* right = sums.data() + static_cast<size_t>(std::min(2 * x + 1, width - 1)) * channels;
+            for (int c = 0; c < channels; c++) {
+                out[x * channels + c] = static_cast<unsigned char>((left[c] + right[c] + 2) >> 2);
+            }
+        }
+    }
+}
+
+/**
+ * @brief Liczy poziomy 1..N dla obrazu poziomu 0.
+ */
+bool MipChain::Build(const unsigned char* pixels, int width, int height, int pixelChannels, bool useSimd) {
+    Clear();
+    if (!pixels || width <= 0 || height <= 0 || pixelChannels < 1 || pixelChannels > 4) return false;
+    channels = pixelChannels;
+
+    // Jeden bufor na wszystkie poziomy – rozmiary znane z góry
+    size_t total = 0;
+    for (int w = width, h = height; w > 1 || h > 1;) {
+        w = std::max(1, w / 2);
+        h = std::max(1, h / 2);
+        MipLevel level;
+        level.width = w;
+        level.height = h;
+        level.offset = total;
+        levels.push_back(level);
+        total += static_cast<size_t>(w) * h * channels;
+    }
+    data.resize(total);
+
+    const unsigned char* source = pixels;
+    int sourceWidth = width, sourceHeight = height;
+    for (const MipLevel& level : levels) {
+        unsigned char* target = data.data() + level.offset;
+        Downsample(source, sourceWidth, sourceHeight, channels, target, useSimd);
+        source = target;
+        sourceWidth = level.width;
+        sourceHeight = level.height;
+    }
+    return true;
+}
+
+/**
+ * @brief Zwalnia poziomy.
+ */
+void MipChain::Clear() {
+    levels.clear();
+    data.clear();
+    channels = 0;
+}
+
+/**
+ * @brief Nazwa używanej ścieżki.
+ */
+const char* MipChain::GetSimdName() {
+#ifdef MIP_SSE
+    return "SSE2";
+#else
+    return "skalarny";
+#endif
+}
@@ -0,0 +1,84 @@
+﻿#pragma once
+#ifndef MIP_CHAIN_H
+#define MIP_CHAIN_H
+
+#include <cstddef>
+#include <vector>
+
+/**
+ * @brief Opis jednego poziomu łańcucha mipmap.
+ */
+struct MipLevel {
+    int width = 0;       /**< Szerokość w pikselach */
+    int height = 0;      /**< Wysokość w pikselach */
+    size_t offset = 0;   /**< Początek danych poziomu w buforze łańcucha */
+};
+
+/**
+ * @brief Łańcuch mipmap liczony na CPU filtrem pudełkowym 2x2.
+ *
+ * Każdy poziom ma wymiary poprzedniego podzielone przez dwa (w dół, co
+ * najmniej 1) – jak w OpenGL dla tekstur o dowolnych wymiarach. Przy
+ * nieparzystym wymiarze ostatni wiersz / kolumna źródła jest pomijany,
+ * a przy wymiarze 1 piksel jest uśredniany sam ze sobą.
+ *
+ * Sumy pionowe liczone są SSE2 dla dowolnej liczby kanałów, sumy poziome
+ * dla RGBA po dwa piksele wyniku naraz. Wynik SIMD jest identyczny ze
+ * skalarnym (zaokrąglenie (a + b + c + d + 2) / 4). Build nie używa GL,
+ * więc może działać w wątku roboczym.
+ */
+class MipChain {
+public:
+    /**
+     * @brief Liczba poziomów poniżej poziomu 0 dla podanych wymiarów.
+     */
+    static int CountLevels(int width, int height);
+
+    /**
+     * @brief Zmniejsza obraz dwukrotnie filtrem pudełkowym.
+     * @param source Piksele źródła (wiersze bez wyrównania).
+     * @param width Szerokość źródła.
+     * @param height Wysokość źródła.
+     * @param channels Liczba kanałów (1-4).
+     * @param target Bufor wyniku (max(1, width / 2) x max(1, height / 2) pikseli).
+     * @param useSimd Czy użyć wersji SSE2 (jeśli dostępna).
+     */
+    static void Downsample(const unsigned char* source, int width, int height, int channels,
+        unsigned char* target, bool useSimd = true);
+
+    /**
+     * @brief Liczy poziomy 1..N dla obrazu poziomu 0 (obraz nie jest kopiowany).
+     * @return False dla niepoprawnych wymiarów lub liczby kanałów.
+     */
+    bool Build(const unsigned char* pixels, int width, int height, int channels, bool useSimd = true);
+
+    /**
+     * @brief Zwalnia poziomy.
+     */
+    void Clear();
+
+    int GetLevelCount() const { return static_cast<int>(levels.size()); }
+    /**
+     * @brief Wymiary poziomu level (1..GetLevelCount()).
+     */
+    const MipLevel& GetLevel(int level) const { return levels[level - 1]; }
+    /**
+     * @brief Piksele poziomu level (1..GetLevelCount()).
+     */
+    const unsigned char* GetLevelData(int level) const { return data.data() + levels[level - 1].offset; }
+    /**
+     * @brief Rozmiar wszystkich poziomów w bajtach (bez poziomu 0).
+     */
+    size_t GetByteSize() const { return data.size(); }
+    int GetChannels() const { return channels; }
+
+    /// Nazwa używanej ścieżki ("SSE2" lub "skalarny")
+    static const char* GetSimdName();
+
+private:
+    std::vector<MipLevel> levels;      /**< Poziomy 1..N */
+    std::vector<unsigned char> data;   /**< Piksele wszystkich poziomów */
+    int channels = 0;                  /**< Kanały pikseli */
+};
+
+#endif
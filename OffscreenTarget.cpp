@@ -0,0 +1,95 @@
+﻿#include "OffscreenTarget.h"
+#include "GLExtensions.h"
+
+#include <iostream>
+
+/**
+ * @brief Konstruktor klasy OffscreenTarget.
+ */
+OffscreenTarget::OffscreenTarget()
+    : fbo(0), colorBuffer(0), depthBuffer(0), width(0), height(0) {
+}
+
+/**
+ * @brief Destruktor klasy OffscreenTarget.
+ */
+OffscreenTarget::~OffscreenTarget() {
+    Destroy();
+}
+
+/**
+ * @brief Tworzy bufor ramki o podanym rozmiarze.
+ * @return True jeśli utworzono FBO; false oznacza użycie domyślnego bufora.
+ */
+bool OffscreenTarget::Create(int w, int h) {
+    Destroy();
+    width = w;
+    height = h;
+
+    if (!GetGLCapabilities().framebufferObjects) {
+        std::cerr << "[OffscreenTarget] FBO not supported, reading the default framebuffer" << std::endl;
+        return false;
+    }
+
+    glGenRenderbuffers(1, &colorBuffer);
+    glBindRenderbuffer(GL_RENDERBUFFER, colorBuffer);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height);
+
+    glGenRenderbuffers(1, &depthBuffer);
+    glBindRenderbuffer(GL_RENDERBUFFER, depthBuffer);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, width, height);
+    glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+    glGenFramebuffers(1, &fbo);
+    glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, colorBuffer);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, depthBuffer);
+    GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+    if (status != GL_FRAMEBUFFER_COMPLETE) {
+        std::cerr << "[OffscreenTarget Error] Incomplete framebuffer (0x" << std::hex << status << std::dec
+            << "), reading the default framebuffer" << std::endl;
+        Destroy();
+        width = w;
+        height = h;
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Zwalnia obiekty GL bufora ramki.
+ */
+void OffscreenTarget::Destroy() {
+    if (fbo) glDeleteFramebuffers(1, &fbo);
+    if (colorBuffer) glDeleteRenderbuffers(1, &colorBuffer);
+    if (depthBuffer) glDeleteRenderbuffers(1, &depthBuffer);
+    fbo = colorBuffer = depthBuffer = 0;
+    width = height = 0;
+}
+
+/**
+ * @brief Ustawia ten cel jako bieżący bufor ramki i viewport.
+ */
+void OffscreenTarget::Bind() const {
+    if (fbo) glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+    glViewport(0, 0, width, height);
+}
+
+/**
+ * @brief Przywraca domyślny bufor ramki.
+ */
+void OffscreenTarget::Unbind() const {
+    if (fbo) glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+/**
+ * @brief Odczytuje zawartość bufora koloru jako RGB (wiersze od dołu).
+ */
+void OffscreenTarget::ReadPixels(std::vector<unsigned char>& rgb) const {
+    rgb.resize((size_t)width * height * 3);
+    if (!fbo) glReadBuffer(GL_BACK);
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    glReadPixels(0, 0, width, height, GL_RGB, GL_UNSIGNED_BYTE, rgb.data());
+}
@@ -0,0 +1,68 @@
+﻿#pragma once
+#ifndef OFFSCREEN_TARGET_H
+#define OFFSCREEN_TARGET_H
+
+#include <GLFW/glfw3.h>
+#include <vector>
+
+/**
+ * @brief Cel renderowania poza ekranem (FBO z buforem koloru i głębokości).
+ *
+ * Jeśli sterownik nie obsługuje FBO, obiekt zapamiętuje tylko rozmiar,
+ * a odczyt pikseli odbywa się z domyślnego bufora ramki.
+ */
+class OffscreenTarget {
+public:
+    /**
+     * @brief Konstruktor klasy OffscreenTarget.
+     */
+    OffscreenTarget();
+
+    /**
+     * @brief Destruktor klasy OffscreenTarget.
+     */
+    ~OffscreenTarget();
+
+    OffscreenTarget(const OffscreenTarget&) = delete;
+    OffscreenTarget& operator=(const OffscreenTarget&) = delete;
+
+    /**
+     * @brief Tworzy bufor ramki o podanym rozmiarze.
+     * @return True jeśli utworzono FBO; false oznacza użycie domyślnego bufora.
+     */
+    bool Create(int width, int height);
+
+    /**
+     * @brief Zwalnia obiekty GL bufora ramki.
+     */
+    void Destroy();
+
+    /**
+     * @brief Ustawia ten cel jako bieżący bufor ramki i viewport.
+     */
+    void Bind() const;
+
+    /**
+     * @brief Przywraca domyślny bufor ramki.
+     */
+    void Unbind() const;
+
+    /**
+     * @brief Odczytuje zawartość bufora koloru jako RGB (wiersze od dołu).
+     * @param rgb Wektor wynikowy (width * height * 3 bajtów).
+     */
+    void ReadPixels(std::vector<unsigned char>& rgb) const;
+
+    bool UsesFramebufferObject() const { return fbo != 0; }
+    int GetWidth() const { return width; }
+    int GetHeight() const { return height; }
+
+private:
+    GLuint fbo;          /**< Obiekt bufora ramki */
+    GLuint colorBuffer;  /**< Bufor koloru (renderbuffer RGBA8) */
+    GLuint depthBuffer;  /**< Bufor głębokości (renderbuffer 24 bit) */
+    int width;           /**< Szerokość w pikselach */
+    int height;          /**< Wysokość w pikselach */
+};
+
+#endif
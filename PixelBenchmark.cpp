@@ -0,0 +1,184 @@
+﻿#include "PixelBenchmark.h"
+#include "BenchmarkUtils.h"
+#include "PixelConvert.h"
+#include "BitmapHandler.h"
+#include "ImageMemory.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+/**
+ * @brief Sprawdza i mierzy konwersje PixelConvert.
+ */
+int RunPixelBenchmark(int megapixels) {
+    if (megapixels <= 0) megapixels = 4;
+    srand(12345);
+
+    // Szerokość nieparzysta: sprawdza końcówki pętli wektorowych
+    const int width = 2047;
+    const int height = std::max(2, megapixels * 1024 * 1024 / width);
+    const size_t pixels = static_cast<size_t>(width) * height;
+
+    std::cout << "\n=== TEST KONWERSJI PIKSELI (" << PixelConvert::GetSimdName() << "): " << width << "x" << height
+        << " ===\n";
+
+    std::vector<unsigned char> rgb(pixels * 3), rgba(pixels * 4);
+    for (unsigned char& value : rgb) value = static_cast<unsigned char>(rand());
+    for (unsigned char& value : rgba) value = static_cast<unsigned char>(rand());
+    std::vector<float> linear(pixels * 4);
+    for (float& value : linear) value = (float)rand() / RAND_MAX * 1.2f - 0.1f; // także poza [0, 1]
+
+    std::vector<unsigned char> scalarOut(pixels * 4), simdOut(pixels * 4);
+    std::vector<float> linearOut(pixels * 4);
+
+    // --- Poprawność ---
+    bool ok = true;
+    PixelConvert::ExpandRGBToRGBA(rgb.data(), scalarOut.data(), pixels, false);
+    PixelConvert::ExpandRGBToRGBA(rgb.data(), simdOut.data(), pixels, true);
+    ok &= BenchmarkCheck("RGB -> RGBA: SIMD = skalarny", scalarOut == simdOut);
+
+    PixelConvert::SwapRedBlue(rgba.data(), scalarOut.data(), pixels, false);
+    PixelConvert::SwapRedBlue(rgba.data(), simdOut.data(), pixels, true);
+    bool swapOk = scalarOut == simdOut;
+    PixelConvert::SwapRedBlue(simdOut.data(), simdOut.data(), pixels, true);
+    swapOk &= std::equal(rgba.begin(), rgba.end(), simdOut.begin());
+    ok &= BenchmarkCheck("RGBA <-> BGRA: SIMD = skalarny, dwukrotnie = id", swapOk);
+
+    scalarOut = rgba;
+    simdOut = rgba;
+    PixelConvert::FlipVertical(scalarOut.data(), width, height, 4, false);
+    PixelConvert::FlipVertical(simdOut.data(), width, height, 4, true);
+    bool flipOk = scalarOut == simdOut && std::equal(rgba.begin(), rgba.begin() + width * 4,
+        simdOut.begin() + (height - 1) * static_cast<size_t>(width) * 4);
+    ok &= BenchmarkCheck("Odwrócenie w pionie: SIMD = skalarny", flipOk);
+
+    scalarOut = rgba;
+    simdOut = rgba;
+    PixelConvert::PremultiplyAlpha(scalarOut.data(), pixels, false);
+    PixelConvert::PremultiplyAlpha(simdOut.data(), pixels, true);
+    bool premultiplyOk = scalarOut == simdOut;
+    for (size_t i = 0; i < pixels * 4 && premultiplyOk; i++) {
+        int expected = i % 4 == 3 ? rgba[i] : static_cast<int>(std::floor(rgba[i] * rgba[i | 3] / 255.0 + 0.5));
+        premultiplyOk = simdOut[i] == expected;
+    }
+    ok &= BenchmarkCheck("Przemnożona alfa: SIMD = skalarny = round(c*a/255)", premultiplyOk);
+
+    PixelConvert::LinearToSrgb(linear.data(), scalarOut.data(), pixels, 4, false);
+    PixelConvert::LinearToSrgb(linear.data(), simdOut.data(), pixels, 4, true);
+    int srgbError = 0, simdDifference = 0;
+    for (size_t i = 0; i < pixels * 4; i++) {
+        float value = std::min(std::max(linear[i], 0.0f), 1.0f);
+        float exact = (i % 4 == 3 ? value : PixelConvert::LinearToSrgbExact(value)) * 255.0f;
+        srgbError = std::max(srgbError, static_cast<int>(std::fabs(simdOut[i] - exact) + 0.5f));
+        simdDifference = std::max(simdDifference, std::abs(simdOut[i] - scalarOut[i]));
+    }
+    ok &= BenchmarkCheck("Liniowe -> sRGB: SIMD = skalarny (błąd <= 1)", simdDifference == 0 && srgbError <= 1);
+
+    PixelConvert::SrgbToLinear(rgba.data(), linearOut.data(), pixels, 4);
+    PixelConvert::LinearToSrgb(linearOut.data(), simdOut.data(), pixels, 4, true);
+    ok &= BenchmarkCheck("sRGB -> liniowe -> sRGB = id", std::equal(rgba.begin(), rgba.end(), simdOut.begin()));
+
+    // --- Wydajność ---
+    struct Row { const char* name; double scalar; double simd; };
+    Row rows[] = {
+        { "RGB -> RGBA",
+            BestMs(5, [&]() { PixelConvert::ExpandRGBToRGBA(rgb.data(), scalarOut.data(), pixels, false); }),
+            BestMs(5, [&]() { PixelConvert::ExpandRGBToRGBA(rgb.data(), simdOut.data(), pixels, true); }) },
+        { "RGBA <-> BGRA",
+            BestMs(5, [&]() { PixelConvert::SwapRedBlue(rgba.data(), scalarOut.data(), pixels, false); }),
+            BestMs(5, [&]() { PixelConvert::SwapRedBlue(rgba.data(), simdOut.data(), pixels, true); }) },
+        { "Odwrócenie w pionie",
+            BestMs(5, [&]() { PixelConvert::FlipVertical(scalarOut.data(), width, height, 4, false); }),
+            BestMs(5, [&]() { PixelConvert::FlipVertical(simdOut.data(), width, height, 4, true); }) },
+        { "Przemnożona alfa",
+            BestMs(5, [&]() { scalarOut = rgba; PixelConvert::PremultiplyAlpha(scalarOut.data(), pixels, false); }),
+            BestMs(5, [&]() { simdOut = rgba; PixelConvert::PremultiplyAlpha(simdOut.data(), pixels, true); }) },
+        { "Liniowe -> sRGB",
+            BestMs(5, [&]() { PixelConvert::LinearToSrgb(linear.data(), scalarOut.data(), pixels, 4, false); }),
+            BestMs(5, [&]() { PixelConvert::LinearToSrgb(linear.data(), simdOut.data(), pixels, 4, true); }) },
+    };
+
+    const double megapixelCount = pixels / 1e6;
+    std::cout << "\n  Operacja              skalarny [MP/s]   " << PixelConvert::GetSimdName()
+        << " [MP/s]   przyspieszenie\n";
+    std::cout << std::fixed << std::setprecision(1);
+    for (const Row& row : rows) {
+        std::cout << "  ";
+        PrintPadded(row.name, 22);
+        std::cout << std::setw(17) << megapixelCount / (row.scalar / 1000.0)
+            << std::setw(14) << megapixelCount / (row.simd / 1000.0)
+            << std::setw(15) << std::setprecision(2) << row.scalar / row.simd << "x\n" << std::setprecision(1);
+    }
+    std::cout << std::defaultfloat;
+    return BenchmarkSummary(ok);
+}
+
+/**
+ * @brief Wczytuje obraz loads razy bieżącym przydziałem.
+ * @param output Kopia pikseli ostatniego wczytania.
+ * @return Milisekundy na wczytanie (0 przy błędzie).
+ */
+static double TimeLoads(const std::string& path, int loads, std::vector<unsigned char>& output) {
+    BitmapHandler bitmap;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < loads; i++) {
+        if (!bitmap.Load(path, true, PIXEL_FORMAT_RGBA)) return 0.0;
+    }
+    auto end = std::chrono::steady_clock::now();
+    output.assign(bitmap.GetData(), bitmap.GetData() + bitmap.GetTotalSize());
+    return std::chrono::duration<double, std::milli>(end - start).count() / loads;
+}
+
+/**
+ * @brief Porównuje stertę z areną dekodowania i pulą buforów.
+ */
+int RunDecodeBenchmark(const std::string& path, int loads) {
+    if (loads <= 0) loads = 50;
+    std::cout << "\n=== TEST PAMIĘCI DEKODOWANIA: " << path << ", " << loads << " wczytań ===\n";
+
+    // Sterta: stb_image i bufor wyniku bez ponownego użycia pamięci
+    HeapImageAllocator heap;
+    SetImageAllocator(&heap);
+    SetImageScratchEnabled(false);
+    ResetImageMemoryStats();
+    std::vector<unsigned char> heapPixels;
+    const double heapMs = TimeLoads(path, loads, heapPixels);
+    const unsigned int heapScratch = GetImageMemoryStats().scratchHeapAllocations;
+    const unsigned int heapOutput = heap.GetStats().heapAllocations;
+
+    // Arena + pula: pierwsze wczytanie rozgrzewa, kolejne nie przydzielają
+    PooledImageAllocator pool;
+    SetImageAllocator(&pool);
+    SetImageScratchEnabled(true);
+    ResetImageMemoryStats();
+    std::vector<unsigned char> poolPixels;
+    const double poolMs = TimeLoads(path, loads, poolPixels);
+    const ImageMemoryStats stats = GetImageMemoryStats();
+    const unsigned int poolOutput = pool.GetStats().heapAllocations;
+    PrintImageMemoryReport();
+    SetImageAllocator(nullptr);
+
+    if (heapMs == 0.0 || poolMs == 0.0) {
+        std::cerr << "[PixelBenchmark Error] Failed to load: " << path << std::endl;
+        return 1;
+    }
+
+    bool ok = true;
+    ok &= BenchmarkCheck("Arena i pula: piksele identyczne ze stertą", heapPixels == poolPixels);
+    ok &= BenchmarkCheck("Arena i pula: przydziały nie rosną z wczytaniami",
+        stats.scratchHeapAllocations + poolOutput < (unsigned int)loads || loads < 4);
+
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "\n  Wariant         [ms/wczytanie]   przydziały sterty (stb + wynik)\n";
+    std::cout << "  sterta          " << std::setw(14) << heapMs << "   " << heapScratch << " + " << heapOutput << "\n";
+    std::cout << "  arena + pula    " << std::setw(14) << poolMs << "   " << stats.scratchHeapAllocations << " + "
+        << poolOutput << "\n";
+    std::cout << std::defaultfloat;
+    return BenchmarkSummary(ok);
+}
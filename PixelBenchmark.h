@@ -0,0 +1,28 @@
+﻿#pragma once
+#ifndef PIXEL_BENCHMARK_H
+#define PIXEL_BENCHMARK_H
+
+#include <string>
+
+/**
+ * @brief Sprawdza zgodność wersji SIMD konwersji PixelConvert ze skalarnymi
+ *        i mierzy ich przepustowość.
+ *
+ * Nie wymaga kontekstu OpenGL.
+ * @param megapixels Rozmiar obrazu testowego w megapikselach.
+ * @return 0 jeśli wszystkie sprawdzenia przeszły, 1 w przeciwnym razie.
+ */
+int RunPixelBenchmark(int megapixels);
+
+/**
+ * @brief Porównuje wczytywanie obrazu przez stertę z areną dekodowania
+ *        i pulą buforów (ImageMemory): czas i przydziały na wczytanie.
+ *
+ * Nie wymaga kontekstu OpenGL.
+ * @param path Plik obrazu.
+ * @param loads Liczba wczytań w każdym wariancie.
+ * @return 0 jeśli wyniki są identyczne, 1 w przeciwnym razie.
+ */
+int RunDecodeBenchmark(const std::string& path, int loads);
+
+#endif
@@ -0,0 +1,339 @@
+﻿#include "PixelConvert.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__SSE2__)
+#include <emmintrin.h>
+#define PIXEL_SSE2 1
+#endif
+#if defined(__SSSE3__) || defined(__AVX__)
+#include <tmmintrin.h>
+#define PIXEL_SSSE3 1
+#endif
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define PIXEL_AVX2 1
+#endif
+
+/**
+ * @brief Dzieli iloczyn kanału i alfy przez 255 z zaokrągleniem (dokładnie dla 0..255^2).
+ */
+static inline unsigned char MultiplyAlpha(unsigned int color, unsigned int alpha) {
+    unsigned int t = color * alpha + 128;
+    return static_cast<unsigned char>((t + (t >> 8)) >> 8);
+}
+
+/**
+ * @brief Rozszerza RGB do RGBA z alfą 255.
+ */
+void PixelConvert::ExpandRGBToRGBA(const unsigned char* source, unsigned char* target, size_t pixels,
+    bool useSimd) {
+    size_t i = 0;
+    if (useSimd) {
+#if defined(PIXEL_AVX2)
+        // Każda połowa rejestru bierze 4 piksele z osobnego odczytu 16 bajtów
+        const __m256i wideMask = _mm256_setr_epi8(0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1,
+            0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1);
+        const __m256i wideAlpha = _mm256_set1_epi32(static_cast<int>(0xFF000000u));
+        for (; i + 10 <= pixels; i += 8) {
+            const unsigned char* in = source + i * 3;
+            __m256i rgb = _mm256_inserti128_si256(
+                _mm256_castsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in))),
+                _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + 12)), 1);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(target + i * 4),
+                _mm256_or_si256(_mm256_shuffle_epi8(rgb, wideMask), wideAlpha));
+        }
+#endif
+#if defined(PIXEL_SSSE3)
+        // 16 pikseli = 48 bajtów źródła w trzech odczytach
+        const __m128i mask = _mm_setr_epi8(0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1);
+        const __m128i alpha = _mm_set1_epi32(static_cast<int>(0xFF000000u));
+        for (; i + 16 <= pixels; i += 16) {
+            const unsigned char* in = source + i * 3;
+            __m128i* out = reinterpret_cast<__m128i*>(target + i * 4);
+            __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in));
+            __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + 16));
+            __m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + 32));
+            _mm_storeu_si128(out, _mm_or_si128(_mm_shuffle_epi8(a, mask), alpha));
+            _mm_storeu_si128(out + 1, _mm_or_si128(_mm_shuffle_epi8(_mm_alignr_epi8(b, a, 12), mask), alpha));
+            _mm_storeu_si128(out + 2, _mm_or_si128(_mm_shuffle_epi8(_mm_alignr_epi8(c, b, 8), mask), alpha));
+            _mm_storeu_si128(out + 3, _mm_or_si128(_mm_shuffle_epi8(_mm_srli_si128(c, 4), mask), alpha));
+        }
+#elif defined(PIXEL_SSE2)
+        // Bez tasowania bajtów: 4 odczyty 32-bitowe (czwarty bajt nadpisuje alfa)
+        const __m128i alpha = _mm_set1_epi32(static_cast<int>(0xFF000000u));
+        for (; i + 5 <= pixels; i += 4) {
+            const unsigned char* in = source + i * 3;
+            int p[4];
+            memcpy(p, in, 4);
+            memcpy(p + 1, in + 3, 4);
+            memcpy(p + 2, in + 6, 4);
+            memcpy(p + 3, in + 9, 4);
+            __m128i rgbx = _mm_setr_epi32(p[0], p[1], p[2], p[3]);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(target + i * 4), _mm_or_si128(rgbx, alpha));
+        }
+#endif
+    }
+    for (; i < pixels; i++) {
+        target[i * 4 + 0] = source[i * 3 + 0];
+        target[i * 4 + 1] = source[i * 3 + 1];
+        target[i * 4 + 2] = source[i * 3 + 2];
+        target[i * 4 + 3] = 255;
+    }
+}
+
+/**
+ * @brief Zamienia kanały R i B (RGBA <-> BGRA).
+ */
+void PixelConvert::SwapRedBlue(const unsigned char* source, unsigned char* target, size_t pixels, bool useSimd) {
+    size_t i = 0;
+    if (useSimd) {
+#if defined(PIXEL_AVX2)
+        const __m256i wideMask = _mm256_setr_epi8(2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15,
+            2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15);
+        for (; i + 8 <= pixels; i += 8) {
+            __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(source + i * 4));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(target + i * 4), _mm256_shuffle_epi8(x, wideMask));
+        }
+#endif
+#if defined(PIXEL_SSSE3)
+        const __m128i mask = _mm_setr_epi8(2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15);
+        for (; i + 4 <= pixels; i += 4) {
+            __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + i * 4));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(target + i * 4), _mm_shuffle_epi8(x, mask));
+        }
+#elif defined(PIXEL_SSE2)
+        // Piksel jako liczba 32-bitowa: G i A zostają, R i B przesunięte o 16 bitów
+        const __m128i keep = _mm_set1_epi32(static_cast<int>(0xFF00FF00u));
+        const __m128i low = _mm_set1_epi32(0x000000FF);
+        const __m128i high = _mm_set1_epi32(0x00FF0000);
+        for (; i + 4 <= pixels; i += 4) {
+            __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + i * 4));
+            __m128i swapped = _mm_or_si128(_mm_and_si128(x, keep),
+                _mm_or_si128(_mm_and_si128(_mm_srli_epi32(x, 16), low), _mm_and_si128(_mm_slli_epi32(x, 16), high)));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(target + i * 4), swapped);
+        }
+#endif
+    }
+    for (; i < pixels; i++) {
+        unsigned char r = source[i * 4 + 0];
+        unsigned char b = source[i * 4 + 2];
+        target[i * 4 + 0] = b;
+        target[i * 4 + 1] = source[i * 4 + 1];
+        target[i * 4 + 2] = r;
+        target[i * 4 + 3] = source[i * 4 + 3];
+    }
+}
+
+/**
+ * @brief Zamienia zawartość dwóch wierszy.
+ */
+static void SwapRows(unsigned char* a, unsigned char* b, size_t bytes, bool useSimd) {
+    size_t i = 0;
+    if (useSimd) {
+#if defined(PIXEL_AVX2)
+        for (; i + 32 <= bytes; i += 32) {
+            __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i));
+            __m256i y = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(a + i), y);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(b + i), x);
+        }
+#endif
+#if defined(PIXEL_SSE2)
+        for (; i + 16 <= bytes; i += 16) {
+            __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i));
+            __m128i y = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(a + i), y);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(b + i), x);
+        }
+#endif
+    }
+    for (; i < bytes; i++) std::swap(a[i], b[i]);
+}
+
+/**
+ * @brief Odwraca obraz w pionie.
+ */
+void PixelConvert::FlipVertical(unsigned char* pixels, int width, int height, int channels, bool useSimd) {
+    const size_t rowSize = static_cast<size_t>(width) * channels;
+    for (int y = 0; y < height / 2; y++) {
+        SwapRows(pixels + y * rowSize, pixels + (height - 1 - y) * rowSize, rowSize, useSimd);
+    }
+}
+
+/**
+ * @brief Mnoży kanały RGB przez alfę.
+ */
+void PixelConvert::PremultiplyAlpha(unsigned char* rgba, size_t pixels, bool useSimd) {
+    size_t i = 0;
+    if (useSimd) {
+        // Dwa piksele na 128 bitów po rozszerzeniu do 16 bitów; t + (t >> 8) mieści się w 16 bitach
+#if defined(PIXEL_AVX2)
+        const __m256i wideZero = _mm256_setzero_si256();
+        const __m256i wideHalf = _mm256_set1_epi16(128);
+        const __m256i wideAlphaMask = _mm256_setr_epi16(0, 0, 0, -1, 0, 0, 0, -1, 0, 0, 0, -1, 0, 0, 0, -1);
+        for (; i + 8 <= pixels; i += 8) {
+            __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(rgba + i * 4));
+            __m256i halves[2] = { _mm256_unpacklo_epi8(x, wideZero), _mm256_unpackhi_epi8(x, wideZero) };
+            for (__m256i& c : halves) {
+                __m256i a = _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(c, 0xFF), 0xFF);
+                __m256i t = _mm256_add_epi16(_mm256_mullo_epi16(c, a), wideHalf);
+                t = _mm256_srli_epi16(_mm256_add_epi16(t, _mm256_srli_epi16(t, 8)), 8);
+                c = _mm256_or_si256(_mm256_andnot_si256(wideAlphaMask, t), _mm256_and_si256(wideAlphaMask, c));
+            }
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(rgba + i * 4), _mm256_packus_epi16(halves[0], halves[1]));
+        }
+#endif
+#if defined(PIXEL_SSE2)
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i half = _mm_set1_epi16(128);
+        const __m128i alphaMask = _mm_setr_epi16(0, 0, 0, -1, 0, 0, 0, -1);
+        for (; i + 4 <= pixels; i += 4) {
+            __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(rgba + i * 4));
+            __m128i halves[2] = { _mm_unpacklo_epi8(x, zero), _mm_unpackhi_epi8(x, zero) };
+            for (__m128i& c : halves) {
+                __m128i a = _mm_shufflehi_epi16(_mm_shufflelo_epi16(c, 0xFF), 0xFF);
+                __m128i t = _mm_add_epi16(_mm_mullo_epi16(c, a), half);
+                t = _mm_srli_epi16(_mm_add_epi16(t, _mm_srli_epi16(t, 8)), 8);
+                c = _mm_or_si128(_mm_andnot_si128(alphaMask, t), _mm_and_si128(alphaMask, c));
+            }
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(rgba + i * 4), _mm_packus_epi16(halves[0], halves[1]));
+        }
+#endif
+    }
+    for (; i < pixels; i++) {
+        unsigned char* p = rgba + i * 4;
+        p[0] = MultiplyAlpha(p[0], p[3]);
+        p[1] = MultiplyAlpha(p[1], p[3]);
+        p[2] = MultiplyAlpha(p[2], p[3]);
+    }
+}
+
+/**
+ * @brief Dokładne przekształcenie sRGB -> liniowe.
+ */
+float PixelConvert::SrgbToLinearExact(float value) {
+    return value <= 0.04045f ? value / 12.92f : std::pow((value + 0.055f) / 1.055f, 2.4f);
+}
+
+/**
+ * @brief Dokładne przekształcenie liniowe -> sRGB.
+ */
+float PixelConvert::LinearToSrgbExact(float value) {
+    return value <= 0.0031308f ? value * 12.92f : 1.055f * std::pow(value, 1.0f / 2.4f) - 0.055f;
+}
+
+static const int LINEAR_TABLE_SIZE = 4096;
+
+/**
+ * @brief Tablica sRGB -> liniowe (256 wartości, liczona przy pierwszym użyciu).
+ */
+static const float* SrgbToLinearTable() {
+    static const struct Table {
+        float values[256];
+        Table() {
+            for (int i = 0; i < 256; i++) values[i] = PixelConvert::SrgbToLinearExact(i / 255.0f);
+        }
+    } table;
+    return table.values;
+}
+
+/**
+ * @brief Tablica liniowe -> sRGB (LINEAR_TABLE_SIZE równych przedziałów [0, 1]).
+ */
+static const unsigned char* LinearToSrgbTable() {
+    static const struct Table {
+        unsigned char values[LINEAR_TABLE_SIZE];
+        Table() {
+            for (int i = 0; i < LINEAR_TABLE_SIZE; i++) {
+                float srgb = PixelConvert::LinearToSrgbExact(i / float(LINEAR_TABLE_SIZE - 1));
+                values[i] = static_cast<unsigned char>(std::min(255.0f, srgb * 255.0f + 0.5f));
+            }
+        }
+    } table;
+    return table.values;
+}
+
+/**
+ * @brief Zamienia kolory sRGB na liniowe [0, 1].
+ */
+void PixelConvert::SrgbToLinear(const unsigned char* source, float* target, size_t pixels, int channels) {
+    const float* table = SrgbToLinearTable();
+    const size_t count = pixels * channels;
+    for (size_t i = 0; i < count; i++) {
+        target[i] = (channels == 4 && i % 4 == 3) ? source[i] / 255.0f : table[source[i]];
+    }
+}
+
+/**
+ * @brief Indeks tablicy liniowe -> sRGB (NaN i wartości ujemne dają 0).
+ */
+static inline int LinearIndex(float value) {
+    value = value > 0.0f ? (value < 1.0f ? value : 1.0f) : 0.0f;
+    return static_cast<int>(value * float(LINEAR_TABLE_SIZE - 1) + 0.5f);
+}
+
+/**
+ * @brief Zamienia kolory liniowe [0, 1] na sRGB.
+ */
+void PixelConvert::LinearToSrgb(const float* source, unsigned char* target, size_t pixels, int channels,
+    bool useSimd) {
+    const unsigned char* table = LinearToSrgbTable();
+    const size_t count = pixels * channels;
+    size_t i = 0;
+#if defined(PIXEL_SSE2)
+    // Indeksy 4 składowych naraz; alfa (co 4. składowa) liczona osobno
+    if (useSimd && channels != 4) {
+        const __m128 scale = _mm_set1_ps(float(LINEAR_TABLE_SIZE - 1));
+        const __m128 half = _mm_set1_ps(0.5f);
+        for (; i + 4 <= count; i += 4) {
+            __m128 v = _mm_min_ps(_mm_max_ps(_mm_loadu_ps(source + i), _mm_setzero_ps()), _mm_set1_ps(1.0f));
+            int idx[4];
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(idx), _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(v, scale), half)));
+            target[i + 0] = table[idx[0]];
+            target[i + 1] = table[idx[1]];
+            target[i + 2] = table[idx[2]];
+            target[i + 3] = table[idx[3]];
+        }
+    }
+    else if (useSimd) {
+        const __m128 scale = _mm_setr_ps(float(LINEAR_TABLE_SIZE - 1), float(LINEAR_TABLE_SIZE - 1),
+            float(LINEAR_TABLE_SIZE - 1), 255.0f);
+        const __m128 half = _mm_set1_ps(0.5f);
+        for (; i + 4 <= count; i += 4) {
+            __m128 v = _mm_min_ps(_mm_max_ps(_mm_loadu_ps(source + i), _mm_setzero_ps()), _mm_set1_ps(1.0f));
+            int idx[4];
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(idx), _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(v, scale), half)));
+            target[i + 0] = table[idx[0]];
+            target[i + 1] = table[idx[1]];
+            target[i + 2] = table[idx[2]];
+            target[i + 3] = static_cast<unsigned char>(idx[3]);
+        }
+    }
+#else
+    (void)useSimd;
+#endif
+    for (; i < count; i++) {
+        if (channels == 4 && i % 4 == 3) {
+            float alpha = source[i] > 0.0f ? (source[i] < 1.0f ? source[i] : 1.0f) : 0.0f;
+            target[i] = static_cast<unsigned char>(alpha * 255.0f + 0.5f);
+        }
+        else {
+            target[i] = table[LinearIndex(source[i])];
+        }
+    }
+}
+
+const char* PixelConvert::GetSimdName() {
+#if defined(PIXEL_AVX2)
+    return "AVX2";
+#elif defined(PIXEL_SSSE3)
+    return "SSSE3";
+#elif defined(PIXEL_SSE2)
+    return "SSE2";
+#else
+    return "skalarny";
+#endif
+}
@@ -0,0 +1,77 @@
+﻿#pragma once
+#ifndef PIXEL_CONVERT_H
+#define PIXEL_CONVERT_H
+
+#include <cstddef>
+
+/**
+ * @brief Docelowy układ pikseli obrazu (BitmapHandler::Load, Convert).
+ */
+enum PixelFormat {
+    PIXEL_FORMAT_SOURCE = 0, /**< Jak w pliku (1-4 kanały) */
+    PIXEL_FORMAT_RGBA = 1,   /**< 4 kanały R, G, B, A */
+    PIXEL_FORMAT_BGRA = 2    /**< 4 kanały B, G, R, A (natywny układ wielu sterowników) */
+};
+
+/**
+ * @brief Konwersje pikseli 8-bitowych: rozszerzanie RGB, zamiana kanałów,
+ *        odwracanie w pionie, przestrzeń sRGB i przemnożona alfa.
+ *
+ * Każda funkcja z parametrem useSimd ma wersję skalarną i wektorową
+ * (SSE2; SSSE3 i AVX2 gdy kompilator je włącza, np. /arch:AVX2) dającą
+ * identyczny wynik. Funkcje nie używają GL, więc mogą działać w wątkach
+ * dekodujących.
+ */
+class PixelConvert {
+public:
+    /**
+     * @brief Rozszerza RGB do RGBA z alfą 255.
+     * @param source Piksele RGB (3 bajty na piksel).
+     * @param target Bufor RGBA (4 bajty na piksel, rozłączny ze źródłem).
+     * @param pixels Liczba pikseli.
+     */
+    static void ExpandRGBToRGBA(const unsigned char* source, unsigned char* target, size_t pixels,
+        bool useSimd = true);
+
+    /**
+     * @brief Zamienia kanały R i B (RGBA <-> BGRA). Może działać w miejscu.
+     */
+    static void SwapRedBlue(const unsigned char* source, unsigned char* target, size_t pixels,
+        bool useSimd = true);
+
+    /**
+     * @brief Odwraca obraz w pionie (w miejscu).
+     */
+    static void FlipVertical(unsigned char* pixels, int width, int height, int channels, bool useSimd = true);
+
+    /**
+     * @brief Mnoży kanały RGB przez alfę (w miejscu, zaokrąglenie do najbliższej).
+     */
+    static void PremultiplyAlpha(unsigned char* rgba, size_t pixels, bool useSimd = true);
+
+    /**
+     * @brief Zamienia kolory sRGB na liniowe [0, 1] (tablica 256 wartości).
+     *
+     * Przy 4 kanałach alfa jest tylko skalowana do [0, 1].
+     */
+    static void SrgbToLinear(const unsigned char* source, float* target, size_t pixels, int channels);
+
+    /**
+     * @brief Zamienia kolory liniowe [0, 1] na sRGB (tablica 4096 wartości, błąd do 1).
+     *
+     * Przy 4 kanałach alfa jest tylko skalowana do [0, 255].
+     */
+    static void LinearToSrgb(const float* source, unsigned char* target, size_t pixels, int channels,
+        bool useSimd = true);
+
+    /**
+     * @brief Dokładne przekształcenia jednej wartości (wzory sRGB, do sprawdzania tablic).
+     */
+    static float SrgbToLinearExact(float value);
+    static float LinearToSrgbExact(float value);
+
+    /// Nazwa używanego zestawu instrukcji ("AVX2", "SSSE3", "SSE2" lub "skalarny")
+    static const char* GetSimdName();
+};
+
+#endif
@@ -0,0 +1,248 @@
+﻿#include "PixelUploadRing.h"
+
+#include <chrono>
+#include <iostream>
+
+// Przesunięcia wysyłek wyrównane do linii pamięci podręcznej
+static const size_t UPLOAD_ALIGNMENT = 64;
+
+/**
+ * @brief Konstruktor klasy PixelUploadRing.
+ */
+PixelUploadRing::PixelUploadRing()
+    : mode(PIXEL_UPLOAD_CLIENT), initialized(false), buffer(0), persistentBase(nullptr), segmentSize(0),
+      segment(0), segmentOffset(0), segmentUsed(false), pendingOffset(0), pendingBytes(0), mapped(false) {
+    for (GLsync& fence : fences) fence = nullptr;
+}
+
+/**
+ * @brief Destruktor klasy PixelUploadRing.
+ */
+PixelUploadRing::~PixelUploadRing() {
+    Shutdown();
+}
+
+/**
+ * @brief Sprawdza, czy kontekst obsługuje tryb.
+ */
+bool PixelUploadRing::IsModeSupported(PixelUploadMode mode) {
+    const GLCapabilities& caps = GetGLCapabilities();
+    switch (mode) {
+    case PIXEL_UPLOAD_CLIENT: return true;
+    case PIXEL_UPLOAD_ORPHAN: return caps.pixelBufferObjects;
+    case PIXEL_UPLOAD_MAP_RANGE: return caps.mapBufferRange && caps.syncObjects;
+    case PIXEL_UPLOAD_PERSISTENT: return caps.bufferStorage && caps.syncObjects;
+    default: return false;
+    }
+}
+
+/**
+ * @brief Najszybszy tryb dostępny w bieżącym kontekście.
+ */
+PixelUploadMode PixelUploadRing::GetBestMode() {
+    for (int m = PIXEL_UPLOAD_MODE_COUNT - 1; m > PIXEL_UPLOAD_CLIENT; m--) {
+        if (IsModeSupported(static_cast<PixelUploadMode>(m))) return static_cast<PixelUploadMode>(m);
+    }
+    return PIXEL_UPLOAD_CLIENT;
+}
+
+const char* PixelUploadRing::GetModeName(PixelUploadMode mode) {
+    switch (mode) {
+    case PIXEL_UPLOAD_CLIENT: return "pamięć klienta";
+    case PIXEL_UPLOAD_ORPHAN: return "PBO + osierocanie";
+    case PIXEL_UPLOAD_MAP_RANGE: return "PBO + glMapBufferRange";
+    case PIXEL_UPLOAD_PERSISTENT: return "PBO mapowany na stałe";
+    default: return "?";
+    }
+}
+
+/**
+ * @brief Tworzy bufor (zwalnia poprzedni).
+ */
+bool PixelUploadRing::Init(size_t capacity, PixelUploadMode newMode) {
+    Shutdown();
+    if (!IsModeSupported(newMode) || capacity < SEGMENT_COUNT * UPLOAD_ALIGNMENT) return false;
+
+    mode = newMode;
+    segmentSize = capacity / SEGMENT_COUNT / UPLOAD_ALIGNMENT * UPLOAD_ALIGNMENT;
+    const GLsizeiptr size = static_cast<GLsizeiptr>(segmentSize * SEGMENT_COUNT);
+
+    if (mode != PIXEL_UPLOAD_CLIENT) {
+        glGenBuffers(1, &buffer);
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, buffer);
+        if (mode == PIXEL_UPLOAD_PERSISTENT) {
+            const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+            glBufferStorage(GL_PIXEL_UNPACK_BUFFER, size, nullptr, flags);
+            persistentBase = static_cast<unsigned char*>(glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, size, flags));
+        }
+        else if (mode == PIXEL_UPLOAD_MAP_RANGE) {
+            glBufferData(GL_PIXEL_UNPACK_BUFFER, size, nullptr, GL_STREAM_DRAW);
+        }
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+        if (mode == PIXEL_UPLOAD_PERSISTENT && !persistentBase) {
+            std::cerr << "[PixelUploadRing Error] Cannot map persistent buffer" << std::endl;
+            glDeleteBuffers(1, &buffer);
+            buffer = 0;
+            return false;
+        }
+    }
+    initialized = true;
+    return true;
+}
+
+/**
+ * @brief Czeka na zaległe płoty i zwalnia bufor.
+ */
+void PixelUploadRing::Shutdown() {
+    if (!initialized) return;
+    for (GLsync& fence : fences) {
+        if (fence) glDeleteSync(fence);
+        fence = nullptr;
+    }
+    if (buffer) {
+        if (mapped || persistentBase) {
+            glBindBuffer(GL_PIXEL_UNPACK_BUFFER, buffer);
+            glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+            glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+        }
+        // Sterownik zwalnia pamięć dopiero po zakończeniu kopii
+        glDeleteBuffers(1, &buffer);
+    }
+    buffer = 0;
+    persistentBase = nullptr;
+    mapped = false;
+    segment = 0;
+    segmentOffset = 0;
+    segmentUsed = false;
+    pendingBytes = 0;
+    staging.clear();
+    staging.shrink_to_fit();
+    initialized = false;
+}
+
+/**
+ * @brief Stawia płot na bieżącym segmencie i przechodzi do następnego.
+ */
+void PixelUploadRing::CloseSegment() {
+    if (segmentUsed) {
+        fences[segment] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        stats.segments++;
+    }
+    segment = (segment + 1) % SEGMENT_COUNT;
+    segmentOffset = 0;
+    segmentUsed = false;
+}
+
+/**
+ * @brief Czeka, aż GPU skończy czytać segment.
+ */
+void PixelUploadRing::WaitSegment(int index) {
+    GLsync& fence = fences[index];
+    if (!fence) return;
+    GLenum status = glClientWaitSync(fence, 0, 0);
+    if (status == GL_TIMEOUT_EXPIRED) {
+        auto start = std::chrono::steady_clock::now();
+        do {
+            status = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000ull);
+        } while (status == GL_TIMEOUT_EXPIRED);
+        stats.fenceWaits++;
+        stats.fenceWaitMs += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+    if (status == GL_WAIT_FAILED) std::cerr << "[PixelUploadRing Error] glClientWaitSync failed" << std::endl;
+    glDeleteSync(fence);
+    fence = nullptr;
+}
+
+/**
+ * @brief Rezerwuje miejsce na piksele jednej wysyłki.
+ */
+void* PixelUploadRing::Map(size_t bytes) {
+    if (!initialized || bytes == 0 || bytes > segmentSize) return nullptr;
+    if (mapped) {
+        // Poprzedni Map bez TexSubImage2D
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, buffer);
+        glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+        mapped = false;
+    }
+    pendingBytes = 0;
+
+    if (mode == PIXEL_UPLOAD_CLIENT) {
+        if (staging.size() < bytes) staging.resize(bytes);
+        pendingBytes = bytes;
+        return staging.data();
+    }
+
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, buffer);
+    void* pointer = nullptr;
+    if (mode == PIXEL_UPLOAD_ORPHAN) {
+        // Nowa pamięć przy każdej wysyłce – poprzednia zostaje sterownikowi do końca kopii
+        glBufferData(GL_PIXEL_UNPACK_BUFFER, static_cast<GLsizeiptr>(bytes), nullptr, GL_STREAM_DRAW);
+        pointer = glMapBuffer(GL_PIXEL_UNPACK_BUFFER, GL_WRITE_ONLY);
+        pendingOffset = 0;
+    }
+    else {
+        if (segmentOffset + bytes > segmentSize) CloseSegment();
+        if (segmentOffset == 0) WaitSegment(segment);
+        pendingOffset = static_cast<size_t>(segment) * segmentSize + segmentOffset;
+        segmentOffset += (bytes + UPLOAD_ALIGNMENT - 1) / UPLOAD_ALIGNMENT * UPLOAD_ALIGNMENT;
+
+        if (mode == PIXEL_UPLOAD_PERSISTENT) {
+            pointer = persistentBase + pendingOffset;
+        }
+        else {
+            // Płot segmentu gwarantuje, że GPU nie czyta tego zakresu
+            pointer = glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, static_cast<GLintptr>(pendingOffset),
+                static_cast<GLsizeiptr>(bytes), GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT);
+        }
+    }
+    if (!pointer) {
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+        return nullptr;
+    }
+    mapped = mode != PIXEL_UPLOAD_PERSISTENT;
+    if (!mapped) glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    pendingBytes = bytes;
+    return pointer;
+}
+
+/**
+ * @brief Wysyła piksele zapisane po ostatnim Map do związanej tekstury.
+ */
+void PixelUploadRing::TexSubImage2D(GLenum target, GLint level, GLint x, GLint y, GLsizei width, GLsizei height,
+    GLenum format, GLenum type) {
+    if (!pendingBytes) return;
+
+    if (mode == PIXEL_UPLOAD_CLIENT) {
+        glTexSubImage2D(target, level, x, y, width, height, format, type, staging.data());
+    }
+    else {
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, buffer);
+        bool valid = true;
+        if (mapped) {
+            // False: zawartość utracona (np. zmiana trybu ekranu) – wysyłka pominięta
+            valid = glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER) == GL_TRUE;
+            mapped = false;
+        }
+        if (valid) {
+            glTexSubImage2D(target, level, x, y, width, height, format, type,
+                reinterpret_cast<const void*>(pendingOffset));
+        }
+        else {
+            std::cerr << "[PixelUploadRing Error] Pixel buffer contents lost" << std::endl;
+        }
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+        segmentUsed = true;
+    }
+    stats.uploads++;
+    stats.bytes += pendingBytes;
+    pendingBytes = 0;
+}
+
+/**
+ * @brief Zamyka segment bieżącej klatki.
+ */
+void PixelUploadRing::EndFrame() {
+    if (!initialized || mode < PIXEL_UPLOAD_MAP_RANGE || !segmentUsed) return;
+    CloseSegment();
+}
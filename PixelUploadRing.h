@@ -0,0 +1,134 @@
+﻿#pragma once
+#ifndef PIXEL_UPLOAD_RING_H
+#define PIXEL_UPLOAD_RING_H
+
+#include "GLExtensions.h"
+
+#include <cstddef>
+#include <vector>
+
+/**
+ * @brief Sposób przekazania pikseli do glTexSubImage2D (od najprostszego).
+ */
+enum PixelUploadMode {
+    PIXEL_UPLOAD_CLIENT = 0,     /**< Bez PBO – sterownik kopiuje z pamięci klienta */
+    PIXEL_UPLOAD_ORPHAN = 1,     /**< PBO osierocany przy każdej wysyłce, glMapBuffer (GL 2.1) */
+    PIXEL_UPLOAD_MAP_RANGE = 2,  /**< Pierścień w PBO, glMapBufferRange bez synchronizacji + płoty (GL 3.2) */
+    PIXEL_UPLOAD_PERSISTENT = 3, /**< Pierścień w PBO mapowanym na stałe + płoty (GL 4.4) */
+    PIXEL_UPLOAD_MODE_COUNT = 4
+};
+
+/**
+ * @brief Liczniki pracy pierścienia wysyłek.
+ */
+struct PixelUploadStats {
+    unsigned int uploads = 0;     /**< Wywołania glTexSubImage2D */
+    size_t bytes = 0;             /**< Bajty przekazane przez pierścień */
+    unsigned int segments = 0;    /**< Zamknięte segmenty (postawione płoty) */
+    unsigned int fenceWaits = 0;  /**< Segmenty, na które trzeba było czekać */
+    double fenceWaitMs = 0.0;     /**< Czas czekania na płoty [ms] */
+};
+
+/**
+ * @brief Pierścień buforów pikseli (GL_PIXEL_UNPACK_BUFFER) do wysyłki tekstur.
+ *
+ * Map zwraca wskaźnik do pamięci widocznej dla GPU, do której wywołujący
+ * kopiuje piksele, a TexSubImage2D zleca kopię do tekstury z bufora – wywołanie
+ * wraca od razu, a transfer DMA nakłada się na renderowanie. Pamięć jest
+ * podzielona na SEGMENT_COUNT segmentów; zamykany segment dostaje płot
+ * (glFenceSync), a ponowne użycie czeka na jego sygnał. Tryb ORPHAN nie
+ * potrzebuje płotów – sterownik przydziela nową pamięć przy glBufferData(nullptr).
+ *
+ * Wszystkie metody wywołuje wątek z aktywnym kontekstem GL.
+ */
+class PixelUploadRing {
+public:
+    static const int SEGMENT_COUNT = 4;
+
+    PixelUploadRing();
+    ~PixelUploadRing();
+
+    PixelUploadRing(const PixelUploadRing&) = delete;
+    PixelUploadRing& operator=(const PixelUploadRing&) = delete;
+
+    /**
+     * @brief Sprawdza, czy kontekst obsługuje tryb.
+     */
+    static bool IsModeSupported(PixelUploadMode mode);
+
+    /**
+     * @brief Najszybszy tryb dostępny w bieżącym kontekście.
+     */
+    static PixelUploadMode GetBestMode();
+
+    static const char* GetModeName(PixelUploadMode mode);
+
+    /**
+     * @brief Tworzy bufor (zwalnia poprzedni).
+     * @param capacity Rozmiar pierścienia w bajtach (segment = capacity / SEGMENT_COUNT).
+     * @param mode Tryb wysyłki.
+     * @return False jeśli tryb nie jest obsługiwany lub nie udało się utworzyć bufora.
+     */
+    bool Init(size_t capacity, PixelUploadMode mode);
+
+    /**
+     * @brief Czeka na zaległe płoty i zwalnia bufor.
+     */
+    void Shutdown();
+
+    bool IsInitialized() const { return initialized; }
+    PixelUploadMode GetMode() const { return mode; }
+
+    /**
+     * @brief Największa pojedyncza wysyłka (rozmiar segmentu).
+     */
+    size_t GetMaxUploadSize() const { return segmentSize; }
+
+    /**
+     * @brief Rezerwuje miejsce na piksele jednej wysyłki.
+     *
+     * Jeśli segment jest pełny, zostaje zamknięty płotem, a następny jest
+     * odzyskiwany (czekanie tylko, gdy GPU jeszcze z niego czyta).
+     * @return Wskaźnik do zapisu lub nullptr (za duża wysyłka / błąd mapowania).
+     */
+    void* Map(size_t bytes);
+
+    /**
+     * @brief Wysyła piksele zapisane po ostatnim Map do związanej tekstury.
+     *
+     * Układ wierszy jak w glTexSubImage2D (GL_UNPACK_ALIGNMENT wywołującego).
+     */
+    void TexSubImage2D(GLenum target, GLint level, GLint x, GLint y, GLsizei width, GLsizei height,
+        GLenum format, GLenum type);
+
+    /**
+     * @brief Zamyka segment bieżącej klatki (płot), żeby następna klatka go nie nadpisała.
+     */
+    void EndFrame();
+
+    const PixelUploadStats& GetStats() const { return stats; }
+    void ResetStats() { stats = PixelUploadStats(); }
+
+private:
+    void CloseSegment();
+    void WaitSegment(int index);
+
+    PixelUploadMode mode;
+    bool initialized;
+    GLuint buffer;                     /**< Bufor GL_PIXEL_UNPACK_BUFFER */
+    unsigned char* persistentBase;     /**< Stałe mapowanie (PIXEL_UPLOAD_PERSISTENT) */
+    size_t segmentSize;
+    int segment;                       /**< Bieżący segment */
+    size_t segmentOffset;              /**< Zajęte bajty bieżącego segmentu */
+    bool segmentUsed;                  /**< Czy bieżący segment ma wysyłki bez płotu */
+    GLsync fences[SEGMENT_COUNT];      /**< Płoty zamkniętych segmentów */
+
+    size_t pendingOffset;              /**< Przesunięcie danych ostatniego Map w buforze */
+    size_t pendingBytes;               /**< Rozmiar ostatniego Map (0: brak) */
+    bool mapped;                       /**< Czy bufor jest zmapowany (tryby ORPHAN i MAP_RANGE) */
+    std::vector<unsigned char> staging; /**< Pamięć klienta (PIXEL_UPLOAD_CLIENT) */
+
+    PixelUploadStats stats;
+};
+
+#endif
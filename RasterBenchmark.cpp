@@ -0,0 +1,205 @@
+﻿#include "RasterBenchmark.h"
+#include "BenchmarkUtils.h"
+#include "SoftwareRasterizer.h"
+#include "BitmapHandler.h"
+#include "LitShader.h"
+#include "MathLib.h"
+#include "Mesh.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+/// Rozdzielczość testu
+static const int BENCH_WIDTH = 1280;
+static const int BENCH_HEIGHT = 720;
+
+/**
+ * @brief Siatka cells x cells czworokątów o losowo przesuniętych węzłach pokrywająca [-1, 1]^2.
+ *
+ * Każdy trójkąt ma własne wierzchołki i jest bliżej kamery niż poprzedni,
+ * więc przy teście GL_LESS każdy zapisany fragment przechodzi test – liczba
+ * zapisanych pikseli równa liczbie pikseli ekranu oznacza brak dziur
+ * i podwójnie rysowanych pikseli na wspólnych krawędziach.
+ */
+static void BuildJitteredGrid(Mesh& mesh, int cells) {
+    std::vector<float> nodes((cells + 1) * (cells + 1) * 2);
+    for (int y = 0; y <= cells; y++) {
+        for (int x = 0; x <= cells; x++) {
+            float px = -1.0f + 2.0f * x / cells, py = -1.0f + 2.0f * y / cells;
+            // Węzły wewnętrzne przesunięte o ułamek komórki (krawędzie pod dowolnym kątem)
+            if (x > 0 && x < cells) px += ((float)rand() / RAND_MAX - 0.5f) * 1.4f / cells;
+            if (y > 0 && y < cells) py += ((float)rand() / RAND_MAX - 0.5f) * 1.4f / cells;
+            nodes[(y * (cells + 1) + x) * 2] = px;
+            nodes[(y * (cells + 1) + x) * 2 + 1] = py;
+        }
+    }
+
+    mesh.Clear();
+    float z = -0.99f;
+    const float zStep = 1.9f / (cells * cells * 2);
+    auto corner = [&](int x, int y) {
+        const float* node = &nodes[(y * (cells + 1) + x) * 2];
+        return mesh.AddVertex(node[0], node[1], z, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 1.0f, 1.0f, 1.0f);
+    };
+    for (int y = 0; y < cells; y++) {
+        for (int x = 0; x < cells; x++) {
+            unsigned int a = corner(x, y), b = corner(x + 1, y), c = corner(x + 1, y + 1);
+            mesh.AddTriangle(a, b, c);
+            z += zStep;
+            a = corner(x, y), b = corner(x + 1, y + 1), c = corner(x, y + 1);
+            mesh.AddTriangle(a, b, c);
+            z += zStep;
+        }
+    }
+}
+
+/**
+ * @brief Scena testu: obiekty na kwadratowej siatce (jak Engine::buildStressScene) i podłoże z linii.
+ */
+struct BenchScene {
+    Mesh cube, pyramid, sphere, grid;
+    BitmapHandler texture;
+    LightingState lighting;
+    std::vector<Vec3> positions;
+    Mat4 view, projection;
+
+    explicit BenchScene(int objects) : grid(GL_LINES) {
+        cube.BuildCube();
+        pyramid.BuildPyramid();
+        sphere.BuildSphere(24);
+        grid.BuildGrid(5, 0.5f, 0.5f, 0.5f);
+        if (!texture.Load("textura.jpg", true, PIXEL_FORMAT_RGBA)) {
+            std::cout << "  (brak textura.jpg – sześciany bez tekstury)\n";
+        }
+
+        LightSource light = {
+            { -5.0f, 10.0f, 5.0f, 0.0f },
+            { 0.2f, 0.2f, 0.2f, 1.0f },
+            { 0.8f, 0.8f, 0.8f, 1.0f },
+            { 1.0f, 1.0f, 1.0f, 1.0f }
+        };
+        lighting.SetLight(0, light);
+        const float specular[4] = { 0.5f, 0.5f, 0.5f, 1.0f };
+        lighting.SetMaterial(specular, 50.0f);
+
+        const float spacing = 3.0f;
+        const int side = static_cast<int>(std::ceil(std::sqrt(static_cast<double>(objects))));
+        const float offset = (side - 1) * spacing * 0.5f;
+        for (int i = 0; i < objects; i++) {
+            positions.push_back(Vec3((i % side) * spacing - offset, (i / side) * spacing - offset, 0.0f));
+        }
+        // Kamera ukośnie nad siatką: część obiektów blisko (duże trójkąty), część daleko
+        const float distance = side * spacing * 0.6f + 6.0f;
+        view = Mat4::LookAt(Vec3(0.0f, -distance, distance * 0.7f), Vec3(0.0f, 0.0f, 0.0f), Vec3(0.0f, 0.0f, 1.0f));
+        projection = Mat4::Perspective(Radians(60.0f), (float)BENCH_WIDTH / BENCH_HEIGHT, 0.1f, distance * 4.0f);
+    }
+
+    /**
+     * @brief Rysuje scenę jedną klatką rasteryzera.
+     */
+    void Draw(SoftwareRasterizer& rasterizer) {
+        const float clearColor[4] = { 0.2f, 0.3f, 0.3f, 1.0f };
+        const float white[4] = { 1.0f, 1.0f, 1.0f, 1.0f };
+        rasterizer.Clear(clearColor);
+        rasterizer.SetCamera(view, projection);
+        rasterizer.SetLighting(&lighting);
+        for (size_t i = 0; i < positions.size(); i++) {
+            const Mat4 model = Mat4::Translation(positions[i].x, positions[i].y, positions[i].z);
+            switch (i % 3) {
+            case 0: rasterizer.DrawMesh(cube, model, white, &texture, true); break;
+            case 1: rasterizer.DrawMesh(pyramid, model, white, nullptr, true); break;
+            default:
+                rasterizer.DrawMesh(sphere, model * Mat4::Scale(1.5f, 1.5f, 1.5f), white, nullptr, true,
+                    rasterizer.IsSmoothShading() ? 0 : Mesh::SPHERE_FLAT_COLORS);
+                break;
+            }
+        }
+        rasterizer.DrawMesh(grid, Mat4::Scale(6.0f, 6.0f, 6.0f), white, nullptr, false);
+        rasterizer.Flush();
+    }
+};
+
+/**
+ * @brief Sprawdza rasteryzer i mierzy przepustowość dla rosnącej liczby wątków.
+ */
+int RunRasterBenchmark(int objects) {
+    if (objects <= 0) objects = 2000;
+    srand(12345);
+    const int maxThreads = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+
+    std::cout << "\n=== TEST RASTERYZERA PROGRAMOWEGO (" << BENCH_WIDTH << "x" << BENCH_HEIGHT << ", kafelki "
+        << SoftwareRasterizer::TILE_SIZE << "x" << SoftwareRasterizer::TILE_SIZE << ", " << objects << " obiektów) ===\n";
+
+    bool ok = true;
+    SoftwareRasterizer reference(1);
+    reference.Resize(BENCH_WIDTH, BENCH_HEIGHT);
+
+    // --- Szczelność krawędzi ---
+    {
+        Mesh jittered;
+        BuildJitteredGrid(jittered, 23);
+        const float black[4] = { 0.0f, 0.0f, 0.0f, 1.0f };
+        const float white[4] = { 1.0f, 1.0f, 1.0f, 1.0f };
+        reference.Clear(black);
+        reference.SetCamera(Mat4::Identity(), Mat4::Identity());
+        reference.SetLighting(nullptr);
+        reference.DrawMesh(jittered, Mat4::Identity(), white, nullptr, false);
+        reference.Flush();
+        ok &= BenchmarkCheck("Krawędzie: każdy piksel zapisany dokładnie raz",
+            reference.GetStats().pixels == static_cast<size_t>(BENCH_WIDTH) * BENCH_HEIGHT);
+    }
+
+    // --- Niezależność od liczby wątków ---
+    BenchScene scene(objects);
+    std::vector<unsigned char> referenceColor;
+    std::vector<float> referenceDepth;
+    for (int smooth = 1; smooth >= 0; smooth--) {
+        reference.SetSmoothShading(smooth != 0);
+        scene.Draw(reference);
+        referenceColor.assign(reference.GetColor(), reference.GetColor() + BENCH_WIDTH * BENCH_HEIGHT * 4);
+        referenceDepth.assign(reference.GetDepth(), reference.GetDepth() + BENCH_WIDTH * BENCH_HEIGHT);
+
+        SoftwareRasterizer threaded(maxThreads);
+        threaded.Resize(BENCH_WIDTH, BENCH_HEIGHT);
+        threaded.SetSmoothShading(smooth != 0);
+        scene.Draw(threaded);
+        const bool same = std::memcmp(threaded.GetColor(), referenceColor.data(), referenceColor.size()) == 0
+            && std::memcmp(threaded.GetDepth(), referenceDepth.data(), referenceDepth.size() * sizeof(float)) == 0;
+        ok &= BenchmarkCheck(smooth ? "Gouraud: obraz 1 wątku = obraz wszystkich wątków"
+            : "Płaskie: obraz 1 wątku = obraz wszystkich wątków", same);
+    }
+    reference.SetSmoothShading(true);
+    reference.PrintStats();
+
+    // --- Przepustowość ---
+    std::cout << "\n  Wątki  przygotowanie [ms]  rasteryzacja [ms]  klatka [ms]  Mtrójkątów/s  przyspieszenie\n";
+    double singleMs = 0.0;
+    for (int threads = 1;; threads = std::min(threads * 2, maxThreads)) {
+        SoftwareRasterizer rasterizer(threads);
+        rasterizer.Resize(BENCH_WIDTH, BENCH_HEIGHT);
+        double bestMs = 1e30, setupMs = 0.0, rasterMs = 0.0;
+        for (int frame = 0; frame < 5; frame++) {
+            scene.Draw(rasterizer);
+            const RasterStats& stats = rasterizer.GetStats();
+            if (stats.setupMs + stats.rasterMs < bestMs) {
+                bestMs = stats.setupMs + stats.rasterMs;
+                setupMs = stats.setupMs;
+                rasterMs = stats.rasterMs;
+            }
+        }
+        if (threads == 1) singleMs = bestMs;
+        const double triangles = static_cast<double>(rasterizer.GetStats().triangles);
+        std::cout << std::fixed << std::setprecision(2) << std::setw(7) << threads << std::setw(20) << setupMs
+            << std::setw(19) << rasterMs << std::setw(13) << bestMs << std::setw(14) << triangles / (bestMs * 1000.0)
+            << std::setw(15) << singleMs / bestMs << "x\n" << std::defaultfloat;
+        if (threads == maxThreads) break;
+    }
+
+    return BenchmarkSummary(ok);
+}
@@ -0,0 +1,17 @@
+﻿#pragma once
+#ifndef RASTER_BENCHMARK_H
+#define RASTER_BENCHMARK_H
+
+/**
+ * @brief Test rasteryzera programowego (SoftwareRasterizer).
+ *
+ * Sprawdza szczelność krawędzi (każdy piksel siatki trójkątów pokrywającej
+ * ekran zapisany dokładnie raz) i to, że obraz nie zależy od liczby wątków,
+ * a następnie mierzy przepustowość w trójkątach na sekundę dla 1, 2, 4...
+ * wątków na scenie z sześcianów, piramid i kul. Nie wymaga kontekstu OpenGL.
+ * @param objects Liczba obiektów sceny testowej (domyślnie 2000).
+ * @return 0 jeśli wszystkie sprawdzenia przeszły, 1 w przeciwnym razie.
+ */
+int RunRasterBenchmark(int objects);
+
+#endif
@@ -0,0 +1,54 @@
+﻿#include "RenderQueue.h"
+
+#include <algorithm>
+
+/**
+ * @brief Składa klucz sortowania.
+ */
+uint64_t RenderQueue::MakeKey(unsigned int pass, unsigned int shader, unsigned int texture,
+    unsigned int material, unsigned int mesh, float depth) {
+    const uint64_t depthMax = (1u << DEPTH_BITS) - 1;
+    depth = std::min(std::max(depth, 0.0f), 1.0f);
+    uint64_t quantized = static_cast<uint64_t>(depth * depthMax);
+    return (static_cast<uint64_t>(pass & 0x3) << 62)
+        | (static_cast<uint64_t>(shader & 0x3) << 60)
+        | (static_cast<uint64_t>(texture & 0xFFF) << 48)
+        | (static_cast<uint64_t>(material & 0xFFF) << 36)
+        | (static_cast<uint64_t>(mesh & 0xFFF) << 24)
+        | quantized;
+}
+
+/**
+ * @brief Sortuje pakiety rosnąco po kluczu (radix LSD, 8 bitów na przebieg).
+ */
+void RenderQueue::Sort() {
+    const size_t count = packets.size();
+    if (count < 2) return;
+    scratch.resize(count);
+
+    // Cyfry takie same we wszystkich kluczach nie zmieniają kolejności
+    uint64_t keyOr = 0, keyAnd = ~0ull;
+    for (const DrawPacket& packet : packets) {
+        keyOr |= packet.key;
+        keyAnd &= packet.key;
+    }
+    const uint64_t varying = keyOr ^ keyAnd;
+
+    DrawPacket* source = packets.data();
+    DrawPacket* target = scratch.data();
+    for (int shift = 0; shift < 64; shift += 8) {
+        if (((varying >> shift) & 0xFF) == 0) continue;
+
+        size_t offsets[256] = {};
+        for (size_t i = 0; i < count; i++) offsets[(source[i].key >> shift) & 0xFF]++;
+        size_t sum = 0;
+        for (size_t& offset : offsets) {
+            size_t digitCount = offset;
+            offset = sum;
+            sum += digitCount;
+        }
+        for (size_t i = 0; i < count; i++) target[offsets[(source[i].key >> shift) & 0xFF]++] = source[i];
+        std::swap(source, target);
+    }
+    if (source != packets.data()) packets.swap(scratch);
+}
@@ -0,0 +1,82 @@
+﻿#pragma once
+#ifndef RENDER_QUEUE_H
+#define RENDER_QUEUE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief Przebiegi kolejki w kolejności rysowania (najstarsze bity klucza).
+ */
+enum RenderPass {
+    RENDER_PASS_OPAQUE = 0,  /**< Obiekty oświetlone */
+    RENDER_PASS_UNLIT = 1,   /**< Obiekty bez oświetlenia (siatka podłoża) */
+    RENDER_PASS_OVERLAY = 2  /**< Elementy pomocnicze rysowane na końcu */
+};
+
+/**
+ * @brief Pakiet rysowania: klucz sortowania i numer rysowanego elementu.
+ */
+struct DrawPacket {
+    uint64_t key;   /**< Klucz z RenderQueue::MakeKey */
+    uint32_t item;  /**< Numer elementu (np. obiektu sceny) */
+};
+
+/**
+ * @brief Kolejka pakietów rysowania sortowana po 64-bitowym kluczu.
+ *
+ * Klucz (od najstarszych bitów): przebieg (2), wariant shadera (2),
+ * tekstura (12), materiał (12), siatka (12), głębokość (24). Pakiety
+ * o tym samym stanie trafiają obok siebie, a w obrębie stanu są
+ * uporządkowane od najbliższych (wczesne odrzucanie przez test głębokości).
+ * Sortowanie pozycyjne (radix, 8 bitów na przebieg) pomija cyfry wspólne
+ * dla wszystkich kluczy.
+ */
+class RenderQueue {
+public:
+    static const int DEPTH_BITS = 24;
+
+    /**
+     * @brief Składa klucz sortowania.
+     * @param pass Przebieg (RenderPass).
+     * @param shader Wariant shadera (2 bity).
+     * @param texture Numer tekstury (12 bitów).
+     * @param material Numer materiału (12 bitów).
+     * @param mesh Numer siatki (12 bitów).
+     * @param depth Odległość od kamery znormalizowana do [0, 1].
+     */
+    static uint64_t MakeKey(unsigned int pass, unsigned int shader, unsigned int texture,
+        unsigned int material, unsigned int mesh, float depth);
+
+    /**
+     * @brief Usuwa pakiety (pamięć zostaje na następną klatkę).
+     */
+    void Clear() { packets.clear(); }
+
+    void Reserve(size_t count) { packets.reserve(count); }
+
+    /**
+     * @brief Dodaje pakiet.
+     */
+    void Push(uint64_t key, uint32_t item) { packets.push_back({ key, item }); }
+
+    /**
+     * @brief Sortuje pakiety rosnąco po kluczu (stabilnie).
+     */
+    void Sort();
+
+    size_t GetSize() const { return packets.size(); }
+    const DrawPacket* GetPackets() const { return packets.data(); }
+
+    /**
+     * @brief Zwraca przebieg zapisany w kluczu.
+     */
+    static unsigned int GetPass(uint64_t key) { return static_cast<unsigned int>(key >> 62); }
+
+private:
+    std::vector<DrawPacket> packets; /**< Pakiety bieżącej klatki */
+    std::vector<DrawPacket> scratch; /**< Bufor pomocniczy sortowania */
+};
+
+#endif
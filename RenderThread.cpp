@@ -0,0 +1,211 @@
+﻿#include "RenderThread.h"
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+/// Wyrównanie danych poleceń w buforze listy
+static const size_t DATA_ALIGNMENT = 16;
+
+/**
+ * @brief Dodaje polecenie bez danych.
+ */
+void RenderCommandList::Push(int type, int arg0, int arg1) {
+    commands.push_back({ type, { arg0, arg1 }, 0, 0 });
+}
+
+/**
+ * @brief Dodaje polecenie z kopią danych.
+ */
+void RenderCommandList::PushData(int type, const void* source, size_t bytes, int arg0, int arg1) {
+    const size_t offset = (data.size() + DATA_ALIGNMENT - 1) & ~(DATA_ALIGNMENT - 1);
+    data.resize(offset + bytes);
+    if (bytes) std::memcpy(data.data() + offset, source, bytes);
+    commands.push_back({ type, { arg0, arg1 }, offset, bytes });
+}
+
+/**
+ * @brief Usuwa polecenia (pojemność buforów zostaje na kolejne klatki).
+ */
+void RenderCommandList::Clear() {
+    commands.clear();
+    data.clear();
+}
+
+/**
+ * @brief Konstruktor klasy RenderThread.
+ */
+RenderThread::RenderThread(int bufferCount)
+    : lists(std::min(std::max(bufferCount, MIN_BUFFERS), MAX_BUFFERS)),
+    recordIndex(0), executeIndex(0), pending(0), recording(false), quit(false), nextFrame(0) {
+    ResetStats();
+}
+
+/**
+ * @brief Destruktor – kończy wątek po wykonaniu przekazanych list.
+ */
+RenderThread::~RenderThread() {
+    Stop();
+}
+
+/**
+ * @brief Uruchamia wątek renderowania.
+ */
+void RenderThread::Start(std::function<void(const RenderCommandList&)> function,
+    std::function<void()> begin, std::function<void()> end) {
+    Stop();
+    execute = std::move(function);
+    recordIndex = 0;
+    executeIndex = 0;
+    pending = 0;
+    recording = false;
+    quit = false;
+    nextFrame = 0;
+    ResetStats();
+    thread = std::thread(&RenderThread::ThreadLoop, this, std::move(begin), std::move(end));
+}
+
+/**
+ * @brief Wykonuje przekazane listy i kończy wątek.
+ */
+void RenderThread::Stop() {
+    if (!thread.joinable()) return;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        quit = true;
+    }
+    submittedSignal.notify_all();
+    thread.join();
+}
+
+/**
+ * @brief Zwraca wolną listę do nagrania.
+ */
+RenderCommandList& RenderThread::BeginRecord() {
+    const Clock::time_point start = Clock::now();
+    std::unique_lock<std::mutex> lock(mutex);
+    executedSignal.wait(lock, [this] { return pending < lists.size(); });
+    const Clock::time_point now = Clock::now();
+    stallSeconds += std::chrono::duration<double>(now - start).count();
+    recording = true;
+
+    RenderCommandList& list = lists[recordIndex];
+    list.Clear();
+    list.frame = nextFrame++;
+    list.recorded = now;
+    return list;
+}
+
+/**
+ * @brief Przekazuje nagraną listę do wykonania.
+ */
+void RenderThread::Submit() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!recording) return;
+        RenderCommandList& list = lists[recordIndex];
+        list.submitted = Clock::now();
+        recordSeconds += std::chrono::duration<double>(list.submitted - list.recorded).count();
+        recordIndex = (recordIndex + 1) % lists.size();
+        pending++;
+        recording = false;
+    }
+    submittedSignal.notify_one();
+}
+
+/**
+ * @brief Czeka na wykonanie wszystkich przekazanych list.
+ */
+void RenderThread::Flush() {
+    std::unique_lock<std::mutex> lock(mutex);
+    executedSignal.wait(lock, [this] { return pending == 0; });
+}
+
+/**
+ * @brief Pętla wątku renderowania.
+ */
+void RenderThread::ThreadLoop(std::function<void()> begin, std::function<void()> end) {
+    if (begin) begin();
+
+    for (;;) {
+        const Clock::time_point waitStart = Clock::now();
+        std::unique_lock<std::mutex> lock(mutex);
+        submittedSignal.wait(lock, [this] { return quit || pending > 0; });
+        if (pending == 0) break;
+        RenderCommandList& list = lists[executeIndex];
+        lock.unlock();
+
+        const Clock::time_point start = Clock::now();
+        execute(list);
+        const Clock::time_point done = Clock::now();
+
+        lock.lock();
+        idleSeconds += std::chrono::duration<double>(start - waitStart).count();
+        executeSeconds += std::chrono::duration<double>(done - start).count();
+        queuedSeconds += std::max(0.0, std::chrono::duration<double>(start - list.submitted).count());
+        const double latency = std::chrono::duration<double>(done - list.recorded).count();
+        latencySeconds += latency;
+        maxLatencySeconds = std::max(maxLatencySeconds, latency);
+        lastExecuted = done;
+        frames++;
+        executeIndex = (executeIndex + 1) % lists.size();
+        pending--;
+        lock.unlock();
+        executedSignal.notify_all();
+    }
+
+    if (end) end();
+}
+
+/**
+ * @brief Zwraca średnie na klatkę od Start lub ResetStats.
+ */
+RenderThreadStats RenderThread::GetStats() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    RenderThreadStats stats;
+    stats.frames = frames;
+    if (frames == 0) return stats;
+    const double scale = 1000.0 / frames;
+    stats.recordMs = recordSeconds * scale;
+    stats.executeMs = executeSeconds * scale;
+    stats.stallMs = stallSeconds * scale;
+    stats.idleMs = idleSeconds * scale;
+    stats.queuedMs = queuedSeconds * scale;
+    stats.latencyMs = latencySeconds * scale;
+    stats.maxLatencyMs = maxLatencySeconds * 1000.0;
+    const double elapsed = std::chrono::duration<double>(lastExecuted - statsStart).count();
+    if (elapsed > 0.0) stats.framesPerSecond = frames / elapsed;
+    return stats;
+}
+
+/**
+ * @brief Zeruje liczniki.
+ */
+void RenderThread::ResetStats() {
+    std::lock_guard<std::mutex> lock(mutex);
+    frames = 0;
+    recordSeconds = executeSeconds = stallSeconds = idleSeconds = queuedSeconds = 0.0;
+    latencySeconds = maxLatencySeconds = 0.0;
+    statsStart = lastExecuted = Clock::now();
+}
+
+/**
+ * @brief Wypisuje opóźnienie i przepustowość względem wykonania sekwencyjnego.
+ */
+void RenderThread::PrintStats() const {
+    const RenderThreadStats stats = GetStats();
+    std::cout << "Wątek renderowania (" << GetBufferCount() << " bufory list): " << stats.frames << " klatek, "
+        << stats.framesPerSecond << " FPS\n";
+    std::cout << "  Na klatkę: symulacja " << stats.recordMs << " ms, renderowanie " << stats.executeMs
+        << " ms | czekanie na bufor " << stats.stallMs << " ms, bezczynność renderowania " << stats.idleMs << " ms\n";
+    std::cout << "  Opóźnienie wejście->koniec klatki: średnio " << stats.latencyMs << " ms, max " << stats.maxLatencyMs
+        << " ms (w tym kolejka: " << stats.queuedMs << " ms)\n";
+    if (stats.frames) {
+        // Jeden wątek wykonuje symulację i renderowanie po kolei; potok – równolegle
+        const double sequentialMs = stats.recordMs + stats.executeMs;
+        const double pipelinedMs = std::max(stats.recordMs, stats.executeMs);
+        std::cout << "  Limit przepustowości: sekwencyjnie " << 1000.0 / sequentialMs << " FPS, potokowo "
+            << 1000.0 / pipelinedMs << " FPS (" << sequentialMs / pipelinedMs << "x)";
+    }
+    std::cout << std::endl;
+}
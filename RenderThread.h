@@ -0,0 +1,176 @@
+﻿#pragma once
+#ifndef RENDER_THREAD_H
+#define RENDER_THREAD_H
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Polecenie listy renderowania: typ zdefiniowany przez użytkownika i argumenty.
+ */
+struct RenderCommand {
+    int type;              /**< Rodzaj polecenia (znaczenie nadaje wykonawca) */
+    int args[2];           /**< Argumenty całkowite (np. klawisz, rozmiar okna) */
+    size_t offset;         /**< Początek danych w buforze listy */
+    size_t size;           /**< Rozmiar danych w bajtach (0: brak) */
+};
+
+/**
+ * @brief Lista poleceń jednej klatki nagrywana przez wątek symulacji.
+ *
+ * Dane poleceń (macierze, tablice świateł) kopiowane są do bufora listy
+ * z wyrównaniem do 16 bajtów, więc pozostają ważne do końca wykonania listy
+ * niezależnie od dalszych zmian stanu symulacji.
+ */
+class RenderCommandList {
+public:
+    RenderCommandList() : frame(0) {}
+
+    /**
+     * @brief Dodaje polecenie bez danych.
+     */
+    void Push(int type, int arg0 = 0, int arg1 = 0);
+
+    /**
+     * @brief Dodaje polecenie z kopią bytes bajtów danych.
+     */
+    void PushData(int type, const void* data, size_t bytes, int arg0 = 0, int arg1 = 0);
+
+    /**
+     * @brief Zwraca dane polecenia (nullptr, gdy brak).
+     */
+    const void* GetData(const RenderCommand& command) const {
+        return command.size ? data.data() + command.offset : nullptr;
+    }
+
+    const std::vector<RenderCommand>& GetCommands() const { return commands; }
+
+    /// Numer klatki od Start
+    uint64_t GetFrame() const { return frame; }
+
+private:
+    friend class RenderThread;
+
+    void Clear();
+
+    std::vector<RenderCommand> commands;
+    std::vector<unsigned char> data;                 /**< Dane poleceń */
+    uint64_t frame;                                  /**< Numer klatki */
+    std::chrono::steady_clock::time_point recorded;  /**< Początek nagrywania (próbkowanie wejścia) */
+    std::chrono::steady_clock::time_point submitted; /**< Przekazanie do wątku renderowania */
+};
+
+/**
+ * @brief Liczniki wątku renderowania od Start lub ResetStats (średnie na klatkę).
+ */
+struct RenderThreadStats {
+    size_t frames = 0;          /**< Wykonane listy */
+    double recordMs = 0.0;      /**< Nagrywanie (symulacja) na wątku głównym */
+    double executeMs = 0.0;     /**< Wykonanie listy (GL, zamiana buforów) */
+    double stallMs = 0.0;       /**< Czekanie wątku głównego na wolny bufor */
+    double idleMs = 0.0;        /**< Czekanie wątku renderowania na listę */
+    double queuedMs = 0.0;      /**< Lista gotowa, wątek renderowania zajęty (opóźnienie dodane przez kolejkę) */
+    double latencyMs = 0.0;     /**< Od początku nagrywania do końca wykonania */
+    double maxLatencyMs = 0.0;  /**< Najdłuższe opóźnienie */
+    double framesPerSecond = 0.0; /**< Wykonane listy na sekundę */
+};
+
+/**
+ * @brief Wątek renderowania wykonujący listy poleceń nagrane przez wątek główny.
+ *
+ * Listy krążą w pierścieniu bufferCount buforów (2: podwójne, 3: potrójne
+ * buforowanie). Wątek główny nagrywa klatkę N+1, gdy wątek renderowania
+ * wykonuje klatkę N; gdy wszystkie bufory czekają na wykonanie, BeginRecord
+ * blokuje (wątek symulacji nie ucieka dalej niż bufferCount - 1 klatek).
+ *
+ * Klasa nie zna OpenGL: funkcja begin wykonywana na starcie wątku przejmuje
+ * kontekst, execute wykonuje listę, end oddaje kontekst przed zakończeniem.
+ */
+class RenderThread {
+public:
+    static const int MIN_BUFFERS = 2;
+    static const int MAX_BUFFERS = 3;
+
+    /**
+     * @param bufferCount Liczba list w pierścieniu (2 lub 3).
+     */
+    explicit RenderThread(int bufferCount = MIN_BUFFERS);
+    ~RenderThread();
+
+    RenderThread(const RenderThread&) = delete;
+    RenderThread& operator=(const RenderThread&) = delete;
+
+    /**
+     * @brief Uruchamia wątek.
+     * @param execute Wykonanie listy (wątek renderowania).
+     * @param begin Wywoływane na wątku renderowania przed pierwszą listą (opcjonalne).
+     * @param end Wywoływane na wątku renderowania po ostatniej liście (opcjonalne).
+     */
+    void Start(std::function<void(const RenderCommandList&)> execute,
+        std::function<void()> begin = nullptr, std::function<void()> end = nullptr);
+
+    /**
+     * @brief Wykonuje przekazane listy i kończy wątek.
+     */
+    void Stop();
+
+    bool IsRunning() const { return thread.joinable(); }
+    int GetBufferCount() const { return static_cast<int>(lists.size()); }
+
+    /**
+     * @brief Zwraca wolną listę do nagrania (czeka, gdy wszystkie są w kolejce).
+     */
+    RenderCommandList& BeginRecord();
+
+    /**
+     * @brief Przekazuje nagraną listę do wykonania.
+     */
+    void Submit();
+
+    /**
+     * @brief Czeka, aż wszystkie przekazane listy zostaną wykonane.
+     *
+     * Po powrocie wątek renderowania czeka na kolejną listę i nie dotyka
+     * stanu silnika – wątek główny może go bezpiecznie czytać.
+     */
+    void Flush();
+
+    RenderThreadStats GetStats() const;
+    void ResetStats();
+
+    /**
+     * @brief Wypisuje opóźnienie i przepustowość względem wykonania sekwencyjnego.
+     */
+    void PrintStats() const;
+
+private:
+    typedef std::chrono::steady_clock Clock;
+
+    void ThreadLoop(std::function<void()> begin, std::function<void()> end);
+
+    std::vector<RenderCommandList> lists;
+    std::function<void(const RenderCommandList&)> execute;
+    std::thread thread;
+    mutable std::mutex mutex;
+    std::condition_variable submittedSignal;  /**< Nowa lista lub zakończenie */
+    std::condition_variable executedSignal;   /**< Lista wykonana (wolny bufor) */
+    size_t recordIndex;       /**< Lista nagrywana przez wątek główny */
+    size_t executeIndex;      /**< Następna lista do wykonania */
+    size_t pending;           /**< Przekazane i jeszcze niewykonane listy */
+    bool recording;           /**< Czy trwa nagrywanie (BeginRecord bez Submit) */
+    bool quit;
+    uint64_t nextFrame;
+
+    // Sumy do statystyk (pod blokadą)
+    size_t frames;
+    double recordSeconds, executeSeconds, stallSeconds, idleSeconds, queuedSeconds, latencySeconds, maxLatencySeconds;
+    Clock::time_point statsStart, lastExecuted;
+};
+
+#endif
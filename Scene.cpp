@@ -0,0 +1,166 @@
+﻿#include "Scene.h"
+
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+/**
+ * @brief Zwraca promień siatki (0 dla pustego lub błędnego wpisu).
+ */
+float Scene::MeshRadius(int meshId) const {
+    if (meshId < 0 || meshId >= (int)meshes.size() || !meshes[meshId]) return 0.0f;
+    return meshes[meshId]->GetBoundingRadius();
+}
+
+/**
+ * @brief Rejestruje siatkę pod nazwą.
+ */
+int Scene::AddMesh(const std::string& name, const Mesh* mesh) {
+    meshes.push_back(mesh);
+    meshNames.push_back(name);
+    return static_cast<int>(meshes.size() - 1);
+}
+
+/**
+ * @brief Podmienia siatkę o danym numerze (aktualizuje promienie obiektów).
+ */
+void Scene::SetMesh(int meshId, const Mesh* mesh) {
+    if (meshId < 0 || meshId >= (int)meshes.size()) return;
+    revision++;
+    meshes[meshId] = mesh;
+
+    float radius = MeshRadius(meshId);
+    for (size_t i = 0; i < meshIds.size(); i++) {
+        if (meshIds[i] == meshId) radii[i] = radius * scales[i];
+    }
+}
+
+/**
+ * @brief Rejestruje materiał pod nazwą.
+ */
+int Scene::AddMaterial(const std::string& name, const SceneMaterial& material) {
+    materials.push_back(material);
+    materialNames.push_back(name);
+    return static_cast<int>(materials.size() - 1);
+}
+
+/**
+ * @brief Wyszukuje siatkę po nazwie.
+ */
+int Scene::FindMesh(const std::string& name) const {
+    for (size_t i = 0; i < meshNames.size(); i++) {
+        if (meshNames[i] == name) return static_cast<int>(i);
+    }
+    return -1;
+}
+
+/**
+ * @brief Wyszukuje materiał po nazwie.
+ */
+int Scene::FindMaterial(const std::string& name) const {
+    for (size_t i = 0; i < materialNames.size(); i++) {
+        if (materialNames[i] == name) return static_cast<int>(i);
+    }
+    return -1;
+}
+
+/**
+ * @brief Dodaje obiekt do sceny.
+ */
+size_t Scene::AddObject(int meshId, int materialId, float x, float y, float z, float scale) {
+    revision++;
+    positionX.push_back(x);
+    positionY.push_back(y);
+    positionZ.push_back(z);
+    scales.push_back(scale);
+    radii.push_back(MeshRadius(meshId) * scale);
+    meshIds.push_back(meshId);
+    materialIds.push_back(materialId);
+    return meshIds.size() - 1;
+}
+
+/**
+ * @brief Ustawia pozycję obiektu.
+ */
+void Scene::SetPosition(size_t object, float x, float y, float z) {
+    revision++;
+    positionX[object] = x;
+    positionY[object] = y;
+    positionZ[object] = z;
+}
+
+/**
+ * @brief Ustawia skalę obiektu.
+ */
+void Scene::SetScale(size_t object, float scale) {
+    revision++;
+    scales[object] = scale;
+    radii[object] = MeshRadius(meshIds[object]) * scale;
+}
+
+/**
+ * @brief Rezerwuje miejsce na podaną liczbę obiektów.
+ */
+void Scene::Reserve(size_t objectCount) {
+    positionX.reserve(objectCount);
+    positionY.reserve(objectCount);
+    positionZ.reserve(objectCount);
+    scales.reserve(objectCount);
+    radii.reserve(objectCount);
+    meshIds.reserve(objectCount);
+    materialIds.reserve(objectCount);
+}
+
+/**
+ * @brief Usuwa wszystkie obiekty (siatki i materiały pozostają).
+ */
+void Scene::ClearObjects() {
+    revision++;
+    positionX.clear();
+    positionY.clear();
+    positionZ.clear();
+    scales.clear();
+    radii.clear();
+    meshIds.clear();
+    materialIds.clear();
+}
+
+/**
+ * @brief Wczytuje obiekty z pliku tekstowego.
+ */
+bool Scene::LoadFromFile(const std::string& filePath) {
+    std::ifstream file(filePath);
+    if (!file) {
+        std::cerr << "[Scene Error] Failed to open scene file: " << filePath << std::endl;
+        return false;
+    }
+
+    bool ok = true;
+    std::string line;
+    int lineNumber = 0;
+    while (std::getline(file, line)) {
+        lineNumber++;
+        std::istringstream stream(line);
+        std::string meshName, materialName;
+        if (!(stream >> meshName) || meshName[0] == '#') continue;
+
+        float x, y, z, scale = 1.0f;
+        if (!(stream >> materialName >> x >> y >> z)) {
+            std::cerr << "[Scene Error] " << filePath << ":" << lineNumber << ": expected <mesh> <material> x y z [scale]" << std::endl;
+            ok = false;
+            continue;
+        }
+        stream >> scale;
+
+        int meshId = FindMesh(meshName);
+        int materialId = FindMaterial(materialName);
+        if (meshId < 0 || materialId < 0) {
+            std::cerr << "[Scene Error] " << filePath << ":" << lineNumber << ": unknown "
+                << (meshId < 0 ? "mesh '" + meshName : "material '" + materialName) << "'" << std::endl;
+            ok = false;
+            continue;
+        }
+        AddObject(meshId, materialId, x, y, z, scale);
+    }
+    return ok;
+}
@@ -0,0 +1,142 @@
+﻿#pragma once
+#ifndef SCENE_H
+#define SCENE_H
+
+#include "Mesh.h"
+#include "TextureCache.h"
+
+#include <string>
+#include <vector>
+
+/**
+ * @brief Materiał obiektu sceny (stan potrzebny do narysowania siatki).
+ */
+struct SceneMaterial {
+    TextureHandle texture = INVALID_TEXTURE;   /**< Tekstura (INVALID_TEXTURE = brak) */
+    float color[4] = { 1.0f, 1.0f, 1.0f, 1.0f }; /**< Kolor bazowy (mnożony przez teksturę) */
+    bool lit = true;                            /**< Czy obiekt podlega oświetleniu */
+    int flatColorVariant = 0;                   /**< Wariant kolorów siatki dla cieniowania płaskiego */
+};
+
+/**
+ * @brief Lista obiektów sceny przechowywana jako struktura tablic (SoA).
+ *
+ * Każda składowa obiektu (pozycja X/Y/Z, skala, promień otaczający,
+ * siatka, materiał) leży w osobnej, ciągłej tablicy indeksowanej numerem
+ * obiektu. Pętle po jednej składowej (np. culling po pozycjach i promieniach)
+ * czytają tylko potrzebne dane.
+ *
+ * Siatki i materiały są rejestrowane w tabelach sceny, a obiekty odwołują
+ * się do nich numerami – podmiana siatki (np. poziomu LOD kuli) wymaga
+ * zmiany jednego wpisu w tabeli, a nie każdego obiektu.
+ */
+class Scene {
+public:
+    Scene() = default;
+
+    Scene(const Scene&) = delete;
+    Scene& operator=(const Scene&) = delete;
+
+    /**
+     * @brief Rejestruje siatkę pod nazwą.
+     * @return Numer siatki używany w AddObject.
+     */
+    int AddMesh(const std::string& name, const Mesh* mesh);
+
+    /**
+     * @brief Podmienia siatkę o danym numerze (aktualizuje promienie obiektów).
+     */
+    void SetMesh(int meshId, const Mesh* mesh);
+
+    /**
+     * @brief Rejestruje materiał pod nazwą.
+     * @return Numer materiału używany w AddObject.
+     */
+    int AddMaterial(const std::string& name, const SceneMaterial& material);
+
+    /**
+     * @brief Wyszukuje siatkę po nazwie.
+     * @return Numer siatki lub -1.
+     */
+    int FindMesh(const std::string& name) const;
+
+    /**
+     * @brief Wyszukuje materiał po nazwie.
+     * @return Numer materiału lub -1.
+     */
+    int FindMaterial(const std::string& name) const;
+
+    /**
+     * @brief Dodaje obiekt do sceny.
+     * @return Numer obiektu.
+     */
+    size_t AddObject(int meshId, int materialId, float x, float y, float z, float scale = 1.0f);
+
+    /**
+     * @brief Ustawia pozycję obiektu.
+     */
+    void SetPosition(size_t object, float x, float y, float z);
+
+    /**
+     * @brief Ustawia skalę obiektu.
+     */
+    void SetScale(size_t object, float scale);
+
+    /**
+     * @brief Rezerwuje miejsce na podaną liczbę obiektów.
+     */
+    void Reserve(size_t objectCount);
+
+    /**
+     * @brief Usuwa wszystkie obiekty (siatki i materiały pozostają).
+     */
+    void ClearObjects();
+
+    /**
+     * @brief Wczytuje obiekty z pliku tekstowego.
+     *
+     * Każdy wiersz: `<siatka> <materiał> x y z [skala]`; wiersze puste
+     * i zaczynające się od '#' są pomijane. Nazwy muszą być wcześniej
+     * zarejestrowane przez AddMesh/AddMaterial.
+     * @return True jeśli plik został otwarty i nie zawierał błędnych wierszy.
+     */
+    bool LoadFromFile(const std::string& filePath);
+
+    size_t GetObjectCount() const { return meshIds.size(); }
+    /// Licznik zmian sceny (rośnie przy każdej modyfikacji obiektów lub siatek)
+    unsigned int GetRevision() const { return revision; }
+    size_t GetMeshCount() const { return meshes.size(); }
+    size_t GetMaterialCount() const { return materials.size(); }
+
+    const Mesh* GetMesh(int meshId) const { return meshes[meshId]; }
+    const SceneMaterial& GetMaterial(int materialId) const { return materials[materialId]; }
+    SceneMaterial& GetMaterial(int materialId) { return materials[materialId]; }
+
+    // === Tablice składowych (SoA) ===
+    const float* GetPositionsX() const { return positionX.data(); }
+    const float* GetPositionsY() const { return positionY.data(); }
+    const float* GetPositionsZ() const { return positionZ.data(); }
+    const float* GetScales() const { return scales.data(); }
+    const float* GetRadii() const { return radii.data(); }
+    const int* GetMeshIds() const { return meshIds.data(); }
+    const int* GetMaterialIds() const { return materialIds.data(); }
+
+private:
+    float MeshRadius(int meshId) const;
+
+    std::vector<const Mesh*> meshes;        /**< Tabela siatek */
+    std::vector<std::string> meshNames;     /**< Nazwy siatek */
+    std::vector<SceneMaterial> materials;   /**< Tabela materiałów */
+    std::vector<std::string> materialNames; /**< Nazwy materiałów */
+
+    std::vector<float> positionX;  /**< Pozycje X obiektów */
+    std::vector<float> positionY;  /**< Pozycje Y obiektów */
+    std::vector<float> positionZ;  /**< Pozycje Z obiektów */
+    std::vector<float> scales;     /**< Skale (jednorodne) obiektów */
+    std::vector<float> radii;      /**< Promienie sfer otaczających w przestrzeni świata */
+    std::vector<int> meshIds;      /**< Numery siatek obiektów */
+    std::vector<int> materialIds;  /**< Numery materiałów obiektów */
+    unsigned int revision = 0;     /**< Licznik zmian */
+};
+
+#endif
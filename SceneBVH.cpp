@@ -0,0 +1,107 @@
+﻿#include "SceneBVH.h"
+
+#include <algorithm>
+
+/**
+ * @brief Buduje drzewo dla sfer (x, y, z, radius).
+ */
+void SceneBVH::Build(const float* x, const float* y, const float* z, const float* radius,
+    size_t count, size_t leafSize) {
+    nodes.clear();
+    order.resize(count);
+    for (size_t i = 0; i < count; i++) order[i] = static_cast<unsigned int>(i);
+    if (count == 0) return;
+
+    nodes.reserve(2 * count / (leafSize > 0 ? leafSize : 1) + 1);
+    BuildNode(x, y, z, radius, 0, static_cast<unsigned int>(count), leafSize > 0 ? leafSize : 1);
+}
+
+/**
+ * @brief Buduje węzeł dla order[start, start + count) i zwraca jego indeks.
+ */
+unsigned int SceneBVH::BuildNode(const float* x, const float* y, const float* z, const float* radius,
+    unsigned int start, unsigned int count, size_t leafSize) {
+    unsigned int index = static_cast<unsigned int>(nodes.size());
+    nodes.push_back(Node());
+
+    Node node;
+    node.min[0] = node.min[1] = node.min[2] = 1e30f;
+    node.max[0] = node.max[1] = node.max[2] = -1e30f;
+    float centerMin[3] = { 1e30f, 1e30f, 1e30f };
+    float centerMax[3] = { -1e30f, -1e30f, -1e30f };
+    for (unsigned int i = start; i < start + count; i++) {
+        unsigned int object = order[i];
+        const float center[3] = { x[object], y[object], z[object] };
+        for (int axis = 0; axis < 3; axis++) {
+            node.min[axis] = std::min(node.min[axis], center[axis] - radius[object]);
+            node.max[axis] = std::max(node.max[axis], center[axis] + radius[object]);
+            centerMin[axis] = std::min(centerMin[axis], center[axis]);
+            centerMax[axis] = std::max(centerMax[axis], center[axis]);
+        }
+    }
+    node.start = start;
+    node.count = count;
+    node.right = 0;
+
+    if (count > leafSize) {
+        // Podział w medianie wzdłuż najdłuższej osi rozrzutu środków
+        int axis = 0;
+        float extent[3] = { centerMax[0] - centerMin[0], centerMax[1] - centerMin[1], centerMax[2] - centerMin[2] };
+        if (extent[1] > extent[axis]) axis = 1;
+        if (extent[2] > extent[axis]) axis = 2;
+        const float* key = axis == 0 ? x : (axis == 1 ? y : z);
+
+        unsigned int half = count / 2;
+        std::nth_element(order.begin() + start, order.begin() + start + half, order.begin() + start + count,
+            [key](unsigned int a, unsigned int b) { return key[a] < key[b]; });
+
+        BuildNode(x, y, z, radius, start, half, leafSize);
+        node.right = BuildNode(x, y, z, radius, start + half, count - half, leafSize);
+    }
+
+    nodes[index] = node;
+    return index;
+}
+
+/**
+ * @brief Wyznacza widoczność obiektów.
+ */
+void SceneBVH::Cull(const Frustum& frustum, const float* x, const float* y, const float* z, const float* radius,
+    unsigned char* visible, CullStats& stats) const {
+    stats = CullStats();
+    stats.objects = order.size();
+    std::fill(visible, visible + order.size(), static_cast<unsigned char>(0));
+    if (nodes.empty()) return;
+
+    unsigned int stack[64];
+    int top = 0;
+    stack[top++] = 0;
+    while (top > 0) {
+        const Node& node = nodes[stack[--top]];
+        stats.nodeTests++;
+
+        FrustumTest test = AabbInFrustum(frustum, node.min, node.max);
+        if (test == FRUSTUM_OUTSIDE) continue;
+
+        if (test == FRUSTUM_INSIDE) {
+            for (unsigned int i = node.start; i < node.start + node.count; i++) visible[order[i]] = 1;
+            stats.visible += node.count;
+        }
+        else if (node.right == 0) {
+            for (unsigned int i = node.start; i < node.start + node.count; i++) {
+                unsigned int object = order[i];
+                stats.sphereTests++;
+                if (SphereInFrustum(frustum, x[object], y[object], z[object], radius[object])) {
+                    visible[object] = 1;
+                    stats.visible++;
+                }
+            }
+        }
+        else if (top + 2 <= 64) {
+            unsigned int index = static_cast<unsigned int>(&node - nodes.data());
+            stack[top++] = node.right;
+            stack[top++] = index + 1;
+        }
+    }
+    stats.culled = stats.objects - stats.visible;
+}
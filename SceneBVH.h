@@ -0,0 +1,66 @@
+﻿#pragma once
+#ifndef SCENE_BVH_H
+#define SCENE_BVH_H
+
+#include "Frustum.h"
+
+#include <vector>
+
+/**
+ * @brief Liczniki jednego przebiegu cullingu.
+ */
+struct CullStats {
+    size_t objects = 0;      /**< Liczba obiektów w scenie */
+    size_t visible = 0;      /**< Obiekty przekazane do rysowania */
+    size_t culled = 0;       /**< Obiekty odrzucone */
+    size_t sphereTests = 0;  /**< Wykonane testy sfer */
+    size_t nodeTests = 0;    /**< Wykonane testy węzłów BVH */
+};
+
+/**
+ * @brief Hierarchia brył otaczających (AABB) nad sferami obiektów sceny.
+ *
+ * Węzeł całkowicie wewnątrz bryły widzenia akceptuje wszystkie swoje
+ * obiekty bez dalszych testów, a węzeł całkowicie poza nią odrzuca je
+ * jednym testem – koszt zależy od liczby węzłów na granicy bryły,
+ * a nie od rozmiaru sceny.
+ */
+class SceneBVH {
+public:
+    /**
+     * @brief Buduje drzewo dla sfer (x, y, z, radius).
+     * @param leafSize Maksymalna liczba obiektów w liściu.
+     */
+    void Build(const float* x, const float* y, const float* z, const float* radius,
+        size_t count, size_t leafSize = 16);
+
+    /**
+     * @brief Wyznacza widoczność obiektów.
+     * @param visible Wynik: 1 dla obiektów widocznych, 0 dla odrzuconych (count elementów).
+     */
+    void Cull(const Frustum& frustum, const float* x, const float* y, const float* z, const float* radius,
+        unsigned char* visible, CullStats& stats) const;
+
+    size_t GetNodeCount() const { return nodes.size(); }
+    size_t GetObjectCount() const { return order.size(); }
+
+private:
+    /**
+     * @brief Węzeł drzewa (dzieci węzła wewnętrznego: index + 1 i right).
+     */
+    struct Node {
+        float min[3];       /**< Minimalny narożnik AABB */
+        float max[3];       /**< Maksymalny narożnik AABB */
+        unsigned int start; /**< Pierwszy obiekt w order */
+        unsigned int count; /**< Liczba obiektów */
+        unsigned int right; /**< Prawe dziecko (0 = liść) */
+    };
+
+    unsigned int BuildNode(const float* x, const float* y, const float* z, const float* radius,
+        unsigned int start, unsigned int count, size_t leafSize);
+
+    std::vector<Node> nodes;          /**< Węzły w kolejności przejścia w głąb */
+    std::vector<unsigned int> order;  /**< Numery obiektów uporządkowane wg liści */
+};
+
+#endif
@@ -0,0 +1,175 @@
+﻿#include "ShaderProgram.h"
+
+#include <iostream>
+#include <vector>
+
+/// Źródło wersji bloków – wersje są unikalne także między różnymi blokami
+static unsigned int nextBlockRevision = 1;
+
+// === UniformBlock ===
+
+/**
+ * @brief Konstruktor klasy UniformBlock (dane wyzerowane).
+ */
+UniformBlock::UniformBlock(const char* name, size_t vec4Count)
+    : name(name), data(vec4Count * 4, 0.0f), revision(nextBlockRevision++) {
+}
+
+/**
+ * @brief Ustawia element vec4 (wersja zmienia się tylko przy innej wartości).
+ */
+void UniformBlock::Set(size_t slot, const float* value) {
+    Set(slot, value[0], value[1], value[2], value[3]);
+}
+
+/**
+ * @brief Ustawia element vec4 z czterech składowych.
+ */
+void UniformBlock::Set(size_t slot, float x, float y, float z, float w) {
+    if (slot >= GetVec4Count()) return;
+    float* target = &data[slot * 4];
+    if (target[0] == x && target[1] == y && target[2] == z && target[3] == w) return;
+    target[0] = x; target[1] = y; target[2] = z; target[3] = w;
+    revision = nextBlockRevision++;
+}
+
+// === ShaderProgram ===
+
+/**
+ * @brief Konstruktor klasy ShaderProgram.
+ */
+ShaderProgram::ShaderProgram() : program(0), blockUploads(0) {
+}
+
+/**
+ * @brief Destruktor klasy ShaderProgram.
+ */
+ShaderProgram::~ShaderProgram() {
+    Release();
+}
+
+/**
+ * @brief Kompiluje pojedynczy shader.
+ * @return Nazwa shadera lub 0 przy błędzie.
+ */
+GLuint ShaderProgram::Compile(GLenum type, const char* source) {
+    GLuint shader = glCreateShader(type);
+    glShaderSource(shader, 1, &source, nullptr);
+    glCompileShader(shader);
+
+    GLint status = 0;
+    glGetShaderiv(shader, GL_COMPILE_STATUS, &status);
+    if (!status) {
+        GLint length = 0;
+        glGetShaderiv(shader, GL_INFO_LOG_LENGTH, &length);
+        std::vector<GLchar> log(length > 1 ? length : 1, '\0');
+        glGetShaderInfoLog(shader, (GLsizei)log.size(), nullptr, log.data());
+        std::cerr << "[ShaderProgram Error] " << name << ": "
+            << (type == GL_VERTEX_SHADER ? "vertex" : "fragment") << " shader compilation failed:\n"
+            << log.data() << std::endl;
+        glDeleteShader(shader);
+        return 0;
+    }
+    return shader;
+}
+
+/**
+ * @brief Kompiluje i linkuje program.
+ */
+bool ShaderProgram::Build(const std::string& name, const char* vertexSource, const char* fragmentSource,
+    const ShaderAttribute* attributes, size_t attributeCount) {
+    Release();
+    this->name = name;
+
+    if (!GetGLCapabilities().shaders) {
+        std::cerr << "[ShaderProgram Error] " << name << ": GLSL is not supported by this context" << std::endl;
+        return false;
+    }
+
+    GLuint vertexShader = Compile(GL_VERTEX_SHADER, vertexSource);
+    GLuint fragmentShader = Compile(GL_FRAGMENT_SHADER, fragmentSource);
+    if (!vertexShader || !fragmentShader) {
+        if (vertexShader) glDeleteShader(vertexShader);
+        if (fragmentShader) glDeleteShader(fragmentShader);
+        return false;
+    }
+
+    program = glCreateProgram();
+    glAttachShader(program, vertexShader);
+    glAttachShader(program, fragmentShader);
+    for (size_t i = 0; i < attributeCount; i++) {
+        glBindAttribLocation(program, attributes[i].index, attributes[i].name);
+    }
+    glLinkProgram(program);
+
+    // Shadery pozostają w programie do jego usunięcia
+    glDeleteShader(vertexShader);
+    glDeleteShader(fragmentShader);
+
+    GLint status = 0;
+    glGetProgramiv(program, GL_LINK_STATUS, &status);
+    if (!status) {
+        GLint length = 0;
+        glGetProgramiv(program, GL_INFO_LOG_LENGTH, &length);
+        std::vector<GLchar> log(length > 1 ? length : 1, '\0');
+        glGetProgramInfoLog(program, (GLsizei)log.size(), nullptr, log.data());
+        std::cerr << "[ShaderProgram Error] " << name << ": link failed:\n" << log.data() << std::endl;
+        Release();
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Usuwa program.
+ */
+void ShaderProgram::Release() {
+    if (program) glDeleteProgram(program);
+    program = 0;
+    uniformLocations.clear();
+    blockRevisions.clear();
+}
+
+/**
+ * @brief Ustawia program jako bieżący.
+ */
+void ShaderProgram::Use() const {
+    glUseProgram(program);
+}
+
+/**
+ * @brief Przywraca potok stałych funkcji (program 0).
+ */
+void ShaderProgram::UseFixedFunction() {
+    if (GetGLCapabilities().shaders) glUseProgram(0);
+}
+
+/**
+ * @brief Zwraca położenie zmiennej uniform (-1 gdy nie istnieje).
+ */
+GLint ShaderProgram::GetUniformLocation(const char* uniformName) const {
+    if (!program) return -1;
+
+    auto it = uniformLocations.find(uniformName);
+    if (it != uniformLocations.end()) return it->second;
+
+    GLint location = glGetUniformLocation(program, uniformName);
+    uniformLocations[uniformName] = location;
+    return location;
+}
+
+/**
+ * @brief Wysyła blok do bieżącego programu, jeśli zmienił się od ostatniej wysyłki.
+ */
+bool ShaderProgram::UploadBlock(const UniformBlock& block) {
+    unsigned int& uploaded = blockRevisions[block.GetName()];
+    if (uploaded == block.GetRevision()) return false;
+
+    GLint location = GetUniformLocation(block.GetName());
+    if (location >= 0) {
+        glUniform4fv(location, static_cast<GLsizei>(block.GetVec4Count()), block.GetData());
+    }
+    uploaded = block.GetRevision();
+    blockUploads++;
+    return true;
+}
@@ -0,0 +1,130 @@
+﻿#pragma once
+#ifndef SHADER_PROGRAM_H
+#define SHADER_PROGRAM_H
+
+#include "GLExtensions.h"
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @brief Powiązanie ogólnego atrybutu wierzchołka z nazwą w shaderze.
+ */
+struct ShaderAttribute {
+    GLuint index;     /**< Numer atrybutu (glVertexAttribPointer) */
+    const char* name; /**< Nazwa zmiennej attribute w shaderze */
+};
+
+/**
+ * @brief Blok zmiennych uniform: tablica vec4 wysyłana jednym glUniform4fv.
+ *
+ * Kontekst OpenGL 2.1 nie ma obiektów UBO, więc blok jest emulowany tablicą
+ * "uniform vec4 nazwa[N]". Każda zmiana danych nadaje blokowi nową wersję
+ * (unikalną między blokami); program wysyła blok tylko wtedy, gdy wersja
+ * różni się od ostatnio wysłanej – dane niezmienione od poprzedniej klatki
+ * nie są wysyłane wcale.
+ */
+class UniformBlock {
+public:
+    /**
+     * @param name Nazwa tablicy uniform w shaderze.
+     * @param vec4Count Liczba elementów vec4.
+     */
+    UniformBlock(const char* name, size_t vec4Count);
+
+    /**
+     * @brief Ustawia element vec4 (wersja zmienia się tylko przy innej wartości).
+     */
+    void Set(size_t slot, const float* value);
+    void Set(size_t slot, float x, float y, float z, float w);
+
+    const char* GetName() const { return name.c_str(); }
+    const float* GetData() const { return data.data(); }
+    const float* Get(size_t slot) const { return &data[slot * 4]; }
+    size_t GetVec4Count() const { return data.size() / 4; }
+    unsigned int GetRevision() const { return revision; }
+
+private:
+    std::string name;        /**< Nazwa tablicy w shaderze */
+    std::vector<float> data; /**< Dane (4 floaty na element) */
+    unsigned int revision;   /**< Wersja danych */
+};
+
+/**
+ * @brief Program GLSL złożony z shadera wierzchołków i fragmentów.
+ *
+ * Błędy kompilacji i linkowania są wypisywane razem z logiem sterownika.
+ * Położenia zmiennych uniform są zapamiętywane po pierwszym zapytaniu.
+ */
+class ShaderProgram {
+public:
+    ShaderProgram();
+    ~ShaderProgram();
+
+    ShaderProgram(const ShaderProgram&) = delete;
+    ShaderProgram& operator=(const ShaderProgram&) = delete;
+
+    /**
+     * @brief Kompiluje i linkuje program.
+     * @param name Nazwa programu (w komunikatach błędów).
+     * @param vertexSource Kod shadera wierzchołków.
+     * @param fragmentSource Kod shadera fragmentów.
+     * @param attributes Atrybuty wiązane z numerami przed linkowaniem.
+     * @param attributeCount Liczba elementów attributes.
+     * @return True jeśli program jest gotowy do użycia.
+     */
+    bool Build(const std::string& name, const char* vertexSource, const char* fragmentSource,
+        const ShaderAttribute* attributes = nullptr, size_t attributeCount = 0);
+
+    /**
+     * @brief Usuwa program.
+     */
+    void Release();
+
+    /**
+     * @brief Ustawia program jako bieżący.
+     */
+    void Use() const;
+
+    /**
+     * @brief Przywraca potok stałych funkcji (program 0).
+     */
+    static void UseFixedFunction();
+
+    /**
+     * @brief Zwraca położenie zmiennej uniform (-1 gdy nie istnieje).
+     *
+     * Pierwsze zapytanie o nazwę trafia do sterownika, kolejne do cache.
+     */
+    GLint GetUniformLocation(const char* uniformName) const;
+
+    /**
+     * @brief Wysyła blok do bieżącego programu, jeśli zmienił się od ostatniej wysyłki.
+     *
+     * Program musi być bieżący (Use).
+     * @return True jeśli dane zostały wysłane.
+     */
+    bool UploadBlock(const UniformBlock& block);
+
+    /**
+     * @brief Zwraca liczbę wysyłek bloków od ostatniego ResetBlockUploads.
+     */
+    unsigned int GetBlockUploads() const { return blockUploads; }
+    void ResetBlockUploads() { blockUploads = 0; }
+
+    bool IsValid() const { return program != 0; }
+    GLuint GetProgram() const { return program; }
+    const std::string& GetName() const { return name; }
+
+private:
+    GLuint Compile(GLenum type, const char* source);
+
+    GLuint program;   /**< Nazwa programu GL */
+    std::string name; /**< Nazwa programu w komunikatach */
+    mutable std::unordered_map<std::string, GLint> uniformLocations; /**< Cache położeń uniform */
+    std::unordered_map<std::string, unsigned int> blockRevisions;   /**< Ostatnio wysłane wersje bloków */
+    unsigned int blockUploads; /**< Licznik wysyłek bloków */
+};
+
+#endif
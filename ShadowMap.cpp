@@ -0,0 +1,236 @@
+﻿#include "ShadowMap.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+/**
+ * @brief Konstruktor klasy ShadowMap.
+ */
+ShadowMap::ShadowMap()
+    : cascadeCount(0), resolution(0), texture(0), fbo(0), lightView(Mat4::Identity()),
+    block("shadowData", MAX_CASCADES * 4 + 2) {
+    for (Mat4& projection : lightProjection) projection = Mat4::Identity();
+}
+
+/**
+ * @brief Destruktor klasy ShadowMap.
+ */
+ShadowMap::~ShadowMap() {
+    ReleaseGPU();
+}
+
+/**
+ * @brief Zmienia ustawienia (tekstura tworzona ponownie przy następnym Prepare).
+ */
+void ShadowMap::SetSettings(const ShadowSettings& newSettings) {
+    settings = newSettings;
+    settings.cascadeCount = std::min(std::max(settings.cascadeCount, 1), MAX_CASCADES);
+    settings.resolution = std::max(settings.resolution, 64);
+}
+
+/**
+ * @brief Sprawdza, czy kontekst obsługuje mapy cieni.
+ */
+bool ShadowMap::IsSupported() {
+    const GLCapabilities& caps = GetGLCapabilities();
+    return caps.framebufferObjects && caps.shaders && caps.depthTextures && caps.multitexture;
+}
+
+/**
+ * @brief Tworzy teksturę i bufor ramki dla bieżących ustawień.
+ */
+bool ShadowMap::Prepare() {
+    if (!IsSupported()) return false;
+
+    // Atlas nie może przekroczyć największego rozmiaru tekstury
+    GLint maxSize = 0;
+    glGetIntegerv(GL_MAX_TEXTURE_SIZE, &maxSize);
+    int wantedResolution = settings.resolution;
+    while (wantedResolution > 64 && wantedResolution * settings.cascadeCount > maxSize) wantedResolution /= 2;
+
+    if (fbo && resolution == wantedResolution && cascadeCount == settings.cascadeCount) return true;
+    ReleaseGPU();
+    resolution = wantedResolution;
+    cascadeCount = settings.cascadeCount;
+
+    glGenTextures(1, &texture);
+    glBindTexture(GL_TEXTURE_2D, texture);
+    // Filtrowanie liniowe z porównaniem: sprzętowe PCF 2x2
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_COMPARE_MODE, GL_COMPARE_R_TO_TEXTURE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_COMPARE_FUNC, GL_LEQUAL);
+    glTexParameteri(GL_TEXTURE_2D, GL_DEPTH_TEXTURE_MODE, GL_LUMINANCE);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH_COMPONENT24, resolution * cascadeCount, resolution, 0,
+        GL_DEPTH_COMPONENT, GL_UNSIGNED_INT, nullptr);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    glGenFramebuffers(1, &fbo);
+    glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, texture, 0);
+    // Bufor bez koloru
+    glDrawBuffer(GL_NONE);
+    glReadBuffer(GL_NONE);
+    GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+    if (status != GL_FRAMEBUFFER_COMPLETE) {
+        std::cerr << "[ShadowMap Error] Incomplete framebuffer (0x" << std::hex << status << std::dec
+            << "), shadows disabled" << std::endl;
+        ReleaseGPU();
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Wyznacza kaskady dla bieżącej kamery.
+ */
+void ShadowMap::Update(const Vec3& lightDirection, const Mat4& view, const Mat4& projection,
+    float nearPlane, float farPlane) {
+    if (!fbo) return;
+
+    // Obrót do układu światła zależy tylko od kierunku – nie od kamery
+    Vec3 direction = Normalize(lightDirection);
+    Vec3 up = std::fabs(direction.y) > 0.99f ? Vec3(0.0f, 0.0f, 1.0f) : Vec3(0.0f, 1.0f, 0.0f);
+    lightView = Mat4::LookAt(Vec3(), -direction, up);
+
+    // Narożniki bliskiej i dalekiej płaszczyzny w układzie świata
+    const Mat4 inverseViewProjection = Inverse(projection * view);
+    Vec3 nearCorners[4], farCorners[4];
+    for (int i = 0; i < 4; i++) {
+        float x = (i & 1) ? 1.0f : -1.0f, y = (i & 2) ? 1.0f : -1.0f;
+        Vec4 n = inverseViewProjection.Transform(Vec4(x, y, -1.0f, 1.0f));
+        Vec4 f = inverseViewProjection.Transform(Vec4(x, y, 1.0f, 1.0f));
+        nearCorners[i] = Vec3(n.x / n.w, n.y / n.w, n.z / n.w);
+        farCorners[i] = Vec3(f.x / f.w, f.y / f.w, f.z / f.w);
+    }
+
+    // Granice kaskad: średnia podziału logarytmicznego i równomiernego
+    const float shadowFar = std::min(settings.distance, farPlane);
+    stats.splits[0] = nearPlane;
+    for (int c = 1; c <= cascadeCount; c++) {
+        float ratio = static_cast<float>(c) / cascadeCount;
+        float logarithmic = nearPlane * std::pow(shadowFar / nearPlane, ratio);
+        float uniform = nearPlane + (shadowFar - nearPlane) * ratio;
+        stats.splits[c] = settings.splitLambda * logarithmic + (1.0f - settings.splitLambda) * uniform;
+    }
+
+    const Mat4 inverseView = Inverse(view);
+    // Przekształca [-1, 1] do współrzędnych tekstury w pasie kaskady atlasu
+    const float atlasScale = 1.0f / cascadeCount;
+    for (int c = 0; c < cascadeCount; c++) {
+        // Wycinek bryły: punkty promieni narożników na głębokościach granic
+        Vec3 corners[8];
+        float t0 = (stats.splits[c] - nearPlane) / (farPlane - nearPlane);
+        float t1 = (stats.splits[c + 1] - nearPlane) / (farPlane - nearPlane);
+        Vec3 center;
+        for (int i = 0; i < 4; i++) {
+            Vec3 ray = farCorners[i] - nearCorners[i];
+            corners[i] = nearCorners[i] + ray * t0;
+            corners[i + 4] = nearCorners[i] + ray * t1;
+            center = center + corners[i] + corners[i + 4];
+        }
+        center = center * (1.0f / 8.0f);
+
+        // Promień zaokrąglony w górę, żeby nie drgał od błędów zaokrągleń
+        float radius = 0.0f;
+        for (const Vec3& corner : corners) radius = std::max(radius, Length(corner - center));
+        radius = std::ceil(radius * 16.0f) / 16.0f;
+
+        // Środek przyciągnięty do siatki tekseli w układzie światła
+        Vec3 lightCenter = lightView.TransformPoint(center);
+        float texel = 2.0f * radius / resolution;
+        lightCenter.x = std::floor(lightCenter.x / texel) * texel;
+        lightCenter.y = std::floor(lightCenter.y / texel) * texel;
+
+        // Bliska płaszczyzna odsunięta o zasięg cieni – obiekty między światłem a wycinkiem też rzucają cień
+        float nearDistance = -lightCenter.z - radius - settings.distance;
+        float farDistance = -lightCenter.z + radius;
+        lightProjection[c] = Mat4::Orthographic(lightCenter.x - radius, lightCenter.x + radius,
+            lightCenter.y - radius, lightCenter.y + radius, nearDistance, farDistance);
+
+        Mat4 lightViewProjection = lightProjection[c] * lightView;
+        ExtractFrustum(lightViewProjection.Data(), casterFrustums[c]);
+
+        Mat4 toAtlas = Mat4::Translation((c + 0.5f) * atlasScale, 0.5f, 0.5f) * Mat4::Scale(0.5f * atlasScale, 0.5f, 0.5f);
+        Mat4 eyeToShadow = toAtlas * lightViewProjection * inverseView;
+        for (int column = 0; column < 4; column++) {
+            const float* m = eyeToShadow.m + column * 4;
+            block.Set(c * 4 + column, m[0], m[1], m[2], m[3]);
+        }
+    }
+
+    // Nieużywane granice bardzo daleko – shader liczy kaskadę jako liczbę granic przed fragmentem
+    float splitEnds[MAX_CASCADES];
+    for (int c = 0; c < MAX_CASCADES; c++) splitEnds[c] = c < cascadeCount ? stats.splits[c + 1] : 1e30f;
+    block.Set(MAX_CASCADES * 4, splitEnds[0], splitEnds[1], splitEnds[2], splitEnds[3]);
+    block.Set(MAX_CASCADES * 4 + 1, static_cast<float>(cascadeCount),
+        1.0f / (resolution * cascadeCount), 1.0f / resolution, 0.0f);
+}
+
+/**
+ * @brief Ustawia bufor ramki, obszar atlasu i macierze do rysowania kaskady.
+ */
+void ShadowMap::BeginCascade(int cascade) {
+    if (cascade == 0) {
+        glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+        glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
+        glDisable(GL_LIGHTING);
+        glDisable(GL_TEXTURE_2D);
+        glEnable(GL_DEPTH_TEST);
+        glEnable(GL_SCISSOR_TEST);
+        // Przesunięcie głębokości zamiast stałego biasu w shaderze – zależy od nachylenia
+        glEnable(GL_POLYGON_OFFSET_FILL);
+        glPolygonOffset(2.0f, 4.0f);
+    }
+    glViewport(cascade * resolution, 0, resolution, resolution);
+    glScissor(cascade * resolution, 0, resolution, resolution);
+    glClear(GL_DEPTH_BUFFER_BIT);
+
+    glMatrixMode(GL_PROJECTION);
+    glLoadMatrixf(lightProjection[cascade].Data());
+    glMatrixMode(GL_MODELVIEW);
+    glLoadMatrixf(lightView.Data());
+}
+
+/**
+ * @brief Przywraca domyślny bufor ramki i stan po rysowaniu kaskad.
+ */
+void ShadowMap::End() {
+    glDisable(GL_POLYGON_OFFSET_FILL);
+    glDisable(GL_SCISSOR_TEST);
+    glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+/**
+ * @brief Wiąże teksturę głębokości z jednostką unit.
+ */
+void ShadowMap::BindTexture(int unit) const {
+    glActiveTexture(GL_TEXTURE0 + unit);
+    glBindTexture(GL_TEXTURE_2D, texture);
+    glActiveTexture(GL_TEXTURE0);
+}
+
+/**
+ * @brief Odwiązuje teksturę z jednostki unit.
+ */
+void ShadowMap::UnbindTexture(int unit) const {
+    glActiveTexture(GL_TEXTURE0 + unit);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    glActiveTexture(GL_TEXTURE0);
+}
+
+/**
+ * @brief Zwalnia teksturę i bufor ramki.
+ */
+void ShadowMap::ReleaseGPU() {
+    if (fbo) glDeleteFramebuffers(1, &fbo);
+    if (texture) glDeleteTextures(1, &texture);
+    fbo = texture = 0;
+    resolution = cascadeCount = 0;
+}
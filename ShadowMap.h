@@ -0,0 +1,134 @@
+﻿#pragma once
+#ifndef SHADOW_MAP_H
+#define SHADOW_MAP_H
+
+#include "Frustum.h"
+#include "MathLib.h"
+#include "ShaderProgram.h"
+
+/**
+ * @brief Ustawienia kaskadowych map cieni.
+ */
+struct ShadowSettings {
+    int resolution = 2048;      /**< Rozmiar mapy jednej kaskady w tekselach */
+    int cascadeCount = 3;       /**< Liczba kaskad (1..ShadowMap::MAX_CASCADES) */
+    float distance = 60.0f;     /**< Zasięg cieni od kamery */
+    float splitLambda = 0.75f;  /**< Podział kaskad: 0 – równomierny, 1 – logarytmiczny */
+};
+
+/**
+ * @brief Liczniki ostatniego przebiegu cieni.
+ */
+struct ShadowStats {
+    size_t casters[4] = {};     /**< Rysowane obiekty rzucające cień w każdej kaskadzie (MAX_CASCADES) */
+    size_t totalCasters = 0;    /**< Suma casters */
+    size_t nodeTests = 0;       /**< Testy węzłów BVH we wszystkich kaskadach */
+    float splits[5] = {};       /**< Granice kaskad (głębokość w układzie kamery) */
+};
+
+/**
+ * @brief Kaskadowe mapy cieni dla światła kierunkowego.
+ *
+ * Zakres [near, distance] bryły widzenia dzielony jest na kaskady. Każda
+ * kaskada obejmuje sferę otaczającą swój wycinek bryły, więc rozmiar jej
+ * projekcji nie zależy od obrotu kamery, a środek przyciągany jest do siatki
+ * tekseli w układzie światła – krawędzie cieni nie migoczą przy ruchu kamery.
+ *
+ * Mapy wszystkich kaskad leżą obok siebie w jednej teksturze głębokości
+ * (GL 2.1 nie ma tablic tekstur). Blok uniform "shadowData" zawiera
+ * macierze z układu kamery do współrzędnych atlasu i granice kaskad.
+ */
+class ShadowMap {
+public:
+    static const int MAX_CASCADES = 4;  /**< Najwięcej kaskad (rozmiar bloku shadowData) */
+
+    ShadowMap();
+    ~ShadowMap();
+
+    ShadowMap(const ShadowMap&) = delete;
+    ShadowMap& operator=(const ShadowMap&) = delete;
+
+    /**
+     * @brief Zmienia ustawienia (tekstura tworzona ponownie przy następnym Prepare).
+     */
+    void SetSettings(const ShadowSettings& settings);
+    const ShadowSettings& GetSettings() const { return settings; }
+
+    /**
+     * @brief Sprawdza, czy kontekst obsługuje mapy cieni (FBO, GLSL, tekstury głębokości).
+     */
+    static bool IsSupported();
+
+    /**
+     * @brief Tworzy teksturę i bufor ramki, jeśli jeszcze nie istnieją lub zmieniły się ustawienia.
+     * @return False jeśli mapy cieni nie są dostępne.
+     */
+    bool Prepare();
+
+    /**
+     * @brief Wyznacza kaskady dla bieżącej kamery.
+     * @param lightDirection Kierunek do światła w układzie świata.
+     * @param view Macierz widoku kamery.
+     * @param projection Macierz projekcji kamery.
+     * @param nearPlane Bliska płaszczyzna projekcji.
+     * @param farPlane Daleka płaszczyzna projekcji.
+     */
+    void Update(const Vec3& lightDirection, const Mat4& view, const Mat4& projection,
+        float nearPlane, float farPlane);
+
+    /**
+     * @brief Bryła kaskady wydłużona w stronę światła (do odrzucania obiektów rzucających cień).
+     */
+    const Frustum& GetCasterFrustum(int cascade) const { return casterFrustums[cascade]; }
+
+    /**
+     * @brief Ustawia bufor ramki, obszar atlasu i macierze do rysowania kaskady.
+     *
+     * Wyłącza zapis koloru, oświetlenie i tekstury; stan przywraca End.
+     */
+    void BeginCascade(int cascade);
+
+    /**
+     * @brief Przywraca domyślny bufor ramki i stan po rysowaniu kaskad.
+     *
+     * Viewport i macierze kamery ustawia ponownie wywołujący.
+     */
+    void End();
+
+    /**
+     * @brief Wiąże teksturę głębokości z jednostką unit.
+     */
+    void BindTexture(int unit) const;
+
+    /**
+     * @brief Odwiązuje teksturę z jednostki unit.
+     */
+    void UnbindTexture(int unit) const;
+
+    /**
+     * @brief Zwalnia teksturę i bufor ramki.
+     */
+    void ReleaseGPU();
+
+    int GetCascadeCount() const { return cascadeCount; }
+    int GetResolution() const { return resolution; }
+    const UniformBlock& GetBlock() const { return block; }
+    ShadowStats& GetStats() { return stats; }
+    const ShadowStats& GetStats() const { return stats; }
+
+private:
+    ShadowSettings settings;  /**< Żądane ustawienia */
+    int cascadeCount;         /**< Kaskady bieżącej tekstury */
+    int resolution;           /**< Rozmiar kaskady bieżącej tekstury */
+
+    GLuint texture;           /**< Atlas głębokości (cascadeCount * resolution x resolution) */
+    GLuint fbo;               /**< Bufor ramki z atlasem jako buforem głębokości */
+
+    Mat4 lightProjection[MAX_CASCADES]; /**< Projekcje kaskad (przyciągnięte do tekseli) */
+    Mat4 lightView;                     /**< Obrót do układu światła */
+    Frustum casterFrustums[MAX_CASCADES]; /**< Bryły kaskad wydłużone w stronę światła */
+    UniformBlock block;       /**< Macierze kaskad i granice dla shadera */
+    ShadowStats stats;        /**< Liczniki ostatniej klatki */
+};
+
+#endif
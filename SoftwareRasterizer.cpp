@@ -0,0 +1,664 @@
+﻿#include "SoftwareRasterizer.h"
+#include "JobSystem.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+
+/// Wierzchołki jednego zadania transformacji
+static const size_t VERTICES_PER_TASK = 4096;
+/// Największa współrzędna ekranu w jednostkach 1/16 piksela (iloczyny krawędzi mieszczą się w int64)
+static const float MAX_FIXED_COORDINATE = 67108864.0f;
+
+/**
+ * @brief Liniowa interpolacja wierzchołków (przycinanie).
+ */
+template <typename Vertex>
+static Vertex LerpVertex(const Vertex& a, const Vertex& b, float t) {
+    Vertex result;
+    for (int i = 0; i < 4; i++) result.clip[i] = a.clip[i] + (b.clip[i] - a.clip[i]) * t;
+    for (int i = 0; i < 2; i++) result.uv[i] = a.uv[i] + (b.uv[i] - a.uv[i]) * t;
+    for (int i = 0; i < 4; i++) result.rgba[i] = a.rgba[i] + (b.rgba[i] - a.rgba[i]) * t;
+    return result;
+}
+
+/**
+ * @brief Odległość od bliskiej płaszczyzny obcinania (z >= -w).
+ */
+template <typename Vertex>
+static float NearDistance(const Vertex& vertex) {
+    return vertex.clip[2] + vertex.clip[3];
+}
+
+static unsigned char ToByte(float value) {
+    value = std::min(std::max(value, 0.0f), 1.0f);
+    return static_cast<unsigned char>(value * 255.0f + 0.5f);
+}
+
+/**
+ * @brief Próbkuje teksturę RGBA filtrem dwuliniowym z powtarzaniem (GL_REPEAT).
+ */
+static void SampleBilinear(const BitmapHandler& texture, float u, float v, float out[4]) {
+    const int w = texture.GetWidth();
+    const int h = texture.GetHeight();
+    const unsigned char* data = texture.GetData();
+
+    float x = u * w - 0.5f;
+    float y = v * h - 0.5f;
+    float fx = std::floor(x), fy = std::floor(y);
+    float ax = x - fx, ay = y - fy;
+    int x0 = static_cast<int>(fx) % w, y0 = static_cast<int>(fy) % h;
+    if (x0 < 0) x0 += w;
+    if (y0 < 0) y0 += h;
+    int x1 = x0 + 1 == w ? 0 : x0 + 1;
+    int y1 = y0 + 1 == h ? 0 : y0 + 1;
+
+    const unsigned char* t00 = data + (static_cast<size_t>(y0) * w + x0) * 4;
+    const unsigned char* t10 = data + (static_cast<size_t>(y0) * w + x1) * 4;
+    const unsigned char* t01 = data + (static_cast<size_t>(y1) * w + x0) * 4;
+    const unsigned char* t11 = data + (static_cast<size_t>(y1) * w + x1) * 4;
+    const float scale = 1.0f / 255.0f;
+    for (int c = 0; c < 4; c++) {
+        float top = t00[c] + (t10[c] - t00[c]) * ax;
+        float bottom = t01[c] + (t11[c] - t01[c]) * ax;
+        out[c] = (top + (bottom - top) * ay) * scale;
+    }
+}
+
+/**
+ * @brief Konstruktor klasy SoftwareRasterizer.
+ */
+SoftwareRasterizer::SoftwareRasterizer(int threadCount)
+    : width(0), height(0), tilesX(0), tilesY(0), clearPending(false),
+    viewProjection(Mat4::Identity()), lighting(nullptr), smoothShading(true), jobs(nullptr) {
+    for (int i = 0; i < 4; i++) clearColor[i] = 0;
+    SetThreadCount(threadCount);
+}
+
+/**
+ * @brief Destruktor klasy SoftwareRasterizer.
+ */
+SoftwareRasterizer::~SoftwareRasterizer() {
+}
+
+/**
+ * @brief Zmienia liczbę wątków (0: wspólny system zadań silnika).
+ */
+void SoftwareRasterizer::SetThreadCount(int threadCount) {
+    if (threadCount <= 0) {
+        ownJobs.reset();
+        jobs = &GetJobSystem();
+        return;
+    }
+    if (ownJobs && ownJobs->GetThreadCount() == threadCount) return;
+    ownJobs.reset();
+    ownJobs.reset(new JobSystem(threadCount));
+    jobs = ownJobs.get();
+}
+
+/**
+ * @brief Zwraca liczbę wątków.
+ */
+int SoftwareRasterizer::GetThreadCount() const {
+    return jobs->GetThreadCount();
+}
+
+/**
+ * @brief Zmienia rozmiar bufora ramki.
+ */
+void SoftwareRasterizer::Resize(int newWidth, int newHeight) {
+    width = std::max(newWidth, 1);
+    height = std::max(newHeight, 1);
+    tilesX = (width + TILE_SIZE - 1) / TILE_SIZE;
+    tilesY = (height + TILE_SIZE - 1) / TILE_SIZE;
+    color.assign(static_cast<size_t>(width) * height * 4, 0);
+    depth.assign(static_cast<size_t>(width) * height, 1.0f);
+}
+
+/**
+ * @brief Zleca czyszczenie koloru i głębokości.
+ */
+void SoftwareRasterizer::Clear(const float rgba[4]) {
+    for (int i = 0; i < 4; i++) clearColor[i] = ToByte(rgba[i]);
+    clearPending = true;
+}
+
+/**
+ * @brief Ustawia kamerę dla kolejnych DrawMesh.
+ */
+void SoftwareRasterizer::SetCamera(const Mat4& view, const Mat4& projection) {
+    viewProjection = projection * view;
+    eyePosition = Inverse(view).TransformPoint(Vec3(0.0f, 0.0f, 0.0f));
+}
+
+/**
+ * @brief Zapamiętuje narysowanie siatki.
+ */
+void SoftwareRasterizer::DrawMesh(const Mesh& mesh, const Mat4& model, const float rgba[4],
+    const BitmapHandler* texture, bool lit, int colorVariant) {
+    if (mesh.GetIndexCount() == 0) return;
+    if (texture && (!texture->GetData() || texture->GetChannels() != 4)) texture = nullptr;
+
+    DrawCall draw;
+    draw.mesh = &mesh;
+    draw.variantColors = mesh.GetColorVariant(colorVariant);
+    draw.model = model;
+    draw.modelViewProjection = viewProjection * model;
+    for (int i = 0; i < 4; i++) draw.color[i] = rgba[i];
+    draw.texture = texture;
+    draw.lit = lit && lighting != nullptr;
+    draw.firstVertex = 0;
+    draws.push_back(draw);
+}
+
+/**
+ * @brief Transformuje i oświetla wierzchołki fragmentu jednego wywołania.
+ *
+ * Oświetlenie jak w potoku stałych funkcji z GL_COLOR_MATERIAL: kolor
+ * wierzchołka jest materiałem ambient i diffuse, odbicie zwierciadlane
+ * (Blinn-Phong, obserwator lokalny) pochodzi z LightingState.
+ */
+void SoftwareRasterizer::TransformVertices(const SetupTask& task) {
+    const DrawCall& draw = draws[task.draw];
+    const MeshVertex* source = draw.mesh->GetVertices().data();
+    ClipVertex* target = vertices.data() + draw.firstVertex;
+    const float* m = draw.modelViewProjection.Data();
+
+    const float* globalAmbient = nullptr;
+    const float* specular = nullptr;
+    int lightCount = 0;
+    if (draw.lit) {
+        globalAmbient = lighting->GetMaterialBlock().Get(1);
+        specular = lighting->GetMaterialBlock().Get(0);
+        lightCount = lighting->GetLightCount();
+    }
+
+    for (size_t i = task.first; i < task.first + task.count; i++) {
+        const MeshVertex& in = source[i];
+        ClipVertex& out = target[i];
+        const float x = in.position[0], y = in.position[1], z = in.position[2];
+        for (int r = 0; r < 4; r++) out.clip[r] = m[r] * x + m[4 + r] * y + m[8 + r] * z + m[12 + r];
+        out.uv[0] = in.uv[0];
+        out.uv[1] = in.uv[1];
+
+        const float* vertexColor = draw.variantColors ? draw.variantColors[i].rgba : in.color;
+        float base[4];
+        for (int c = 0; c < 4; c++) base[c] = vertexColor[c] * draw.color[c];
+
+        if (!draw.lit) {
+            for (int c = 0; c < 4; c++) out.rgba[c] = base[c];
+            continue;
+        }
+
+        const Vec3 position = draw.model.TransformPoint(Vec3(x, y, z));
+        const Vec3 normal = Normalize(draw.model.TransformVector(Vec3(in.normal[0], in.normal[1], in.normal[2])));
+        const Vec3 toEye = Normalize(eyePosition - position);
+        float lit[3] = { globalAmbient[0] * base[0], globalAmbient[1] * base[1], globalAmbient[2] * base[2] };
+        for (int l = 0; l < lightCount; l++) {
+            const LightSource& light = lighting->GetLight(l);
+            const Vec3 lightPosition(light.position[0], light.position[1], light.position[2]);
+            const Vec3 toLight = Normalize(light.position[3] == 0.0f ? lightPosition : lightPosition - position);
+            const float diffuse = std::max(Dot(normal, toLight), 0.0f);
+            float highlight = 0.0f;
+            if (diffuse > 0.0f && specular[3] > 0.0f) {
+                highlight = std::pow(std::max(Dot(normal, Normalize(toLight + toEye)), 0.0f), specular[3]);
+            }
+            for (int c = 0; c < 3; c++) {
+                lit[c] += light.ambient[c] * base[c] + light.diffuse[c] * base[c] * diffuse
+                    + light.specular[c] * specular[c] * highlight;
+            }
+        }
+        for (int c = 0; c < 3; c++) out.rgba[c] = std::min(lit[c], 1.0f);
+        out.rgba[3] = base[3];
+    }
+}
+
+/**
+ * @brief Przycina, przygotowuje i dzieli na kafelki prymitywy fragmentu wywołania.
+ */
+void SoftwareRasterizer::SetupPrimitives(SetupTask& task) {
+    task.primitives.clear();
+    task.bins.clear();
+    task.tileOffsets.assign(static_cast<size_t>(tilesX) * tilesY, 0);
+    task.culled = 0;
+    task.clipped = 0;
+
+    const DrawCall& draw = draws[task.draw];
+    const unsigned int* indices = draw.mesh->GetIndices().data();
+    const ClipVertex* source = vertices.data() + draw.firstVertex;
+
+    if (draw.mesh->GetPrimitive() == GL_LINES) {
+        for (size_t p = task.first; p < task.first + task.count; p++) {
+            ClipVertex a = source[indices[p * 2]];
+            ClipVertex b = source[indices[p * 2 + 1]];
+            const float da = NearDistance(a), db = NearDistance(b);
+            if (da < 0.0f && db < 0.0f) {
+                task.culled++;
+                continue;
+            }
+            if (da < 0.0f || db < 0.0f) {
+                ClipVertex cut = LerpVertex(a, b, da / (da - db));
+                if (da < 0.0f) a = cut;
+                else b = cut;
+                task.clipped++;
+            }
+            EmitLine(task, a, b);
+        }
+        return;
+    }
+
+    for (size_t p = task.first; p < task.first + task.count; p++) {
+        const ClipVertex* corners[3] = {
+            &source[indices[p * 3]], &source[indices[p * 3 + 1]], &source[indices[p * 3 + 2]]
+        };
+        // Cieniowanie płaskie: kolor ostatniego wierzchołka, także po przycięciu
+        const float* flatColor = corners[2]->rgba;
+
+        float distance[3];
+        int inside = 0;
+        for (int i = 0; i < 3; i++) {
+            distance[i] = NearDistance(*corners[i]);
+            if (distance[i] >= 0.0f) inside++;
+        }
+        if (inside == 0) {
+            task.culled++;
+            continue;
+        }
+        if (inside == 3) {
+            ClipVertex triangle[3] = { *corners[0], *corners[1], *corners[2] };
+            EmitTriangle(task, triangle, flatColor);
+            continue;
+        }
+
+        // Sutherland-Hodgman względem bliskiej płaszczyzny: 3 lub 4 wierzchołki
+        ClipVertex polygon[4];
+        int count = 0;
+        for (int i = 0; i < 3; i++) {
+            const int j = (i + 1) % 3;
+            if (distance[i] >= 0.0f) polygon[count++] = *corners[i];
+            if ((distance[i] >= 0.0f) != (distance[j] >= 0.0f)) {
+                polygon[count++] = LerpVertex(*corners[i], *corners[j], distance[i] / (distance[i] - distance[j]));
+            }
+        }
+        task.clipped++;
+        for (int i = 1; i + 1 < count; i++) {
+            ClipVertex triangle[3] = { polygon[0], polygon[i], polygon[i + 1] };
+            EmitTriangle(task, triangle, flatColor);
+        }
+    }
+}
+
+/**
+ * @brief Przygotowuje przycięty trójkąt i dopisuje go do kafelków, które pokrywa.
+ */
+void SoftwareRasterizer::EmitTriangle(SetupTask& task, const ClipVertex* triangle, const float flatColor[4]) {
+    Primitive primitive;
+    int64_t fx[3], fy[3];
+    const float fixedScale = static_cast<float>(1 << SUBPIXEL_BITS);
+    for (int i = 0; i < 3; i++) {
+        const float invW = 1.0f / triangle[i].clip[3];
+        const float sx = (triangle[i].clip[0] * invW * 0.5f + 0.5f) * width * fixedScale;
+        const float sy = (triangle[i].clip[1] * invW * 0.5f + 0.5f) * height * fixedScale;
+        if (std::fabs(sx) > MAX_FIXED_COORDINATE || std::fabs(sy) > MAX_FIXED_COORDINATE) {
+            task.culled++;
+            return;
+        }
+        fx[i] = static_cast<int64_t>(std::lrint(sx));
+        fy[i] = static_cast<int64_t>(std::lrint(sy));
+        primitive.z[i] = triangle[i].clip[2] * invW * 0.5f + 0.5f;
+        primitive.invW[i] = invW;
+        primitive.u[i] = triangle[i].uv[0] * invW;
+        primitive.v[i] = triangle[i].uv[1] * invW;
+        for (int c = 0; c < 4; c++) primitive.rgba[i][c] = triangle[i].rgba[c] * invW;
+    }
+
+    // Podwojone pole ze znakiem: dodatnie dla ścian przednich (CCW, oś Y w górę)
+    const int64_t area = (fx[1] - fx[0]) * (fy[2] - fy[0]) - (fx[2] - fx[0]) * (fy[1] - fy[0]);
+    if (area <= 0) {
+        task.culled++;
+        return;
+    }
+
+    // Piksele, których środki (x * 16 + 8) leżą w prostokącie otaczającym
+    const int64_t half = 1 << (SUBPIXEL_BITS - 1);
+    const int64_t minFx = std::min(fx[0], std::min(fx[1], fx[2])), maxFx = std::max(fx[0], std::max(fx[1], fx[2]));
+    const int64_t minFy = std::min(fy[0], std::min(fy[1], fy[2])), maxFy = std::max(fy[0], std::max(fy[1], fy[2]));
+    primitive.minX = static_cast<int>(std::max<int64_t>((minFx - half + (1 << SUBPIXEL_BITS) - 1) >> SUBPIXEL_BITS, 0));
+    primitive.minY = static_cast<int>(std::max<int64_t>((minFy - half + (1 << SUBPIXEL_BITS) - 1) >> SUBPIXEL_BITS, 0));
+    primitive.maxX = static_cast<int>(std::min<int64_t>((maxFx - half) >> SUBPIXEL_BITS, width - 1));
+    primitive.maxY = static_cast<int>(std::min<int64_t>((maxFy - half) >> SUBPIXEL_BITS, height - 1));
+    if (primitive.minX > primitive.maxX || primitive.minY > primitive.maxY) {
+        task.culled++;
+        return;
+    }
+
+    // Krawędź i -> j; waga wierzchołka naprzeciw krawędzi (j + 1) % 3
+    for (int i = 0; i < 3; i++) {
+        const int j = (i + 1) % 3;
+        const int64_t a = fy[i] - fy[j];
+        const int64_t b = fx[j] - fx[i];
+        // Reguła lewej-górnej krawędzi (CCW, oś Y w górę): krawędź lewa idzie w dół, górna w lewo
+        const bool topLeft = a > 0 || (a == 0 && b < 0);
+        primitive.edgeA[i] = a;
+        primitive.edgeB[i] = b;
+        primitive.edgeC[i] = -a * fx[i] - b * fy[i] - (topLeft ? 0 : 1);
+    }
+    primitive.invArea = 1.0f / static_cast<float>(area);
+    for (int c = 0; c < 4; c++) primitive.flatColor[c] = flatColor[c];
+    primitive.draw = task.draw;
+    primitive.line = false;
+
+    const uint32_t index = static_cast<uint32_t>(task.primitives.size());
+    task.primitives.push_back(primitive);
+    for (int ty = primitive.minY / TILE_SIZE; ty <= primitive.maxY / TILE_SIZE; ty++) {
+        for (int tx = primitive.minX / TILE_SIZE; tx <= primitive.maxX / TILE_SIZE; tx++) {
+            const uint32_t tile = static_cast<uint32_t>(ty * tilesX + tx);
+            task.bins.push_back(static_cast<uint64_t>(tile) << 32 | index);
+            task.tileOffsets[tile]++;
+        }
+    }
+}
+
+/**
+ * @brief Przygotowuje przycięty odcinek i dopisuje go do kafelków prostokąta otaczającego.
+ */
+void SoftwareRasterizer::EmitLine(SetupTask& task, const ClipVertex& a, const ClipVertex& b) {
+    Primitive primitive;
+    const ClipVertex* ends[2] = { &a, &b };
+    for (int i = 0; i < 2; i++) {
+        const float invW = 1.0f / ends[i]->clip[3];
+        primitive.lineX[i] = (ends[i]->clip[0] * invW * 0.5f + 0.5f) * width;
+        primitive.lineY[i] = (ends[i]->clip[1] * invW * 0.5f + 0.5f) * height;
+        primitive.z[i] = ends[i]->clip[2] * invW * 0.5f + 0.5f;
+        for (int c = 0; c < 4; c++) primitive.rgba[i][c] = ends[i]->rgba[c];
+        if (std::fabs(primitive.lineX[i]) * 16.0f > MAX_FIXED_COORDINATE
+            || std::fabs(primitive.lineY[i]) * 16.0f > MAX_FIXED_COORDINATE) {
+            task.culled++;
+            return;
+        }
+    }
+    primitive.minX = std::max(static_cast<int>(std::floor(std::min(primitive.lineX[0], primitive.lineX[1]))), 0);
+    primitive.minY = std::max(static_cast<int>(std::floor(std::min(primitive.lineY[0], primitive.lineY[1]))), 0);
+    primitive.maxX = std::min(static_cast<int>(std::floor(std::max(primitive.lineX[0], primitive.lineX[1]))), width - 1);
+    primitive.maxY = std::min(static_cast<int>(std::floor(std::max(primitive.lineY[0], primitive.lineY[1]))), height - 1);
+    if (primitive.minX > primitive.maxX || primitive.minY > primitive.maxY) {
+        task.culled++;
+        return;
+    }
+    primitive.draw = task.draw;
+    primitive.line = true;
+
+    const uint32_t index = static_cast<uint32_t>(task.primitives.size());
+    task.primitives.push_back(primitive);
+    for (int ty = primitive.minY / TILE_SIZE; ty <= primitive.maxY / TILE_SIZE; ty++) {
+        for (int tx = primitive.minX / TILE_SIZE; tx <= primitive.maxX / TILE_SIZE; tx++) {
+            const uint32_t tile = static_cast<uint32_t>(ty * tilesX + tx);
+            task.bins.push_back(static_cast<uint64_t>(tile) << 32 | index);
+            task.tileOffsets[tile]++;
+        }
+    }
+}
+
+/**
+ * @brief Rysuje wszystkie zapamiętane wywołania.
+ */
+void SoftwareRasterizer::Flush() {
+    stats = RasterStats();
+    if (width == 0 || (draws.empty() && !clearPending)) return;
+    auto start = std::chrono::steady_clock::now();
+
+    // --- Etap 1: transformacja wierzchołków (fragmenty po VERTICES_PER_TASK) ---
+    size_t vertexCount = 0;
+    size_t vertexTaskCount = 0, setupTaskCount = 0;
+    for (DrawCall& draw : draws) {
+        draw.firstVertex = vertexCount;
+        vertexCount += draw.mesh->GetVertexCount();
+        vertexTaskCount += (draw.mesh->GetVertexCount() + VERTICES_PER_TASK - 1) / VERTICES_PER_TASK;
+        const bool lines = draw.mesh->GetPrimitive() == GL_LINES;
+        const size_t primitives = draw.mesh->GetIndexCount() / (lines ? 2 : 3);
+        (lines ? stats.lines : stats.triangles) += primitives;
+        setupTaskCount += (primitives + TRIANGLES_PER_TASK - 1) / TRIANGLES_PER_TASK;
+    }
+    vertices.resize(vertexCount);
+    vertexTasks.resize(vertexTaskCount);
+    // Zmniejszanie listy zadań zwolniłoby bufory prymitywów – nadmiarowe zadania są pomijane
+    if (tasks.size() < setupTaskCount) tasks.resize(setupTaskCount);
+
+    size_t vertexTask = 0, setupTask = 0;
+    for (uint32_t d = 0; d < draws.size(); d++) {
+        const Mesh& mesh = *draws[d].mesh;
+        for (size_t first = 0; first < mesh.GetVertexCount(); first += VERTICES_PER_TASK) {
+            SetupTask& task = vertexTasks[vertexTask++];
+            task.draw = d;
+            task.first = first;
+            task.count = std::min(VERTICES_PER_TASK, mesh.GetVertexCount() - first);
+        }
+        const size_t primitives = mesh.GetIndexCount() / (mesh.GetPrimitive() == GL_LINES ? 2 : 3);
+        for (size_t first = 0; first < primitives; first += TRIANGLES_PER_TASK) {
+            SetupTask& task = tasks[setupTask++];
+            task.draw = d;
+            task.first = first;
+            task.count = std::min(static_cast<size_t>(TRIANGLES_PER_TASK), primitives - first);
+        }
+    }
+    jobs->ParallelFor(vertexTaskCount, 1, [this](size_t begin, size_t end) {
+        for (size_t t = begin; t < end; t++) TransformVertices(vertexTasks[t]);
+    });
+
+    // --- Etap 2: przycinanie, przygotowanie i podział na kafelki ---
+    jobs->ParallelFor(setupTaskCount, 1, [this](size_t begin, size_t end) {
+        for (size_t t = begin; t < end; t++) SetupPrimitives(tasks[t]);
+    });
+
+    // Listy kafelków: zliczenie po (kafelek, zadanie), potem rozproszenie równoległe
+    const int tileCount = tilesX * tilesY;
+    tileStart.assign(tileCount + 1, 0);
+    uint32_t offset = 0;
+    for (int tile = 0; tile < tileCount; tile++) {
+        tileStart[tile] = offset;
+        for (size_t t = 0; t < setupTaskCount; t++) {
+            const uint32_t count = tasks[t].tileOffsets[tile];
+            tasks[t].tileOffsets[tile] = offset;
+            offset += count;
+        }
+    }
+    tileStart[tileCount] = offset;
+    tileItems.resize(offset);
+    jobs->ParallelFor(setupTaskCount, 1, [this](size_t begin, size_t end) {
+        for (size_t t = begin; t < end; t++) {
+            SetupTask& task = tasks[t];
+            for (uint64_t bin : task.bins) {
+                const uint32_t tile = static_cast<uint32_t>(bin >> 32);
+                tileItems[task.tileOffsets[tile]++] = static_cast<uint64_t>(t) << 32 | (bin & 0xFFFFFFFFu);
+            }
+        }
+    });
+    for (size_t t = 0; t < setupTaskCount; t++) {
+        stats.culled += tasks[t].culled;
+        stats.clipped += tasks[t].clipped;
+    }
+    stats.binned = offset;
+
+    auto setupEnd = std::chrono::steady_clock::now();
+    stats.setupMs = std::chrono::duration<double, std::milli>(setupEnd - start).count();
+
+    // --- Etap 3: rasteryzacja kafelków (czyszczenie w tym samym przebiegu) ---
+    tilePixels.assign(tileCount, 0);
+    jobs->ParallelFor(tileCount, 1, [this](size_t begin, size_t end) {
+        for (size_t tile = begin; tile < end; tile++) tilePixels[tile] = RasterizeTile(static_cast<int>(tile));
+    });
+    for (size_t pixels : tilePixels) stats.pixels += pixels;
+    clearPending = false;
+    draws.clear();
+
+    stats.rasterMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - setupEnd).count();
+}
+
+/**
+ * @brief Czyści kafelek (jeśli zlecono) i rysuje jego prymitywy w kolejności wywołań.
+ * @return Liczba zapisanych pikseli.
+ */
+size_t SoftwareRasterizer::RasterizeTile(int tile) {
+    const int x0 = (tile % tilesX) * TILE_SIZE;
+    const int y0 = (tile / tilesX) * TILE_SIZE;
+    const int x1 = std::min(x0 + TILE_SIZE, width) - 1;
+    const int y1 = std::min(y0 + TILE_SIZE, height) - 1;
+
+    if (clearPending) {
+        uint32_t packed;
+        std::memcpy(&packed, clearColor, 4);
+        for (int y = y0; y <= y1; y++) {
+            const size_t row = static_cast<size_t>(y) * width;
+            std::fill(reinterpret_cast<uint32_t*>(color.data()) + row + x0,
+                reinterpret_cast<uint32_t*>(color.data()) + row + x1 + 1, packed);
+            std::fill(depth.begin() + row + x0, depth.begin() + row + x1 + 1, 1.0f);
+        }
+    }
+
+    size_t written = 0;
+    for (uint32_t i = tileStart[tile]; i < tileStart[tile + 1]; i++) {
+        const uint64_t item = tileItems[i];
+        const Primitive& primitive = tasks[item >> 32].primitives[item & 0xFFFFFFFFu];
+        const int px0 = std::max(x0, primitive.minX), py0 = std::max(y0, primitive.minY);
+        const int px1 = std::min(x1, primitive.maxX), py1 = std::min(y1, primitive.maxY);
+        if (px0 > px1 || py0 > py1) continue;
+        if (primitive.line) RasterizeLine(primitive, px0, py0, px1, py1, written);
+        else RasterizeTriangle(primitive, px0, py0, px1, py1, written);
+    }
+    return written;
+}
+
+/**
+ * @brief Rysuje część trójkąta w prostokącie pikseli (x0, y0) - (x1, y1).
+ */
+void SoftwareRasterizer::RasterizeTriangle(const Primitive& primitive, int x0, int y0, int x1, int y1, size_t& written) {
+    const int64_t half = 1 << (SUBPIXEL_BITS - 1);
+    const int64_t startX = (static_cast<int64_t>(x0) << SUBPIXEL_BITS) + half;
+    const int64_t startY = (static_cast<int64_t>(y0) << SUBPIXEL_BITS) + half;
+    int64_t row[3], stepX[3], stepY[3];
+    for (int e = 0; e < 3; e++) {
+        row[e] = primitive.edgeA[e] * startX + primitive.edgeB[e] * startY + primitive.edgeC[e];
+        stepX[e] = primitive.edgeA[e] << SUBPIXEL_BITS;
+        stepY[e] = primitive.edgeB[e] << SUBPIXEL_BITS;
+    }
+
+    for (int y = y0; y <= y1; y++) {
+        int64_t e0 = row[0], e1 = row[1], e2 = row[2];
+        const size_t rowStart = static_cast<size_t>(y) * width;
+        for (int x = x0; x <= x1; x++) {
+            if ((e0 | e1 | e2) >= 0) {
+                // Krawędź i leży naprzeciw wierzchołka (i + 2) % 3
+                const float w0 = static_cast<float>(e1) * primitive.invArea;
+                const float w1 = static_cast<float>(e2) * primitive.invArea;
+                const float w2 = static_cast<float>(e0) * primitive.invArea;
+                const size_t pixel = rowStart + x;
+                const float z = primitive.z[0] * w0 + primitive.z[1] * w1 + primitive.z[2] * w2;
+                if (z < depth[pixel]) {
+                    depth[pixel] = z;
+                    ShadeTriangle(primitive, pixel, w0, w1, w2);
+                    written++;
+                }
+            }
+            e0 += stepX[0];
+            e1 += stepX[1];
+            e2 += stepX[2];
+        }
+        for (int e = 0; e < 3; e++) row[e] += stepY[e];
+    }
+}
+
+/**
+ * @brief Liczy kolor piksela trójkąta (korekcja perspektywy, tekstura, tryb cieniowania).
+ */
+void SoftwareRasterizer::ShadeTriangle(const Primitive& primitive, size_t pixel, float w0, float w1, float w2) {
+    const DrawCall& draw = draws[primitive.draw];
+    const float w = 1.0f / (primitive.invW[0] * w0 + primitive.invW[1] * w1 + primitive.invW[2] * w2);
+
+    float rgba[4];
+    if (smoothShading) {
+        for (int c = 0; c < 4; c++) {
+            rgba[c] = (primitive.rgba[0][c] * w0 + primitive.rgba[1][c] * w1 + primitive.rgba[2][c] * w2) * w;
+        }
+    }
+    else {
+        for (int c = 0; c < 4; c++) rgba[c] = primitive.flatColor[c];
+    }
+
+    if (draw.texture) {
+        const float u = (primitive.u[0] * w0 + primitive.u[1] * w1 + primitive.u[2] * w2) * w;
+        const float v = (primitive.v[0] * w0 + primitive.v[1] * w1 + primitive.v[2] * w2) * w;
+        float texel[4];
+        SampleBilinear(*draw.texture, u, v, texel);
+        for (int c = 0; c < 4; c++) rgba[c] *= texel[c];
+    }
+
+    unsigned char* out = color.data() + pixel * 4;
+    for (int c = 0; c < 4; c++) out[c] = ToByte(rgba[c]);
+}
+
+/**
+ * @brief Rysuje część odcinka w prostokącie pikseli (krok po dłuższej osi, środki pikseli).
+ */
+void SoftwareRasterizer::RasterizeLine(const Primitive& primitive, int x0, int y0, int x1, int y1, size_t& written) {
+    const float dx = primitive.lineX[1] - primitive.lineX[0];
+    const float dy = primitive.lineY[1] - primitive.lineY[0];
+    const bool alongX = std::fabs(dx) >= std::fabs(dy);
+    const float major0 = alongX ? primitive.lineX[0] : primitive.lineY[0];
+    const float majorDelta = alongX ? dx : dy;
+    if (majorDelta == 0.0f) return;
+    const float minor0 = alongX ? primitive.lineY[0] : primitive.lineX[0];
+    const float minorDelta = alongX ? dy : dx;
+
+    // Piksele, których środek leży na odcinku [początek, koniec) dłuższej osi
+    const float first = std::min(major0, major0 + majorDelta), last = std::max(major0, major0 + majorDelta);
+    int from = static_cast<int>(std::ceil(first - 0.5f));
+    int to = static_cast<int>(std::ceil(last - 0.5f)) - 1;
+    from = std::max(from, alongX ? x0 : y0);
+    to = std::min(to, alongX ? x1 : y1);
+
+    for (int m = from; m <= to; m++) {
+        const float t = (m + 0.5f - major0) / majorDelta;
+        const int n = static_cast<int>(std::floor(minor0 + minorDelta * t));
+        const int x = alongX ? m : n;
+        const int y = alongX ? n : m;
+        if (x < x0 || x > x1 || y < y0 || y > y1) continue;
+
+        const size_t pixel = static_cast<size_t>(y) * width + x;
+        const float z = primitive.z[0] + (primitive.z[1] - primitive.z[0]) * t;
+        if (z >= depth[pixel]) continue;
+        depth[pixel] = z;
+        unsigned char* out = color.data() + pixel * 4;
+        for (int c = 0; c < 4; c++) {
+            const float value = smoothShading ? primitive.rgba[0][c] + (primitive.rgba[1][c] - primitive.rgba[0][c]) * t
+                : primitive.rgba[1][c];
+            out[c] = ToByte(value);
+        }
+        written++;
+    }
+}
+
+/**
+ * @brief Kopiuje kolor do RGB.
+ */
+void SoftwareRasterizer::ReadPixels(std::vector<unsigned char>& rgb) const {
+    const size_t pixels = static_cast<size_t>(width) * height;
+    rgb.resize(pixels * 3);
+    for (size_t i = 0; i < pixels; i++) {
+        rgb[i * 3 + 0] = color[i * 4 + 0];
+        rgb[i * 3 + 1] = color[i * 4 + 1];
+        rgb[i * 3 + 2] = color[i * 4 + 2];
+    }
+}
+
+/**
+ * @brief Wypisuje liczniki ostatniego Flush.
+ */
+void SoftwareRasterizer::PrintStats() const {
+    std::cout << "Rasteryzer programowy (" << GetThreadCount() << " wątków, " << width << "x" << height << ", kafelki "
+        << tilesX << "x" << tilesY << "): trójkąty " << stats.triangles << ", odcinki " << stats.lines
+        << ", odrzucone " << stats.culled << ", przycięte " << stats.clipped << "\n";
+    std::cout << "  Kafelki: " << stats.binned << " wpisów, piksele " << stats.pixels << " | przygotowanie "
+        << stats.setupMs << " ms, rasteryzacja " << stats.rasterMs << " ms" << std::endl;
+}
@@ -0,0 +1,220 @@
+﻿#pragma once
+#ifndef SOFTWARE_RASTERIZER_H
+#define SOFTWARE_RASTERIZER_H
+
+#include "BitmapHandler.h"
+#include "LitShader.h"
+#include "MathLib.h"
+#include "Mesh.h"
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+class JobSystem;
+
+/**
+ * @brief Liczniki ostatniego Flush rasteryzera programowego.
+ */
+struct RasterStats {
+    size_t triangles = 0;       /**< Trójkąty przekazane w DrawMesh */
+    size_t lines = 0;           /**< Odcinki przekazane w DrawMesh */
+    size_t culled = 0;          /**< Odrzucone (tylne ściany, poza ekranem, zerowe pole) */
+    size_t clipped = 0;         /**< Przycięte bliską płaszczyzną */
+    size_t binned = 0;          /**< Pary (prymityw, kafelek) po podziale na kafelki */
+    size_t pixels = 0;          /**< Piksele, które przeszły test głębokości */
+    double setupMs = 0.0;       /**< Transformacja, przycinanie i podział na kafelki [ms] */
+    double rasterMs = 0.0;      /**< Rasteryzacja kafelków [ms] */
+};
+
+/**
+ * @brief Rasteryzer programowy rysujący siatki Mesh bez kontekstu OpenGL.
+ *
+ * Odpowiednik ścieżki stałych funkcji silnika: macierz widoku i projekcji
+ * kamery, oświetlenie na wierzchołek z LightingState (jak GL_LIGHTING z GL_COLOR_MATERIAL),
+ * cieniowanie Gourauda lub płaskie (kolor ostatniego wierzchołka, jak
+ * GL_FLAT), tekstura RGBA z BitmapHandler modulowana kolorem (filtr
+ * dwuliniowy, GL_REPEAT), test głębokości GL_LESS i odrzucanie tylnych ścian.
+ *
+ * DrawMesh tylko zapamiętuje wywołanie. Flush wykonuje dwa etapy w systemie
+ * zadań: transformację i przygotowanie prymitywów (zadania po fragmencie
+ * siatki, każde z własną listą kafelków), a następnie rasteryzację kafelków
+ * TILE_SIZE x TILE_SIZE – każdy kafelek należy do jednego wątku, więc zapis
+ * koloru i głębokości nie wymaga synchronizacji. Prymitywy kafelka są
+ * rysowane w kolejności wywołań, więc obraz nie zależy od liczby wątków.
+ *
+ * Krawędzie trójkątów liczone są w stałym przecinku (1/16 piksela) z regułą
+ * lewej-górnej krawędzi; współrzędne tekstury i kolory interpolowane są
+ * z korekcją perspektywy.
+ */
+class SoftwareRasterizer {
+public:
+    static const int TILE_SIZE = 64;          /**< Bok kafelka w pikselach */
+    static const int SUBPIXEL_BITS = 4;       /**< Bity ułamka współrzędnych ekranu */
+    static const int TRIANGLES_PER_TASK = 1024; /**< Trójkąty jednego zadania przygotowania */
+
+    /**
+     * @param threadCount Liczba wątków (0: wspólny system zadań silnika).
+     */
+    explicit SoftwareRasterizer(int threadCount = 0);
+    ~SoftwareRasterizer();
+
+    SoftwareRasterizer(const SoftwareRasterizer&) = delete;
+    SoftwareRasterizer& operator=(const SoftwareRasterizer&) = delete;
+
+    /**
+     * @brief Zmienia liczbę wątków (0: wspólny system zadań, inaczej własny system).
+     */
+    void SetThreadCount(int threadCount);
+    int GetThreadCount() const;
+
+    /**
+     * @brief Zmienia rozmiar bufora ramki (zawartość nieokreślona do Clear).
+     */
+    void Resize(int width, int height);
+    int GetWidth() const { return width; }
+    int GetHeight() const { return height; }
+
+    /**
+     * @brief Czyści kolor i głębokość (1.0) – w następnym Flush, razem z rasteryzacją kafelków.
+     */
+    void Clear(const float color[4]);
+
+    /**
+     * @brief Ustawia kamerę dla kolejnych DrawMesh.
+     */
+    void SetCamera(const Mat4& view, const Mat4& projection);
+
+    /**
+     * @brief Ustawia oświetlenie (nullptr: bez oświetlenia). Stan musi istnieć do Flush.
+     */
+    void SetLighting(const LightingState* lighting) { this->lighting = lighting; }
+
+    /**
+     * @brief Cieniowanie Gourauda (true) lub płaskie (false) – jak Player::toggleShading.
+     */
+    void SetSmoothShading(bool smooth) { smoothShading = smooth; }
+    bool IsSmoothShading() const { return smoothShading; }
+
+    /**
+     * @brief Zapamiętuje narysowanie siatki (trójkąty lub odcinki).
+     * @param mesh Siatka z kopią danych CPU (musi istnieć do Flush).
+     * @param model Macierz modelu (przesunięcie i jednorodna skala – normalne nie są odwracane).
+     * @param color Kolor bazowy mnożony przez kolor wierzchołka i teksturę.
+     * @param texture Obraz RGBA (4 kanały) lub nullptr; musi istnieć do Flush.
+     * @param lit Czy obiekt podlega oświetleniu.
+     * @param colorVariant Numer wariantu kolorów siatki.
+     */
+    void DrawMesh(const Mesh& mesh, const Mat4& model, const float color[4], const BitmapHandler* texture,
+        bool lit, int colorVariant = 0);
+
+    /**
+     * @brief Rysuje wszystkie zapamiętane wywołania.
+     */
+    void Flush();
+
+    /**
+     * @brief Kopiuje kolor do RGB (3 bajty na piksel, wiersze od dołu – jak glReadPixels).
+     */
+    void ReadPixels(std::vector<unsigned char>& rgb) const;
+
+    /// Kolor RGBA po Flush, wiersze od dołu ekranu
+    const unsigned char* GetColor() const { return color.data(); }
+    /// Głębokość [0, 1], wiersze od dołu ekranu
+    const float* GetDepth() const { return depth.data(); }
+
+    const RasterStats& GetStats() const { return stats; }
+
+    /**
+     * @brief Wypisuje liczniki ostatniego Flush.
+     */
+    void PrintStats() const;
+
+private:
+    /**
+     * @brief Zapamiętane wywołanie DrawMesh.
+     */
+    struct DrawCall {
+        const Mesh* mesh;
+        const MeshColor* variantColors;  /**< Kolory wariantu lub nullptr (kolor wierzchołka) */
+        Mat4 model;
+        Mat4 modelViewProjection;
+        float color[4];
+        const BitmapHandler* texture;
+        bool lit;
+        size_t firstVertex;              /**< Początek wierzchołków siatki w vertices */
+    };
+
+    /**
+     * @brief Wierzchołek po transformacji (współrzędne obcinania i oświetlony kolor).
+     */
+    struct ClipVertex {
+        float clip[4];
+        float uv[2];
+        float rgba[4];
+    };
+
+    /**
+     * @brief Trójkąt lub odcinek przygotowany do rasteryzacji.
+     *
+     * Funkcje krawędzi trójkąta: E(x, y) = A * x + B * y + C w jednostkach
+     * 1/16 piksela, z przesunięciem C dla reguły lewej-górnej krawędzi.
+     * Współrzędne tekstury i kolory są podzielone przez w (korekcja perspektywy).
+     */
+    struct Primitive {
+        int64_t edgeA[3], edgeB[3], edgeC[3];
+        float invArea;
+        float z[3], invW[3], u[3], v[3], rgba[3][4];
+        float flatColor[4];          /**< Kolor ostatniego wierzchołka (cieniowanie płaskie) */
+        float lineX[2], lineY[2];    /**< Końce odcinka w pikselach */
+        int minX, minY, maxX, maxY;  /**< Prostokąt otaczający w pikselach (włącznie) */
+        uint32_t draw;
+        bool line;
+    };
+
+    /**
+     * @brief Zadanie etapu wierzchołków lub przygotowania (fragment jednego wywołania).
+     */
+    struct SetupTask {
+        uint32_t draw;
+        size_t first, count;                 /**< Zakres wierzchołków lub prymitywów */
+        std::vector<Primitive> primitives;
+        std::vector<uint64_t> bins;          /**< (kafelek << 32 | prymityw) w kolejności prymitywów */
+        std::vector<uint32_t> tileOffsets;   /**< Liczba, a po zliczeniu miejsce zapisu każdego kafelka */
+        size_t culled, clipped;
+    };
+
+    void TransformVertices(const SetupTask& task);
+    void SetupPrimitives(SetupTask& task);
+    void EmitTriangle(SetupTask& task, const ClipVertex* vertices, const float flatColor[4]);
+    void EmitLine(SetupTask& task, const ClipVertex& a, const ClipVertex& b);
+    size_t RasterizeTile(int tile);
+    void RasterizeTriangle(const Primitive& primitive, int x0, int y0, int x1, int y1, size_t& written);
+    void RasterizeLine(const Primitive& primitive, int x0, int y0, int x1, int y1, size_t& written);
+    void ShadeTriangle(const Primitive& primitive, size_t pixel, float w0, float w1, float w2);
+
+    int width, height;
+    int tilesX, tilesY;
+    std::vector<unsigned char> color; /**< Kolor RGBA8 */
+    std::vector<float> depth;         /**< Głębokość w [0, 1] */
+    unsigned char clearColor[4];
+    bool clearPending;                /**< Czyszczenie wykonywane przez kafelki w następnym Flush */
+
+    Mat4 viewProjection;             /**< Projekcja * widok bieżącej kamery */
+    Vec3 eyePosition;                /**< Położenie kamery w świecie (odbicia zwierciadlane) */
+    const LightingState* lighting;   /**< Oświetlenie (nullptr: brak) */
+    bool smoothShading;
+
+    std::vector<DrawCall> draws;                /**< Wywołania od ostatniego Flush */
+    std::vector<ClipVertex> vertices;           /**< Wierzchołki wszystkich wywołań */
+    std::vector<SetupTask> vertexTasks;         /**< Zadania transformacji wierzchołków */
+    std::vector<SetupTask> tasks;               /**< Zadania przygotowania (fragmenty siatek) */
+    std::vector<uint32_t> tileStart;            /**< Początek listy kafelka w tileItems */
+    std::vector<uint64_t> tileItems;            /**< (zadanie << 32 | prymityw) posortowane po kafelku */
+    std::vector<size_t> tilePixels;             /**< Zapisane piksele każdego kafelka */
+    std::unique_ptr<JobSystem> ownJobs;         /**< Własny system zadań (jawna liczba wątków) */
+    JobSystem* jobs;                            /**< System wykonujący etapy Flush */
+    RasterStats stats;
+};
+
+#endif
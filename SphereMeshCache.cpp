@@ -0,0 +1,58 @@
+﻿#include "SphereMeshCache.h"
+#include "JobSystem.h"
+
+#include <vector>
+
+/**
+ * @brief Zwraca siatkę kuli, budując ją przy pierwszym użyciu.
+ * @param segments Liczba segmentów.
+ * @return Wskaźnik na siatkę (ważny do Clear()).
+ */
+const Mesh* SphereMeshCache::Get(int segments) {
+    auto it = meshes.find(segments);
+    if (it != meshes.end()) return it->second.get();
+
+    std::unique_ptr<Mesh> mesh(new Mesh(GL_TRIANGLES));
+    mesh->BuildSphere(segments);
+    mesh->Upload();
+    buildCount++;
+
+    const Mesh* result = mesh.get();
+    meshes[segments] = std::move(mesh);
+    return result;
+}
+
+/**
+ * @brief Buduje z wyprzedzeniem siatki min, 2*min, 4*min, ... <= max.
+ *
+ * Geometria brakujących poziomów generowana jest równolegle w systemie
+ * zadań; wysyłka do GPU odbywa się potem w wątku wywołującym (kontekst GL).
+ */
+void SphereMeshCache::Prewarm(int minSegments, int maxSegments) {
+    if (minSegments <= 0) return;
+    std::vector<int> missing;
+    for (int segments = minSegments; segments <= maxSegments; segments *= 2) {
+        if (meshes.find(segments) == meshes.end()) missing.push_back(segments);
+    }
+
+    std::vector<std::unique_ptr<Mesh>> built(missing.size());
+    GetJobSystem().ParallelFor(missing.size(), 1, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) {
+            built[i].reset(new Mesh(GL_TRIANGLES));
+            built[i]->BuildSphere(missing[i]);
+        }
+    });
+
+    for (size_t i = 0; i < missing.size(); i++) {
+        built[i]->Upload();
+        buildCount++;
+        meshes[missing[i]] = std::move(built[i]);
+    }
+}
+
+/**
+ * @brief Zwalnia wszystkie siatki (także bufory GPU).
+ */
+void SphereMeshCache::Clear() {
+    meshes.clear();
+}
@@ -0,0 +1,58 @@
+﻿#pragma once
+#ifndef SPHERE_MESH_CACHE_H
+#define SPHERE_MESH_CACHE_H
+
+#include "Mesh.h"
+
+#include <map>
+#include <memory>
+
+/**
+ * @brief Cache siatek kuli indeksowany liczbą segmentów (poziomem LOD).
+ *
+ * Każda liczba segmentów jest generowana co najwyżej raz i współdzielona
+ * przez wszystkie instancje kul. Zmiana szczegółowości sprowadza się do
+ * podmiany wskaźnika na inną, już zbudowaną siatkę.
+ */
+class SphereMeshCache {
+public:
+    SphereMeshCache() = default;
+
+    SphereMeshCache(const SphereMeshCache&) = delete;
+    SphereMeshCache& operator=(const SphereMeshCache&) = delete;
+
+    /**
+     * @brief Zwraca siatkę kuli, budując ją przy pierwszym użyciu.
+     * @param segments Liczba segmentów.
+     * @return Wskaźnik na siatkę (ważny do Clear()).
+     */
+    const Mesh* Get(int segments);
+
+    /**
+     * @brief Buduje z wyprzedzeniem siatki min, 2*min, 4*min, ... <= max.
+     *
+     * Odpowiada poziomom osiągalnym klawiszami T/Y (podwajanie/połowienie).
+     */
+    void Prewarm(int minSegments, int maxSegments);
+
+    /**
+     * @brief Zwalnia wszystkie siatki (także bufory GPU).
+     */
+    void Clear();
+
+    /**
+     * @brief Zwraca liczbę zbudowanych poziomów LOD.
+     */
+    size_t GetLevelCount() const { return meshes.size(); }
+
+    /**
+     * @brief Zwraca liczbę generacji geometrii od początku działania.
+     */
+    unsigned int GetBuildCount() const { return buildCount; }
+
+private:
+    std::map<int, std::unique_ptr<Mesh>> meshes; /**< Siatki wg liczby segmentów */
+    unsigned int buildCount = 0;                 /**< Liczba wygenerowanych siatek */
+};
+
+#endif
@@ -0,0 +1,719 @@
+﻿#include "TextureCache.h"
+#include "BitmapHandler.h"
+#include "GLExtensions.h"
+#include "MipChain.h"
+#include "TextureStreamer.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <future>
+#include <iomanip>
+#include <iostream>
+
+/**
+ * @brief Konstruktor klasy TextureCache.
+ */
+TextureCache::TextureCache()
+    : mipGenerator(MIP_GENERATOR_CPU), anisotropy(1.0f), placeholder(0), uploadMode(PIXEL_UPLOAD_MODE_COUNT) {
+}
+
+/**
+ * @brief Destruktor klasy TextureCache.
+ */
+TextureCache::~TextureCache() {
+    Clear();
+}
+
+/**
+ * @brief Buduje klucz wyszukiwania z pary (ścieżka, flagi).
+ */
+std::string TextureCache::MakeKey(const std::string& filePath, unsigned int flags) {
+    return filePath + "|" + std::to_string(flags);
+}
+
+/**
+ * @brief Składa uchwyt z numeru slotu i generacji.
+ */
+TextureHandle TextureCache::MakeHandle(size_t slot, unsigned short generation) {
+    return (static_cast<TextureHandle>(generation) << 16) | static_cast<TextureHandle>(slot + 1);
+}
+
+/**
+ * @brief Odszukuje żywy wpis dla uchwytu.
+ */
+TextureCache::Entry* TextureCache::FindEntry(TextureHandle handle) {
+    return const_cast<Entry*>(static_cast<const TextureCache*>(this)->FindEntry(handle));
+}
+
+/**
+ * @brief Odszukuje żywy wpis dla uchwytu (wersja const).
+ */
+const TextureCache::Entry* TextureCache::FindEntry(TextureHandle handle) const {
+    size_t index = handle & 0xFFFFu;
+    if (index == 0 || index > entries.size()) return nullptr;
+
+    const Entry& entry = entries[index - 1];
+    if (!entry.alive || entry.generation != (handle >> 16)) return nullptr;
+    return &entry;
+}
+
+/**
+ * @brief Pobiera teksturę z cache lub wczytuje ją przy pierwszym użyciu.
+ * @param filePath Ścieżka do pliku obrazu.
+ * @param flags Kombinacja TextureLoadFlags.
+ * @return Uchwyt tekstury lub INVALID_TEXTURE przy błędzie.
+ */
+TextureHandle TextureCache::Acquire(const std::string& filePath, unsigned int flags) {
+    std::string key = MakeKey(filePath, flags);
+
+    auto it = lookup.find(key);
+    if (it != lookup.end()) {
+        Entry* entry = FindEntry(it->second);
+        if (entry) {
+            entry->refCount++;
+            frameStats.hits++;
+            totalStats.hits++;
+            return it->second;
+        }
+    }
+
+    frameStats.misses++;
+    totalStats.misses++;
+
+    size_t slot = AllocateSlot(filePath);
+    if (slot == static_cast<size_t>(-1)) return INVALID_TEXTURE;
+
+    Entry& entry = entries[slot];
+    if (!LoadEntry(entry, filePath, flags)) {
+        freeSlots.push_back(slot);
+        return INVALID_TEXTURE;
+    }
+
+    entry.key = key;
+    entry.refCount = 1;
+    entry.alive = true;
+
+    TextureHandle handle = MakeHandle(slot, entry.generation);
+    lookup[key] = handle;
+    return handle;
+}
+
+/**
+ * @brief Jak Acquire, ale dekodowanie odbywa się w tle.
+ */
+TextureHandle TextureCache::AcquireAsync(const std::string& filePath, unsigned int flags) {
+    std::string key = MakeKey(filePath, flags);
+
+    auto it = lookup.find(key);
+    if (it != lookup.end()) {
+        Entry* entry = FindEntry(it->second);
+        if (entry) {
+            entry->refCount++;
+            frameStats.hits++;
+            totalStats.hits++;
+            return it->second;
+        }
+    }
+
+    frameStats.misses++;
+    totalStats.misses++;
+
+    size_t slot = AllocateSlot(filePath);
+    if (slot == static_cast<size_t>(-1)) return INVALID_TEXTURE;
+    if (!streamer) streamer.reset(new TextureStreamer());
+    if (!placeholder) CreatePlaceholder();
+
+    Entry& entry = entries[slot];
+    entry.key = key;
+    entry.flags = flags;
+    entry.refCount = 1;
+    entry.alive = true;
+    entry.resident = false;
+
+    TextureDecodeRequest request;
+    request.slot = slot;
+    request.generation = entry.generation;
+    request.filePath = filePath;
+    request.flipY = (flags & TEXTURE_FLIP_Y) != 0;
+    request.mipmaps = (flags & TEXTURE_MIPMAPS) != 0;
+    request.requestTime = TextureStreamer::Now();
+    streamer->Submit(request);
+    frameStats.streamRequests++;
+    totalStats.streamRequests++;
+
+    TextureHandle handle = MakeHandle(slot, entry.generation);
+    lookup[key] = handle;
+    return handle;
+}
+
+/**
+ * @brief Zajmuje wolny slot wpisu.
+ * @return Numer slotu lub (size_t)-1 przy przepełnieniu.
+ */
+size_t TextureCache::AllocateSlot(const std::string& filePath) {
+    if (!freeSlots.empty()) {
+        size_t slot = freeSlots.back();
+        freeSlots.pop_back();
+        return slot;
+    }
+    size_t slot = entries.size();
+    if (slot >= 0xFFFFu) {
+        std::cerr << "[TextureCache Error] Too many textures, cannot load: " << filePath << std::endl;
+        return static_cast<size_t>(-1);
+    }
+    entries.push_back(Entry());
+    return slot;
+}
+
+/**
+ * @brief Tworzy teksturę zastępczą (szachownica 2x2 w odcieniach szarości).
+ */
+void TextureCache::CreatePlaceholder() {
+    const unsigned char pixels[12] = { 160, 160, 160, 96, 96, 96, 96, 96, 96, 160, 160, 160 };
+    glGenTextures(1, &placeholder);
+    glBindTexture(GL_TEXTURE_2D, placeholder);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, 2, 2, 0, GL_RGB, GL_UNSIGNED_BYTE, pixels);
+    glBindTexture(GL_TEXTURE_2D, 0);
+}
+
+/**
+ * @brief Format GL dla liczby kanałów obrazu.
+ */
+static GLenum FormatForChannels(int channels) {
+    switch (channels) {
+    case 1: return GL_LUMINANCE;
+    case 2: return GL_LUMINANCE_ALPHA;
+    case 4: return GL_RGBA;
+    default: return GL_RGB;
+    }
+}
+
+/**
+ * @brief Szacowany rozmiar poziomu w pamięci GPU (RGB przechowywane jako RGBA).
+ */
+static size_t GpuLevelBytes(int width, int height, int channels) {
+    return static_cast<size_t>(width) * height * (channels == 3 ? 4 : channels);
+}
+
+/**
+ * @brief Dekoduje plik i wysyła go do GPU.
+ *
+ * Z TEXTURE_MIPMAPS łańcuch mipmap liczony jest w wątku roboczym, gdy
+ * wątek główny wysyła poziom 0, albo – dla MIP_GENERATOR_GPU – przez
+ * GL_GENERATE_MIPMAP przy wysyłce poziomu 0.
+ * @return True jeśli tekstura została utworzona.
+ */
+bool TextureCache::LoadEntry(Entry& entry, const std::string& filePath, unsigned int flags) {
+    BitmapHandler loader;
+    frameStats.decodes++;
+    totalStats.decodes++;
+    if (!loader.Load(filePath, (flags & TEXTURE_FLIP_Y) != 0, PIXEL_FORMAT_RGBA)) {
+        std::cerr << "[TextureCache Error] Cannot create texture from: " << filePath << std::endl;
+        return false;
+    }
+
+    const int width = loader.GetWidth(), height = loader.GetHeight(), channels = loader.GetChannels();
+    const bool mipmaps = (flags & TEXTURE_MIPMAPS) != 0;
+    const bool gpuMipmaps = mipmaps && mipGenerator == MIP_GENERATOR_GPU && GetGLCapabilities().generateMipmap;
+
+    // Łańcuch liczony równolegle z wysyłką poziomu 0 (MipChain nie używa GL)
+    MipChain chain;
+    std::future<double> chainJob;
+    if (mipmaps && !gpuMipmaps) {
+        const unsigned char* pixels = loader.GetData();
+        chainJob = std::async(std::launch::async, [&chain, pixels, width, height, channels]() {
+            auto start = std::chrono::steady_clock::now();
+            chain.Build(pixels, width, height, channels);
+            return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        });
+    }
+
+    glGenTextures(1, &entry.glName);
+    glBindTexture(GL_TEXTURE_2D, entry.glName);
+    entry.flags = flags;
+    ApplySampling(entry);
+    if (gpuMipmaps) glTexParameteri(GL_TEXTURE_2D, GL_GENERATE_MIPMAP, GL_TRUE);
+
+    const GLenum format = FormatForChannels(channels);
+    // Obraz rozszerzony do RGBA: wiersze wyrównane do 4 bajtów, bez wolnej ścieżki RGB sterownika
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, format, GL_UNSIGNED_BYTE, loader.GetData());
+    size_t uploaded = loader.GetTotalSize();
+    entry.levels = 1;
+    entry.gpuBytes = GpuLevelBytes(width, height, channels);
+
+    if (chainJob.valid()) {
+        double buildMs = chainJob.get();
+        frameStats.mipBuildMs += buildMs;
+        totalStats.mipBuildMs += buildMs;
+        for (int level = 1; level <= chain.GetLevelCount(); level++) {
+            const MipLevel& mip = chain.GetLevel(level);
+            glTexImage2D(GL_TEXTURE_2D, level, format, mip.width, mip.height, 0, format, GL_UNSIGNED_BYTE,
+                chain.GetLevelData(level));
+            entry.gpuBytes += GpuLevelBytes(mip.width, mip.height, channels);
+        }
+        entry.levels += chain.GetLevelCount();
+        uploaded += chain.GetByteSize();
+    }
+    else if (gpuMipmaps) {
+        // Poziomy tworzy sterownik – rozmiar jak dla pełnego łańcucha
+        for (int w = width, h = height; w > 1 || h > 1; entry.levels++) {
+            w = std::max(1, w / 2);
+            h = std::max(1, h / 2);
+            entry.gpuBytes += GpuLevelBytes(w, h, channels);
+        }
+    }
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    entry.width = width;
+    entry.height = height;
+    entry.channels = channels;
+
+    frameStats.uploads++;
+    totalStats.uploads++;
+    frameStats.bytesUploaded += uploaded;
+    totalStats.bytesUploaded += uploaded;
+    return true;
+}
+
+/**
+ * @brief Ustawia filtrowanie i zawijanie związanej tekstury według flag wpisu.
+ */
+void TextureCache::ApplySampling(const Entry& entry) const {
+    const bool nearest = (entry.flags & TEXTURE_NEAREST) != 0;
+    GLint magFilter = nearest ? GL_NEAREST : GL_LINEAR;
+    GLint minFilter = magFilter;
+    if (entry.flags & TEXTURE_MIPMAPS) minFilter = nearest ? GL_NEAREST_MIPMAP_NEAREST : GL_LINEAR_MIPMAP_LINEAR;
+    GLint wrap = (entry.flags & TEXTURE_CLAMP) ? GL_CLAMP : GL_REPEAT;
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, minFilter);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, magFilter);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, wrap);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, wrap);
+    if (GetGLCapabilities().maxAnisotropy > 1.0f) {
+        float value = (entry.flags & TEXTURE_MIPMAPS) ? anisotropy : 1.0f;
+        glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MAX_ANISOTROPY_EXT, value);
+    }
+}
+
+/**
+ * @brief Przywraca filtrowanie tekstury z flag wczytania.
+ */
+void TextureCache::ApplySampling(TextureHandle handle) {
+    const Entry* entry = FindEntry(handle);
+    if (!entry || !entry->resident || !entry->glName) return;
+    glBindTexture(GL_TEXTURE_2D, entry->glName);
+    ApplySampling(*entry);
+    glBindTexture(GL_TEXTURE_2D, 0);
+}
+
+/**
+ * @brief Ustawia anizotropię wszystkich tekstur z mipmapami.
+ */
+float TextureCache::SetAnisotropy(float value) {
+    anisotropy = std::min(std::max(value, 1.0f), GetGLCapabilities().maxAnisotropy);
+    for (const Entry& entry : entries) {
+        // Tekstury w drodze dostaną ustawienie przy tworzeniu
+        if (!entry.alive || !entry.resident || !entry.glName || !(entry.flags & TEXTURE_MIPMAPS)) continue;
+        glBindTexture(GL_TEXTURE_2D, entry.glName);
+        ApplySampling(entry);
+    }
+    glBindTexture(GL_TEXTURE_2D, 0);
+    return anisotropy;
+}
+
+/**
+ * @brief Szacowana pamięć GPU wszystkich tekstur w bajtach.
+ */
+size_t TextureCache::GetMemoryUsage() const {
+    size_t total = 0;
+    for (const Entry& entry : entries) {
+        if (entry.alive) total += entry.gpuBytes;
+    }
+    return total;
+}
+
+/**
+ * @brief Zwiększa licznik referencji istniejącego uchwytu.
+ */
+bool TextureCache::AddRef(TextureHandle handle) {
+    Entry* entry = FindEntry(handle);
+    if (!entry) return false;
+    entry->refCount++;
+    return true;
+}
+
+/**
+ * @brief Zmniejsza licznik referencji; przy zerze zwalnia nazwę GL.
+ */
+void TextureCache::Release(TextureHandle handle) {
+    Entry* entry = FindEntry(handle);
+    if (!entry) return;
+
+    if (--entry->refCount <= 0) {
+        lookup.erase(entry->key);
+        FreeEntry(*entry);
+        freeSlots.push_back(static_cast<size_t>((handle & 0xFFFFu) - 1));
+    }
+}
+
+/**
+ * @brief Zwalnia nazwę GL wpisu i unieważnia jego uchwyty.
+ */
+void TextureCache::FreeEntry(Entry& entry) {
+    if (entry.glName) {
+        glDeleteTextures(1, &entry.glName);
+        frameStats.frees++;
+        totalStats.frees++;
+    }
+    entry.glName = 0;
+    entry.levels = 1;
+    entry.gpuBytes = 0;
+    entry.flags = 0;
+    entry.key.clear();
+    entry.refCount = 0;
+    entry.alive = false;
+    entry.generation++;
+}
+
+/**
+ * @brief Wczytuje teksturę ponownie z pliku.
+ */
+bool TextureCache::Reload(TextureHandle handle) {
+    if (!IsValid(handle)) return false;
+    // Wynik w tle nadpisałby wczytaną teksturę
+    if (!IsResident(handle)) FinishStreaming();
+    Entry* entry = FindEntry(handle);
+
+    // Klucz: ścieżka|flagi
+    std::string path = entry->key.substr(0, entry->key.rfind('|'));
+    Entry loaded;
+    if (!LoadEntry(loaded, path, entry->flags)) return false;
+
+    glDeleteTextures(1, &entry->glName);
+    frameStats.frees++;
+    totalStats.frees++;
+    entry->glName = loaded.glName;
+    entry->width = loaded.width;
+    entry->height = loaded.height;
+    entry->channels = loaded.channels;
+    entry->levels = loaded.levels;
+    entry->gpuBytes = loaded.gpuBytes;
+    return true;
+}
+
+/**
+ * @brief Zwraca nazwę tekstury OpenGL dla uchwytu.
+ */
+GLuint TextureCache::GetGLName(TextureHandle handle) const {
+    const Entry* entry = FindEntry(handle);
+    if (!entry) return 0;
+    return entry->resident ? entry->glName : placeholder;
+}
+
+/**
+ * @brief Odbiera zdekodowane obrazy i wysyła je do GPU w ramach budżetu.
+ */
+bool TextureCache::Update(size_t byteBudget) {
+    if (!streamer) return false;
+    const double start = TextureStreamer::Now();
+    streamer->TakeCompleted(uploadQueue);
+    if (!uploadRing.IsInitialized() && (activeUpload.data || !uploadQueue.empty())) {
+        PixelUploadMode mode = PixelUploadRing::IsModeSupported(uploadMode) ? uploadMode : PixelUploadRing::GetBestMode();
+        if (!uploadRing.Init(UPLOAD_RING_BYTES, mode)) uploadRing.Init(UPLOAD_RING_BYTES, PIXEL_UPLOAD_CLIENT);
+    }
+
+    bool bound = false;
+    size_t uploaded = 0;
+    size_t queueIndex = 0;
+    while (activeUpload.data || queueIndex < uploadQueue.size()) {
+        if (!activeUpload.data) activeUpload.data = std::move(uploadQueue[queueIndex++]);
+        DecodedTexture& decoded = *activeUpload.data;
+
+        // Uchwyt mógł zostać zwolniony w trakcie dekodowania lub wysyłki
+        Entry* entry = FindEntry(MakeHandle(decoded.request.slot, decoded.request.generation));
+        if (!entry) {
+            DiscardUpload();
+            continue;
+        }
+        if (!decoded.ok) {
+            std::cerr << "[TextureCache Error] Cannot create texture from: " << decoded.request.filePath << std::endl;
+            entry->resident = true; // bez tekstury, jak po nieudanym Acquire
+            frameStats.streamFailed++;
+            totalStats.streamFailed++;
+            frameStats.decodes++;
+            totalStats.decodes++;
+            activeUpload = StreamUpload();
+            continue;
+        }
+        if (uploaded >= byteBudget) break;
+
+        const BitmapHandler& image = decoded.image;
+        const int channels = image.GetChannels();
+        const GLenum format = FormatForChannels(channels);
+        if (!activeUpload.created) {
+            // Pamięć wszystkich poziomów od razu, dane pasami w kolejnych klatkach
+            glGenTextures(1, &activeUpload.glName);
+            glBindTexture(GL_TEXTURE_2D, activeUpload.glName);
+            ApplySampling(*entry);
+            glTexImage2D(GL_TEXTURE_2D, 0, format, image.GetWidth(), image.GetHeight(), 0, format,
+                GL_UNSIGNED_BYTE, nullptr);
+            for (int level = 1; level <= decoded.chain.GetLevelCount(); level++) {
+                const MipLevel& mip = decoded.chain.GetLevel(level);
+                glTexImage2D(GL_TEXTURE_2D, level, format, mip.width, mip.height, 0, format, GL_UNSIGNED_BYTE, nullptr);
+            }
+            activeUpload.level = decoded.chain.GetLevelCount();
+            activeUpload.row = 0;
+            activeUpload.created = true;
+        }
+        else {
+            glBindTexture(GL_TEXTURE_2D, activeUpload.glName);
+        }
+        bound = true;
+
+        const int level = activeUpload.level;
+        const int levelWidth = level ? decoded.chain.GetLevel(level).width : image.GetWidth();
+        const int levelHeight = level ? decoded.chain.GetLevel(level).height : image.GetHeight();
+        const unsigned char* pixels = level ? decoded.chain.GetLevelData(level) : image.GetData();
+        const size_t rowBytes = static_cast<size_t>(levelWidth) * channels;
+
+        // Co najmniej jeden wiersz, żeby duża tekstura nie czekała w nieskończoność
+        size_t rows = (byteBudget - uploaded) / rowBytes;
+        rows = std::min(rows, uploadRing.GetMaxUploadSize() / rowBytes);
+        if (rows == 0) rows = 1;
+        rows = std::min(rows, static_cast<size_t>(levelHeight - activeUpload.row));
+
+        UploadRows(level, activeUpload.row, levelWidth, static_cast<GLsizei>(rows), format,
+            pixels + activeUpload.row * rowBytes, rows * rowBytes);
+        uploaded += rows * rowBytes;
+        activeUpload.row += static_cast<int>(rows);
+
+        if (activeUpload.row == levelHeight) {
+            if (level == 0) FinishUpload(*entry);
+            else {
+                activeUpload.level--;
+                activeUpload.row = 0;
+            }
+        }
+    }
+    uploadQueue.erase(uploadQueue.begin(), uploadQueue.begin() + queueIndex);
+    if (bound) glBindTexture(GL_TEXTURE_2D, 0);
+    uploadRing.EndFrame();
+
+    if (uploaded > byteBudget) {
+        frameStats.budgetOverruns++;
+        totalStats.budgetOverruns++;
+        frameStats.overrunBytes += uploaded - byteBudget;
+        totalStats.overrunBytes += uploaded - byteBudget;
+    }
+    frameStats.bytesUploaded += uploaded;
+    totalStats.bytesUploaded += uploaded;
+    const double elapsedMs = (TextureStreamer::Now() - start) * 1000.0;
+    frameStats.uploadMs += elapsedMs;
+    totalStats.uploadMs += elapsedMs;
+    return bound;
+}
+
+/**
+ * @brief Wysyła pas wierszy związanej tekstury przez pierścień PBO.
+ */
+void TextureCache::UploadRows(GLint level, GLint row, GLsizei width, GLsizei rows, GLenum format,
+    const unsigned char* pixels, size_t bytes) {
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    if (void* staging = uploadRing.Map(bytes)) {
+        memcpy(staging, pixels, bytes);
+        uploadRing.TexSubImage2D(GL_TEXTURE_2D, level, 0, row, width, rows, format, GL_UNSIGNED_BYTE);
+        return;
+    }
+    // Wiersz większy niż segment pierścienia – kopię robi sterownik
+    glTexSubImage2D(GL_TEXTURE_2D, level, 0, row, width, rows, format, GL_UNSIGNED_BYTE, pixels);
+    frameStats.directUploads++;
+    totalStats.directUploads++;
+}
+
+/**
+ * @brief Podmienia teksturę zastępczą na wysłaną i zapisuje metryki.
+ */
+void TextureCache::FinishUpload(Entry& entry) {
+    DecodedTexture& decoded = *activeUpload.data;
+    const BitmapHandler& image = decoded.image;
+    entry.glName = activeUpload.glName;
+    entry.width = image.GetWidth();
+    entry.height = image.GetHeight();
+    entry.channels = image.GetChannels();
+    entry.levels = 1 + decoded.chain.GetLevelCount();
+    entry.gpuBytes = GpuLevelBytes(entry.width, entry.height, entry.channels);
+    for (int level = 1; level <= decoded.chain.GetLevelCount(); level++) {
+        const MipLevel& mip = decoded.chain.GetLevel(level);
+        entry.gpuBytes += GpuLevelBytes(mip.width, mip.height, entry.channels);
+    }
+    entry.resident = true;
+
+    const double latencyMs = (TextureStreamer::Now() - decoded.request.requestTime) * 1000.0;
+    for (TextureCacheStats* stats : { &frameStats, &totalStats }) {
+        stats->uploads++;
+        stats->streamCompleted++;
+        stats->latencyMs += latencyMs;
+        stats->maxLatencyMs = std::max(stats->maxLatencyMs, latencyMs);
+        stats->decodeMs += decoded.decodeMs;
+        stats->decodes++;
+    }
+    activeUpload = StreamUpload();
+}
+
+/**
+ * @brief Porzuca wysyłkę obrazu, którego uchwyt został zwolniony.
+ */
+void TextureCache::DiscardUpload() {
+    if (activeUpload.glName) glDeleteTextures(1, &activeUpload.glName);
+    frameStats.streamDiscarded++;
+    totalStats.streamDiscarded++;
+    activeUpload = StreamUpload();
+}
+
+/**
+ * @brief Czeka na wszystkie zlecenia w tle i wysyła je bez budżetu.
+ */
+void TextureCache::FinishStreaming() {
+    while (GetStreamingCount() > 0) {
+        streamer->WaitIdle();
+        Update(static_cast<size_t>(-1));
+    }
+}
+
+/**
+ * @brief Liczba tekstur zleconych w tle, które nie są jeszcze rezydentne.
+ */
+size_t TextureCache::GetStreamingCount() const {
+    if (!streamer) return 0;
+    return streamer->GetPendingCount() + uploadQueue.size() + (activeUpload.data ? 1 : 0);
+}
+
+/**
+ * @brief Sprawdza, czy tekstura ma już dane w GPU.
+ */
+bool TextureCache::IsResident(TextureHandle handle) const {
+    const Entry* entry = FindEntry(handle);
+    return entry && entry->resident;
+}
+
+/**
+ * @brief Zwraca liczbę poziomów mipmap tekstury.
+ */
+int TextureCache::GetLevelCount(TextureHandle handle) const {
+    const Entry* entry = FindEntry(handle);
+    return entry ? entry->levels : 0;
+}
+
+/**
+ * @brief Rozpoczyna nową klatkę – zapisuje liczniki poprzedniej i je zeruje.
+ */
+void TextureCache::BeginFrame() {
+    lastFrameStats = frameStats;
+    frameStats = TextureCacheStats();
+}
+
+/**
+ * @brief Zwalnia wszystkie tekstury niezależnie od liczników referencji.
+ */
+void TextureCache::Clear() {
+    for (size_t i = 0; i < entries.size(); i++) {
+        if (entries[i].alive) {
+            FreeEntry(entries[i]);
+            freeSlots.push_back(i);
+        }
+    }
+    lookup.clear();
+
+    // Wyniki w tle mają już nieaktualne generacje
+    uploadQueue.clear();
+    if (activeUpload.data) DiscardUpload();
+    if (placeholder) glDeleteTextures(1, &placeholder);
+    placeholder = 0;
+    uploadRing.Shutdown();
+}
+
+/**
+ * @brief Wybiera tryb pierścienia wysyłek (pierścień powstanie przy następnej wysyłce).
+ */
+void TextureCache::SetUploadMode(PixelUploadMode mode) {
+    uploadMode = mode;
+    uploadRing.Shutdown();
+}
+
+/**
+ * @brief Wypisuje statystyki cache na standardowe wyjście.
+ */
+void TextureCache::PrintStats() const {
+    std::cout << "Cache tekstur: " << lookup.size() << " tekstur\n";
+    std::cout << "  Ostatnia klatka: trafienia=" << lastFrameStats.hits
+        << ", chybienia=" << lastFrameStats.misses
+        << ", dekodowania=" << lastFrameStats.decodes
+        << ", wysyłki=" << lastFrameStats.uploads << "\n";
+    std::cout << "  Łącznie: trafienia=" << totalStats.hits
+        << ", chybienia=" << totalStats.misses
+        << ", dekodowania=" << totalStats.decodes
+        << ", wysyłki=" << totalStats.uploads
+        << " (" << totalStats.bytesUploaded / 1024 << " KB)"
+        << ", zwolnione=" << totalStats.frees << "\n";
+    std::cout << "  Pamięć GPU: " << GetMemoryUsage() / 1024 << " KB"
+        << ", mipmapy na CPU: " << std::fixed << std::setprecision(2) << totalStats.mipBuildMs << " ms"
+        << std::defaultfloat << std::endl;
+}
+
+/**
+ * @brief Wypisuje metryki strumieniowania.
+ */
+void TextureCache::PrintStreamingStats() const {
+    const TextureCacheStats& total = totalStats;
+    std::cout << "Strumieniowanie tekstur: " << total.streamRequests << " zleceń, " << total.streamCompleted
+        << " gotowych, " << GetStreamingCount() << " w toku, " << total.streamFailed << " błędów, "
+        << total.streamDiscarded << " porzuconych\n";
+    std::cout << std::fixed << std::setprecision(2);
+    if (total.streamCompleted) {
+        std::cout << "  Opóźnienie zlecenie->rezydencja: średnio " << total.latencyMs / total.streamCompleted
+            << " ms, maks. " << total.maxLatencyMs << " ms | dekodowanie w tle średnio "
+            << total.decodeMs / total.streamCompleted << " ms\n";
+    }
+    std::cout << "  Wysyłka: ostatnia klatka " << lastFrameStats.bytesUploaded / 1024 << " KB w "
+        << lastFrameStats.uploadMs << " ms, łącznie " << total.uploadMs << " ms | przekroczenia budżetu: "
+        << total.budgetOverruns << " klatek (" << total.overrunBytes / 1024 << " KB)\n";
+    if (uploadRing.IsInitialized()) {
+        const PixelUploadStats& ring = uploadRing.GetStats();
+        std::cout << "  Bufor wysyłek: " << PixelUploadRing::GetModeName(uploadRing.GetMode()) << ", "
+            << ring.uploads << " pasów (" << ring.bytes / 1024 << " KB), płoty: " << ring.segments
+            << ", czekanie " << ring.fenceWaits << "x (" << ring.fenceWaitMs << " ms), z pominięciem: "
+            << total.directUploads << "\n";
+    }
+    std::cout << std::defaultfloat << std::flush;
+}
+
+/**
+ * @brief Wypisuje pamięć GPU każdej tekstury.
+ */
+void TextureCache::PrintMemoryReport() const {
+    std::cout << "Pamięć tekstur (szacunkowo, RGB jako RGBA):\n";
+    for (const Entry& entry : entries) {
+        if (!entry.alive) continue;
+        // Klucz: ścieżka|flagi
+        std::string path = entry.key.substr(0, entry.key.rfind('|'));
+        if (!entry.resident || !entry.glName) {
+            std::cout << "  " << path << ": " << (entry.resident ? "błąd wczytania" : "wczytywanie w tle")
+                << ", referencje " << entry.refCount << "\n";
+            continue;
+        }
+        size_t baseBytes = GpuLevelBytes(entry.width, entry.height, entry.channels);
+        std::cout << "  " << path << ": " << entry.width << "x" << entry.height << "x" << entry.channels
+            << ", poziomy " << entry.levels << ", " << entry.gpuBytes / 1024 << " KB";
+        if (entry.levels > 1) {
+            std::cout << " (+" << std::fixed << std::setprecision(1)
+                << 100.0 * (entry.gpuBytes - baseBytes) / baseBytes << "% na mipmapy"
+                << ", anizotropia " << std::setprecision(0) << anisotropy << "x)" << std::defaultfloat;
+        }
+        std::cout << ", referencje " << entry.refCount << "\n";
+    }
+    std::cout << "  Razem: " << lookup.size() << " tekstur, " << GetMemoryUsage() / 1024 << " KB" << std::endl;
+}
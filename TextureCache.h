@@ -0,0 +1,321 @@
+﻿#pragma once
+#ifndef TEXTURE_CACHE_H
+#define TEXTURE_CACHE_H
+
+#include "PixelUploadRing.h"
+
+#include <GLFW/glfw3.h>
+#include <memory>
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+class TextureStreamer;
+struct DecodedTexture;
+
+/**
+ * @brief Flagi wczytywania tekstury (są częścią klucza w cache).
+ */
+enum TextureLoadFlags : unsigned int {
+    TEXTURE_FLAG_NONE = 0,        /**< Brak dodatkowych opcji */
+    TEXTURE_FLIP_Y = 1u << 0,     /**< Odwrócenie obrazu w osi Y */
+    TEXTURE_CLAMP = 1u << 1,      /**< Zawijanie GL_CLAMP zamiast GL_REPEAT */
+    TEXTURE_NEAREST = 1u << 2,    /**< Filtrowanie GL_NEAREST zamiast GL_LINEAR */
+    TEXTURE_MIPMAPS = 1u << 3     /**< Pełny łańcuch mipmap i filtrowanie anizotropowe */
+};
+
+/**
+ * @brief Sposób liczenia mipmap tekstur z TEXTURE_MIPMAPS.
+ */
+enum MipGenerator {
+    MIP_GENERATOR_CPU = 0,  /**< Filtr pudełkowy SIMD (MipChain) w wątku roboczym */
+    MIP_GENERATOR_GPU = 1   /**< GL_GENERATE_MIPMAP – liczy sterownik */
+};
+
+/**
+ * @brief Stabilny uchwyt tekstury (indeks slotu + generacja).
+ */
+typedef unsigned int TextureHandle;
+
+/// Uchwyt oznaczający brak tekstury
+const TextureHandle INVALID_TEXTURE = 0;
+
+/**
+ * @brief Liczniki pracy cache tekstur.
+ */
+struct TextureCacheStats {
+    unsigned int hits = 0;       /**< Acquire trafiło w istniejący wpis */
+    unsigned int misses = 0;     /**< Acquire musiało utworzyć nowy wpis */
+    unsigned int decodes = 0;    /**< Liczba dekodowań pliku (BitmapHandler::Load) */
+    unsigned int uploads = 0;    /**< Liczba wywołań glTexImage2D */
+    unsigned int frees = 0;      /**< Liczba zwolnionych nazw GL */
+    size_t bytesUploaded = 0;    /**< Bajty przesłane do GPU (z poziomami mipmap) */
+    double mipBuildMs = 0.0;     /**< Czas liczenia mipmap na CPU [ms] */
+
+    // Strumieniowanie (AcquireAsync)
+    unsigned int streamRequests = 0;   /**< Zlecone wczytania w tle */
+    unsigned int streamCompleted = 0;  /**< Tekstury, które stały się rezydentne */
+    unsigned int streamFailed = 0;     /**< Nieudane dekodowania */
+    unsigned int streamDiscarded = 0;  /**< Wyniki porzucone (uchwyt zwolniony przed końcem) */
+    unsigned int budgetOverruns = 0;   /**< Klatki z wysyłką ponad budżet (co najmniej jeden wiersz) */
+    size_t overrunBytes = 0;           /**< Bajty wysłane ponad budżet */
+    double latencyMs = 0.0;            /**< Suma czasów od zlecenia do rezydencji [ms] */
+    double maxLatencyMs = 0.0;         /**< Najdłuższy czas od zlecenia do rezydencji [ms] */
+    double decodeMs = 0.0;             /**< Suma czasów dekodowania w tle [ms] */
+    double uploadMs = 0.0;             /**< Czas wysyłek w Update [ms] */
+    unsigned int directUploads = 0;    /**< Pasy wysłane z pominięciem pierścienia (za duże / błąd mapowania) */
+};
+
+/**
+ * @brief Cache tekstur OpenGL kluczowany ścieżką pliku i flagami wczytywania.
+ *
+ * Każdy plik jest dekodowany i wysyłany do GPU tylko raz. Użytkownicy
+ * otrzymują stabilny uchwyt, a nazwa GL jest zwalniana, gdy licznik
+ * referencji spadnie do zera.
+ *
+ * AcquireAsync zleca dekodowanie w tle (TextureStreamer) i od razu zwraca
+ * uchwyt; do czasu rezydencji GetGLName zwraca teksturę zastępczą. Update
+ * (raz na klatkę, wątek renderowania) wysyła gotowe obrazy pasami wierszy
+ * w ramach budżetu bajtów – od najmniejszej mipmapy do poziomu 0. Pasy
+ * przechodzą przez pierścień PBO (PixelUploadRing), więc glTexSubImage2D nie
+ * czeka na skopiowanie danych przez sterownik.
+ */
+class TextureCache {
+public:
+    /// Rozmiar pierścienia PBO wysyłek (segment 1 MB)
+    static const size_t UPLOAD_RING_BYTES = 4 * 1024 * 1024;
+
+    /**
+     * @brief Konstruktor klasy TextureCache.
+     */
+    TextureCache();
+
+    /**
+     * @brief Destruktor klasy TextureCache (zwalnia pozostałe tekstury).
+     */
+    ~TextureCache();
+
+    TextureCache(const TextureCache&) = delete;
+    TextureCache& operator=(const TextureCache&) = delete;
+
+    /**
+     * @brief Pobiera teksturę z cache lub wczytuje ją przy pierwszym użyciu.
+     * @param filePath Ścieżka do pliku obrazu.
+     * @param flags Kombinacja TextureLoadFlags.
+     * @return Uchwyt tekstury lub INVALID_TEXTURE przy błędzie.
+     */
+    TextureHandle Acquire(const std::string& filePath, unsigned int flags = TEXTURE_FLIP_Y);
+
+    /**
+     * @brief Jak Acquire, ale dekodowanie odbywa się w tle.
+     *
+     * Do czasu rezydencji GetGLName zwraca teksturę zastępczą. Mipmapy
+     * liczone są zawsze na CPU (MipChain w wątku dekodującym).
+     * @return Uchwyt tekstury (od razu ważny).
+     */
+    TextureHandle AcquireAsync(const std::string& filePath, unsigned int flags = TEXTURE_FLIP_Y);
+
+    /**
+     * @brief Odbiera zdekodowane obrazy i wysyła je do GPU w ramach budżetu.
+     *
+     * Wysyła co najmniej jeden wiersz na klatkę, więc bardzo mały budżet
+     * może zostać przekroczony (liczone w budgetOverruns).
+     * @param byteBudget Najwięcej bajtów pikseli wysłanych w tej klatce.
+     * @return True jeśli zmieniło się wiązanie GL_TEXTURE_2D jednostki 0.
+     */
+    bool Update(size_t byteBudget);
+
+    /**
+     * @brief Czeka na wszystkie zlecenia w tle i wysyła je bez budżetu.
+     */
+    void FinishStreaming();
+
+    /**
+     * @brief Liczba tekstur zleconych w tle, które nie są jeszcze rezydentne.
+     */
+    size_t GetStreamingCount() const;
+
+    /**
+     * @brief Sprawdza, czy tekstura ma już dane w GPU.
+     */
+    bool IsResident(TextureHandle handle) const;
+
+    /**
+     * @brief Zwiększa licznik referencji istniejącego uchwytu.
+     * @return True jeśli uchwyt jest poprawny.
+     */
+    bool AddRef(TextureHandle handle);
+
+    /**
+     * @brief Zmniejsza licznik referencji; przy zerze zwalnia nazwę GL.
+     */
+    void Release(TextureHandle handle);
+
+    /**
+     * @brief Wczytuje teksturę ponownie z pliku (uchwyt i nazwa wpisu bez zmian).
+     *
+     * Używa bieżących ustawień (np. sposobu liczenia mipmap). Przy błędzie
+     * zostaje poprzednia tekstura.
+     * @return True jeśli tekstura została wczytana ponownie.
+     */
+    bool Reload(TextureHandle handle);
+
+    /**
+     * @brief Zwraca nazwę tekstury OpenGL dla uchwytu.
+     * @return Nazwa GL lub 0 dla niepoprawnego uchwytu.
+     */
+    GLuint GetGLName(TextureHandle handle) const;
+
+    /**
+     * @brief Sprawdza, czy uchwyt wskazuje na żywy wpis.
+     */
+    bool IsValid(TextureHandle handle) const { return FindEntry(handle) != nullptr; }
+
+    /**
+     * @brief Zwraca liczbę poziomów mipmap tekstury (1 – bez mipmap, 0 – zły uchwyt).
+     */
+    int GetLevelCount(TextureHandle handle) const;
+
+    /**
+     * @brief Wybiera sposób liczenia mipmap dla kolejnych wczytań.
+     *
+     * MIP_GENERATOR_GPU bez GL_GENERATE_MIPMAP przechodzi na CPU.
+     */
+    void SetMipGenerator(MipGenerator generator) { mipGenerator = generator; }
+    MipGenerator GetMipGenerator() const { return mipGenerator; }
+
+    /**
+     * @brief Ustawia anizotropię wszystkich tekstur z mipmapami (1 – wyłączona).
+     *
+     * Wartość jest przycinana do GLCapabilities::maxAnisotropy.
+     * @return Ustawiona wartość.
+     */
+    float SetAnisotropy(float anisotropy);
+    float GetAnisotropy() const { return anisotropy; }
+
+    /**
+     * @brief Wybiera tryb pierścienia wysyłek (domyślnie najszybszy dostępny).
+     *
+     * Nieobsługiwany tryb zostaje zastąpiony najszybszym dostępnym.
+     */
+    void SetUploadMode(PixelUploadMode mode);
+    PixelUploadMode GetUploadMode() const { return uploadRing.IsInitialized() ? uploadRing.GetMode() : uploadMode; }
+
+    /**
+     * @brief Przywraca filtrowanie tekstury z flag wczytania (np. po zmianach w teście).
+     */
+    void ApplySampling(TextureHandle handle);
+
+    /**
+     * @brief Szacowana pamięć GPU wszystkich tekstur w bajtach.
+     */
+    size_t GetMemoryUsage() const;
+
+    /**
+     * @brief Rozpoczyna nową klatkę – zapisuje liczniki poprzedniej i je zeruje.
+     */
+    void BeginFrame();
+
+    /**
+     * @brief Zwraca liczniki ostatniej zakończonej klatki.
+     */
+    const TextureCacheStats& GetFrameStats() const { return lastFrameStats; }
+
+    /**
+     * @brief Zwraca liczniki od początku działania programu.
+     */
+    const TextureCacheStats& GetTotalStats() const { return totalStats; }
+
+    /**
+     * @brief Zwraca liczbę tekstur obecnie trzymanych w cache.
+     */
+    size_t GetTextureCount() const { return lookup.size(); }
+
+    /**
+     * @brief Zwalnia wszystkie tekstury niezależnie od liczników referencji.
+     *
+     * Musi być wywołane przed zniszczeniem kontekstu OpenGL.
+     */
+    void Clear();
+
+    /**
+     * @brief Wypisuje statystyki cache na standardowe wyjście.
+     */
+    void PrintStats() const;
+
+    /**
+     * @brief Wypisuje pamięć GPU każdej tekstury (wymiary, poziomy, filtrowanie).
+     */
+    void PrintMemoryReport() const;
+
+    /**
+     * @brief Wypisuje metryki strumieniowania (opóźnienie, budżet).
+     */
+    void PrintStreamingStats() const;
+
+private:
+    /**
+     * @brief Pojedynczy wpis cache.
+     */
+    struct Entry {
+        std::string key;          /**< Klucz wyszukiwania (ścieżka + flagi) */
+        GLuint glName = 0;        /**< Nazwa tekstury OpenGL */
+        int width = 0;            /**< Szerokość w pikselach */
+        int height = 0;           /**< Wysokość w pikselach */
+        int channels = 0;         /**< Liczba kanałów */
+        int levels = 1;           /**< Liczba poziomów mipmap (z poziomem 0) */
+        size_t gpuBytes = 0;      /**< Szacowana pamięć GPU wszystkich poziomów */
+        unsigned int flags = 0;   /**< Flagi wczytania (TextureLoadFlags) */
+        bool resident = true;     /**< Czy dane są w GPU (false: wczytywanie w tle) */
+        int refCount = 0;         /**< Liczba użytkowników */
+        unsigned short generation = 0; /**< Generacja slotu (unieważnia stare uchwyty) */
+        bool alive = false;       /**< Czy slot jest zajęty */
+    };
+
+    static std::string MakeKey(const std::string& filePath, unsigned int flags);
+    static TextureHandle MakeHandle(size_t slot, unsigned short generation);
+
+    /**
+     * @brief Wysyłka zdekodowanego obrazu rozłożona na klatki.
+     */
+    struct StreamUpload {
+        std::unique_ptr<DecodedTexture> data; /**< Obraz i mipmapy */
+        GLuint glName = 0;        /**< Tworzona tekstura */
+        bool created = false;     /**< Czy pamięć poziomów została przydzielona */
+        int level = 0;            /**< Wysyłany poziom (od najmniejszego do 0) */
+        int row = 0;              /**< Następny wiersz poziomu */
+    };
+
+    size_t AllocateSlot(const std::string& filePath);
+    void CreatePlaceholder();
+    void UploadRows(GLint level, GLint row, GLsizei width, GLsizei rows, GLenum format,
+        const unsigned char* pixels, size_t bytes);
+    void FinishUpload(Entry& entry);
+    void DiscardUpload();
+
+    Entry* FindEntry(TextureHandle handle);
+    const Entry* FindEntry(TextureHandle handle) const;
+    bool LoadEntry(Entry& entry, const std::string& filePath, unsigned int flags);
+    void ApplySampling(const Entry& entry) const;
+    void FreeEntry(Entry& entry);
+
+    std::vector<Entry> entries;                           /**< Sloty wpisów */
+    std::vector<size_t> freeSlots;                        /**< Wolne sloty do ponownego użycia */
+    std::unordered_map<std::string, TextureHandle> lookup; /**< Klucz -> uchwyt */
+
+    TextureCacheStats frameStats;      /**< Liczniki bieżącej klatki */
+    TextureCacheStats lastFrameStats;  /**< Liczniki poprzedniej klatki */
+    TextureCacheStats totalStats;      /**< Liczniki łączne */
+
+    MipGenerator mipGenerator;         /**< Sposób liczenia mipmap */
+    float anisotropy;                  /**< Anizotropia tekstur z mipmapami */
+
+    std::unique_ptr<TextureStreamer> streamer;  /**< Dekodowanie w tle (tworzone przy pierwszym AcquireAsync) */
+    std::vector<std::unique_ptr<DecodedTexture>> uploadQueue; /**< Obrazy czekające na wysyłkę */
+    StreamUpload activeUpload;         /**< Wysyłka w toku */
+    GLuint placeholder;                /**< Tekstura zastępcza 2x2 */
+    PixelUploadRing uploadRing;        /**< Bufory pikseli wysyłek (tworzone przy pierwszej wysyłce) */
+    PixelUploadMode uploadMode;        /**< Tryb pierścienia */
+};
+
+#endif
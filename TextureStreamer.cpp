@@ -0,0 +1,84 @@
+﻿#include "TextureStreamer.h"
+
+#include <chrono>
+
+/**
+ * @brief Konstruktor klasy TextureStreamer.
+ */
+TextureStreamer::TextureStreamer() : jobs(GetJobSystem()), decoding(0), quit(false) {
+}
+
+/**
+ * @brief Destruktor – porzuca oczekujące zlecenia i czeka na dekodowane.
+ */
+TextureStreamer::~TextureStreamer() {
+    quit = true;
+    jobs.Wait(counter);
+}
+
+/**
+ * @brief Bieżący czas zegara steady w sekundach.
+ */
+double TextureStreamer::Now() {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/**
+ * @brief Zleca dekodowanie jako zadanie tła.
+ */
+void TextureStreamer::Submit(const TextureDecodeRequest& request) {
+    decoding++;
+    if (jobs.GetThreadCount() == 1) {
+        Decode(request);
+        return;
+    }
+    jobs.Schedule([this, request] {
+        if (!quit) Decode(request);
+        else decoding--;
+    }, &counter, nullptr, JOB_PRIORITY_LOW);
+}
+
+/**
+ * @brief Przenosi gotowe wyniki do output.
+ */
+size_t TextureStreamer::TakeCompleted(std::vector<std::unique_ptr<DecodedTexture>>& output) {
+    std::lock_guard<std::mutex> lock(mutex);
+    size_t count = completed.size();
+    for (std::unique_ptr<DecodedTexture>& result : completed) output.push_back(std::move(result));
+    completed.clear();
+    return count;
+}
+
+/**
+ * @brief Czeka na zakończenie wszystkich zleceń.
+ */
+void TextureStreamer::WaitIdle() {
+    jobs.Wait(counter);
+}
+
+/**
+ * @brief Zlecenia w kolejce, w trakcie dekodowania lub czekające na odebranie.
+ */
+size_t TextureStreamer::GetPendingCount() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return decoding + completed.size();
+}
+
+/**
+ * @brief Dekoduje plik i liczy mipmapy (wątek roboczy systemu zadań).
+ */
+void TextureStreamer::Decode(const TextureDecodeRequest& request) {
+    std::unique_ptr<DecodedTexture> result(new DecodedTexture());
+    result->request = request;
+    double start = Now();
+    result->ok = result->image.Load(request.filePath, request.flipY, request.format);
+    if (result->ok && request.mipmaps) {
+        result->chain.Build(result->image.GetData(), result->image.GetWidth(), result->image.GetHeight(),
+            result->image.GetChannels());
+    }
+    result->decodeMs = (Now() - start) * 1000.0;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    completed.push_back(std::move(result));
+    decoding--;
+}
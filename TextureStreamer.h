@@ -0,0 +1,96 @@
+﻿#pragma once
+#ifndef TEXTURE_STREAMER_H
+#define TEXTURE_STREAMER_H
+
+#include "BitmapHandler.h"
+#include "JobSystem.h"
+#include "MipChain.h"
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Zlecenie dekodowania pliku tekstury.
+ */
+struct TextureDecodeRequest {
+    size_t slot = 0;                 /**< Slot wpisu w TextureCache */
+    unsigned short generation = 0;   /**< Generacja slotu w chwili zlecenia */
+    std::string filePath;            /**< Ścieżka pliku obrazu */
+    bool flipY = true;               /**< Odwrócenie obrazu w osi Y */
+    bool mipmaps = false;            /**< Czy policzyć łańcuch mipmap (MipChain) */
+    PixelFormat format = PIXEL_FORMAT_RGBA; /**< Układ pikseli wyniku */
+    double requestTime = 0.0;        /**< Chwila zlecenia [s, zegar steady] */
+};
+
+/**
+ * @brief Wynik dekodowania: piksele poziomu 0 i opcjonalny łańcuch mipmap.
+ */
+struct DecodedTexture {
+    TextureDecodeRequest request;    /**< Zlecenie, którego dotyczy wynik */
+    BitmapHandler image;             /**< Zdekodowany obraz (pusty przy błędzie) */
+    MipChain chain;                  /**< Poziomy 1..N (gdy request.mipmaps) */
+    bool ok = false;                 /**< Czy dekodowanie się powiodło */
+    double decodeMs = 0.0;           /**< Czas dekodowania i mipmap [ms] */
+};
+
+/**
+ * @brief Dekodowanie tekstur poza wątkiem renderowania.
+ *
+ * Każde zlecenie to zadanie o niskim priorytecie we wspólnym systemie zadań
+ * (kolejka FIFO tła): wątek roboczy dekoduje plik przez BitmapHandler
+ * (stb_image z lokalną dla wątku flagą odwracania) i liczy łańcuch mipmap.
+ * Czekający na pracę klatki (ParallelFor) nie biorą tych zadań, więc długie
+ * dekodowanie nie wydłuża klatki. Gotowe wyniki odbiera wątek renderowania
+ * przez TakeCompleted; wysyłka do GPU należy do TextureCache::Update.
+ *
+ * Gdy system zadań nie ma wątków w tle (--jobs 1), Submit dekoduje od razu.
+ */
+class TextureStreamer {
+public:
+    TextureStreamer();
+    ~TextureStreamer();
+
+    TextureStreamer(const TextureStreamer&) = delete;
+    TextureStreamer& operator=(const TextureStreamer&) = delete;
+
+    /**
+     * @brief Zleca dekodowanie.
+     */
+    void Submit(const TextureDecodeRequest& request);
+
+    /**
+     * @brief Przenosi gotowe wyniki do output (kolejność zakończenia).
+     * @return Liczba odebranych wyników.
+     */
+    size_t TakeCompleted(std::vector<std::unique_ptr<DecodedTexture>>& output);
+
+    /**
+     * @brief Czeka na zakończenie wszystkich zleceń (pomagając je wykonywać).
+     */
+    void WaitIdle();
+
+    /**
+     * @brief Zlecenia w kolejce, w trakcie dekodowania lub czekające na odebranie.
+     */
+    size_t GetPendingCount() const;
+
+    /**
+     * @brief Bieżący czas zegara steady w sekundach (wspólny dla zleceń i metryk).
+     */
+    static double Now();
+
+private:
+    void Decode(const TextureDecodeRequest& request);
+
+    JobSystem& jobs;                /**< Wspólny system zadań silnika */
+    JobCounter counter;             /**< Zadania dekodowania w toku */
+    mutable std::mutex mutex;
+    std::vector<std::unique_ptr<DecodedTexture>> completed;  /**< Wyniki do odebrania */
+    std::atomic<size_t> decoding;   /**< Zlecenia w kolejce lub w trakcie dekodowania */
+    std::atomic<bool> quit;         /**< Zadania w kolejce kończą się bez dekodowania */
+};
+
+#endif
@@ -0,0 +1,183 @@
+﻿#include "TimestepBenchmark.h"
+#include "BenchmarkUtils.h"
+#include "FixedTimestep.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+/// Symulowany czas każdego przebiegu [s]
+static const double RUN_SECONDS = 10.0;
+/// Ściana: położenie i grubość [m]
+static const float WALL_X = 5.0f;
+static const float WALL_WIDTH = 0.2f;
+
+/**
+ * @brief Ciało testowe: ruch w osi X z przyspieszeniem i odbiciem od ściany.
+ */
+struct TestBody {
+    float x = 0.0f;
+    float velocity = 10.0f;
+    int bounces = 0;
+};
+
+/**
+ * @brief Jeden krok ciała: całkowanie i odbicie, gdy ciało jest wewnątrz ściany.
+ */
+static void StepBody(TestBody& body, float dt) {
+    body.velocity += 2.0f * dt * (body.velocity > 0.0f ? 1.0f : -1.0f);
+    body.x += body.velocity * dt;
+    if (body.velocity > 0.0f && body.x >= WALL_X && body.x <= WALL_X + WALL_WIDTH) {
+        body.x = WALL_X;
+        body.velocity = -body.velocity;
+        body.bounces++;
+    }
+    if (body.velocity < 0.0f && body.x <= 0.0f) {
+        body.x = 0.0f;
+        body.velocity = -body.velocity;
+    }
+}
+
+/**
+ * @brief Czasy klatek: stałe tempo fps albo losowe 5-40 ms ze skokiem co 97 klatek (fps = 0).
+ */
+static std::vector<double> MakeFrames(int fps, uint32_t seed) {
+    std::vector<double> frames;
+    double total = 0.0;
+    for (size_t i = 0; total < RUN_SECONDS; i++) {
+        double seconds = 1.0 / std::max(fps, 1);
+        if (fps == 0) {
+            seed ^= seed << 13;
+            seed ^= seed >> 17;
+            seed ^= seed << 5;
+            seconds = 0.005 + (seed % 1000) * 0.000035;
+            if (i % 97 == 96) seconds = 0.060;
+        }
+        frames.push_back(seconds);
+        total += seconds;
+    }
+    return frames;
+}
+
+/**
+ * @brief Symuluje ciało stałym krokiem dla podanych czasów klatek.
+ * @param history Stan po każdym kroku.
+ * @param alphaOk Czy alfa po każdej klatce mieściła się w [0, 1).
+ */
+static FixedTimestepStats RunFixed(const std::vector<double>& frames, int rate, std::vector<TestBody>& history, bool& alphaOk) {
+    FixedTimestep clock(rate);
+    TestBody body;
+    history.clear();
+    alphaOk = true;
+    for (double frameSeconds : frames) {
+        const int steps = clock.Advance(frameSeconds);
+        for (int i = 0; i < steps; i++) {
+            StepBody(body, static_cast<float>(clock.GetStep()));
+            history.push_back(body);
+        }
+        alphaOk &= clock.GetAlpha() >= 0.0f && clock.GetAlpha() < 1.0f;
+    }
+    return clock.GetStats();
+}
+
+/**
+ * @brief Sprawdza stały krok symulacji.
+ */
+int RunTimestepBenchmark(int rate) {
+    rate = std::max(rate, 1);
+    std::cout << "\n=== TEST STAŁEGO KROKU SYMULACJI (" << rate << " Hz, " << RUN_SECONDS << " s) ===\n";
+
+    bool ok = true;
+    const int displayRates[] = { 60, 144, 0 };
+    const char* names[] = { "60 Hz", "144 Hz", "jitter 5-40 ms + skoki 60 ms" };
+    std::vector<std::vector<TestBody>> histories(3);
+    bool countsOk = true, alphaOk = true;
+
+    std::cout << "  Klatki                         klatki    kroki  max/klatkę  przycięte  odbicia\n";
+    for (int i = 0; i < 3; i++) {
+        const std::vector<double> frames = MakeFrames(displayRates[i], 12345u);
+        double total = 0.0;
+        for (double seconds : frames) total += seconds;
+        bool alpha = true;
+        const FixedTimestepStats stats = RunFixed(frames, rate, histories[i], alpha);
+        alphaOk &= alpha;
+        // Kroki = czas * częstotliwość (bez czasu odrzuconego przez przycięcie)
+        countsOk &= std::fabs(static_cast<double>(stats.steps) - (total - stats.droppedSeconds) * rate) <= 1.0;
+        std::cout << "  " << std::left << std::setw(30) << names[i] << std::right << std::setw(7) << stats.frames
+            << std::setw(9) << stats.steps << std::setw(12) << stats.maxStepsInFrame
+            << std::setw(11) << stats.clampedFrames << std::setw(9) << histories[i].back().bounces << "\n";
+    }
+    ok &= BenchmarkCheck("Liczba kroków = czas * częstotliwość", countsOk);
+    ok &= BenchmarkCheck("Alfa interpolacji w [0, 1)", alphaOk);
+
+    // Powtarzalność: po kroku N stan jest ten sam bez względu na tempo klatek
+    bool identical = true;
+    for (int i = 1; i < 3; i++) {
+        const size_t common = std::min(histories[0].size(), histories[i].size());
+        for (size_t step = 0; step < common; step++) {
+            identical &= histories[0][step].x == histories[i][step].x
+                && histories[0][step].velocity == histories[i][step].velocity
+                && histories[0][step].bounces == histories[i][step].bounces;
+        }
+    }
+    ok &= BenchmarkCheck("Stan po każdym kroku identyczny dla każdego tempa", identical);
+
+    // Spirala śmierci: klatka 2 s daje maxSteps kroków, reszta czasu odrzucona
+    {
+        FixedTimestep clock(rate);
+        const int steps = clock.Advance(2.0);
+        const FixedTimestepStats stats = clock.GetStats();
+        const double expectedDrop = std::floor(2.0 * rate - clock.GetMaxSteps()) / rate;
+        bool clamped = steps == clock.GetMaxSteps() && stats.clampedFrames == 1
+            && std::fabs(stats.droppedSeconds - expectedDrop) < 1e-9 && clock.GetAlpha() < 1.0f;
+        // Następna zwykła klatka wraca do normalnej liczby kroków
+        clamped &= clock.Advance(1.0 / 60.0) <= (rate + 59) / 60;
+        ok &= BenchmarkCheck("Długa klatka przycięta do maxSteps kroków", clamped);
+    }
+
+    // Interpolacja: przy stałej prędkości obraz pokazuje stan sprzed jednego kroku
+    {
+        FixedTimestep clock(rate);
+        const float velocity = 3.0f;
+        float previous = 0.0f, current = 0.0f;
+        double time = 0.0, worst = 0.0;
+        for (double frameSeconds : MakeFrames(0, 777u)) {
+            time += frameSeconds;
+            const int steps = clock.Advance(frameSeconds);
+            for (int i = 0; i < steps; i++) {
+                previous = current;
+                current = velocity * static_cast<float>((clock.GetTick() - steps + i + 1) * clock.GetStep());
+            }
+            const float alpha = clock.GetAlpha();
+            const float rendered = previous + (current - previous) * alpha;
+            const double expected = velocity * (time - clock.GetStats().droppedSeconds - clock.GetStep());
+            if (clock.GetTick() > 1) worst = std::max(worst, std::fabs(rendered - expected));
+        }
+        std::cout << "  Błąd interpolacji względem ruchu ciągłego: " << worst << " m\n";
+        ok &= BenchmarkCheck("Interpolacja płynna (opóźnienie dokładnie 1 kroku)", worst < 1e-3);
+    }
+
+    // Przenikanie: skok klatki 100 ms tuż przed ścianą
+    {
+        std::vector<double> frames(60, 1.0 / 60.0);
+        frames[28] = 0.100;
+        TestBody variable;
+        for (double seconds : frames) StepBody(variable, static_cast<float>(seconds));
+
+        std::vector<TestBody> history;
+        bool alpha = true;
+        RunFixed(frames, rate, history, alpha);
+        std::cout << "  Skok klatki 100 ms przy ścianie: krok zmienny – "
+            << (variable.bounces ? "odbicie" : "przeniknięcie przez ścianę") << ", krok stały – "
+            << (history.back().bounces ? "odbicie" : "przeniknięcie przez ścianę") << "\n";
+        // Krok stały przesuwa ciało o mniej niż grubość ściany
+        const bool thin = (12.0f + 2.0f) / rate < WALL_WIDTH;
+        ok &= BenchmarkCheck("Krok stały bez przenikania przez ścianę", !thin || history.back().bounces > 0);
+    }
+
+    return BenchmarkSummary(ok);
+}
@@ -0,0 +1,19 @@
+﻿#pragma once
+#ifndef TIMESTEP_BENCHMARK_H
+#define TIMESTEP_BENCHMARK_H
+
+/**
+ * @brief Test stałego kroku symulacji (FixedTimestep).
+ *
+ * Symuluje ciało odbijające się od cienkiej ściany przy różnych tempach
+ * klatek (60 Hz, 144 Hz, losowy jitter ze skokami) i sprawdza liczbę
+ * kroków, identyczność stanu po każdym kroku niezależnie od tempa klatek
+ * (powtarzalne odtwarzanie), przycięcie długiej klatki, zakres alfa,
+ * interpolację położenia oraz brak przenikania przez ścianę przy skoku
+ * czasu klatki. Nie wymaga okna ani OpenGL.
+ * @param rate Częstotliwość kroków symulacji [Hz].
+ * @return 0 jeśli wszystkie sprawdzenia przeszły, 1 w przeciwnym razie.
+ */
+int RunTimestepBenchmark(int rate);
+
+#endif